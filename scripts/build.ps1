@@ -75,6 +75,9 @@ This script provides helpers for building msquic.
 .PARAMETER TlsSecretsSupport
     Enables export of traffic secrets.
 
+.PARAMETER IoUring
+    Uses io_uring for the Linux datapath.
+
 .EXAMPLE
     build.ps1
 
@@ -155,7 +158,10 @@ param (
     [switch]$RandomAllocFail = $false,
 
     [Parameter(Mandatory = $false)]
-    [switch]$TlsSecretsSupport = $false
+    [switch]$TlsSecretsSupport = $false,
+
+    [Parameter(Mandatory = $false)]
+    [switch]$IoUring = $false
 )
 
 Set-StrictMode -Version 'Latest'
@@ -305,6 +311,9 @@ function CMake-Generate {
     if ($TlsSecretsSupport) {
         $Arguments += " -DQUIC_TLS_SECRETS_SUPPORT=on"
     }
+    if ($IoUring) {
+        $Arguments += " -DQUIC_LINUX_IO_URING=on"
+    }
     $Arguments += " ../../.."
 
     CMake-Execute $Arguments
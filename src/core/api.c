@@ -1053,25 +1053,32 @@ MsQuicStreamSend(
     SendRequest->TotalLength = TotalLength;
     SendRequest->ClientContext = ClientSendContext;
 
-    QuicDispatchLockAcquire(&Stream->ApiSendRequestLock);
-    if (!Stream->Flags.SendEnabled) {
-        Status = QUIC_STATUS_INVALID_STATE;
-    } else {
-        QUIC_SEND_REQUEST** ApiSendRequestsTail = &Stream->ApiSendRequests;
-        while (*ApiSendRequestsTail != NULL) {
-            ApiSendRequestsTail = &((*ApiSendRequestsTail)->Next);
-            QueueOper = FALSE; // Not necessary if the previous send hasn't been flushed yet.
+    //
+    // Push the request onto the stream's lock-free queue. The worker reverses
+    // the whole list back into order when it takes it.
+    //
+    QUIC_SEND_REQUEST* ApiSendRequests;
+    do {
+        ApiSendRequests = Stream->ApiSendRequests;
+        if (ApiSendRequests == QUIC_API_SEND_REQUESTS_CLOSED) {
+            break;
         }
-        *ApiSendRequestsTail = SendRequest;
-        Status = QUIC_STATUS_SUCCESS;
-    }
-    QuicDispatchLockRelease(&Stream->ApiSendRequestLock);
+        SendRequest->Next = ApiSendRequests;
+    } while (InterlockedCompareExchangePointer(
+                (void* volatile*)&Stream->ApiSendRequests,
+                SendRequest,
+                ApiSendRequests) != ApiSendRequests);
 
-    if (QUIC_FAILED(Status)) {
+    if (ApiSendRequests == QUIC_API_SEND_REQUESTS_CLOSED) {
+        Status = QUIC_STATUS_INVALID_STATE;
         QuicPoolFree(&Connection->Worker->SendRequestPool, SendRequest);
         goto Exit;
     }
 
+    if (ApiSendRequests != NULL) {
+        QueueOper = FALSE; // Not necessary if the previous send hasn't been flushed yet.
+    }
+
     if (QueueOper) {
         Oper = QuicOperationAlloc(Connection->Worker, QUIC_OPER_TYPE_API_CALL);
         if (Oper == NULL) {
@@ -0,0 +1,979 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Bottleneck Bandwidth and Round-trip propagation time (BBR) congestion
+    control, version 2.
+
+    Instead of reacting to every loss, BBR builds a model of the path from the
+    delivery rate (the bottleneck bandwidth) and the min RTT (the propagation
+    delay), and sends at the bandwidth while keeping about one bandwidth-delay
+    product (BDP) in flight. It cycles through states to keep the model fresh:
+
+    STARTUP     - Doubles the sending rate every round until the bandwidth
+                  estimate stops growing.
+    DRAIN       - Drains the queue created in STARTUP.
+    PROBE_BW    - Cycles between probing for more bandwidth (UP), draining the
+                  queue that created (DOWN), and sending at the estimate
+                  (CRUISE) for a randomized period of 2 to 3 seconds.
+    PROBE_RTT   - Briefly shrinks the window to re-measure the min RTT if it
+                  hasn't been seen for 5 seconds.
+
+    Loss is only treated as a congestion signal if more than 2% of the bytes
+    delivered in a round were lost, so random (non-congestive) loss doesn't
+    shrink the window the way it does for CUBIC. When it is, the amount in
+    flight is bounded by InflightHi for the following cycles.
+
+    The bandwidth is the max of the delivery rate samples loss detection
+    takes on every ACK, kept over the last two PROBE_BW cycles.
+
+--*/
+
+#include "precomp.h"
+#ifdef QUIC_CLOG
+#include "bbr.c.clog.h"
+#endif
+
+//
+// Gains, in percent.
+//
+#define BBR_STARTUP_PACING_GAIN             277 // 2/ln(2)
+#define BBR_STARTUP_CWND_GAIN               200
+#define BBR_DRAIN_PACING_GAIN               35
+#define BBR_PROBE_BW_DOWN_PACING_GAIN       90
+#define BBR_PROBE_BW_UP_PACING_GAIN         125
+#define BBR_PROBE_BW_CWND_GAIN              200
+#define BBR_PROBE_RTT_CWND_GAIN             50
+
+//
+// Pace slightly below the estimated bandwidth to avoid building a queue.
+//
+#define BBR_PACING_MARGIN_PERCENT           1
+
+//
+// STARTUP ends when the bandwidth grew less than 25% for 3 rounds, or on
+// too many loss events in a round.
+//
+#define BBR_FULL_BW_GROWTH_PERCENT          125
+#define BBR_FULL_BW_ROUNDS                  3
+#define BBR_FULL_LOSS_COUNT                 6
+
+//
+// The loss rate in a round above which loss is treated as congestion.
+//
+#define BBR_LOSS_THRESHOLD_PERCENT          2
+
+//
+// The multiplicative decrease applied to the bounds on congestion.
+//
+#define BBR_BETA_PERCENT                    70
+
+//
+// Leave some room for other flows to grow when cruising below InflightHi.
+//
+#define BBR_HEADROOM_PERCENT                15
+
+#define BBR_MIN_RTT_FILTER_LEN_US           10000000 // 10 seconds
+#define BBR_PROBE_RTT_INTERVAL_US           5000000  // 5 seconds
+#define BBR_PROBE_RTT_DURATION_US           200000   // 200 ms
+
+//
+// Time to wait in PROBE_BW before probing for bandwidth again: a base wait
+// plus a random part, so flows sharing a bottleneck don't synchronize.
+//
+#define BBR_PROBE_WAIT_BASE_US              2000000  // 2 seconds
+#define BBR_PROBE_WAIT_RANDOM_US            1000000  // 1 second
+
+#define BBR_MIN_CWND_PACKETS                4
+
+//
+// The longest the wait to probe can be in rounds, to coexist with Reno flows
+// at a similar BDP.
+//
+#define BBR_MAX_RENO_ROUNDS                 63
+
+#define BBR_UNSET_BW                        UINT64_MAX
+#define BBR_UNSET_INFLIGHT                  UINT32_MAX
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+BbrCongestionControlGetMinCongestionWindow(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return
+        BBR_MIN_CWND_PACKETS *
+        (uint32_t)QuicCongestionControlGetConnection(Cc)->Paths[0].Mtu;
+}
+
+//
+// The bandwidth estimate used for pacing and the BDP, or 0 if there has
+// been no sample yet.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint64_t
+BbrCongestionControlGetBandwidth(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    const QUIC_CONGESTION_CONTROL_BBR* Bbr = &Cc->Bbr;
+    uint64_t MaxBw = max(Bbr->MaxBwFilter[0], Bbr->MaxBwFilter[1]);
+    return min(MaxBw, Bbr->BwLo);
+}
+
+//
+// Returns Gain percent of the estimated bandwidth-delay product.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+BbrCongestionControlGetTargetInflight(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint32_t Gain
+    )
+{
+    const QUIC_CONGESTION_CONTROL_BBR* Bbr = &Cc->Bbr;
+    uint64_t Bw = BbrCongestionControlGetBandwidth(Cc);
+    uint64_t Inflight;
+    if (!Bbr->MinRttValid || Bw == 0) {
+        Inflight =
+            (uint64_t)Bbr->InitialWindowPackets *
+            QuicCongestionControlGetConnection(Cc)->Paths[0].Mtu;
+    } else {
+        Inflight = Bw * Bbr->MinRtt / 1000000;
+    }
+    Inflight = Inflight * Gain / 100;
+    return Inflight > UINT32_MAX ? UINT32_MAX : (uint32_t)Inflight;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+BbrCongestionControlResetLowerBounds(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    Cc->Bbr.BwLo = BBR_UNSET_BW;
+    Cc->Bbr.InflightLo = BBR_UNSET_INFLIGHT;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+BbrCongestionControlSetState(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ BBR_STATE State
+    )
+{
+    QuicTraceLogConnInfo(
+        BbrStateChange,
+        QuicCongestionControlGetConnection(Cc),
+        "BBR state change: %hhu -> %hhu",
+        Cc->Bbr.State,
+        (uint8_t)State);
+    Cc->Bbr.State = (uint8_t)State;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+BbrCongestionControlSetProbeBwPhase(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ BBR_PROBE_BW_PHASE Phase
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR* Bbr = &Cc->Bbr;
+    QuicTraceLogConnVerbose(
+        BbrProbeBwPhaseChange,
+        QuicCongestionControlGetConnection(Cc),
+        "BBR PROBE_BW phase change: %hhu -> %hhu",
+        Bbr->ProbeBwPhase,
+        (uint8_t)Phase);
+    Bbr->ProbeBwPhase = (uint8_t)Phase;
+    Bbr->PhaseStartRound = Bbr->RoundCount;
+}
+
+//
+// Starts a new bandwidth probing cycle, with its DOWN phase.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+BbrCongestionControlStartProbeBwCycle(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint64_t TimeNow
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR* Bbr = &Cc->Bbr;
+
+    //
+    // Age the max bandwidth filter, so the estimate only covers the last two
+    // cycles.
+    //
+    Bbr->MaxBwFilter[1] = Bbr->MaxBwFilter[0];
+    Bbr->MaxBwFilter[0] = 0;
+
+    uint32_t Random;
+    QuicRandom(sizeof(Random), &Random);
+    Bbr->ProbeWaitUs = BBR_PROBE_WAIT_BASE_US + Random % BBR_PROBE_WAIT_RANDOM_US;
+    Bbr->CycleStartTime = TimeNow;
+    Bbr->CycleStartRound = Bbr->RoundCount;
+
+    BbrCongestionControlSetProbeBwPhase(Cc, BBR_PROBE_BW_DOWN);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+BbrCongestionControlEnterProbeBw(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint64_t TimeNow
+    )
+{
+    BbrCongestionControlSetState(Cc, BBR_STATE_PROBE_BW);
+    BbrCongestionControlStartProbeBwCycle(Cc, TimeNow);
+}
+
+//
+// Returns TRUE if it is time to probe for bandwidth again: either the random
+// wait elapsed or enough rounds passed for a Reno flow with the same BDP to
+// have grown its window back.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+BbrCongestionControlIsTimeToProbeBw(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint64_t TimeNow
+    )
+{
+    const QUIC_CONGESTION_CONTROL_BBR* Bbr = &Cc->Bbr;
+    if (QuicTimeDiff64(Bbr->CycleStartTime, TimeNow) >= Bbr->ProbeWaitUs) {
+        return TRUE;
+    }
+    uint64_t RenoRounds =
+        BbrCongestionControlGetTargetInflight(Cc, 100) /
+        QuicCongestionControlGetConnection(Cc)->Paths[0].Mtu;
+    if (RenoRounds > BBR_MAX_RENO_ROUNDS) {
+        RenoRounds = BBR_MAX_RENO_ROUNDS;
+    }
+    return Bbr->RoundCount - Bbr->CycleStartRound >= RenoRounds;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+BbrCongestionControlUpdateMinRtt(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint32_t LatestRtt,
+    _In_ uint64_t TimeNow
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR* Bbr = &Cc->Bbr;
+
+    Bbr->ProbeRttExpired =
+        Bbr->MinRttValid &&
+        QuicTimeDiff64(Bbr->ProbeRttMinTimestamp, TimeNow) > BBR_PROBE_RTT_INTERVAL_US;
+    if (!Bbr->MinRttValid || LatestRtt < Bbr->ProbeRttMinRtt || Bbr->ProbeRttExpired) {
+        Bbr->ProbeRttMinRtt = LatestRtt;
+        Bbr->ProbeRttMinTimestamp = TimeNow;
+    }
+
+    BOOLEAN MinRttExpired =
+        Bbr->MinRttValid &&
+        QuicTimeDiff64(Bbr->MinRttTimestamp, TimeNow) > BBR_MIN_RTT_FILTER_LEN_US;
+    if (!Bbr->MinRttValid || Bbr->ProbeRttMinRtt < Bbr->MinRtt || MinRttExpired) {
+        Bbr->MinRtt = Bbr->ProbeRttMinRtt;
+        Bbr->MinRttTimestamp = Bbr->ProbeRttMinTimestamp;
+        Bbr->MinRttValid = TRUE;
+    }
+}
+
+//
+// Called with each delivery rate sample.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+BbrCongestionControlUpdateMaxBw(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint64_t Bw,
+    _In_ BOOLEAN AppLimited
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR* Bbr = &Cc->Bbr;
+    uint64_t MaxBw = max(Bbr->MaxBwFilter[0], Bbr->MaxBwFilter[1]);
+
+    //
+    // An app limited sample only measures how fast the app sent, so it can
+    // only raise the estimate.
+    //
+    if (!AppLimited || Bw > MaxBw) {
+        if (Bw > Bbr->MaxBwFilter[0]) {
+            Bbr->MaxBwFilter[0] = Bw;
+        }
+    }
+}
+
+//
+// Called at the start of each round to check if STARTUP filled the pipe.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+BbrCongestionControlCheckFullBw(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ BOOLEAN AppLimited
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR* Bbr = &Cc->Bbr;
+
+    if (Bbr->FullBwReached || AppLimited) {
+        return;
+    }
+
+    uint64_t MaxBw = max(Bbr->MaxBwFilter[0], Bbr->MaxBwFilter[1]);
+    if (MaxBw * 100 >= Bbr->FullBw * BBR_FULL_BW_GROWTH_PERCENT) {
+        Bbr->FullBw = MaxBw;
+        Bbr->FullBwCount = 0;
+    } else if (++Bbr->FullBwCount >= BBR_FULL_BW_ROUNDS) {
+        Bbr->FullBwReached = TRUE;
+        QuicTraceLogConnInfo(
+            BbrFullBwReached,
+            QuicCongestionControlGetConnection(Cc),
+            "BBR full bandwidth reached: %llu bytes/sec",
+            MaxBw);
+    }
+}
+
+//
+// Called at the end of each round to react to the loss in the round, if it
+// was high enough to indicate congestion.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+BbrCongestionControlHandleRoundLoss(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint64_t TimeNow
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR* Bbr = &Cc->Bbr;
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    uint64_t RoundBytes = Bbr->Delivered - Bbr->RoundStartDelivered + Bbr->LostInRound;
+
+    if (Bbr->LostInRound == 0 ||
+        Bbr->LostInRound * 100 <= RoundBytes * BBR_LOSS_THRESHOLD_PERCENT) {
+        return;
+    }
+
+    if (Bbr->State == BBR_STATE_STARTUP &&
+        Bbr->LossEventsInRound < BBR_FULL_LOSS_COUNT) {
+        //
+        // The rounds are too short early in STARTUP for a few scattered losses
+        // to say anything about the path.
+        //
+        return;
+    }
+
+    QuicTraceEvent(
+        ConnCongestion,
+        "[conn][%p] Congestion event",
+        Connection);
+    Connection->Stats.Send.CongestionCount++;
+
+    const uint32_t MinCwnd = BbrCongestionControlGetMinCongestionWindow(Cc);
+    const BOOLEAN Probing =
+        Bbr->State == BBR_STATE_STARTUP ||
+        (Bbr->State == BBR_STATE_PROBE_BW &&
+         (Bbr->ProbeBwPhase == BBR_PROBE_BW_REFILL ||
+          Bbr->ProbeBwPhase == BBR_PROBE_BW_UP));
+
+    if (Probing) {
+        //
+        // Probing found the most the path holds without too much loss.
+        //
+        Bbr->InflightHi =
+            max(MinCwnd, (uint32_t)((uint64_t)Bbr->CongestionWindow * BBR_BETA_PERCENT / 100));
+
+    } else {
+        //
+        // Back off the short term bounds until the next probe, but not below
+        // what was delivered in the round: that much clearly still fits, and
+        // random loss shouldn't keep shrinking the bounds round after round.
+        //
+        uint64_t Bw = BbrCongestionControlGetBandwidth(Cc);
+        Bbr->BwLo = max(Bbr->BwLatest, Bw * BBR_BETA_PERCENT / 100);
+        uint64_t InflightLatest = Bbr->Delivered - Bbr->RoundStartDelivered;
+        uint64_t InflightLo = min(Bbr->InflightLo, Bbr->CongestionWindow);
+        InflightLo = max(InflightLatest, InflightLo * BBR_BETA_PERCENT / 100);
+        Bbr->InflightLo =
+            max(MinCwnd, (uint32_t)min(InflightLo, BBR_UNSET_INFLIGHT - 1));
+    }
+
+    if (Bbr->State == BBR_STATE_STARTUP &&
+        Bbr->LossEventsInRound >= BBR_FULL_LOSS_COUNT) {
+        Bbr->FullBwReached = TRUE;
+    } else if (
+        Bbr->State == BBR_STATE_PROBE_BW &&
+        Bbr->ProbeBwPhase == BBR_PROBE_BW_UP) {
+        BbrCongestionControlStartProbeBwCycle(Cc, TimeNow);
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+BbrCongestionControlUpdateProbeBw(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ BOOLEAN RoundStart,
+    _In_ uint64_t TimeNow
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR* Bbr = &Cc->Bbr;
+
+    switch (Bbr->ProbeBwPhase) {
+    case BBR_PROBE_BW_DOWN:
+        if (BbrCongestionControlIsTimeToProbeBw(Cc, TimeNow)) {
+            BbrCongestionControlResetLowerBounds(Cc);
+            BbrCongestionControlSetProbeBwPhase(Cc, BBR_PROBE_BW_REFILL);
+        } else if (Bbr->BytesInFlight <= BbrCongestionControlGetTargetInflight(Cc, 100)) {
+            BbrCongestionControlSetProbeBwPhase(Cc, BBR_PROBE_BW_CRUISE);
+        }
+        break;
+
+    case BBR_PROBE_BW_CRUISE:
+        if (BbrCongestionControlIsTimeToProbeBw(Cc, TimeNow)) {
+            BbrCongestionControlResetLowerBounds(Cc);
+            BbrCongestionControlSetProbeBwPhase(Cc, BBR_PROBE_BW_REFILL);
+        }
+        break;
+
+    case BBR_PROBE_BW_REFILL:
+        //
+        // One round at the estimated bandwidth, so the probe's loss or queue
+        // is attributable to the probe itself.
+        //
+        if (RoundStart && Bbr->RoundCount > Bbr->PhaseStartRound) {
+            Bbr->ProbeUpRounds = 0;
+            BbrCongestionControlSetProbeBwPhase(Cc, BBR_PROBE_BW_UP);
+        }
+        break;
+
+    case BBR_PROBE_BW_UP:
+        if (RoundStart && Bbr->InflightHi != BBR_UNSET_INFLIGHT) {
+            //
+            // Grow the upper bound exponentially for every round the probe
+            // didn't cause too much loss.
+            //
+            uint64_t Growth =
+                (uint64_t)QuicCongestionControlGetConnection(Cc)->Paths[0].Mtu <<
+                min(Bbr->ProbeUpRounds, 30);
+            uint64_t InflightHi = Bbr->InflightHi + Growth;
+            Bbr->InflightHi =
+                InflightHi >= BBR_UNSET_INFLIGHT ?
+                    BBR_UNSET_INFLIGHT - 1 : (uint32_t)InflightHi;
+            Bbr->ProbeUpRounds++;
+        }
+        if (Bbr->RoundCount > Bbr->PhaseStartRound &&
+            Bbr->BytesInFlight >
+                BbrCongestionControlGetTargetInflight(Cc, BBR_PROBE_BW_UP_PACING_GAIN)) {
+            BbrCongestionControlStartProbeBwCycle(Cc, TimeNow);
+        }
+        break;
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+BbrCongestionControlUpdateProbeRtt(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ BOOLEAN RoundStart,
+    _In_ uint64_t TimeNow
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR* Bbr = &Cc->Bbr;
+
+    if (Bbr->State != BBR_STATE_PROBE_RTT) {
+        if (Bbr->ProbeRttExpired && Bbr->State != BBR_STATE_STARTUP) {
+            Bbr->PriorCongestionWindow = Bbr->CongestionWindow;
+            Bbr->ProbeRttDoneTimeValid = FALSE;
+            BbrCongestionControlSetState(Cc, BBR_STATE_PROBE_RTT);
+        }
+        return;
+    }
+
+    if (!Bbr->ProbeRttDoneTimeValid) {
+        if (Bbr->BytesInFlight <=
+                BbrCongestionControlGetTargetInflight(Cc, BBR_PROBE_RTT_CWND_GAIN)) {
+            Bbr->ProbeRttDoneTime = TimeNow + BBR_PROBE_RTT_DURATION_US;
+            Bbr->ProbeRttRound = Bbr->RoundCount;
+            Bbr->ProbeRttDoneTimeValid = TRUE;
+            Bbr->ProbeRttRoundDone = FALSE;
+        }
+        return;
+    }
+
+    if (RoundStart && Bbr->RoundCount > Bbr->ProbeRttRound) {
+        Bbr->ProbeRttRoundDone = TRUE;
+    }
+
+    if (Bbr->ProbeRttRoundDone &&
+        QuicTimeAtOrBefore64(Bbr->ProbeRttDoneTime, TimeNow)) {
+        //
+        // The min RTT has been re-measured. Restore the window and go back
+        // to where we left off.
+        //
+        Bbr->ProbeRttMinTimestamp = TimeNow;
+        Bbr->ProbeRttExpired = FALSE;
+        Bbr->CongestionWindow = max(Bbr->CongestionWindow, Bbr->PriorCongestionWindow);
+        BbrCongestionControlResetLowerBounds(Cc);
+        if (Bbr->FullBwReached) {
+            BbrCongestionControlSetState(Cc, BBR_STATE_PROBE_BW);
+            Bbr->CycleStartTime = TimeNow;
+            Bbr->CycleStartRound = Bbr->RoundCount;
+            BbrCongestionControlSetProbeBwPhase(Cc, BBR_PROBE_BW_CRUISE);
+        } else {
+            BbrCongestionControlSetState(Cc, BBR_STATE_STARTUP);
+        }
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+BbrCongestionControlUpdateGains(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR* Bbr = &Cc->Bbr;
+    switch (Bbr->State) {
+    case BBR_STATE_STARTUP:
+        Bbr->PacingGain = BBR_STARTUP_PACING_GAIN;
+        Bbr->CwndGain = BBR_STARTUP_CWND_GAIN;
+        break;
+    case BBR_STATE_DRAIN:
+        Bbr->PacingGain = BBR_DRAIN_PACING_GAIN;
+        Bbr->CwndGain = BBR_STARTUP_CWND_GAIN;
+        break;
+    case BBR_STATE_PROBE_BW:
+        Bbr->PacingGain =
+            Bbr->ProbeBwPhase == BBR_PROBE_BW_DOWN ? BBR_PROBE_BW_DOWN_PACING_GAIN :
+            Bbr->ProbeBwPhase == BBR_PROBE_BW_UP ? BBR_PROBE_BW_UP_PACING_GAIN :
+            100;
+        Bbr->CwndGain = BBR_PROBE_BW_CWND_GAIN;
+        break;
+    default: // BBR_STATE_PROBE_RTT
+        Bbr->PacingGain = 100;
+        Bbr->CwndGain = BBR_PROBE_RTT_CWND_GAIN;
+        break;
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+BbrCongestionControlUpdatePacingRate(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR* Bbr = &Cc->Bbr;
+    const QUIC_PATH* Path = &QuicCongestionControlGetConnection(Cc)->Paths[0];
+    uint64_t Bw = BbrCongestionControlGetBandwidth(Cc);
+    uint64_t Rate;
+
+    if (Bw == 0) {
+        //
+        // No sample yet, so pace the initial window over the smoothed RTT.
+        //
+        Rate =
+            (uint64_t)Bbr->InitialWindowPackets * Path->Mtu * 1000000 /
+            max(Path->SmoothedRtt, 1);
+    } else {
+        Rate = Bw * (100 - BBR_PACING_MARGIN_PERCENT) / 100;
+    }
+    Rate = Rate * Bbr->PacingGain / 100;
+
+    //
+    // Until the pipe is full, don't let an early low sample slow us down.
+    //
+    if (Bbr->FullBwReached || Rate > Bbr->PacingRate) {
+        Bbr->PacingRate = Rate;
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+BbrCongestionControlUpdateCongestionWindow(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint32_t NumAckedBytes
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR* Bbr = &Cc->Bbr;
+    const uint32_t MinCwnd = BbrCongestionControlGetMinCongestionWindow(Cc);
+    const uint32_t Mtu = QuicCongestionControlGetConnection(Cc)->Paths[0].Mtu;
+
+    uint64_t Target = (uint64_t)BbrCongestionControlGetTargetInflight(Cc, Bbr->CwndGain) + 3 * Mtu;
+    uint64_t Cwnd = (uint64_t)Bbr->CongestionWindow + NumAckedBytes;
+    if (Bbr->FullBwReached) {
+        Cwnd = min(Cwnd, Target);
+    } else if (Bbr->CongestionWindow >= Target &&
+        Bbr->Delivered >= (uint64_t)Bbr->InitialWindowPackets * Mtu) {
+        Cwnd = Bbr->CongestionWindow;
+    }
+
+    if (Bbr->State == BBR_STATE_PROBE_RTT) {
+        Cwnd = min(Cwnd, BbrCongestionControlGetTargetInflight(Cc, BBR_PROBE_RTT_CWND_GAIN));
+    }
+
+    if (Bbr->InflightHi != BBR_UNSET_INFLIGHT) {
+        uint64_t InflightHi = Bbr->InflightHi;
+        if (Bbr->State == BBR_STATE_PROBE_RTT ||
+            (Bbr->State == BBR_STATE_PROBE_BW && Bbr->ProbeBwPhase == BBR_PROBE_BW_CRUISE)) {
+            InflightHi = InflightHi * (100 - BBR_HEADROOM_PERCENT) / 100;
+        }
+        Cwnd = min(Cwnd, InflightHi);
+    }
+    Cwnd = min(Cwnd, Bbr->InflightLo);
+
+    Bbr->CongestionWindow = (uint32_t)max(Cwnd, MinCwnd);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+BbrCongestionControlCanSend(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR* Bbr = &Cc->Bbr;
+    return Bbr->BytesInFlight < Bbr->CongestionWindow || Bbr->Exemptions > 0;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+BbrCongestionControlSetExemption(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint8_t NumPackets
+    )
+{
+    Cc->Bbr.Exemptions = NumPackets;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+BbrCongestionControlResetState(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR* Bbr = &Cc->Bbr;
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    uint32_t InitialWindowPackets = Bbr->InitialWindowPackets;
+
+    QuicZeroMemory(Bbr, sizeof(*Bbr));
+    Bbr->InitialWindowPackets = InitialWindowPackets;
+    Bbr->State = BBR_STATE_STARTUP;
+    Bbr->CongestionWindow = Connection->Paths[0].Mtu * InitialWindowPackets;
+    Bbr->BytesInFlightMax = Bbr->CongestionWindow / 2;
+    Bbr->InflightHi = BBR_UNSET_INFLIGHT;
+    BbrCongestionControlResetLowerBounds(Cc);
+    BbrCongestionControlUpdateGains(Cc);
+    BbrCongestionControlUpdatePacingRate(Cc);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+BbrCongestionControlReset(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    BbrCongestionControlResetState(Cc);
+    QuicConnLogOutFlowStats(QuicCongestionControlGetConnection(Cc));
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+BbrCongestionControlGetSendAllowance(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint64_t TimeSinceLastSend, // microsec
+    _In_ BOOLEAN TimeSinceLastSendValid
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR* Bbr = &Cc->Bbr;
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    uint32_t SendAllowance;
+
+    if (Bbr->BytesInFlight >= Bbr->CongestionWindow) {
+        //
+        // We are CC blocked, so we can't send anything.
+        //
+        SendAllowance = 0;
+
+    } else if (
+        !TimeSinceLastSendValid ||
+        !Connection->Settings.PacingEnabled ||
+        !Connection->Paths[0].GotFirstRttSample ||
+        Connection->Paths[0].SmoothedRtt < MS_TO_US(QUIC_SEND_PACING_INTERVAL)) {
+        //
+        // We're not in the necessary state to pace.
+        //
+        SendAllowance = Bbr->CongestionWindow - Bbr->BytesInFlight;
+
+    } else {
+        //
+        // We are pacing, so the allowance is what the pacing rate allows in
+        // the time since the last send.
+        //
+        uint64_t Allowance = Bbr->PacingRate * TimeSinceLastSend / 1000000;
+        SendAllowance = Bbr->CongestionWindow - Bbr->BytesInFlight;
+        if (Allowance < SendAllowance) {
+            SendAllowance = (uint32_t)Allowance;
+        }
+    }
+    return SendAllowance;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint64_t
+BbrCongestionControlGetDepartureTime(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint64_t TimeNow // microsec
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR* Bbr = &Cc->Bbr;
+    if (QuicTimeAtOrBefore64(Bbr->NextDepartureTime, TimeNow)) {
+        Bbr->NextDepartureTime = TimeNow;
+    }
+    return Bbr->NextDepartureTime;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+BbrCongestionControlAdvanceDepartureTime(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint32_t NumBytes
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR* Bbr = &Cc->Bbr;
+    if (Bbr->PacingRate != 0) {
+        Bbr->NextDepartureTime += (uint64_t)NumBytes * 1000000 / Bbr->PacingRate;
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+BbrCongestionControlGetPacingQuantum(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    //
+    // About a pacing interval's worth of bytes, but at least two packets.
+    //
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    uint64_t Quantum =
+        Cc->Bbr.PacingRate * MS_TO_US(QUIC_SEND_PACING_INTERVAL) / 1000000;
+    if (Quantum < 2 * (uint64_t)Connection->Paths[0].Mtu) {
+        Quantum = 2 * (uint64_t)Connection->Paths[0].Mtu;
+    } else if (Quantum > UINT32_MAX) {
+        Quantum = UINT32_MAX;
+    }
+    return (uint32_t)Quantum;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+BbrCongestionControlOnDataSent(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint32_t NumRetransmittableBytes
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR* Bbr = &Cc->Bbr;
+    BOOLEAN PreviousCanSendState = QuicCongestionControlCanSend(Cc);
+
+    Bbr->BytesInFlight += NumRetransmittableBytes;
+    if (Bbr->BytesInFlightMax < Bbr->BytesInFlight) {
+        Bbr->BytesInFlightMax = Bbr->BytesInFlight;
+        QuicSendBufferConnectionAdjust(QuicCongestionControlGetConnection(Cc));
+    }
+
+    if (Bbr->Exemptions > 0) {
+        --Bbr->Exemptions;
+    }
+
+    QuicCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+BbrCongestionControlOnDataInvalidated(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint32_t NumRetransmittableBytes
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR* Bbr = &Cc->Bbr;
+    BOOLEAN PreviousCanSendState = QuicCongestionControlCanSend(Cc);
+
+    QUIC_DBG_ASSERT(Bbr->BytesInFlight >= NumRetransmittableBytes);
+    Bbr->BytesInFlight -= NumRetransmittableBytes;
+
+    return QuicCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+BbrCongestionControlOnDataAcknowledged(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_ACK_EVENT* AckEvent
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR* Bbr = &Cc->Bbr;
+    const uint64_t TimeNow = AckEvent->TimeNow;
+    BOOLEAN PreviousCanSendState = QuicCongestionControlCanSend(Cc);
+    BOOLEAN RoundStart = FALSE;
+
+    QUIC_DBG_ASSERT(Bbr->BytesInFlight >= AckEvent->NumRetransmittableBytes);
+    Bbr->BytesInFlight -= AckEvent->NumRetransmittableBytes;
+    Bbr->Delivered += AckEvent->NumRetransmittableBytes;
+
+    if (AckEvent->HasRttSample) {
+        BbrCongestionControlUpdateMinRtt(Cc, AckEvent->LatestRtt, TimeNow);
+    }
+
+    if (AckEvent->HasRateSample) {
+        BbrCongestionControlUpdateMaxBw(
+            Cc, AckEvent->DeliveryRate, AckEvent->IsAppLimited);
+        if (AckEvent->DeliveryRate > Bbr->BwLatest) {
+            Bbr->BwLatest = AckEvent->DeliveryRate;
+        }
+    }
+
+    if (Bbr->RoundCount == 0 || AckEvent->LargestAck > Bbr->RoundEndPacketNumber) {
+        //
+        // The round is over. React to its bandwidth growth and loss.
+        //
+        RoundStart = TRUE;
+        BbrCongestionControlCheckFullBw(
+            Cc, !AckEvent->HasRateSample || AckEvent->IsAppLimited);
+        BbrCongestionControlHandleRoundLoss(Cc, TimeNow);
+
+        Bbr->RoundCount++;
+        Bbr->RoundEndPacketNumber = AckEvent->LargestSentPacketNumber;
+        Bbr->RoundStartDelivered = Bbr->Delivered;
+        Bbr->LostInRound = 0;
+        Bbr->LossEventsInRound = 0;
+        Bbr->BwLatest = 0;
+    }
+
+    if (Bbr->State == BBR_STATE_STARTUP && Bbr->FullBwReached) {
+        BbrCongestionControlSetState(Cc, BBR_STATE_DRAIN);
+    }
+    if (Bbr->State == BBR_STATE_DRAIN &&
+        Bbr->BytesInFlight <= BbrCongestionControlGetTargetInflight(Cc, 100)) {
+        BbrCongestionControlEnterProbeBw(Cc, TimeNow);
+    }
+    if (Bbr->State == BBR_STATE_PROBE_BW) {
+        BbrCongestionControlUpdateProbeBw(Cc, RoundStart, TimeNow);
+    }
+    BbrCongestionControlUpdateProbeRtt(Cc, RoundStart, TimeNow);
+
+    BbrCongestionControlUpdateGains(Cc);
+    BbrCongestionControlUpdatePacingRate(Cc);
+    BbrCongestionControlUpdateCongestionWindow(Cc, AckEvent->NumRetransmittableBytes);
+
+    return QuicCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+BbrCongestionControlOnDataLost(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_LOSS_EVENT* LossEvent
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR* Bbr = &Cc->Bbr;
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    BOOLEAN PreviousCanSendState = QuicCongestionControlCanSend(Cc);
+
+    QUIC_DBG_ASSERT(Bbr->BytesInFlight >= LossEvent->NumRetransmittableBytes);
+    Bbr->BytesInFlight -= LossEvent->NumRetransmittableBytes;
+    Bbr->LostInRound += LossEvent->NumRetransmittableBytes;
+    Bbr->LossEventsInRound++;
+
+    if (LossEvent->PersistentCongestion) {
+        QuicTraceEvent(
+            ConnPersistentCongestion,
+            "[conn][%p] Persistent congestion event",
+            Connection);
+        Connection->Stats.Send.PersistentCongestionCount++;
+        Bbr->PriorCongestionWindow = Bbr->CongestionWindow;
+        Bbr->CongestionWindow = BbrCongestionControlGetMinCongestionWindow(Cc);
+    }
+
+    QuicCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint8_t
+BbrCongestionControlGetExemptions(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return Cc->Bbr.Exemptions;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+BbrCongestionControlGetBytesInFlightMax(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return Cc->Bbr.BytesInFlightMax;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+BbrCongestionControlLogOutFlowStatus(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    const QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    const QUIC_PATH* Path = &Connection->Paths[0];
+    UNREFERENCED_PARAMETER(Path);
+
+    //
+    // BBR has no slow start threshold.
+    //
+    QuicTraceEvent(
+        ConnOutFlowStats,
+        "[conn][%p] OUT: BytesSent=%llu InFlight=%u InFlightMax=%u CWnd=%u SSThresh=%u ConnFC=%llu ISB=%llu PostedBytes=%llu SRtt=%u",
+        Connection,
+        Connection->Stats.Send.TotalBytes,
+        Cc->Bbr.BytesInFlight,
+        Cc->Bbr.BytesInFlightMax,
+        Cc->Bbr.CongestionWindow,
+        UINT32_MAX,
+        Connection->Send.PeerMaxData - Connection->Send.OrderedStreamBytesSent,
+        Connection->SendBuffer.IdealBytes,
+        Connection->SendBuffer.PostedBytes,
+        Path->GotFirstRttSample ? Path->SmoothedRtt : 0);
+}
+
+static const QUIC_CONGESTION_CONTROL_OPS QuicCongestionControlBbrOps = {
+    BbrCongestionControlCanSend,
+    BbrCongestionControlSetExemption,
+    BbrCongestionControlReset,
+    BbrCongestionControlGetSendAllowance,
+    BbrCongestionControlGetDepartureTime,
+    BbrCongestionControlAdvanceDepartureTime,
+    BbrCongestionControlGetPacingQuantum,
+    BbrCongestionControlOnDataSent,
+    BbrCongestionControlOnDataInvalidated,
+    BbrCongestionControlOnDataAcknowledged,
+    BbrCongestionControlOnDataLost,
+    BbrCongestionControlGetExemptions,
+    BbrCongestionControlGetBytesInFlightMax,
+    BbrCongestionControlLogOutFlowStatus
+};
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+BbrCongestionControlInitialize(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_SETTINGS* Settings
+    )
+{
+    Cc->Name = "BBR";
+    Cc->Ops = &QuicCongestionControlBbrOps;
+
+    Cc->Bbr.InitialWindowPackets = Settings->InitialWindowPackets;
+    BbrCongestionControlResetState(Cc);
+    QuicConnLogOutFlowStats(QuicCongestionControlGetConnection(Cc));
+}
@@ -0,0 +1,178 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+--*/
+
+typedef enum BBR_STATE {
+
+    BBR_STATE_STARTUP,
+    BBR_STATE_DRAIN,
+    BBR_STATE_PROBE_BW,
+    BBR_STATE_PROBE_RTT
+
+} BBR_STATE;
+
+//
+// The phases of the BBR_STATE_PROBE_BW bandwidth probing cycle.
+//
+typedef enum BBR_PROBE_BW_PHASE {
+
+    BBR_PROBE_BW_DOWN,      // Drain the queue built while probing.
+    BBR_PROBE_BW_CRUISE,    // Send at the estimated bandwidth.
+    BBR_PROBE_BW_REFILL,    // Refill the pipe before probing.
+    BBR_PROBE_BW_UP         // Probe for more bandwidth.
+
+} BBR_PROBE_BW_PHASE;
+
+typedef struct QUIC_CONGESTION_CONTROL_BBR {
+
+    //
+    // TRUE once the bandwidth estimate stopped growing in STARTUP.
+    //
+    BOOLEAN FullBwReached : 1;
+
+    BOOLEAN MinRttValid : 1;
+
+    //
+    // TRUE if the ProbeRttMinRtt filter expired on the last RTT sample.
+    //
+    BOOLEAN ProbeRttExpired : 1;
+
+    //
+    // TRUE once BytesInFlight dropped to the PROBE_RTT window and the
+    // ProbeRttDoneTime timer started.
+    //
+    BOOLEAN ProbeRttDoneTimeValid : 1;
+
+    //
+    // TRUE once a round passed since ProbeRttDoneTime started.
+    //
+    BOOLEAN ProbeRttRoundDone : 1;
+
+    uint8_t State; // BBR_STATE
+    uint8_t ProbeBwPhase; // BBR_PROBE_BW_PHASE
+
+    //
+    // A count of packets which can be sent ignoring CongestionWindow.
+    //
+    uint8_t Exemptions;
+
+    //
+    // The number of rounds in STARTUP without significant bandwidth growth.
+    //
+    uint8_t FullBwCount;
+
+    //
+    // The number of loss events in the current round.
+    //
+    uint32_t LossEventsInRound;
+
+    //
+    // The size of the initial congestion window, in packets.
+    //
+    uint32_t InitialWindowPackets;
+
+    uint32_t CongestionWindow; // bytes
+
+    //
+    // The window before entering PROBE_RTT, restored on exit.
+    //
+    uint32_t PriorCongestionWindow; // bytes
+
+    uint32_t BytesInFlight;
+    uint32_t BytesInFlightMax;
+
+    uint32_t PacingGain; // percent
+    uint32_t CwndGain; // percent
+
+    //
+    // A round trip ends once a packet sent after the round started is
+    // acknowledged.
+    //
+    uint64_t RoundCount;
+    uint64_t RoundEndPacketNumber;
+
+    //
+    // The total number of bytes acknowledged.
+    //
+    uint64_t Delivered;
+
+    uint64_t RoundStartDelivered;
+
+    //
+    // The number of bytes lost in the current round.
+    //
+    uint64_t LostInRound;
+
+    //
+    // The windowed max bandwidth filter, kept over the last two PROBE_BW
+    // cycles.
+    //
+    uint64_t MaxBwFilter[2]; // bytes/sec
+
+    //
+    // The max delivery rate sampled in the current round.
+    //
+    uint64_t BwLatest; // bytes/sec
+
+    //
+    // The short term lower bounds on the bandwidth and inflight data, set
+    // on loss and reset every time bandwidth is probed.
+    //
+    uint64_t BwLo; // bytes/sec
+    uint32_t InflightLo; // bytes
+
+    //
+    // The long term upper bound on inflight data, set when probing for
+    // bandwidth caused too much loss.
+    //
+    uint32_t InflightHi; // bytes
+
+    //
+    // The bandwidth STARTUP last saw a significant increase at.
+    //
+    uint64_t FullBw; // bytes/sec
+
+    uint64_t PacingRate; // bytes/sec
+
+    //
+    // The min RTT over the last 10 seconds, used for the BDP.
+    //
+    uint32_t MinRtt; // microsec
+    uint64_t MinRttTimestamp; // microsec
+
+    //
+    // The min RTT over the last 5 seconds. PROBE_RTT is entered when it
+    // expires.
+    //
+    uint32_t ProbeRttMinRtt; // microsec
+    uint64_t ProbeRttMinTimestamp; // microsec
+
+    uint64_t ProbeRttDoneTime; // microsec
+    uint64_t ProbeRttRound;
+
+    //
+    // State of the current PROBE_BW cycle.
+    //
+    uint64_t CycleStartTime; // microsec
+    uint64_t CycleStartRound;
+    uint64_t PhaseStartRound;
+    uint32_t ProbeWaitUs;
+    uint32_t ProbeUpRounds;
+
+    //
+    // The earliest time the next batch of packets may depart, when pacing is
+    // offloaded to the datapath.
+    //
+    uint64_t NextDepartureTime; // microsec
+
+} QUIC_CONGESTION_CONTROL_BBR;
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+BbrCongestionControlInitialize(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_SETTINGS* Settings
+    );
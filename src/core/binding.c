@@ -48,7 +48,6 @@ QuicBindingInitialize(
 {
     QUIC_STATUS Status;
     QUIC_BINDING* Binding;
-    uint8_t HashSalt[20];
     BOOLEAN HashTableInitialized = FALSE;
 
     Binding = QUIC_ALLOC_NONPAGED(sizeof(QUIC_BINDING), QUIC_POOL_BINDING);
@@ -67,9 +66,7 @@ QuicBindingInitialize(
     Binding->ServerOwned = ServerOwned;
     Binding->Connected = RemoteAddress == NULL ? FALSE : TRUE;
     Binding->StatelessOperCount = 0;
-    Binding->ResetTokenHash = NULL;
     QuicDispatchRwLockInitialize(&Binding->RwLock);
-    QuicDispatchLockInitialize(&Binding->ResetTokenLock);
     QuicDispatchLockInitialize(&Binding->StatelessOperLock);
     QuicListInitializeHead(&Binding->Listeners);
     QuicLookupInitialize(&Binding->Lookup);
@@ -88,23 +85,6 @@ QuicBindingInitialize(
         (Binding->RandomReservedVersion & ~QUIC_VERSION_RESERVED_MASK) |
         QUIC_VERSION_RESERVED;
 
-    QuicRandom(sizeof(HashSalt), HashSalt);
-    Status =
-        QuicHashCreate(
-            QUIC_HASH_SHA256,
-            HashSalt,
-            sizeof(HashSalt),
-            &Binding->ResetTokenHash);
-    if (QUIC_FAILED(Status)) {
-        QuicTraceEvent(
-            BindingErrorStatus,
-            "[bind][%p] ERROR, %u, %s.",
-            Binding,
-            Status,
-            "Create reset token hash");
-        goto Error;
-    }
-
 #ifdef QUIC_COMPARTMENT_ID
     Binding->CompartmentId = CompartmentId;
 
@@ -125,12 +105,25 @@ QuicBindingInitialize(
     }
 #endif
 
+    //
+    // Only listeners steer receives by connection ID. The datapath has to
+    // open up the port for that, so it's opt-in.
+    //
+    const BOOLEAN CidSteering =
+        ServerOwned &&
+        RemoteAddress == NULL &&
+        (QuicDataPathGetSupportedFeatures(MsQuicLib.Datapath) &
+            QUIC_DATAPATH_FEATURE_CID_STEERING);
+
     Status =
         QuicDataPathBindingCreate(
             MsQuicLib.Datapath,
             LocalAddress,
             RemoteAddress,
             Binding,
+            CidSteering ?
+                QUIC_DATAPATH_BINDING_FLAG_CID_STEERING :
+                QUIC_DATAPATH_BINDING_FLAG_NONE,
             &Binding->DatapathBinding);
 
 #ifdef QUIC_COMPARTMENT_ID
@@ -149,6 +142,31 @@ QuicBindingInitialize(
         goto Error;
     }
 
+    if (CidSteering) {
+        //
+        // Have the datapath deliver short header packets on the partition that
+        // owns the connection, so they don't need to be moved across workers.
+        //
+        QUIC_DATAPATH_CID_STEERING CidSteering = {
+            MsQuicLib.CidServerIdLength,
+            MsQuicLib.PartitionMask,
+            MsQuicLib.PartitionCount
+        };
+        QUIC_STATUS SteeringStatus =
+            QuicDataPathBindingSetParam(
+                Binding->DatapathBinding,
+                QUIC_DATAPATH_BINDING_PARAM_CID_STEERING,
+                sizeof(CidSteering),
+                (const uint8_t*)&CidSteering);
+        if (QUIC_FAILED(SteeringStatus)) {
+            QuicTraceLogWarning(
+                BindingCidSteeringFailed,
+                "[bind][%p] Failed to enable CID steering, 0x%x",
+                Binding,
+                SteeringStatus);
+        }
+    }
+
     QUIC_ADDR DatapathLocalAddr, DatapathRemoteAddr;
     QuicDataPathBindingGetLocalAddress(Binding->DatapathBinding, &DatapathLocalAddr);
     QuicDataPathBindingGetRemoteAddress(Binding->DatapathBinding, &DatapathRemoteAddr);
@@ -167,13 +185,11 @@ Error:
 
     if (QUIC_FAILED(Status)) {
         if (Binding != NULL) {
-            QuicHashFree(Binding->ResetTokenHash);
             QuicLookupUninitialize(&Binding->Lookup);
             if (HashTableInitialized) {
                 QuicHashtableUninitialize(&Binding->StatelessOperTable);
             }
             QuicDispatchLockUninitialize(&Binding->StatelessOperLock);
-            QuicDispatchLockUninitialize(&Binding->ResetTokenLock);
             QuicDispatchRwLockUninitialize(&Binding->RwLock);
             QUIC_FREE(Binding, QUIC_POOL_BINDING);
         }
@@ -224,11 +240,9 @@ QuicBindingUninitialize(
     QUIC_DBG_ASSERT(Binding->StatelessOperCount == 0);
     QUIC_DBG_ASSERT(Binding->StatelessOperTable.NumEntries == 0);
 
-    QuicHashFree(Binding->ResetTokenHash);
     QuicLookupUninitialize(&Binding->Lookup);
     QuicDispatchLockUninitialize(&Binding->StatelessOperLock);
     QuicHashtableUninitialize(&Binding->StatelessOperTable);
-    QuicDispatchLockUninitialize(&Binding->ResetTokenLock);
     QuicDispatchRwLockUninitialize(&Binding->RwLock);
 
     QuicTraceEvent(
@@ -879,8 +893,7 @@ QuicBindingProcessStatelessOperation(
         ResetPacket->IsLongHeader = FALSE;
         ResetPacket->FixedBit = 1;
         ResetPacket->KeyPhase = RecvPacket->SH->KeyPhase;
-        QuicBindingGenerateStatelessResetToken(
-            Binding,
+        QuicLibraryGenerateStatelessResetToken(
             RecvPacket->DestCid,
             SendDatagram->Buffer + PacketLength - QUIC_STATELESS_RESET_TOKEN_LENGTH);
 
@@ -1330,7 +1343,8 @@ Exit:
 //
 // Looks up or creates a connection to handle a chain of datagrams.
 // Returns TRUE if the datagrams were delivered, and FALSE if they should be
-// dropped.
+// dropped. For chains routed by local CID, the caller has already done the
+// lookup and passes in the (referenced) result, Connection.
 //
 _IRQL_requires_max_(DISPATCH_LEVEL)
 _Function_class_(QUIC_DATAPATH_RECEIVE_CALLBACK)
@@ -1338,7 +1352,8 @@ BOOLEAN
 QuicBindingDeliverDatagrams(
     _In_ QUIC_BINDING* Binding,
     _In_ QUIC_RECV_DATAGRAM* DatagramChain,
-    _In_ uint32_t DatagramChainLength
+    _In_ uint32_t DatagramChainLength,
+    _In_opt_ QUIC_CONNECTION* Connection
     )
 {
     QUIC_RECV_PACKET* Packet =
@@ -1377,14 +1392,8 @@ QuicBindingDeliverDatagrams(
     // packet, then the packet is dropped.
     //
 
-    QUIC_CONNECTION* Connection;
-    if (!Binding->ServerOwned || Packet->IsShortHeader) {
-        Connection =
-            QuicLookupFindConnectionByLocalCid(
-                &Binding->Lookup,
-                Packet->DestCid,
-                Packet->DestCidLen);
-    } else {
+    if (Binding->ServerOwned && !Packet->IsShortHeader) {
+        QUIC_DBG_ASSERT(Connection == NULL);
         Connection =
             QuicLookupFindConnectionByRemoteHash(
                 &Binding->Lookup,
@@ -1489,6 +1498,74 @@ QuicBindingDeliverDatagrams(
     return TRUE;
 }
 
+//
+// A chain of datagrams with the same destination CID.
+//
+typedef struct QUIC_RECV_SUBCHAIN {
+
+    QUIC_RECV_DATAGRAM* Head;
+    QUIC_RECV_DATAGRAM** Tail;
+    uint32_t Length;
+
+} QUIC_RECV_SUBCHAIN;
+
+//
+// Looks up the connections for a batch of subchains all at once, and then
+// delivers each subchain. Subchains that weren't delivered are appended to the
+// release chain.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicBindingDeliverSubChains(
+    _In_ QUIC_BINDING* Binding,
+    _In_range_(1, QUIC_LOOKUP_MAX_BATCH) uint32_t SubChainCount,
+    _In_reads_(SubChainCount) const QUIC_RECV_SUBCHAIN* SubChains,
+    _Inout_ QUIC_RECV_DATAGRAM*** ReleaseChainTail
+    )
+{
+    const uint8_t* Cids[QUIC_LOOKUP_MAX_BATCH];
+    uint8_t CidLengths[QUIC_LOOKUP_MAX_BATCH];
+    QUIC_CONNECTION* Connections[QUIC_LOOKUP_MAX_BATCH];
+    uint32_t LookupCount = 0;
+
+    for (uint32_t i = 0; i < SubChainCount; ++i) {
+        const QUIC_RECV_PACKET* Packet =
+            QuicDataPathRecvDatagramToRecvPacket(SubChains[i].Head);
+        if (!Binding->ServerOwned || Packet->IsShortHeader) {
+            Cids[LookupCount] = Packet->DestCid;
+            CidLengths[LookupCount] = Packet->DestCidLen;
+            LookupCount++;
+        }
+    }
+
+    if (LookupCount != 0) {
+        QuicLookupFindConnectionsByLocalCid(
+            &Binding->Lookup,
+            LookupCount,
+            Cids,
+            CidLengths,
+            Connections);
+    }
+
+    LookupCount = 0;
+    for (uint32_t i = 0; i < SubChainCount; ++i) {
+        const QUIC_RECV_PACKET* Packet =
+            QuicDataPathRecvDatagramToRecvPacket(SubChains[i].Head);
+        QUIC_CONNECTION* Connection = NULL;
+        if (!Binding->ServerOwned || Packet->IsShortHeader) {
+            Connection = Connections[LookupCount++];
+        }
+        if (!QuicBindingDeliverDatagrams(
+                Binding,
+                SubChains[i].Head,
+                SubChains[i].Length,
+                Connection)) {
+            **ReleaseChainTail = SubChains[i].Head;
+            *ReleaseChainTail = SubChains[i].Tail;
+        }
+    }
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 _Function_class_(QUIC_DATAPATH_RECEIVE_CALLBACK)
 void
@@ -1509,12 +1586,15 @@ QuicBindingReceive(
     QUIC_RECV_DATAGRAM** SubChainTail = &SubChain;
     QUIC_RECV_DATAGRAM** SubChainDataTail = &SubChain;
     uint32_t SubChainLength = 0;
+    QUIC_RECV_SUBCHAIN SubChains[QUIC_LOOKUP_MAX_BATCH];
+    uint32_t SubChainCount = 0;
     uint32_t TotalChainLength = 0;
     uint32_t TotalDatagramBytes = 0;
 
     //
     // Breaks the chain of datagrams into subchains by destination CID and
-    // delivers the subchains.
+    // delivers the subchains. The connection lookups for the subchains are
+    // batched.
     //
     // NB: All packets in a datagram are required to have the same destination
     // CID, so we don't split datagrams here. Later on, the packet handling
@@ -1573,8 +1653,8 @@ QuicBindingReceive(
         QUIC_DBG_ASSERT(Packet->ValidatedHeaderInv);
 
         //
-        // If the next datagram doesn't match the current subchain, deliver the
-        // current subchain and start a new one.
+        // If the next datagram doesn't match the current subchain, queue the
+        // current subchain for delivery and start a new one.
         // (If the binding is exclusively owned, all datagrams are delivered to
         // the same connection and this chain-splitting step is skipped.)
         //
@@ -1584,9 +1664,13 @@ QuicBindingReceive(
         if (!Binding->Exclusive && SubChain != NULL &&
             (Packet->DestCidLen != SubChainPacket->DestCidLen ||
              memcmp(Packet->DestCid, SubChainPacket->DestCid, Packet->DestCidLen) != 0)) {
-            if (!QuicBindingDeliverDatagrams(Binding, SubChain, SubChainLength)) {
-                *ReleaseChainTail = SubChain;
-                ReleaseChainTail = SubChainDataTail;
+            SubChains[SubChainCount].Head = SubChain;
+            SubChains[SubChainCount].Tail = SubChainDataTail;
+            SubChains[SubChainCount].Length = SubChainLength;
+            if (++SubChainCount == QUIC_LOOKUP_MAX_BATCH) {
+                QuicBindingDeliverSubChains(
+                    Binding, SubChainCount, SubChains, &ReleaseChainTail);
+                SubChainCount = 0;
             }
             SubChain = NULL;
             SubChainTail = &SubChain;
@@ -1621,12 +1705,17 @@ QuicBindingReceive(
 
     if (SubChain != NULL) {
         //
-        // Deliver the last subchain.
+        // Queue the last subchain.
         //
-        if (!QuicBindingDeliverDatagrams(Binding, SubChain, SubChainLength)) {
-            *ReleaseChainTail = SubChain;
-            ReleaseChainTail = SubChainTail; // cppcheck-suppress unreadVariable; NOLINT
-        }
+        SubChains[SubChainCount].Head = SubChain;
+        SubChains[SubChainCount].Tail = SubChainDataTail;
+        SubChains[SubChainCount].Length = SubChainLength;
+        SubChainCount++;
+    }
+
+    if (SubChainCount != 0) {
+        QuicBindingDeliverSubChains(
+            Binding, SubChainCount, SubChains, &ReleaseChainTail);
     }
 
     if (ReleaseChain != NULL) {
@@ -1736,36 +1825,3 @@ QuicBindingSend(
 
     return Status;
 }
-
-QUIC_STATIC_ASSERT(
-    QUIC_HASH_SHA256_SIZE >= QUIC_STATELESS_RESET_TOKEN_LENGTH,
-    "Stateless reset token must be shorter than hash size used");
-
-_IRQL_requires_max_(DISPATCH_LEVEL)
-QUIC_STATUS
-QuicBindingGenerateStatelessResetToken(
-    _In_ QUIC_BINDING* Binding,
-    _In_reads_(MsQuicLib.CidTotalLength)
-        const uint8_t* const CID,
-    _Out_writes_all_(QUIC_STATELESS_RESET_TOKEN_LENGTH)
-        uint8_t* ResetToken
-    )
-{
-    uint8_t HashOutput[QUIC_HASH_SHA256_SIZE];
-    QuicDispatchLockAcquire(&Binding->ResetTokenLock);
-    QUIC_STATUS Status =
-        QuicHashCompute(
-            Binding->ResetTokenHash,
-            CID,
-            MsQuicLib.CidTotalLength,
-            sizeof(HashOutput),
-            HashOutput);
-    QuicDispatchLockRelease(&Binding->ResetTokenLock);
-    if (QUIC_SUCCEEDED(Status)) {
-        QuicCopyMemory(
-            ResetToken,
-            HashOutput,
-            QUIC_STATELESS_RESET_TOKEN_LENGTH);
-    }
-    return Status;
-}
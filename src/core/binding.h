@@ -129,6 +129,12 @@ typedef struct QUIC_RECV_PACKET {
     //
     BOOLEAN DecryptionDeferred : 1;
 
+    //
+    // Flag indicating the payload was already decrypted and authenticated in
+    // place, ahead of the rest of the packet's processing.
+    //
+    BOOLEAN Decrypted : 1;
+
     //
     // Flag indicating the packet was completely parsed successfully.
     //
@@ -186,9 +192,15 @@ typedef struct QUIC_BINDING {
     BOOLEAN Connected : 1;
 
     //
-    // Number of (connection and listener) references to the binding.
+    // Entry in the library's binding table.
+    //
+    QUIC_HASHTABLE_ENTRY TableEntry;
+
+    //
+    // Number of (connection and listener) references to the binding. Once it
+    // drops to zero, the binding can no longer be referenced.
     //
-    uint32_t RefCount;
+    long RefCount;
 
     //
     // A randomly created reserved version.
@@ -222,12 +234,6 @@ typedef struct QUIC_BINDING {
     //
     QUIC_LOOKUP Lookup;
 
-    //
-    // Used for generating stateless reset hashes.
-    //
-    QUIC_HASH* ResetTokenHash;
-    QUIC_DISPATCH_LOCK ResetTokenLock;
-
     //
     // Stateless operation tracking structures.
     //
@@ -421,19 +427,6 @@ QuicBindingSend(
     _In_ uint32_t DatagramsToSend
     );
 
-//
-// Generates a stateless reset token for the given connection ID.
-//
-_IRQL_requires_max_(DISPATCH_LEVEL)
-QUIC_STATUS
-QuicBindingGenerateStatelessResetToken(
-    _In_ QUIC_BINDING* Binding,
-    _In_reads_(MsQuicLib.CidTotalLength)
-        const uint8_t* const CID,
-    _Out_writes_all_(QUIC_STATELESS_RESET_TOKEN_LENGTH)
-        uint8_t* ResetToken
-    );
-
 //
 // Decrypts the retry token.
 //
@@ -410,17 +410,19 @@ QuicConfigurationParamGet(
 {
     if (Param == QUIC_PARAM_CONFIGURATION_SETTINGS) {
 
-        if (*BufferLength < sizeof(QUIC_SETTINGS)) {
+        if (*BufferLength < QUIC_SETTINGS_V1_SIZE) {
             *BufferLength = sizeof(QUIC_SETTINGS);
-            return QUIC_STATUS_BUFFER_TOO_SMALL; // TODO - Support partial
+            return QUIC_STATUS_BUFFER_TOO_SMALL;
         }
 
         if (Buffer == NULL) {
             return QUIC_STATUS_INVALID_PARAMETER;
         }
 
-        *BufferLength = sizeof(QUIC_SETTINGS);
-        QuicCopyMemory(Buffer, &Configuration->Settings, sizeof(QUIC_SETTINGS));
+        if (*BufferLength > sizeof(QUIC_SETTINGS)) {
+            *BufferLength = sizeof(QUIC_SETTINGS);
+        }
+        QuicCopyMemory(Buffer, &Configuration->Settings, *BufferLength);
 
         return QUIC_STATUS_SUCCESS;
     }
@@ -440,7 +442,8 @@ QuicConfigurationParamSet(
 {
     if (Param == QUIC_PARAM_GLOBAL_SETTINGS) {
 
-        if (BufferLength != sizeof(QUIC_SETTINGS)) {
+        if (BufferLength < QUIC_SETTINGS_V1_SIZE ||
+            BufferLength > sizeof(QUIC_SETTINGS)) {
             return QUIC_STATUS_INVALID_PARAMETER; // TODO - Support partial
         }
 
@@ -5,78 +5,180 @@
 
 --*/
 
-typedef struct QUIC_CONGESTION_CONTROL {
+//
+// Information about newly acknowledged packets, passed to the congestion
+// control algorithm.
+//
+typedef struct QUIC_ACK_EVENT {
+
+    uint64_t TimeNow; // microsec
 
     //
-    // TRUE if we have had at least one congestion event.
-    // If TRUE, RecoverySentPacketNumber is valid.
+    // The largest packet number acknowledged so far.
     //
-    BOOLEAN HasHadCongestionEvent : 1;
+    uint64_t LargestAck;
 
     //
-    // This flag indicates a congestion event occurred and CC is attempting
-    // to recover from it.
+    // The largest packet number sent so far.
     //
-    BOOLEAN IsInRecovery : 1;
+    uint64_t LargestSentPacketNumber;
 
     //
-    // This flag indicates a persistent congestion event occurred and CC is
-    // attempting to recover from it.
+    // The number of retransmittable bytes newly acknowledged.
     //
-    BOOLEAN IsInPersistentCongestion : 1;
+    uint32_t NumRetransmittableBytes;
+
+    uint32_t SmoothedRtt; // microsec
 
     //
-    // TRUE if there has been at least one ACK.
+    // The RTT sample taken from this ACK. Only valid if HasRttSample.
     //
-    BOOLEAN TimeOfLastAckValid : 1;
+    uint32_t LatestRtt; // microsec
 
     //
-    // The size of the initial congestion window, in packets.
+    // The delivery rate sampled from this ACK. Only valid if HasRateSample.
+    // IsAppLimited indicates the sampled packets were sent while the
+    // connection was app limited, so the rate may underestimate the
+    // bandwidth.
     //
-    uint32_t InitialWindowPackets;
+    uint64_t DeliveryRate; // bytes/sec
+
+    BOOLEAN HasRttSample : 1;
+    BOOLEAN HasRateSample : 1;
+    BOOLEAN IsAppLimited : 1;
+
+} QUIC_ACK_EVENT;
+
+//
+// Information about newly lost packets, passed to the congestion control
+// algorithm.
+//
+typedef struct QUIC_LOSS_EVENT {
 
     //
-    // Minimum time without any sends before the congestion window is reset.
+    // The largest packet number inferred lost by this event.
     //
-    uint32_t SendIdleTimeoutMs;
+    uint64_t LargestPacketNumberLost;
 
-    uint32_t CongestionWindow; // bytes
-    uint32_t SlowStartThreshold; // bytes
+    //
+    // The largest packet number sent so far.
+    //
+    uint64_t LargestSentPacketNumber;
 
     //
-    // The number of bytes considered to be still in the network.
+    // The number of retransmittable bytes inferred lost.
+    //
+    uint32_t NumRetransmittableBytes;
+
     //
-    // The client of this module should send packets until BytesInFlight becomes
-    // larger than CongestionWindow (see QuicCongestionControlCanSend). This
-    // means BytesInFlight can become larger than CongestionWindow by up to one
-    // packet's worth of bytes, plus exemptions (see Exemptions variable).
+    // TRUE if the loss qualifies as persistent congestion.
     //
-    uint32_t BytesInFlight;
-    uint32_t BytesInFlightMax;
+    BOOLEAN PersistentCongestion : 1;
+
+} QUIC_LOSS_EVENT;
+
+//
+// The functions implemented by each congestion control algorithm. See the
+// QuicCongestionControl* wrappers below for descriptions.
+//
+typedef struct QUIC_CONGESTION_CONTROL_OPS {
+
+    BOOLEAN (*CanSend)(
+        _In_ QUIC_CONGESTION_CONTROL* Cc
+        );
+
+    void (*SetExemption)(
+        _In_ QUIC_CONGESTION_CONTROL* Cc,
+        _In_ uint8_t NumPackets
+        );
+
+    void (*Reset)(
+        _In_ QUIC_CONGESTION_CONTROL* Cc
+        );
+
+    uint32_t (*GetSendAllowance)(
+        _In_ QUIC_CONGESTION_CONTROL* Cc,
+        _In_ uint64_t TimeSinceLastSend, // microsec
+        _In_ BOOLEAN TimeSinceLastSendValid
+        );
+
+    uint64_t (*GetDepartureTime)(
+        _In_ QUIC_CONGESTION_CONTROL* Cc,
+        _In_ uint64_t TimeNow // microsec
+        );
+
+    void (*AdvanceDepartureTime)(
+        _In_ QUIC_CONGESTION_CONTROL* Cc,
+        _In_ uint32_t NumBytes
+        );
+
+    uint32_t (*GetPacingQuantum)(
+        _In_ QUIC_CONGESTION_CONTROL* Cc
+        );
+
+    void (*OnDataSent)(
+        _In_ QUIC_CONGESTION_CONTROL* Cc,
+        _In_ uint32_t NumRetransmittableBytes
+        );
+
+    BOOLEAN (*OnDataInvalidated)(
+        _In_ QUIC_CONGESTION_CONTROL* Cc,
+        _In_ uint32_t NumRetransmittableBytes
+        );
+
+    BOOLEAN (*OnDataAcknowledged)(
+        _In_ QUIC_CONGESTION_CONTROL* Cc,
+        _In_ const QUIC_ACK_EVENT* AckEvent
+        );
+
+    void (*OnDataLost)(
+        _In_ QUIC_CONGESTION_CONTROL* Cc,
+        _In_ const QUIC_LOSS_EVENT* LossEvent
+        );
+
+    uint8_t (*GetExemptions)(
+        _In_ const QUIC_CONGESTION_CONTROL* Cc
+        );
+
+    uint32_t (*GetBytesInFlightMax)(
+        _In_ const QUIC_CONGESTION_CONTROL* Cc
+        );
+
+    void (*LogOutFlowStatus)(
+        _In_ const QUIC_CONGESTION_CONTROL* Cc
+        );
+
+} QUIC_CONGESTION_CONTROL_OPS;
+
+typedef struct QUIC_CONGESTION_CONTROL {
 
     //
-    // A count of packets which can be sent ignoring CongestionWindow.
-    // The count is decremented as the packets are sent. BytesInFlight is still
-    // incremented for these packets. This is used to send probe packets for
-    // loss recovery.
+    // Name of the congestion control algorithm.
     //
-    uint8_t Exemptions;
+    const char* Name;
 
-    uint64_t TimeOfLastAck; // millisec
-    uint64_t TimeOfCongAvoidStart; // millisec
-    uint32_t KCubic; // millisec
-    uint32_t WindowMax; // bytes
-    uint32_t WindowLastMax; // bytes
+    const QUIC_CONGESTION_CONTROL_OPS* Ops;
 
     //
-    // This variable tracks the largest packet that was outstanding at the time
-    // the last congestion event occurred. An ACK for any packet number greater
-    // than this indicates recovery is over.
+    // Algorithm specific state.
     //
-    uint64_t RecoverySentPacketNumber;
+    union {
+        QUIC_CONGESTION_CONTROL_CUBIC Cubic;
+        QUIC_CONGESTION_CONTROL_BBR Bbr;
+    };
 
 } QUIC_CONGESTION_CONTROL;
 
+//
+// Initializes the algorithm selected by Settings->CongestionControlAlgorithm.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicCongestionControlInitialize(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_SETTINGS* Settings
+    );
+
 //
 // Returns TRUE if more bytes can be sent on the network.
 //
@@ -87,9 +189,12 @@ QuicCongestionControlCanSend(
     _In_ QUIC_CONGESTION_CONTROL* Cc
     )
 {
-    return Cc->BytesInFlight < Cc->CongestionWindow || Cc->Exemptions > 0;
+    return Cc->Ops->CanSend(Cc);
 }
 
+//
+// Allows NumPackets packets to be sent regardless of the congestion window.
+//
 _IRQL_requires_max_(DISPATCH_LEVEL)
 inline
 void
@@ -98,76 +203,180 @@ QuicCongestionControlSetExemption(
     _In_ uint8_t NumPackets
     )
 {
-    Cc->Exemptions = NumPackets;
+    Cc->Ops->SetExemption(Cc, NumPackets);
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
-void
-QuicCongestionControlInitialize(
-    _In_ QUIC_CONGESTION_CONTROL* Cc,
-    _In_ const QUIC_SETTINGS* Settings
-    );
-
-_IRQL_requires_max_(DISPATCH_LEVEL)
+inline
 void
 QuicCongestionControlReset(
     _In_ QUIC_CONGESTION_CONTROL* Cc
-    );
+    )
+{
+    Cc->Ops->Reset(Cc);
+}
 
 //
 // Returns the number of bytes that can be sent immediately.
 //
 _IRQL_requires_max_(DISPATCH_LEVEL)
+inline
 uint32_t
 QuicCongestionControlGetSendAllowance(
     _In_ QUIC_CONGESTION_CONTROL* Cc,
     _In_ uint64_t TimeSinceLastSend, // microsec
     _In_ BOOLEAN TimeSinceLastSendValid
-    );
+    )
+{
+    return Cc->Ops->GetSendAllowance(Cc, TimeSinceLastSend, TimeSinceLastSendValid);
+}
+
+//
+// Returns the earliest departure time for the next batch of packets when
+// pacing is offloaded to the datapath.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+inline
+uint64_t
+QuicCongestionControlGetDepartureTime(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint64_t TimeNow // microsec
+    )
+{
+    return Cc->Ops->GetDepartureTime(Cc, TimeNow);
+}
+
+//
+// Moves the departure schedule past a batch of NumBytes bytes, at the pacing
+// rate.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+inline
+void
+QuicCongestionControlAdvanceDepartureTime(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint32_t NumBytes
+    )
+{
+    Cc->Ops->AdvanceDepartureTime(Cc, NumBytes);
+}
+
+//
+// Returns the number of bytes to send in each batch when pacing is offloaded
+// to the datapath.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+inline
+uint32_t
+QuicCongestionControlGetPacingQuantum(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return Cc->Ops->GetPacingQuantum(Cc);
+}
 
 //
 // Called when any retransmittable data is sent.
 //
 _IRQL_requires_max_(PASSIVE_LEVEL)
+inline
 void
 QuicCongestionControlOnDataSent(
     _In_ QUIC_CONGESTION_CONTROL* Cc,
     _In_ uint32_t NumRetransmittableBytes
-    );
+    )
+{
+    Cc->Ops->OnDataSent(Cc, NumRetransmittableBytes);
+}
 
 //
 // Called when any data needs to be removed from inflight but cannot be
 // considered lost or acknowledged.
 //
 _IRQL_requires_max_(DISPATCH_LEVEL)
+inline
 BOOLEAN
 QuicCongestionControlOnDataInvalidated(
     _In_ QUIC_CONGESTION_CONTROL* Cc,
     _In_ uint32_t NumRetransmittableBytes
-    );
+    )
+{
+    return Cc->Ops->OnDataInvalidated(Cc, NumRetransmittableBytes);
+}
 
 //
-// Called when any data is acknowledged.
+// Called when any data is acknowledged. Returns TRUE if the connection became
+// unblocked.
 //
 _IRQL_requires_max_(DISPATCH_LEVEL)
+inline
 BOOLEAN
 QuicCongestionControlOnDataAcknowledged(
     _In_ QUIC_CONGESTION_CONTROL* Cc,
-    _In_ uint64_t TimeNow, // millisec
-    _In_ uint64_t LargestPacketNumberAcked,
-    _In_ uint32_t NumRetransmittableBytes,
-    _In_ uint32_t SmoothedRtt
-    );
+    _In_ const QUIC_ACK_EVENT* AckEvent
+    )
+{
+    return Cc->Ops->OnDataAcknowledged(Cc, AckEvent);
+}
 
 //
 // Called when data is determined lost.
 //
 _IRQL_requires_max_(DISPATCH_LEVEL)
+inline
 void
 QuicCongestionControlOnDataLost(
     _In_ QUIC_CONGESTION_CONTROL* Cc,
-    _In_ uint64_t LargestPacketNumberLost,
-    _In_ uint64_t LargestPacketNumberSent,
-    _In_ uint32_t NumRetransmittableBytes,
-    _In_ BOOLEAN PersistentCongestion
-    );
\ No newline at end of file
+    _In_ const QUIC_LOSS_EVENT* LossEvent
+    )
+{
+    Cc->Ops->OnDataLost(Cc, LossEvent);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+inline
+uint8_t
+QuicCongestionControlGetExemptions(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return Cc->Ops->GetExemptions(Cc);
+}
+
+//
+// Returns the largest number of bytes that have been in flight at once.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+inline
+uint32_t
+QuicCongestionControlGetBytesInFlightMax(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return Cc->Ops->GetBytesInFlightMax(Cc);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+inline
+void
+QuicCongestionControlLogOutFlowStatus(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    Cc->Ops->LogOutFlowStatus(Cc);
+}
+
+//
+// Helpers shared by the algorithms.
+//
+
+//
+// Updates the connection's congestion control blocked state after
+// BytesInFlight or the window changed. Returns TRUE if we became unblocked.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicCongestionControlUpdateBlockedState(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ BOOLEAN PreviousCanSendState
+    );
@@ -1986,6 +1986,19 @@ QuicConnRecvResumptionTicket(
         const uint8_t* AppData = NULL;
         uint32_t AppDataLength = 0;
 
+        if (!Connection->State.ResumptionEnabled) {
+            //
+            // Nothing to resume with. This also keeps TLS processing on the
+            // handshake offload threads from calling back into the app.
+            //
+            QuicTraceEvent(
+                ConnError,
+                "[conn][%p] ERROR, %s.",
+                Connection,
+                "Resumption Ticket received with resumption disabled");
+            goto Error;
+        }
+
         QUIC_STATUS Status =
             QuicCryptoDecodeServerTicket(
                 Connection,
@@ -2202,8 +2215,7 @@ QuicConnGenerateLocalTransportParameters(
 
         LocalTP->Flags |= QUIC_TP_FLAG_STATELESS_RESET_TOKEN;
         QUIC_STATUS Status =
-            QuicBindingGenerateStatelessResetToken(
-                Connection->Paths[0].Binding,
+            QuicLibraryGenerateStatelessResetToken(
                 SourceCid->CID.Data,
                 LocalTP->StatelessResetToken);
         if (QUIC_FAILED(Status)) {
@@ -2212,7 +2224,7 @@ QuicConnGenerateLocalTransportParameters(
                 "[conn][%p] ERROR, %u, %s.",
                 Connection,
                 Status,
-                "QuicBindingGenerateStatelessResetToken");
+                "QuicLibraryGenerateStatelessResetToken");
             return Status;
         }
 
@@ -2575,6 +2587,7 @@ QuicConnProcessPeerTransportParameters(
 
     Connection->Send.PeerMaxData =
         Connection->PeerTransportParams.InitialMaxData;
+    QuicSendUnblockAllStreams(&Connection->Send);
 
     QuicStreamSetInitializeTransportParameters(
         &Connection->Streams,
@@ -3276,16 +3289,18 @@ QuicConnRecvHeader(
 }
 
 //
-// Decodes and decompresses the packet number. If necessary, updates the key
-// phase accordingly, to allow for decryption as the next step. Returns TRUE if
-// the packet should continue to be processed further.
+// Decodes and decompresses the packet number, relative to the expected packet
+// number. If necessary, updates the key phase accordingly, to allow for
+// decryption as the next step. Returns TRUE if the packet should continue to
+// be processed further.
 //
 _IRQL_requires_max_(PASSIVE_LEVEL)
 BOOLEAN
 QuicConnRecvPrepareDecrypt(
     _In_ QUIC_CONNECTION* Connection,
     _In_ QUIC_RECV_PACKET* Packet,
-    _In_reads_(16) const uint8_t* HpMask
+    _In_reads_(16) const uint8_t* HpMask,
+    _In_ uint64_t ExpectedPacketNumber
     )
 {
     QUIC_DBG_ASSERT(Packet->ValidatedHeaderInv);
@@ -3344,7 +3359,7 @@ QuicConnRecvPrepareDecrypt(
     QUIC_ENCRYPT_LEVEL EncryptLevel = QuicKeyTypeToEncryptLevel(Packet->KeyType);
     Packet->PacketNumber =
         QuicPktNumDecompress(
-            Connection->Packets[EncryptLevel]->NextRecvPacketNumber,
+            ExpectedPacketNumber,
             CompressedPacketNumber,
             CompressedPacketNumberLength);
     Packet->PacketNumberSet = TRUE;
@@ -3453,6 +3468,7 @@ QuicConnRecvDecryptAndAuthenticate(
     // Decrypt the payload with the appropriate key.
     //
     if (Packet->Encrypted &&
+        !Packet->Decrypted &&
         QUIC_FAILED(
         QuicDecrypt(
             Connection->Crypto.TlsState.ReadKeys[Packet->KeyType]->PacketKey,
@@ -4047,6 +4063,7 @@ QuicConnRecvFrames(
                 // any previously blocked streams.
                 //
                 UpdatedFlowControl = TRUE;
+                QuicSendUnblockAllStreams(&Connection->Send);
                 QuicConnRemoveOutFlowBlockedReason(
                     Connection, QUIC_FLOW_BLOCKED_CONN_FLOW_CONTROL);
                 QuicSendQueueFlush(
@@ -4614,6 +4631,147 @@ QuicConnRecvPostProcessing(
     }
 }
 
+//
+// Removes header protection from, and decrypts in parallel, the leading
+// 1-RTT packets of the batch that use the current key phase. Returns the
+// number of packets handled. Their packet number lengths are returned, or 0
+// if the packet was already dropped.
+//
+// The packet numbers are decompressed assuming each packet ahead of it in the
+// batch is valid, so QuicConnRecvOffloadValidate must be called for each one
+// as the batch is processed.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+uint8_t
+QuicConnRecvOffloadDecrypt(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ uint8_t BatchCount,
+    _In_reads_(BatchCount) QUIC_RECV_DATAGRAM** Datagrams,
+    _In_reads_(BatchCount * QUIC_HP_SAMPLE_LENGTH)
+        const uint8_t* HpMask,
+    _Out_writes_(BatchCount) uint8_t* PacketNumberLengths
+    )
+{
+    QUIC_PACKET_SPACE* PacketSpace = Connection->Packets[QUIC_ENCRYPT_LEVEL_1_RTT];
+    uint64_t ExpectedPacketNumber = PacketSpace->NextRecvPacketNumber;
+
+    QUIC_CRYPT_BATCH_ENTRY Batch[QUIC_MAX_CRYPTO_BATCH_COUNT];
+    uint8_t Iv[QUIC_MAX_CRYPTO_BATCH_COUNT][QUIC_MAX_IV_LENGTH];
+    uint8_t ResetTokens[QUIC_MAX_CRYPTO_BATCH_COUNT][QUIC_STATELESS_RESET_TOKEN_LENGTH];
+    QUIC_RECV_PACKET* Packets[QUIC_MAX_CRYPTO_BATCH_COUNT];
+    uint8_t DecryptCount = 0;
+
+    uint8_t Count;
+    for (Count = 0; Count < BatchCount; ++Count) {
+        QUIC_RECV_PACKET* Packet = QuicDataPathRecvDatagramToRecvPacket(Datagrams[Count]);
+        const uint8_t* Mask = HpMask + Count * QUIC_HP_SAMPLE_LENGTH;
+
+        //
+        // Stop at the first packet using a different key phase, as it may
+        // need new keys. It and the rest of the batch are processed serially.
+        //
+        const uint8_t FirstByte = Packet->Buffer[0] ^ (Mask[0] & 0x1f);
+        if (((const QUIC_SHORT_HEADER_V1*)&FirstByte)->KeyPhase !=
+            PacketSpace->CurrentKeyPhase) {
+            break;
+        }
+
+        if (!QuicConnRecvPrepareDecrypt(
+                Connection, Packet, Mask, ExpectedPacketNumber)) {
+            PacketNumberLengths[Count] = 0;
+            continue;
+        }
+        QUIC_DBG_ASSERT(Packet->KeyType == QUIC_PACKET_KEY_1_RTT);
+
+        PacketNumberLengths[Count] = Packet->SH->PnLength + 1;
+        if (ExpectedPacketNumber <= Packet->PacketNumber) {
+            ExpectedPacketNumber = Packet->PacketNumber + 1;
+        }
+
+        //
+        // A failed decryption trashes the stateless reset token, so save it to
+        // be restored for the usual checks.
+        //
+        uint8_t* Payload = (uint8_t*)Packet->Buffer + Packet->HeaderLength;
+        QuicCopyMemory(
+            ResetTokens[DecryptCount],
+            Payload + Packet->PayloadLength - QUIC_STATELESS_RESET_TOKEN_LENGTH,
+            QUIC_STATELESS_RESET_TOKEN_LENGTH);
+
+        QuicCryptoCombineIvAndPacketNumber(
+            Connection->Crypto.TlsState.ReadKeys[QUIC_PACKET_KEY_1_RTT]->Iv,
+            (uint8_t*)&Packet->PacketNumber,
+            Iv[DecryptCount]);
+        Batch[DecryptCount].Iv = Iv[DecryptCount];
+        Batch[DecryptCount].AuthData = Packet->Buffer;
+        Batch[DecryptCount].AuthDataLength = Packet->HeaderLength;
+        Batch[DecryptCount].Buffer = Payload;
+        Batch[DecryptCount].BufferLength = Packet->PayloadLength;
+        Packets[DecryptCount++] = Packet;
+    }
+
+    if (DecryptCount != 0) {
+        (void)QuicCryptoOffloadBatch(
+            MsQuicLib.CryptoOffload,
+            Connection->Crypto.TlsState.ReadKeys[QUIC_PACKET_KEY_1_RTT],
+            FALSE,
+            DecryptCount,
+            Batch);
+
+        for (uint8_t i = 0; i < DecryptCount; ++i) {
+            if (QUIC_SUCCEEDED(Batch[i].Status)) {
+                Packets[i]->Decrypted = TRUE;
+            } else {
+                QuicCopyMemory(
+                    Batch[i].Buffer + Batch[i].BufferLength - QUIC_STATELESS_RESET_TOKEN_LENGTH,
+                    ResetTokens[i],
+                    QUIC_STATELESS_RESET_TOKEN_LENGTH);
+            }
+        }
+    }
+
+    return Count;
+}
+
+//
+// Validates a packet prepared by QuicConnRecvOffloadDecrypt against the state
+// left by processing the packets ahead of it in the batch. Returns TRUE if the
+// packet should continue to be processed further.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicConnRecvOffloadValidate(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_RECV_PACKET* Packet,
+    _In_ uint8_t PacketNumberLength
+    )
+{
+    if (PacketNumberLength == 0) {
+        return FALSE; // Already dropped.
+    }
+
+    QUIC_PACKET_SPACE* PacketSpace = Connection->Packets[QUIC_ENCRYPT_LEVEL_1_RTT];
+    if (Packet->SH->KeyPhase != PacketSpace->CurrentKeyPhase) {
+        QuicPacketLogDrop(Connection, Packet, "Key phase changed during batch");
+        return FALSE;
+    }
+
+    //
+    // An invalid packet ahead of this one may have left a different expected
+    // packet number than was assumed.
+    //
+    const uint64_t CompressedMask = (1ull << (8 * PacketNumberLength)) - 1;
+    if (QuicPktNumDecompress(
+            PacketSpace->NextRecvPacketNumber,
+            Packet->PacketNumber & CompressedMask,
+            PacketNumberLength) != Packet->PacketNumber) {
+        QuicPacketLogDrop(Connection, Packet, "Packet number changed during batch");
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicConnRecvDatagramBatch(
@@ -4657,12 +4815,34 @@ QuicConnRecvDatagramBatch(
         QuicZeroMemory(HpMask, BatchCount * QUIC_HP_SAMPLE_LENGTH);
     }
 
+    uint8_t OffloadCount = 0;
+    uint8_t PacketNumberLengths[QUIC_MAX_CRYPTO_BATCH_COUNT];
+    if (Connection->Settings.CryptoOffloadEnabled &&
+        BatchCount > 1 &&
+        Packet->IsShortHeader &&
+        Packet->KeyType == QUIC_PACKET_KEY_1_RTT &&
+        Packet->Encrypted) {
+        OffloadCount =
+            QuicConnRecvOffloadDecrypt(
+                Connection,
+                BatchCount,
+                Datagrams,
+                HpMask,
+                PacketNumberLengths);
+    }
+
     for (uint8_t i = 0; i < BatchCount; ++i) {
         QUIC_DBG_ASSERT(Datagrams[i]->Allocated);
         QUIC_ECN_TYPE ECN = QUIC_ECN_FROM_TOS(Datagrams[i]->TypeOfService);
         Packet = QuicDataPathRecvDatagramToRecvPacket(Datagrams[i]);
-        if (QuicConnRecvPrepareDecrypt(
-                Connection, Packet, HpMask + i * QUIC_HP_SAMPLE_LENGTH) &&
+        if ((i < OffloadCount ?
+                QuicConnRecvOffloadValidate(
+                    Connection, Packet, PacketNumberLengths[i]) :
+                QuicConnRecvPrepareDecrypt(
+                    Connection,
+                    Packet,
+                    HpMask + i * QUIC_HP_SAMPLE_LENGTH,
+                    Connection->Packets[QuicKeyTypeToEncryptLevel(Packet->KeyType)]->NextRecvPacketNumber)) &&
             QuicConnRecvDecryptAndAuthenticate(Connection, Path, Packet) &&
             QuicConnRecvFrames(Connection, Path, Packet, ECN)) {
 
@@ -5350,7 +5530,8 @@ QuicConnParamSet(
 
     case QUIC_PARAM_CONN_SETTINGS:
 
-        if (BufferLength != sizeof(QUIC_SETTINGS)) {
+        if (BufferLength < QUIC_SETTINGS_V1_SIZE ||
+            BufferLength > sizeof(QUIC_SETTINGS)) {
             Status = QUIC_STATUS_INVALID_PARAMETER; // TODO - Support partial
             break;
         }
@@ -5769,7 +5950,7 @@ QuicConnParamGet(
 
     case QUIC_PARAM_CONN_SETTINGS:
 
-        if (*BufferLength < sizeof(QUIC_SETTINGS)) {
+        if (*BufferLength < QUIC_SETTINGS_V1_SIZE) {
             *BufferLength = sizeof(QUIC_SETTINGS);
             Status = QUIC_STATUS_BUFFER_TOO_SMALL;
             break;
@@ -5780,8 +5961,10 @@ QuicConnParamGet(
             break;
         }
 
-        *BufferLength = sizeof(QUIC_SETTINGS);
-        *(QUIC_SETTINGS*)Buffer = Connection->Settings;
+        if (*BufferLength > sizeof(QUIC_SETTINGS)) {
+            *BufferLength = sizeof(QUIC_SETTINGS);
+        }
+        QuicCopyMemory(Buffer, &Connection->Settings, *BufferLength);
 
         Status = QUIC_STATUS_SUCCESS;
         break;
@@ -5789,7 +5972,7 @@ QuicConnParamGet(
     case QUIC_PARAM_CONN_STATISTICS:
     case QUIC_PARAM_CONN_STATISTICS_PLAT: {
 
-        if (*BufferLength < sizeof(QUIC_STATISTICS)) {
+        if (*BufferLength < QUIC_STATISTICS_V1_SIZE) {
             *BufferLength = sizeof(QUIC_STATISTICS);
             Status = QUIC_STATUS_BUFFER_TOO_SMALL;
             break;
@@ -5800,7 +5983,15 @@ QuicConnParamGet(
             break;
         }
 
-        QUIC_STATISTICS* Stats = (QUIC_STATISTICS*)Buffer;
+        //
+        // Callers built against an older, smaller QUIC_STATISTICS only get the
+        // fields that fit in their buffer.
+        //
+        QUIC_STATISTICS StatsCopy;
+        QUIC_STATISTICS* Stats =
+            *BufferLength < sizeof(QUIC_STATISTICS) ?
+                &StatsCopy : (QUIC_STATISTICS*)Buffer;
+        QuicZeroMemory(Stats, sizeof(QUIC_STATISTICS));
         const QUIC_PATH* Path = &Connection->Paths[0];
 
         Stats->CorrelationId = Connection->Stats.CorrelationId;
@@ -5832,6 +6023,10 @@ QuicConnParamGet(
         Stats->Recv.DecryptionFailures = Connection->Stats.Recv.DecryptionFailures;
         Stats->Recv.ValidAckFrames = Connection->Stats.Recv.ValidAckFrames;
         Stats->Misc.KeyUpdateCount = Connection->Stats.Misc.KeyUpdateCount;
+        Stats->PathMtuSearchState = Path->MtuDiscovery.State;
+        Stats->PathMtuProbeCount = Connection->Stats.Send.PathMtuProbeCount;
+        Stats->PathMtuBlackHoleCount = Connection->Stats.Send.PathMtuBlackHoleCount;
+        Stats->EstimatedBandwidth = Connection->LossDetection.EstimatedBandwidth;
 
         if (Param == QUIC_PARAM_CONN_STATISTICS_PLAT) {
             Stats->Timing.Start = QuicTimeUs64ToPlat(Stats->Timing.Start); // cppcheck-suppress selfAssignment
@@ -5839,7 +6034,11 @@ QuicConnParamGet(
             Stats->Timing.HandshakeFlightEnd = QuicTimeUs64ToPlat(Stats->Timing.HandshakeFlightEnd); // cppcheck-suppress selfAssignment
         }
 
-        *BufferLength = sizeof(QUIC_STATISTICS);
+        if (Stats == &StatsCopy) {
+            QuicCopyMemory(Buffer, &StatsCopy, *BufferLength);
+        } else {
+            *BufferLength = sizeof(QUIC_STATISTICS);
+        }
         Status = QUIC_STATUS_SUCCESS;
         break;
     }
@@ -6093,6 +6292,25 @@ QuicConnApplyNewSettings(
             Connection->Settings.PeerUnidiStreamCount);
     }
 
+    if (Connection->Settings.CryptoOffloadEnabled &&
+        !QuicLibraryEnsureCryptoOffload()) {
+        QuicTraceLogConnWarning(
+            CryptoOffloadUnavailable,
+            Connection,
+            "Crypto offload unavailable, disabling");
+        Connection->Settings.CryptoOffloadEnabled = FALSE;
+    }
+
+    if (Connection->Settings.HandshakeOffloadEnabled &&
+        QuicConnIsServer(Connection) &&
+        !QuicLibraryEnsureHandshakeOffload()) {
+        QuicTraceLogConnWarning(
+            HandshakeOffloadUnavailable,
+            Connection,
+            "Handshake offload unavailable, disabling");
+        Connection->Settings.HandshakeOffloadEnabled = FALSE;
+    }
+
     if (NewSettings->IsSet.KeepAliveIntervalMs && Connection->State.Started) {
         if (Connection->Settings.KeepAliveIntervalMs != 0) {
             QuicConnProcessKeepAliveOperation(Connection);;
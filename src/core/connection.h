@@ -171,6 +171,7 @@ typedef enum QUIC_CONNECTION_REF {
     QUIC_CONN_REF_LOOKUP_TABLE,         // Per registered CID.
     QUIC_CONN_REF_LOOKUP_RESULT,        // For connections returned from lookups.
     QUIC_CONN_REF_WORKER,               // Worker is (queued for) processing.
+    QUIC_CONN_REF_HANDSHAKE_OFFLOAD,    // TLS call queued to the handshake offload pool.
 
     QUIC_CONN_REF_COUNT
 
@@ -193,6 +194,13 @@ typedef struct QUIC_CONN_TIMER_ENTRY {
 
 } QUIC_CONN_TIMER_ENTRY;
 
+//
+// The size of the original QUIC_STATISTICS struct, the smallest buffer the
+// statistics can be queried with.
+//
+#define QUIC_STATISTICS_V1_SIZE \
+    (uint32_t)FIELD_OFFSET(QUIC_STATISTICS, PathMtuSearchState)
+
 //
 // Per connection statistics.
 //
@@ -221,6 +229,7 @@ typedef struct QUIC_CONN_STATS {
 
     struct {
         uint32_t LastQueueTime;         // Time the connection last entered the work queue.
+        uint32_t LastRebalanceTime;     // Time the connection was last moved off an overloaded worker.
         uint64_t DrainCount;            // Sum of drain calls
         uint64_t OperationCount;        // Sum of operations processed
     } Schedule;
@@ -242,6 +251,8 @@ typedef struct QUIC_CONN_STATS {
 
         uint32_t CongestionCount;
         uint32_t PersistentCongestionCount;
+        uint32_t PathMtuProbeCount;
+        uint32_t PathMtuBlackHoleCount;
     } Send;
 
     struct {
@@ -654,7 +665,7 @@ inline
 _Ret_notnull_
 QUIC_CONNECTION*
 QuicCongestionControlGetConnection(
-    _In_ QUIC_CONGESTION_CONTROL* Cc
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
     )
 {
     return QUIC_CONTAINING_RECORD(Cc, QUIC_CONNECTION, CongestionControl);
@@ -696,22 +707,7 @@ QuicConnLogOutFlowStats(
         return;
     }
 
-    const QUIC_PATH* Path = &Connection->Paths[0];
-    UNREFERENCED_PARAMETER(Path);
-
-    QuicTraceEvent(
-        ConnOutFlowStats,
-        "[conn][%p] OUT: BytesSent=%llu InFlight=%u InFlightMax=%u CWnd=%u SSThresh=%u ConnFC=%llu ISB=%llu PostedBytes=%llu SRtt=%u",
-        Connection,
-        Connection->Stats.Send.TotalBytes,
-        Connection->CongestionControl.BytesInFlight,
-        Connection->CongestionControl.BytesInFlightMax,
-        Connection->CongestionControl.CongestionWindow,
-        Connection->CongestionControl.SlowStartThreshold,
-        Connection->Send.PeerMaxData - Connection->Send.OrderedStreamBytesSent,
-        Connection->SendBuffer.IdealBytes,
-        Connection->SendBuffer.PostedBytes,
-        Path->GotFirstRttSample ? Path->SmoothedRtt : 0);
+    QuicCongestionControlLogOutFlowStatus(&Connection->CongestionControl);
 
     uint64_t FcAvailable, SendWindow;
     QuicStreamSetGetFlowControlSummary(
@@ -225,6 +225,7 @@ QuicCryptoUninitialize(
     _In_ QUIC_CRYPTO* Crypto
     )
 {
+    QuicHandshakeOffloadCancel(Crypto);
     for (size_t i = 0; i < QUIC_PACKET_KEY_COUNT; ++i) {
         QuicPacketKeyFree(Crypto->TlsState.ReadKeys[i]);
         Crypto->TlsState.ReadKeys[i] = NULL;
@@ -1232,6 +1233,10 @@ QuicCryptoProcessTlsCompletion(
         QUIC_DBG_ASSERT(Crypto->TlsState.WriteKey <= QUIC_PACKET_KEY_1_RTT);
         _Analysis_assume_(Crypto->TlsState.WriteKey >= 0);
         QUIC_TEL_ASSERT(Crypto->TlsState.WriteKeys[Crypto->TlsState.WriteKey] != NULL);
+        //
+        // Whether streams can send depends on the available keys.
+        //
+        QuicSendUnblockAllStreams(&Connection->Send);
         if (Crypto->TlsState.WriteKey == QUIC_PACKET_KEY_HANDSHAKE &&
             !QuicConnIsServer(Connection)) {
             //
@@ -1448,7 +1453,7 @@ QuicCryptoProcessTlsCompletion(
         }
         Connection->Stats.ResumptionSucceeded = Crypto->TlsState.SessionResumed;
 
-        QuicSendSetSendFlag(&Connection->Send, QUIC_CONN_SEND_FLAG_PMTUD);
+        QuicMtuDiscoveryStartSearch(Connection, &Connection->Paths[0]);
 
         if (QuicConnIsServer(Connection) &&
             Crypto->TlsState.BufferOffset1Rtt != 0 &&
@@ -1517,7 +1522,9 @@ QuicCryptoProcessCompleteOperation(
 {
     uint32_t BufferConsumed = 0;
     QUIC_TLS_RESULT_FLAGS ResultFlags =
-        QuicTlsProcessDataComplete(Crypto->TLS, &BufferConsumed);
+        Crypto->OffloadJob != NULL ?
+            QuicHandshakeOffloadComplete(Crypto, &BufferConsumed) :
+            QuicTlsProcessDataComplete(Crypto->TLS, &BufferConsumed);
     QuicCryptoProcessDataComplete(Crypto, ResultFlags, BufferConsumed);
 }
 
@@ -1530,6 +1537,7 @@ QuicCryptoProcessData(
 {
     uint32_t BufferCount = 1;
     QUIC_BUFFER Buffer;
+    QUIC_CONNECTION* Connection = QuicCryptoGetConnection(Crypto);
 
     QUIC_TEL_ASSERT(!Crypto->TlsCallPending);
 
@@ -1550,8 +1558,6 @@ QuicCryptoProcessData(
         QUIC_TEL_ASSERT(DataAvailable);
         QUIC_DBG_ASSERT(BufferCount == 1);
 
-        QUIC_CONNECTION* Connection = QuicCryptoGetConnection(Crypto);
-
         Buffer.Length =
             QuicCrytpoTlsGetCompleteTlsMessagesLength(
                 Buffer.Buffer, Buffer.Length);
@@ -1630,6 +1636,23 @@ QuicCryptoProcessData(
 
     QuicCryptoValidate(Crypto);
 
+    if (Connection->Settings.HandshakeOffloadEnabled &&
+        QuicConnIsServer(Connection) &&
+        !Connection->State.ResumptionEnabled &&
+        !Crypto->TlsState.HandshakeComplete &&
+        QuicHandshakeOffloadQueue(
+            MsQuicLib.HandshakeOffload,
+            Crypto,
+            Buffer.Buffer,
+            Buffer.Length)) {
+        //
+        // The TLS call completes asynchronously, on one of the handshake
+        // offload threads. Connections that may resume stay inline, as
+        // processing the resumption ticket calls into the app.
+        //
+        return;
+    }
+
     QUIC_TLS_RESULT_FLAGS ResultFlags =
         QuicTlsProcessData(
             Crypto->TLS,
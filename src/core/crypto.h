@@ -40,6 +40,12 @@ typedef struct QUIC_CRYPTO {
     //
     QUIC_TLS* TLS;
 
+    //
+    // The outstanding TLS call, if it was queued to the handshake offload
+    // pool.
+    //
+    QUIC_HANDSHAKE_OFFLOAD_JOB* OffloadJob;
+
     //
     // Send State
     //
@@ -0,0 +1,360 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    A single connection is normally limited to the throughput of the one core
+    running its worker, and at high rates most of that core's time is spent on
+    packet encryption and decryption. The crypto offload pool lets connections
+    that opt in (via the CryptoOffloadEnabled setting) spread that work across
+    a small number of helper threads.
+
+    The worker still does all the sequencing (packet number assignment,
+    header protection, loss detection, etc.); only the AEAD operations on the
+    packets of a crypto batch are spread out. The worker keeps the first chunk
+    of the batch for itself, posts the other chunks to any idle helpers and
+    then waits for them to finish, so that the batch completes just as it does
+    today, only sooner. If no helper is idle, the chunk is done inline.
+
+    A key may only be used by one thread at a time, so each chunk after the
+    first uses its own duplicate of the packet key. The duplicates are lazily
+    created by the worker and live as long as the packet key itself.
+
+    Helpers spin for a short while waiting for their next job before going to
+    sleep on their event, so back-to-back batches don't pay for a wake up.
+
+--*/
+
+#include "precomp.h"
+#ifdef QUIC_CLOG
+#include "crypto_offload.c.clog.h"
+#endif
+
+//
+// The number of times a helper polls for a new job before going to sleep.
+//
+#define QUIC_CRYPTO_OFFLOAD_SPIN_COUNT 20000
+
+typedef struct QUIC_CRYPTO_OFFLOAD_JOB {
+
+    QUIC_KEY* Key;
+    QUIC_CRYPT_BATCH_ENTRY* Batch;
+    uint8_t BatchSize;
+    BOOLEAN Encrypt;
+
+    //
+    // Set by the helper once it is completely done with the job.
+    //
+    long volatile Complete;
+
+} QUIC_CRYPTO_OFFLOAD_JOB;
+
+typedef struct QUIC_CACHEALIGN QUIC_CRYPTO_OFFLOAD_HELPER {
+
+    QUIC_CRYPTO_OFFLOAD* Offload;
+
+    //
+    // The job currently posted to the helper. NULL when the helper is idle.
+    //
+    QUIC_CRYPTO_OFFLOAD_JOB* volatile Job;
+
+    //
+    // Set while the helper is (about to be) waiting on Ready.
+    //
+    long volatile Sleeping;
+
+    QUIC_EVENT Ready;
+    QUIC_THREAD Thread;
+
+} QUIC_CRYPTO_OFFLOAD_HELPER;
+
+typedef struct QUIC_CRYPTO_OFFLOAD {
+
+    //
+    // Cleared to stop the helper threads.
+    //
+    BOOLEAN volatile Running;
+
+    uint8_t HelperCount;
+
+    //
+    // Hint for where to start looking for an idle helper.
+    //
+    uint8_t NextHelper;
+
+    QUIC_CRYPTO_OFFLOAD_HELPER Helpers[0];
+
+} QUIC_CRYPTO_OFFLOAD;
+
+QUIC_THREAD_CALLBACK(QuicCryptoOffloadHelperThread, Context);
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicCryptoOffloadInitialize(
+    _Out_ QUIC_CRYPTO_OFFLOAD** NewOffload
+    )
+{
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+
+    //
+    // Leave at least one processor for the worker itself.
+    //
+    uint32_t ProcessorCount = QuicProcActiveCount();
+    uint8_t HelperCount =
+        (uint8_t)min(QUIC_CRYPTO_OFFLOAD_MAX_HELPERS, ProcessorCount - 1);
+    if (HelperCount == 0) {
+        QuicTraceLogWarning(
+            CryptoOffloadNotSupported,
+            "[cofl] Not enough processors for crypto offload");
+        return QUIC_STATUS_NOT_SUPPORTED;
+    }
+
+    const size_t OffloadSize =
+        sizeof(QUIC_CRYPTO_OFFLOAD) +
+        HelperCount * sizeof(QUIC_CRYPTO_OFFLOAD_HELPER);
+    QUIC_CRYPTO_OFFLOAD* Offload =
+        QUIC_ALLOC_NONPAGED(OffloadSize, QUIC_POOL_CRYPTO_OFFLOAD);
+    if (Offload == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "QUIC_CRYPTO_OFFLOAD",
+            OffloadSize);
+        return QUIC_STATUS_OUT_OF_MEMORY;
+    }
+
+    QuicZeroMemory(Offload, OffloadSize);
+    Offload->Running = TRUE;
+
+    for (uint8_t i = 0; i < HelperCount; ++i) {
+        QUIC_CRYPTO_OFFLOAD_HELPER* Helper = &Offload->Helpers[i];
+        Helper->Offload = Offload;
+        QuicEventInitialize(&Helper->Ready, FALSE, FALSE);
+        Offload->HelperCount++;
+
+        QUIC_THREAD_CONFIG ThreadConfig = {
+            QUIC_THREAD_FLAG_NONE,
+            0,
+            "quic_crypto",
+            QuicCryptoOffloadHelperThread,
+            Helper
+        };
+
+        Status = QuicThreadCreate(&ThreadConfig, &Helper->Thread);
+        if (QUIC_FAILED(Status)) {
+            QuicTraceEvent(
+                LibraryErrorStatus,
+                "[ lib] ERROR, %u, %s.",
+                Status,
+                "QuicThreadCreate (crypto offload)");
+            goto Error;
+        }
+    }
+
+    QuicTraceLogInfo(
+        CryptoOffloadInitialized,
+        "[cofl] Initialized with %hhu helper threads",
+        HelperCount);
+
+    *NewOffload = Offload;
+    Offload = NULL;
+
+Error:
+
+    if (Offload != NULL) {
+        QuicCryptoOffloadUninitialize(Offload);
+    }
+
+    return Status;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicCryptoOffloadUninitialize(
+    _In_ QUIC_CRYPTO_OFFLOAD* Offload
+    )
+{
+    Offload->Running = FALSE;
+
+    for (uint8_t i = 0; i < Offload->HelperCount; ++i) {
+        QUIC_CRYPTO_OFFLOAD_HELPER* Helper = &Offload->Helpers[i];
+        QUIC_DBG_ASSERT(Helper->Job == NULL);
+        QuicEventSet(Helper->Ready);
+        if (Helper->Thread) {
+            QuicThreadWait(&Helper->Thread);
+            QuicThreadDelete(&Helper->Thread);
+        }
+        QuicEventUninitialize(Helper->Ready);
+    }
+
+    QUIC_FREE(Offload, QUIC_POOL_CRYPTO_OFFLOAD);
+}
+
+//
+// Waits for the next job to be posted to the helper. Returns NULL when the
+// pool is shutting down.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_CRYPTO_OFFLOAD_JOB*
+QuicCryptoOffloadHelperWaitForJob(
+    _In_ QUIC_CRYPTO_OFFLOAD_HELPER* Helper
+    )
+{
+    while (Helper->Offload->Running) {
+
+        for (uint32_t i = 0; i < QUIC_CRYPTO_OFFLOAD_SPIN_COUNT; ++i) {
+            QUIC_CRYPTO_OFFLOAD_JOB* Job = Helper->Job;
+            if (Job != NULL) {
+                return Job;
+            }
+            YieldProcessor();
+        }
+
+        //
+        // Nothing showed up for a while, so go to sleep. Sleeping must be set
+        // before checking for a job one last time, as the poster checks them
+        // in the opposite order.
+        //
+        InterlockedCompareExchange(&Helper->Sleeping, TRUE, FALSE);
+        while (Helper->Job == NULL && Helper->Offload->Running) {
+            QuicEventWaitForever(Helper->Ready);
+        }
+        InterlockedCompareExchange(&Helper->Sleeping, FALSE, TRUE);
+    }
+
+    return NULL;
+}
+
+QUIC_THREAD_CALLBACK(QuicCryptoOffloadHelperThread, Context)
+{
+    QUIC_CRYPTO_OFFLOAD_HELPER* Helper = (QUIC_CRYPTO_OFFLOAD_HELPER*)Context;
+
+    QUIC_CRYPTO_OFFLOAD_JOB* Job;
+    while ((Job = QuicCryptoOffloadHelperWaitForJob(Helper)) != NULL) {
+
+        if (Job->Encrypt) {
+            (void)QuicEncryptBatch(Job->Key, Job->BatchSize, Job->Batch);
+        } else {
+            (void)QuicDecryptBatch(Job->Key, Job->BatchSize, Job->Batch);
+        }
+
+        //
+        // The job lives on the poster's stack, so it must not be touched after
+        // it is marked complete.
+        //
+        InterlockedExchangePointer((void* volatile*)&Helper->Job, NULL);
+        InterlockedCompareExchange(&Job->Complete, TRUE, FALSE);
+    }
+
+    QUIC_THREAD_RETURN(QUIC_STATUS_SUCCESS);
+}
+
+//
+// Hands the job to an idle helper. Returns FALSE if all of them are busy.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicCryptoOffloadPost(
+    _In_ QUIC_CRYPTO_OFFLOAD* Offload,
+    _In_ QUIC_CRYPTO_OFFLOAD_JOB* Job
+    )
+{
+    uint8_t Index = Offload->NextHelper;
+    for (uint8_t i = 0; i < Offload->HelperCount; ++i) {
+        if (++Index >= Offload->HelperCount) {
+            Index = 0;
+        }
+        QUIC_CRYPTO_OFFLOAD_HELPER* Helper = &Offload->Helpers[Index];
+        if (Helper->Job == NULL &&
+            InterlockedCompareExchangePointer(
+                (void* volatile*)&Helper->Job, Job, NULL) == NULL) {
+            Offload->NextHelper = Index;
+            if (Helper->Sleeping) {
+                QuicEventSet(Helper->Ready);
+            }
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicCryptoOffloadBatch(
+    _In_ QUIC_CRYPTO_OFFLOAD* Offload,
+    _In_ QUIC_PACKET_KEY* Key,
+    _In_ BOOLEAN Encrypt,
+    _In_ uint8_t BatchSize,
+    _Inout_updates_(BatchSize)
+        QUIC_CRYPT_BATCH_ENTRY* Batch
+    )
+{
+    QUIC_CRYPTO_OFFLOAD_JOB Jobs[QUIC_CRYPTO_OFFLOAD_MAX_HELPERS];
+    uint8_t JobCount = 0;
+
+    uint8_t ChunkCount = BatchSize / QUIC_CRYPTO_OFFLOAD_MIN_CHUNK_SIZE;
+    if (ChunkCount > Offload->HelperCount + 1) {
+        ChunkCount = Offload->HelperCount + 1;
+    }
+
+    //
+    // The first chunk is done inline with the original key. Any chunk that
+    // can't be posted is added to the inline work at the end.
+    //
+    uint8_t InlineEnd = ChunkCount > 1 ? BatchSize / ChunkCount : BatchSize;
+    uint8_t Offset = InlineEnd;
+    for (uint8_t i = 1; i < ChunkCount; ++i) {
+        uint8_t ChunkEnd = (uint8_t)(((uint32_t)BatchSize * (i + 1)) / ChunkCount);
+
+        QUIC_KEY** Duplicate = &Key->PacketKeyDuplicates[i - 1];
+        if (*Duplicate == NULL &&
+            QUIC_FAILED(QuicKeyDuplicate(Key->PacketKey, Duplicate))) {
+            break;
+        }
+
+        QUIC_CRYPTO_OFFLOAD_JOB* Job = &Jobs[JobCount];
+        Job->Key = *Duplicate;
+        Job->Batch = Batch + Offset;
+        Job->BatchSize = ChunkEnd - Offset;
+        Job->Encrypt = Encrypt;
+        Job->Complete = FALSE;
+        if (!QuicCryptoOffloadPost(Offload, Job)) {
+            break;
+        }
+
+        JobCount++;
+        Offset = ChunkEnd;
+    }
+
+    if (Encrypt) {
+        (void)QuicEncryptBatch(Key->PacketKey, InlineEnd, Batch);
+        if (Offset < BatchSize) {
+            (void)QuicEncryptBatch(Key->PacketKey, BatchSize - Offset, Batch + Offset);
+        }
+    } else {
+        (void)QuicDecryptBatch(Key->PacketKey, InlineEnd, Batch);
+        if (Offset < BatchSize) {
+            (void)QuicDecryptBatch(Key->PacketKey, BatchSize - Offset, Batch + Offset);
+        }
+    }
+
+    //
+    // The interlocked read orders the reads of the batch after the helper's
+    // writes.
+    //
+    for (uint8_t i = 0; i < JobCount; ++i) {
+        while (!InterlockedCompareExchange(&Jobs[i].Complete, TRUE, TRUE)) {
+            YieldProcessor();
+        }
+    }
+
+    for (uint8_t i = 0; i < BatchSize; ++i) {
+        if (QUIC_FAILED(Batch[i].Status)) {
+            return Batch[i].Status;
+        }
+    }
+
+    return QUIC_STATUS_SUCCESS;
+}
@@ -0,0 +1,57 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+--*/
+
+//
+// The maximum number of helper threads in the crypto offload pool.
+//
+#define QUIC_CRYPTO_OFFLOAD_MAX_HELPERS         QUIC_PACKET_KEY_MAX_DUPLICATES
+
+//
+// The minimum number of packets handed to a single helper thread. Smaller
+// chunks cost more in cross-thread signaling than they save.
+//
+#define QUIC_CRYPTO_OFFLOAD_MIN_CHUNK_SIZE      2
+
+typedef struct QUIC_CRYPTO_OFFLOAD QUIC_CRYPTO_OFFLOAD;
+
+//
+// Creates the pool of helper threads used to spread a single connection's
+// packet encryption and decryption across multiple cores.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicCryptoOffloadInitialize(
+    _Out_ QUIC_CRYPTO_OFFLOAD** NewOffload
+    );
+
+//
+// Stops and cleans up the helper threads.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicCryptoOffloadUninitialize(
+    _In_ QUIC_CRYPTO_OFFLOAD* Offload
+    );
+
+//
+// Encrypts or decrypts a batch of packets, as QuicEncryptBatch and
+// QuicDecryptBatch do, splitting the batch between the calling thread and any
+// idle helper threads. Returns once the whole batch is done.
+//
+// The calling thread must own the packet key, as the key's duplicates are
+// lazily created and then handed out to the helper threads.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicCryptoOffloadBatch(
+    _In_ QUIC_CRYPTO_OFFLOAD* Offload,
+    _In_ QUIC_PACKET_KEY* Key,
+    _In_ BOOLEAN Encrypt,
+    _In_ uint8_t BatchSize,
+    _Inout_updates_(BatchSize)
+        QUIC_CRYPT_BATCH_ENTRY* Batch
+    );
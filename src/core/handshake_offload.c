@@ -0,0 +1,587 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Processing a server's first TLS flight (ECDHE, certificate signature) is
+    by far the most expensive thing a connection does, and it normally runs on
+    the connection's worker. A burst of new connections can then starve the
+    established connections sharing those workers. The handshake offload pool
+    lets server connections that opt in (via the HandshakeOffloadEnabled
+    setting) run their TLS handshake processing on a small, bounded set of
+    dedicated threads instead.
+
+    The TLS call is completed asynchronously, just as a TLS provider returning
+    QUIC_TLS_RESULT_PENDING would: the pool thread queues a TLS complete
+    operation on the connection when it's done, and the worker then picks up
+    the results.
+
+    While the job is outstanding, the worker keeps using the connection's TLS
+    process state (keys and send buffer), so TLS runs against a private copy of
+    it instead. The copy starts with the same keys and offsets but an empty
+    buffer. When the job completes, the worker appends any new TLS data to the
+    real buffer and adopts any new keys and state.
+
+    Admission control: the pool only holds so many jobs, past which handshakes
+    are processed inline again. On top of that, outstanding jobs count towards
+    the library's handshake memory usage, so a backed up pool pushes new
+    connection attempts into stateless retry, just as too many handshake
+    connections do.
+
+--*/
+
+#include "precomp.h"
+#ifdef QUIC_CLOG
+#include "handshake_offload.c.clog.h"
+#endif
+
+QUIC_TLS_PROCESS_COMPLETE_CALLBACK QuicTlsProcessDataCompleteCallback;
+
+typedef enum QUIC_HANDSHAKE_OFFLOAD_JOB_STATE {
+
+    QUIC_HANDSHAKE_OFFLOAD_JOB_QUEUED,
+    QUIC_HANDSHAKE_OFFLOAD_JOB_RUNNING,
+    QUIC_HANDSHAKE_OFFLOAD_JOB_COMPLETE,
+    QUIC_HANDSHAKE_OFFLOAD_JOB_CANCELED // Abandoned while running.
+
+} QUIC_HANDSHAKE_OFFLOAD_JOB_STATE;
+
+typedef struct QUIC_HANDSHAKE_OFFLOAD_JOB {
+
+    QUIC_LIST_ENTRY Link;
+
+    QUIC_HANDSHAKE_OFFLOAD* Offload;
+
+    //
+    // The connection holds a QUIC_CONN_REF_HANDSHAKE_OFFLOAD ref for as long
+    // as the job is queued or running.
+    //
+    QUIC_CONNECTION* Connection;
+
+    //
+    // The connection's TLS context. Owned by the job if it is canceled while
+    // running.
+    //
+    QUIC_TLS* TLS;
+
+    //
+    // Protected by the pool's lock.
+    //
+    QUIC_HANDSHAKE_OFFLOAD_JOB_STATE State;
+
+    QUIC_TLS_RESULT_FLAGS ResultFlags;
+
+    //
+    // The input data length, and then the length consumed by TLS.
+    //
+    uint32_t BufferLength;
+
+    //
+    // The amount charged to the library's handshake memory usage.
+    //
+    uint32_t MemoryUsage;
+
+    //
+    // The private copy of the connection's TLS process state that TLS writes
+    // to.
+    //
+    QUIC_TLS_PROCESS_STATE TlsState;
+
+    //
+    // The connection's keys when the job was queued. Any different key in
+    // TlsState is new.
+    //
+    QUIC_PACKET_KEY* ReadKeys[QUIC_PACKET_KEY_COUNT];
+    QUIC_PACKET_KEY* WriteKeys[QUIC_PACKET_KEY_COUNT];
+
+    //
+    // A copy of the input data, as the crypto receive buffer may be
+    // reallocated while the job is outstanding.
+    //
+    uint8_t Buffer[0];
+
+} QUIC_HANDSHAKE_OFFLOAD_JOB;
+
+typedef struct QUIC_HANDSHAKE_OFFLOAD {
+
+    //
+    // Cleared to stop the pool threads.
+    //
+    BOOLEAN volatile Running;
+
+    uint8_t ThreadCount;
+
+    QUIC_DISPATCH_LOCK Lock;
+
+    //
+    // The queued jobs, oldest first.
+    //
+    QUIC_LIST_ENTRY Jobs;
+
+    //
+    // The number of queued and running jobs, and the maximum allowed.
+    //
+    uint32_t JobCount;
+    uint32_t MaxJobCount;
+
+    //
+    // Signaled when a job is queued. Auto reset, so a thread that takes a job
+    // while more are queued signals it again for the next thread.
+    //
+    QUIC_EVENT Ready;
+
+    QUIC_THREAD Threads[0];
+
+} QUIC_HANDSHAKE_OFFLOAD;
+
+QUIC_THREAD_CALLBACK(QuicHandshakeOffloadThread, Context);
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicHandshakeOffloadInitialize(
+    _Out_ QUIC_HANDSHAKE_OFFLOAD** NewOffload
+    )
+{
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+
+    //
+    // Use up to half the processors, leaving the rest to the workers.
+    //
+    uint32_t ProcessorCount = QuicProcActiveCount();
+    uint8_t ThreadCount =
+        (uint8_t)min(QUIC_HANDSHAKE_OFFLOAD_MAX_THREADS, ProcessorCount / 2);
+    if (ThreadCount == 0) {
+        ThreadCount = 1;
+    }
+
+    const size_t OffloadSize =
+        sizeof(QUIC_HANDSHAKE_OFFLOAD) + ThreadCount * sizeof(QUIC_THREAD);
+    QUIC_HANDSHAKE_OFFLOAD* Offload =
+        QUIC_ALLOC_NONPAGED(OffloadSize, QUIC_POOL_HANDSHAKE_OFFLOAD);
+    if (Offload == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "QUIC_HANDSHAKE_OFFLOAD",
+            OffloadSize);
+        return QUIC_STATUS_OUT_OF_MEMORY;
+    }
+
+    QuicZeroMemory(Offload, OffloadSize);
+    Offload->Running = TRUE;
+    Offload->MaxJobCount = ThreadCount * QUIC_HANDSHAKE_OFFLOAD_MAX_QUEUE_DEPTH;
+    QuicDispatchLockInitialize(&Offload->Lock);
+    QuicListInitializeHead(&Offload->Jobs);
+    QuicEventInitialize(&Offload->Ready, FALSE, FALSE);
+
+    for (uint8_t i = 0; i < ThreadCount; ++i) {
+        QUIC_THREAD_CONFIG ThreadConfig = {
+            QUIC_THREAD_FLAG_NONE,
+            0,
+            "quic_handshake",
+            QuicHandshakeOffloadThread,
+            Offload
+        };
+
+        Status = QuicThreadCreate(&ThreadConfig, &Offload->Threads[i]);
+        if (QUIC_FAILED(Status)) {
+            QuicTraceEvent(
+                LibraryErrorStatus,
+                "[ lib] ERROR, %u, %s.",
+                Status,
+                "QuicThreadCreate (handshake offload)");
+            goto Error;
+        }
+        Offload->ThreadCount++;
+    }
+
+    QuicTraceLogInfo(
+        HandshakeOffloadInitialized,
+        "[hofl] Initialized with %hhu threads",
+        ThreadCount);
+
+    *NewOffload = Offload;
+    Offload = NULL;
+
+Error:
+
+    if (Offload != NULL) {
+        QuicHandshakeOffloadUninitialize(Offload);
+    }
+
+    return Status;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicHandshakeOffloadUninitialize(
+    _In_ QUIC_HANDSHAKE_OFFLOAD* Offload
+    )
+{
+    Offload->Running = FALSE;
+
+    for (uint8_t i = 0; i < Offload->ThreadCount; ++i) {
+        QuicEventSet(Offload->Ready);
+    }
+    for (uint8_t i = 0; i < Offload->ThreadCount; ++i) {
+        QuicThreadWait(&Offload->Threads[i]);
+        QuicThreadDelete(&Offload->Threads[i]);
+    }
+
+    QUIC_DBG_ASSERT(QuicListIsEmpty(&Offload->Jobs));
+    QUIC_DBG_ASSERT(Offload->JobCount == 0);
+
+    QuicEventUninitialize(Offload->Ready);
+    QuicDispatchLockUninitialize(&Offload->Lock);
+    QUIC_FREE(Offload, QUIC_POOL_HANDSHAKE_OFFLOAD);
+}
+
+//
+// Frees the job, along with any keys it created that weren't handed over to
+// the connection.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicHandshakeOffloadJobFree(
+    _In_ QUIC_HANDSHAKE_OFFLOAD_JOB* Job
+    )
+{
+    for (uint32_t i = 0; i < QUIC_PACKET_KEY_COUNT; ++i) {
+        if (Job->TlsState.ReadKeys[i] != Job->ReadKeys[i]) {
+            QuicPacketKeyFree(Job->TlsState.ReadKeys[i]);
+        }
+        if (Job->TlsState.WriteKeys[i] != Job->WriteKeys[i]) {
+            QuicPacketKeyFree(Job->TlsState.WriteKeys[i]);
+        }
+    }
+    if (Job->TlsState.Buffer != NULL) {
+        QUIC_FREE(Job->TlsState.Buffer, QUIC_POOL_TLS_BUFFER);
+    }
+    QuicLibraryOnHandshakeOffloadRemoved(Job->MemoryUsage);
+    QUIC_FREE(Job, QUIC_POOL_HANDSHAKE_OFFLOAD);
+}
+
+//
+// Waits for and dequeues the next job. Returns NULL when the pool is shutting
+// down.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_HANDSHAKE_OFFLOAD_JOB*
+QuicHandshakeOffloadWaitForJob(
+    _In_ QUIC_HANDSHAKE_OFFLOAD* Offload
+    )
+{
+    while (Offload->Running) {
+        QUIC_HANDSHAKE_OFFLOAD_JOB* Job = NULL;
+        BOOLEAN MoreJobs = FALSE;
+
+        QuicDispatchLockAcquire(&Offload->Lock);
+        if (!QuicListIsEmpty(&Offload->Jobs)) {
+            Job =
+                QUIC_CONTAINING_RECORD(
+                    QuicListRemoveHead(&Offload->Jobs),
+                    QUIC_HANDSHAKE_OFFLOAD_JOB,
+                    Link);
+            Job->State = QUIC_HANDSHAKE_OFFLOAD_JOB_RUNNING;
+            MoreJobs = !QuicListIsEmpty(&Offload->Jobs);
+        }
+        QuicDispatchLockRelease(&Offload->Lock);
+
+        if (Job != NULL) {
+            if (MoreJobs) {
+                QuicEventSet(Offload->Ready);
+            }
+            return Job;
+        }
+
+        QuicEventWaitForever(Offload->Ready);
+    }
+
+    return NULL;
+}
+
+QUIC_THREAD_CALLBACK(QuicHandshakeOffloadThread, Context)
+{
+    QUIC_HANDSHAKE_OFFLOAD* Offload = (QUIC_HANDSHAKE_OFFLOAD*)Context;
+
+    QUIC_HANDSHAKE_OFFLOAD_JOB* Job;
+    while ((Job = QuicHandshakeOffloadWaitForJob(Offload)) != NULL) {
+        QUIC_CONNECTION* Connection = Job->Connection;
+
+        Job->ResultFlags =
+            QuicTlsProcessData(
+                Job->TLS,
+                QUIC_TLS_CRYPTO_DATA,
+                Job->Buffer,
+                &Job->BufferLength,
+                &Job->TlsState);
+
+        //
+        // Only synchronous TLS providers are supported here.
+        //
+        QUIC_DBG_ASSERT(!(Job->ResultFlags & QUIC_TLS_RESULT_PENDING));
+
+        BOOLEAN Canceled;
+        QuicDispatchLockAcquire(&Offload->Lock);
+        Offload->JobCount--;
+        Canceled = Job->State == QUIC_HANDSHAKE_OFFLOAD_JOB_CANCELED;
+        if (!Canceled) {
+            //
+            // Queued under the lock so that a cancel, once it sees the job
+            // complete, knows the operation is already on the connection's
+            // queue and is cleared along with it.
+            //
+            Job->State = QUIC_HANDSHAKE_OFFLOAD_JOB_COMPLETE;
+            QuicTlsProcessDataCompleteCallback(Connection);
+        }
+        QuicDispatchLockRelease(&Offload->Lock);
+
+        if (Canceled) {
+            QuicTlsUninitialize(Job->TLS);
+            QuicHandshakeOffloadJobFree(Job);
+        }
+
+        QuicConnRelease(Connection, QUIC_CONN_REF_HANDSHAKE_OFFLOAD);
+    }
+
+    QUIC_THREAD_RETURN(QUIC_STATUS_SUCCESS);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicHandshakeOffloadQueue(
+    _In_ QUIC_HANDSHAKE_OFFLOAD* Offload,
+    _In_ QUIC_CRYPTO* Crypto,
+    _In_reads_bytes_(BufferLength)
+        const uint8_t* Buffer,
+    _In_ uint32_t BufferLength
+    )
+{
+    QUIC_CONNECTION* Connection = QuicCryptoGetConnection(Crypto);
+    QUIC_DBG_ASSERT(Crypto->OffloadJob == NULL);
+
+    if (Offload->JobCount >= Offload->MaxJobCount) {
+        QuicTraceLogConnVerbose(
+            HandshakeOffloadFull,
+            Connection,
+            "Handshake offload pool full, processing inline");
+        return FALSE;
+    }
+
+    QUIC_HANDSHAKE_OFFLOAD_JOB* Job =
+        QUIC_ALLOC_NONPAGED(
+            sizeof(QUIC_HANDSHAKE_OFFLOAD_JOB) + BufferLength,
+            QUIC_POOL_HANDSHAKE_OFFLOAD);
+    if (Job == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "handshake offload job",
+            sizeof(QUIC_HANDSHAKE_OFFLOAD_JOB) + BufferLength);
+        return FALSE;
+    }
+
+    QuicCopyMemory(&Job->TlsState, &Crypto->TlsState, sizeof(Job->TlsState));
+    Job->TlsState.BufferLength = 0;
+    Job->TlsState.Buffer =
+        QUIC_ALLOC_NONPAGED(Job->TlsState.BufferAllocLength, QUIC_POOL_TLS_BUFFER);
+    if (Job->TlsState.Buffer == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "TLS buffer",
+            Job->TlsState.BufferAllocLength);
+        QUIC_FREE(Job, QUIC_POOL_HANDSHAKE_OFFLOAD);
+        return FALSE;
+    }
+
+    QuicCopyMemory(Job->ReadKeys, Crypto->TlsState.ReadKeys, sizeof(Job->ReadKeys));
+    QuicCopyMemory(Job->WriteKeys, Crypto->TlsState.WriteKeys, sizeof(Job->WriteKeys));
+    QuicCopyMemory(Job->Buffer, Buffer, BufferLength);
+    Job->Offload = Offload;
+    Job->Connection = Connection;
+    Job->TLS = Crypto->TLS;
+    Job->State = QUIC_HANDSHAKE_OFFLOAD_JOB_QUEUED;
+    Job->ResultFlags = 0;
+    Job->BufferLength = BufferLength;
+    Job->MemoryUsage =
+        (uint32_t)sizeof(QUIC_HANDSHAKE_OFFLOAD_JOB) + BufferLength +
+        Job->TlsState.BufferAllocLength;
+
+    BOOLEAN Queued = FALSE;
+    QuicDispatchLockAcquire(&Offload->Lock);
+    if (Offload->JobCount < Offload->MaxJobCount) {
+        Offload->JobCount++;
+        QuicListInsertTail(&Offload->Jobs, &Job->Link);
+        QuicConnAddRef(Connection, QUIC_CONN_REF_HANDSHAKE_OFFLOAD);
+        QuicLibraryOnHandshakeOffloadAdded(Job->MemoryUsage);
+        Crypto->OffloadJob = Job;
+        Queued = TRUE;
+    }
+    QuicDispatchLockRelease(&Offload->Lock);
+
+    if (!Queued) {
+        QUIC_FREE(Job->TlsState.Buffer, QUIC_POOL_TLS_BUFFER);
+        QUIC_FREE(Job, QUIC_POOL_HANDSHAKE_OFFLOAD);
+        return FALSE;
+    }
+
+    QuicTraceLogConnVerbose(
+        HandshakeOffloadQueued,
+        Connection,
+        "Queued %u bytes of TLS data to the handshake offload pool",
+        BufferLength);
+
+    QuicEventSet(Offload->Ready);
+    return TRUE;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_TLS_RESULT_FLAGS
+QuicHandshakeOffloadComplete(
+    _In_ QUIC_CRYPTO* Crypto,
+    _Out_ uint32_t* BufferConsumed
+    )
+{
+    QUIC_HANDSHAKE_OFFLOAD_JOB* Job = Crypto->OffloadJob;
+    QUIC_DBG_ASSERT(Job != NULL);
+    QUIC_DBG_ASSERT(Job->State == QUIC_HANDSHAKE_OFFLOAD_JOB_COMPLETE);
+    Crypto->OffloadJob = NULL;
+
+    QUIC_TLS_PROCESS_STATE* State = &Crypto->TlsState;
+    const QUIC_TLS_PROCESS_STATE* NewState = &Job->TlsState;
+    QUIC_TLS_RESULT_FLAGS ResultFlags = Job->ResultFlags;
+    *BufferConsumed = Job->BufferLength;
+
+    //
+    // Append the new TLS data to the connection's send buffer, growing it
+    // if necessary.
+    //
+    if (NewState->BufferLength != 0) {
+        uint32_t Length = State->BufferLength + NewState->BufferLength;
+        if (Length > 0xF000) {
+            QuicTraceEvent(
+                ConnError,
+                "[conn][%p] ERROR, %s.",
+                Job->Connection,
+                "Too much handshake data");
+            ResultFlags = QUIC_TLS_RESULT_ERROR;
+            *BufferConsumed = 0;
+            goto Exit;
+        }
+
+        if (Length > State->BufferAllocLength) {
+            uint32_t NewAllocLength = State->BufferAllocLength;
+            while (Length > NewAllocLength) {
+                NewAllocLength <<= 1;
+            }
+            if (NewAllocLength > 0xF000) {
+                NewAllocLength = 0xF000;
+            }
+            uint8_t* NewBuffer =
+                QUIC_ALLOC_NONPAGED(NewAllocLength, QUIC_POOL_TLS_BUFFER);
+            if (NewBuffer == NULL) {
+                QuicTraceEvent(
+                    AllocFailure,
+                    "Allocation of '%s' failed. (%llu bytes)",
+                    "New crypto buffer",
+                    NewAllocLength);
+                ResultFlags = QUIC_TLS_RESULT_ERROR;
+                *BufferConsumed = 0;
+                goto Exit;
+            }
+            QuicCopyMemory(NewBuffer, State->Buffer, State->BufferLength);
+            QUIC_FREE(State->Buffer, QUIC_POOL_TLS_BUFFER);
+            State->Buffer = NewBuffer;
+            State->BufferAllocLength = (uint16_t)NewAllocLength;
+        }
+        QuicCopyMemory(
+            State->Buffer + State->BufferLength,
+            NewState->Buffer,
+            NewState->BufferLength);
+        State->BufferLength = (uint16_t)Length;
+    }
+    QUIC_DBG_ASSERT(
+        NewState->BufferTotalLength ==
+        State->BufferTotalLength + NewState->BufferLength);
+
+    //
+    // Adopt the new keys. The old ones are still owned by the connection.
+    //
+    for (uint32_t i = 0; i < QUIC_PACKET_KEY_COUNT; ++i) {
+        if (NewState->ReadKeys[i] != Job->ReadKeys[i]) {
+            QUIC_DBG_ASSERT(State->ReadKeys[i] == NULL);
+            State->ReadKeys[i] = NewState->ReadKeys[i];
+            Job->ReadKeys[i] = NewState->ReadKeys[i];
+        }
+        if (NewState->WriteKeys[i] != Job->WriteKeys[i]) {
+            QUIC_DBG_ASSERT(State->WriteKeys[i] == NULL);
+            State->WriteKeys[i] = NewState->WriteKeys[i];
+            Job->WriteKeys[i] = NewState->WriteKeys[i];
+        }
+    }
+
+    State->HandshakeComplete = NewState->HandshakeComplete;
+    State->SessionResumed = NewState->SessionResumed;
+    State->EarlyDataState = NewState->EarlyDataState;
+    State->ReadKey = NewState->ReadKey;
+    State->WriteKey = NewState->WriteKey;
+    State->AlertCode = NewState->AlertCode;
+    State->BufferTotalLength = NewState->BufferTotalLength;
+    State->BufferOffsetHandshake = NewState->BufferOffsetHandshake;
+    State->BufferOffset1Rtt = NewState->BufferOffset1Rtt;
+    State->NegotiatedAlpn = NewState->NegotiatedAlpn;
+
+Exit:
+
+    QuicHandshakeOffloadJobFree(Job);
+
+    return ResultFlags;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicHandshakeOffloadCancel(
+    _In_ QUIC_CRYPTO* Crypto
+    )
+{
+    QUIC_HANDSHAKE_OFFLOAD_JOB* Job = Crypto->OffloadJob;
+    if (Job == NULL) {
+        return;
+    }
+    Crypto->OffloadJob = NULL;
+
+    QUIC_CONNECTION* Connection = Job->Connection;
+    QUIC_HANDSHAKE_OFFLOAD* Offload = Job->Offload;
+    QUIC_HANDSHAKE_OFFLOAD_JOB_STATE State;
+
+    QuicDispatchLockAcquire(&Offload->Lock);
+    State = Job->State;
+    if (State == QUIC_HANDSHAKE_OFFLOAD_JOB_QUEUED) {
+        QuicListEntryRemove(&Job->Link);
+        Offload->JobCount--;
+    } else if (State == QUIC_HANDSHAKE_OFFLOAD_JOB_RUNNING) {
+        //
+        // TLS is still in use by the pool thread, which now owns it and cleans
+        // up the job when it's done.
+        //
+        Job->State = QUIC_HANDSHAKE_OFFLOAD_JOB_CANCELED;
+        Crypto->TLS = NULL;
+    }
+    QuicDispatchLockRelease(&Offload->Lock);
+
+    QuicTraceLogConnVerbose(
+        HandshakeOffloadCanceled,
+        Connection,
+        "Canceled handshake offload job (state %u)",
+        State);
+
+    if (State == QUIC_HANDSHAKE_OFFLOAD_JOB_QUEUED) {
+        QuicHandshakeOffloadJobFree(Job);
+        QuicConnRelease(Connection, QUIC_CONN_REF_HANDSHAKE_OFFLOAD);
+    } else if (State == QUIC_HANDSHAKE_OFFLOAD_JOB_COMPLETE) {
+        QuicHandshakeOffloadJobFree(Job);
+    }
+}
@@ -0,0 +1,80 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+--*/
+
+//
+// The maximum number of threads in the handshake offload pool.
+//
+#define QUIC_HANDSHAKE_OFFLOAD_MAX_THREADS      8
+
+//
+// The maximum number of handshake jobs queued (or running) per pool thread.
+// Past this, new jobs are processed inline on the connection's worker.
+//
+#define QUIC_HANDSHAKE_OFFLOAD_MAX_QUEUE_DEPTH  64
+
+typedef struct QUIC_HANDSHAKE_OFFLOAD QUIC_HANDSHAKE_OFFLOAD;
+typedef struct QUIC_HANDSHAKE_OFFLOAD_JOB QUIC_HANDSHAKE_OFFLOAD_JOB;
+typedef struct QUIC_CRYPTO QUIC_CRYPTO;
+
+//
+// Creates the pool of threads used to run server TLS handshake processing off
+// of the connections' workers.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicHandshakeOffloadInitialize(
+    _Out_ QUIC_HANDSHAKE_OFFLOAD** NewOffload
+    );
+
+//
+// Stops and cleans up the pool threads. All connections must already be
+// cleaned up.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicHandshakeOffloadUninitialize(
+    _In_ QUIC_HANDSHAKE_OFFLOAD* Offload
+    );
+
+//
+// Tries to queue the TLS processing of the given (complete) handshake messages
+// to the pool. On success, the TLS call is pending and the result is picked up
+// on the worker by QuicHandshakeOffloadComplete, after a TLS complete
+// operation is queued on the connection. Returns FALSE if the pool is at
+// capacity, in which case the caller processes the data inline.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicHandshakeOffloadQueue(
+    _In_ QUIC_HANDSHAKE_OFFLOAD* Offload,
+    _In_ QUIC_CRYPTO* Crypto,
+    _In_reads_bytes_(BufferLength)
+        const uint8_t* Buffer,
+    _In_ uint32_t BufferLength
+    );
+
+//
+// Merges the results of the completed job into the connection's TLS state and
+// frees the job. Returns the TLS result flags and consumed buffer length, as
+// QuicTlsProcessDataComplete does.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_TLS_RESULT_FLAGS
+QuicHandshakeOffloadComplete(
+    _In_ QUIC_CRYPTO* Crypto,
+    _Out_ uint32_t* BufferConsumed
+    );
+
+//
+// Abandons the connection's outstanding job, if any. If the job is already
+// running, the TLS context is handed over to the pool thread to clean up.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicHandshakeOffloadCancel(
+    _In_ QUIC_CRYPTO* Crypto
+    );
@@ -39,7 +39,7 @@ MsQuicLibraryLoad(
     )
 {
     QuicLockInitialize(&MsQuicLib.Lock);
-    QuicDispatchLockInitialize(&MsQuicLib.DatapathLock);
+    QuicDispatchRwLockInitialize(&MsQuicLib.DatapathLock);
     QuicListInitializeHead(&MsQuicLib.Registrations);
     QuicListInitializeHead(&MsQuicLib.Bindings);
     MsQuicLib.Loaded = TRUE;
@@ -58,7 +58,7 @@ MsQuicLibraryUnload(
     QUIC_LIB_VERIFY(MsQuicLib.RefCount == 0);
     QUIC_LIB_VERIFY(!MsQuicLib.InUse);
     MsQuicLib.Loaded = FALSE;
-    QuicDispatchLockUninitialize(&MsQuicLib.DatapathLock);
+    QuicDispatchRwLockUninitialize(&MsQuicLib.DatapathLock);
     QuicLockUninitialize(&MsQuicLib.Lock);
 }
 
@@ -100,6 +100,17 @@ QuicLibrarySumPerfCounters(
         }
     }
 
+    //
+    // The datapath tracks its own spin/sleep counts.
+    //
+    if (MsQuicLib.Datapath != NULL &&
+        CountersPerBuffer > QUIC_PERF_COUNTER_UDP_SLEEPS) {
+        uint64_t SpinWakes, Sleeps;
+        QuicDataPathGetPollingStats(MsQuicLib.Datapath, &SpinWakes, &Sleeps);
+        Counters[QUIC_PERF_COUNTER_UDP_SPIN_WAKES] = (int64_t)SpinWakes;
+        Counters[QUIC_PERF_COUNTER_UDP_SLEEPS] = (int64_t)Sleeps;
+    }
+
     //
     // Zero any counters that are still negative after summation.
     //
@@ -128,6 +139,24 @@ QuicLibrarySumPerfCountersExternal(
     QuicLockRelease(&MsQuicLib.Lock);
 }
 
+//
+// Pushes the global settings implemented by the datapath down to it.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicLibApplyDatapathSettings(
+    void
+    )
+{
+    QuicDataPathSetPolling(
+        MsQuicLib.Datapath,
+        MsQuicLib.Settings.SpinTimeUs,
+        MsQuicLib.Settings.BusyPollUs);
+    QuicDataPathSetZeroCopySend(
+        MsQuicLib.Datapath,
+        MsQuicLib.Settings.ZeroCopySendEnabled);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 MsQuicLibraryOnSettingsChanged(
@@ -147,6 +176,10 @@ MsQuicLibraryOnSettingsChanged(
         (MsQuicLib.Settings.RetryMemoryLimit * QuicTotalMemory) / UINT16_MAX;
     QuicLibraryEvaluateSendRetryState();
 
+    if (MsQuicLib.Datapath != NULL) {
+        QuicLibApplyDatapathSettings();
+    }
+
     if (UpdateRegistrations) {
         QuicLockAcquire(&MsQuicLib.Lock);
 
@@ -190,6 +223,7 @@ MsQuicLibraryInitialize(
 {
     QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
     BOOLEAN PlatformInitialized = FALSE;
+    BOOLEAN BindingTableInitialized = FALSE;
     uint32_t DefaultMaxPartitionCount = QUIC_MAX_PARTITION_COUNT;
 
     Status = QuicPlatformInitialize();
@@ -278,7 +312,43 @@ MsQuicLibraryInitialize(
         QuicZeroMemory(
             &MsQuicLib.PerProc[i].PerfCounters,
             sizeof(MsQuicLib.PerProc[i].PerfCounters));
+        MsQuicLib.PerProc[i].ResetTokenHash = NULL;
+        QuicDispatchLockInitialize(&MsQuicLib.PerProc[i].ResetTokenLock);
+    }
+
+    uint8_t ResetHashKey[20];
+    QuicRandom(sizeof(ResetHashKey), ResetHashKey);
+    for (uint16_t i = 0; i < MsQuicLib.ProcessorCount; ++i) {
+        Status =
+            QuicHashCreate(
+                QUIC_HASH_SHA256,
+                ResetHashKey,
+                sizeof(ResetHashKey),
+                &MsQuicLib.PerProc[i].ResetTokenHash);
+        if (QUIC_FAILED(Status)) {
+            QuicTraceEvent(
+                LibraryErrorStatus,
+                "[ lib] ERROR, %u, %s.",
+                Status,
+                "Create reset token hash");
+            break;
+        }
+    }
+    QuicSecureZeroMemory(ResetHashKey, sizeof(ResetHashKey));
+    if (QUIC_FAILED(Status)) {
+        goto Error;
+    }
+
+    if (!QuicHashtableInitializeEx(&MsQuicLib.BindingTable, QUIC_HASH_MIN_SIZE)) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "binding table",
+            0);
+        Status = QUIC_STATUS_OUT_OF_MEMORY;
+        goto Error;
     }
+    BindingTableInitialized = TRUE;
 
     Status =
         QuicDataPathInitialize(
@@ -295,6 +365,8 @@ MsQuicLibraryInitialize(
         goto Error;
     }
 
+    QuicLibApplyDatapathSettings();
+
     QuicTraceEvent(
         LibraryInitialized,
         "[ lib] Initialized, PartitionCount=%u DatapathFeatures=%u",
@@ -320,11 +392,16 @@ MsQuicLibraryInitialize(
 Error:
 
     if (QUIC_FAILED(Status)) {
+        if (BindingTableInitialized) {
+            QuicHashtableUninitialize(&MsQuicLib.BindingTable);
+        }
         if (MsQuicLib.PerProc != NULL) {
             for (uint16_t i = 0; i < MsQuicLib.ProcessorCount; ++i) {
                 QuicPoolUninitialize(&MsQuicLib.PerProc[i].ConnectionPool);
                 QuicPoolUninitialize(&MsQuicLib.PerProc[i].TransportParamPool);
                 QuicPoolUninitialize(&MsQuicLib.PerProc[i].PacketSpacePool);
+                QuicHashFree(MsQuicLib.PerProc[i].ResetTokenHash);
+                QuicDispatchLockUninitialize(&MsQuicLib.PerProc[i].ResetTokenLock);
             }
             QUIC_FREE(MsQuicLib.PerProc, QUIC_POOL_PERPROC);
             MsQuicLib.PerProc = NULL;
@@ -408,11 +485,26 @@ MsQuicLibraryUninitialize(
     // first being cleaned up all listeners and connections.
     //
     QUIC_TEL_ASSERT(QuicListIsEmpty(&MsQuicLib.Bindings));
+    QUIC_DBG_ASSERT(MsQuicLib.BindingTable.NumEntries == 0);
+
+    if (MsQuicLib.CryptoOffload != NULL) {
+        QuicCryptoOffloadUninitialize(MsQuicLib.CryptoOffload);
+        MsQuicLib.CryptoOffload = NULL;
+    }
+
+    if (MsQuicLib.HandshakeOffload != NULL) {
+        QuicHandshakeOffloadUninitialize(MsQuicLib.HandshakeOffload);
+        MsQuicLib.HandshakeOffload = NULL;
+    }
+
+    QuicHashtableUninitialize(&MsQuicLib.BindingTable);
 
     for (uint16_t i = 0; i < MsQuicLib.ProcessorCount; ++i) {
         QuicPoolUninitialize(&MsQuicLib.PerProc[i].ConnectionPool);
         QuicPoolUninitialize(&MsQuicLib.PerProc[i].TransportParamPool);
         QuicPoolUninitialize(&MsQuicLib.PerProc[i].PacketSpacePool);
+        QuicHashFree(MsQuicLib.PerProc[i].ResetTokenHash);
+        QuicDispatchLockUninitialize(&MsQuicLib.PerProc[i].ResetTokenLock);
     }
     QUIC_FREE(MsQuicLib.PerProc, QUIC_POOL_PERPROC);
     MsQuicLib.PerProc = NULL;
@@ -657,7 +749,8 @@ QuicLibrarySetGlobalParam(
 
     case QUIC_PARAM_GLOBAL_SETTINGS:
 
-        if (BufferLength != sizeof(QUIC_SETTINGS)) {
+        if (BufferLength < QUIC_SETTINGS_V1_SIZE ||
+            BufferLength > sizeof(QUIC_SETTINGS)) {
             Status = QUIC_STATUS_INVALID_PARAMETER; // TODO - Support partial
             break;
         }
@@ -808,9 +901,9 @@ QuicLibraryGetGlobalParam(
 
     case QUIC_PARAM_GLOBAL_SETTINGS:
 
-        if (*BufferLength < sizeof(QUIC_SETTINGS)) {
+        if (*BufferLength < QUIC_SETTINGS_V1_SIZE) {
             *BufferLength = sizeof(QUIC_SETTINGS);
-            Status = QUIC_STATUS_BUFFER_TOO_SMALL; // TODO - Support partial
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
             break;
         }
 
@@ -819,8 +912,10 @@ QuicLibraryGetGlobalParam(
             break;
         }
 
-        *BufferLength = sizeof(QUIC_SETTINGS);
-        QuicCopyMemory(Buffer, &MsQuicLib.Settings, sizeof(QUIC_SETTINGS));
+        if (*BufferLength > sizeof(QUIC_SETTINGS)) {
+            *BufferLength = sizeof(QUIC_SETTINGS);
+        }
+        QuicCopyMemory(Buffer, &MsQuicLib.Settings, *BufferLength);
 
         Status = QUIC_STATUS_SUCCESS;
         break;
@@ -1202,6 +1297,10 @@ MsQuicClose(
     }
 }
 
+//
+// Looks up a live (non-zero reference count) binding matching the given
+// addresses. Requires the datapath lock to be held (at least shared).
+//
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_BINDING*
 QuicLibraryLookupBinding(
@@ -1212,12 +1311,22 @@ QuicLibraryLookupBinding(
     _In_opt_ const QUIC_ADDR* RemoteAddress
     )
 {
-    for (QUIC_LIST_ENTRY* Link = MsQuicLib.Bindings.Flink;
-        Link != &MsQuicLib.Bindings;
-        Link = Link->Flink) {
+    QUIC_HASHTABLE_LOOKUP_CONTEXT Context;
+    QUIC_HASHTABLE_ENTRY* TableEntry =
+        QuicHashtableLookup(
+            &MsQuicLib.BindingTable,
+            QuicAddrHash(LocalAddress),
+            &Context);
+
+    while (TableEntry != NULL) {
 
         QUIC_BINDING* Binding =
-            QUIC_CONTAINING_RECORD(Link, QUIC_BINDING, Link);
+            QUIC_CONTAINING_RECORD(TableEntry, QUIC_BINDING, TableEntry);
+        TableEntry = QuicHashtableLookupNext(&MsQuicLib.BindingTable, &Context);
+
+        if (Binding->RefCount == 0) {
+            continue; // Binding is in the process of being cleaned up.
+        }
 
 #ifdef QUIC_COMPARTMENT_ID
         if (CompartmentId != Binding->CompartmentId) {
@@ -1282,7 +1391,7 @@ QuicLibraryGetBinding(
         goto NewBinding;
     }
 
-    QuicDispatchLockAcquire(&MsQuicLib.DatapathLock);
+    QuicDispatchRwLockAcquireShared(&MsQuicLib.DatapathLock);
 
     Binding =
         QuicLibraryLookupBinding(
@@ -1299,18 +1408,20 @@ QuicLibraryGetBinding(
             // requested configuration.
             //
             Status = QUIC_STATUS_INVALID_STATE;
-        } else {
+        } else if (QuicLibraryTryAddRefBinding(Binding)) {
             //
             // Match found and can be shared.
             //
-            QUIC_DBG_ASSERT(Binding->RefCount > 0);
-            Binding->RefCount++;
             *NewBinding = Binding;
             Status = QUIC_STATUS_SUCCESS;
         }
+        //
+        // N.B. If the reference failed, the last reference was released
+        // concurrently and it's treated as if no binding was found.
+        //
     }
 
-    QuicDispatchLockRelease(&MsQuicLib.DatapathLock);
+    QuicDispatchRwLockReleaseShared(&MsQuicLib.DatapathLock);
 
     if (Status != QUIC_STATUS_NOT_FOUND) {
         goto Exit;
@@ -1338,40 +1449,30 @@ NewBinding:
 
     QuicDataPathBindingGetLocalAddress((*NewBinding)->DatapathBinding, &NewLocalAddress);
 
-    QuicDispatchLockAcquire(&MsQuicLib.DatapathLock);
+    QuicDispatchRwLockAcquireExclusive(&MsQuicLib.DatapathLock);
 
     //
-    // Now that we created the binding, we need to insert it into the list of
+    // Now that we created the binding, we need to insert it into the table of
     // all bindings. But we need to make sure another thread didn't race this
     // one and already create the binding.
     //
-
-#if 0
-    Binding = QuicLibraryLookupBinding(&NewLocalAddress, RemoteAddress);
-#else
-    //
-    // Don't allow multiple sockets on the same local tuple currently. So just
-    // do collision detection based on local tuple.
+    // N.B. Don't allow multiple sockets on the same local tuple currently. So
+    // just do collision detection based on local tuple.
     //
-    Binding =
-        QuicLibraryLookupBinding(
+    do {
+        Binding =
+            QuicLibraryLookupBinding(
 #ifdef QUIC_COMPARTMENT_ID
-            CompartmentId,
-#endif
-            &NewLocalAddress,
-            NULL);
+                CompartmentId,
 #endif
-    if (Binding != NULL) {
-        if (!Binding->Exclusive) {
-            //
-            // Another thread got the binding first, but it's not exclusive.
-            //
-            QUIC_DBG_ASSERT(Binding->RefCount > 0);
-            Binding->RefCount++;
-        }
-    } else {
+                &NewLocalAddress,
+                NULL);
+    } while (Binding != NULL && !Binding->Exclusive &&
+             !QuicLibraryTryAddRefBinding(Binding));
+
+    if (Binding == NULL) {
         //
-        // No other thread beat us, insert this binding into the list.
+        // No other thread beat us, insert this binding into the table.
         //
         if (QuicListIsEmpty(&MsQuicLib.Bindings)) {
             QuicTraceLogInfo(
@@ -1380,9 +1481,22 @@ NewBinding:
             MsQuicLib.InUse = TRUE;
         }
         QuicListInsertTail(&MsQuicLib.Bindings, &(*NewBinding)->Link);
+        QuicHashtableInsert(
+            &MsQuicLib.BindingTable,
+            &(*NewBinding)->TableEntry,
+            QuicAddrHash(&NewLocalAddress),
+            NULL);
+
+        //
+        // Keep the average chain at most one binding long. The table grows a
+        // single bucket at a time, so this stays cheap on every insert.
+        //
+        if (MsQuicLib.BindingTable.NumEntries > MsQuicLib.BindingTable.TableSize) {
+            (void)QuicHashTableExpand(&MsQuicLib.BindingTable);
+        }
     }
 
-    QuicDispatchLockRelease(&MsQuicLib.DatapathLock);
+    QuicDispatchRwLockReleaseExclusive(&MsQuicLib.DatapathLock);
 
     if (Binding != NULL) {
         if (Binding->Exclusive) {
@@ -1406,16 +1520,25 @@ QuicLibraryTryAddRefBinding(
     _In_ QUIC_BINDING* Binding
     )
 {
-    BOOLEAN Success = FALSE;
-
-    QuicDispatchLockAcquire(&MsQuicLib.DatapathLock);
-    if (Binding->RefCount > 0) {
-        Binding->RefCount++;
-        Success = TRUE;
+    //
+    // Only take a new reference if the binding hasn't already dropped its
+    // last one. This is done without the datapath lock so that the receive
+    // path doesn't serialize on it.
+    //
+    long RefCount = Binding->RefCount;
+    while (RefCount > 0) {
+        long Prev =
+            InterlockedCompareExchange(
+                &Binding->RefCount,
+                RefCount + 1,
+                RefCount);
+        if (Prev == RefCount) {
+            return TRUE;
+        }
+        RefCount = Prev;
     }
-    QuicDispatchLockRelease(&MsQuicLib.DatapathLock);
 
-    return Success;
+    return FALSE;
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -1424,28 +1547,32 @@ QuicLibraryReleaseBinding(
     _In_ QUIC_BINDING* Binding
     )
 {
-    BOOLEAN Uninitialize = FALSE;
-
     QUIC_PASSIVE_CODE();
 
-    QuicDispatchLockAcquire(&MsQuicLib.DatapathLock);
     QUIC_DBG_ASSERT(Binding->RefCount > 0);
-    if (--Binding->RefCount == 0) {
-        QuicListEntryRemove(&Binding->Link);
-        Uninitialize = TRUE;
-
-        if (QuicListIsEmpty(&MsQuicLib.Bindings)) {
-            QuicTraceLogInfo(
-                LibraryNotInUse,
-                "[ lib] No longer in use.");
-            MsQuicLib.InUse = FALSE;
-        }
+    if (InterlockedDecrement(&Binding->RefCount) != 0) {
+        return;
     }
-    QuicDispatchLockRelease(&MsQuicLib.DatapathLock);
 
-    if (Uninitialize) {
-        QuicBindingUninitialize(Binding);
+    //
+    // The binding can no longer be looked up or referenced, so it is now safe
+    // to remove it from the table and clean it up.
+    //
+    QuicDispatchRwLockAcquireExclusive(&MsQuicLib.DatapathLock);
+    QuicHashtableRemove(&MsQuicLib.BindingTable, &Binding->TableEntry, NULL);
+    if (MsQuicLib.BindingTable.NumEntries < MsQuicLib.BindingTable.TableSize / 4) {
+        (void)QuicHashTableContract(&MsQuicLib.BindingTable);
+    }
+    QuicListEntryRemove(&Binding->Link);
+    if (QuicListIsEmpty(&MsQuicLib.Bindings)) {
+        QuicTraceLogInfo(
+            LibraryNotInUse,
+            "[ lib] No longer in use.");
+        MsQuicLib.InUse = FALSE;
     }
+    QuicDispatchRwLockReleaseExclusive(&MsQuicLib.DatapathLock);
+
+    QuicBindingUninitialize(Binding);
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -1537,14 +1664,14 @@ QuicTraceRundown(
                 QUIC_CONTAINING_RECORD(Link, QUIC_REGISTRATION, Link));
         }
 
-        QuicDispatchLockAcquire(&MsQuicLib.DatapathLock);
+        QuicDispatchRwLockAcquireShared(&MsQuicLib.DatapathLock);
         for (QUIC_LIST_ENTRY* Link = MsQuicLib.Bindings.Flink;
             Link != &MsQuicLib.Bindings;
             Link = Link->Flink) {
             QuicBindingTraceRundown(
                 QUIC_CONTAINING_RECORD(Link, QUIC_BINDING, Link));
         }
-        QuicDispatchLockRelease(&MsQuicLib.DatapathLock);
+        QuicDispatchRwLockReleaseShared(&MsQuicLib.DatapathLock);
 
         int64_t PerfCounters[QUIC_PERF_COUNTER_MAX];
         QuicLibrarySumPerfCounters((uint8_t*)PerfCounters, sizeof(PerfCounters));
@@ -1638,6 +1765,84 @@ QuicLibraryGetCurrentStatelessRetryKey(
     return NewKey;
 }
 
+QUIC_STATIC_ASSERT(
+    QUIC_HASH_SHA256_SIZE >= QUIC_STATELESS_RESET_TOKEN_LENGTH,
+    "Stateless reset token must be shorter than hash size used");
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QuicLibraryGenerateStatelessResetToken(
+    _In_reads_(MsQuicLib.CidTotalLength)
+        const uint8_t* const CID,
+    _Out_writes_all_(QUIC_STATELESS_RESET_TOKEN_LENGTH)
+        uint8_t* ResetToken
+    )
+{
+    uint8_t HashOutput[QUIC_HASH_SHA256_SIZE];
+    QUIC_LIBRARY_PP* PerProc =
+        &MsQuicLib.PerProc[QuicProcCurrentNumber() % MsQuicLib.ProcessorCount];
+    QuicDispatchLockAcquire(&PerProc->ResetTokenLock);
+    QUIC_STATUS Status =
+        QuicHashCompute(
+            PerProc->ResetTokenHash,
+            CID,
+            MsQuicLib.CidTotalLength,
+            sizeof(HashOutput),
+            HashOutput);
+    QuicDispatchLockRelease(&PerProc->ResetTokenLock);
+    if (QUIC_SUCCEEDED(Status)) {
+        QuicCopyMemory(
+            ResetToken,
+            HashOutput,
+            QUIC_STATELESS_RESET_TOKEN_LENGTH);
+    }
+    return Status;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicLibraryEnsureCryptoOffload(
+    void
+    )
+{
+    if (MsQuicLib.CryptoOffload != NULL) {
+        return TRUE;
+    }
+
+    QuicLockAcquire(&MsQuicLib.Lock);
+    if (MsQuicLib.CryptoOffload == NULL) {
+        QUIC_CRYPTO_OFFLOAD* CryptoOffload;
+        if (QUIC_SUCCEEDED(QuicCryptoOffloadInitialize(&CryptoOffload))) {
+            MsQuicLib.CryptoOffload = CryptoOffload;
+        }
+    }
+    QuicLockRelease(&MsQuicLib.Lock);
+
+    return MsQuicLib.CryptoOffload != NULL;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicLibraryEnsureHandshakeOffload(
+    void
+    )
+{
+    if (MsQuicLib.HandshakeOffload != NULL) {
+        return TRUE;
+    }
+
+    QuicLockAcquire(&MsQuicLib.Lock);
+    if (MsQuicLib.HandshakeOffload == NULL) {
+        QUIC_HANDSHAKE_OFFLOAD* HandshakeOffload;
+        if (QUIC_SUCCEEDED(QuicHandshakeOffloadInitialize(&HandshakeOffload))) {
+            MsQuicLib.HandshakeOffload = HandshakeOffload;
+        }
+    }
+    QuicLockRelease(&MsQuicLib.Lock);
+
+    return MsQuicLib.HandshakeOffload != NULL;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 QuicLibraryOnHandshakeConnectionAdded(
@@ -1662,6 +1867,30 @@ QuicLibraryOnHandshakeConnectionRemoved(
     QuicLibraryEvaluateSendRetryState();
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLibraryOnHandshakeOffloadAdded(
+    _In_ uint32_t MemoryUsage
+    )
+{
+    InterlockedExchangeAdd64(
+        (int64_t*)&MsQuicLib.CurrentHandshakeMemoryUsage,
+        (int64_t)MemoryUsage);
+    QuicLibraryEvaluateSendRetryState();
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLibraryOnHandshakeOffloadRemoved(
+    _In_ uint32_t MemoryUsage
+    )
+{
+    InterlockedExchangeAdd64(
+        (int64_t*)&MsQuicLib.CurrentHandshakeMemoryUsage,
+        -1 * (int64_t)MemoryUsage);
+    QuicLibraryEvaluateSendRetryState();
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 QuicLibraryEvaluateSendRetryState(
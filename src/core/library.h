@@ -61,6 +61,15 @@ typedef struct QUIC_CACHEALIGN QUIC_LIBRARY_PP {
     //
     int64_t PerfCounters[QUIC_PERF_COUNTER_MAX];
 
+    //
+    // Hash used for generating stateless reset tokens. Every processor has
+    // its own instance, all using the same key, so tokens can be generated
+    // in parallel. The lock only guards against the rare case of a thread
+    // being moved to another processor while using it.
+    //
+    QUIC_HASH* ResetTokenHash;
+    QUIC_DISPATCH_LOCK ResetTokenLock;
+
 } QUIC_LIBRARY_PP;
 
 //
@@ -108,9 +117,11 @@ typedef struct QUIC_LIBRARY {
     QUIC_LOCK Lock;
 
     //
-    // Controls access to all datapath internal state of the library.
+    // Controls access to all datapath internal state of the library. Binding
+    // lookups only need shared access; insertion and removal of bindings
+    // require exclusive access.
     //
-    QUIC_DISPATCH_LOCK DatapathLock;
+    QUIC_DISPATCH_RW_LOCK DatapathLock;
 
     //
     // Total outstanding references on the library.
@@ -181,6 +192,18 @@ typedef struct QUIC_LIBRARY {
     //
     QUIC_DATAPATH* Datapath;
 
+    //
+    // Helper threads for connections with crypto offload enabled. Created by
+    // the first such connection.
+    //
+    QUIC_CRYPTO_OFFLOAD* CryptoOffload;
+
+    //
+    // Threads for server connections with handshake offload enabled. Created
+    // by the first such connection.
+    //
+    QUIC_HANDSHAKE_OFFLOAD* HandshakeOffload;
+
     //
     // List of all registrations in the current process (or kernel).
     //
@@ -191,6 +214,11 @@ typedef struct QUIC_LIBRARY {
     //
     QUIC_LIST_ENTRY Bindings;
 
+    //
+    // Table of all UDP bindings, indexed by the hash of their local address.
+    //
+    QUIC_HASHTABLE BindingTable;
+
     //
     // Contains all (server) connections currently not in an app's registration.
     //
@@ -499,6 +527,38 @@ QuicLibraryGetStatelessRetryKeyForTimestamp(
     _In_ int64_t Timestamp
     );
 
+//
+// Generates a stateless reset token for the given connection ID.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QuicLibraryGenerateStatelessResetToken(
+    _In_reads_(MsQuicLib.CidTotalLength)
+        const uint8_t* const CID,
+    _Out_writes_all_(QUIC_STATELESS_RESET_TOKEN_LENGTH)
+        uint8_t* ResetToken
+    );
+
+//
+// Makes sure the crypto offload helper threads are running. Returns FALSE if
+// they can't be used.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicLibraryEnsureCryptoOffload(
+    void
+    );
+
+//
+// Makes sure the handshake offload threads are running. Returns FALSE if they
+// can't be used.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicLibraryEnsureHandshakeOffload(
+    void
+    );
+
 //
 // Called when a new (server) connection is added in the handshake state.
 //
@@ -516,3 +576,22 @@ void
 QuicLibraryOnHandshakeConnectionRemoved(
     void
     );
+
+//
+// Called when a TLS call is queued to the handshake offload pool, to charge
+// its memory to the handshake memory usage.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLibraryOnHandshakeOffloadAdded(
+    _In_ uint32_t MemoryUsage
+    );
+
+//
+// Called when a handshake offload pool job is cleaned up.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLibraryOnHandshakeOffloadRemoved(
+    _In_ uint32_t MemoryUsage
+    );
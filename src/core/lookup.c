@@ -14,13 +14,297 @@ Abstract:
 #include "lookup.c.clog.h"
 #endif
 
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#elif defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
 typedef struct QUIC_CACHEALIGN QUIC_PARTITIONED_HASHTABLE {
 
     QUIC_DISPATCH_RW_LOCK RwLock;
-    QUIC_HASHTABLE Table;
+    QUIC_CID_TABLE Table;
 
 } QUIC_PARTITIONED_HASHTABLE;
 
+//
+// Hashes a CID for the local CID tables. This is done for every received short
+// header packet, so the CID is consumed a word at a time (with the CRC32C
+// instruction, if the target has it) instead of byte by byte.
+//
+QUIC_NO_SANITIZE("unsigned-integer-overflow")
+uint32_t
+QuicLookupHashCid(
+    _In_ uint8_t Length,
+    _In_reads_(Length)
+        const uint8_t* Data
+    )
+{
+    uint64_t Hash = Length;
+    uint64_t Word;
+
+#if defined(__SSE4_2__)
+#define QUIC_CID_HASH_WORD(Hash, Word) _mm_crc32_u64(Hash, Word)
+#elif defined(__ARM_FEATURE_CRC32)
+#define QUIC_CID_HASH_WORD(Hash, Word) __crc32cd((uint32_t)(Hash), Word)
+#else
+#define QUIC_CID_HASH_WORD(Hash, Word) \
+    (((Hash) ^ (Word)) * 0x9E3779B97F4A7C15ull)
+#endif
+
+    while (Length >= sizeof(Word)) {
+        QuicCopyMemory(&Word, Data, sizeof(Word));
+        Hash = QUIC_CID_HASH_WORD(Hash, Word);
+        Data += sizeof(Word);
+        Length -= sizeof(Word);
+    }
+    if (Length != 0) {
+        Word = 0;
+        QuicCopyMemory(&Word, Data, Length);
+        Hash = QUIC_CID_HASH_WORD(Hash, Word);
+    }
+
+#undef QUIC_CID_HASH_WORD
+
+    //
+    // Mix all the bits together, since both the low bits (bucket index) and
+    // the high bits (fingerprint) are used.
+    //
+    Hash ^= Hash >> 33;
+    Hash *= 0xFF51AFD7ED558CCDull;
+    Hash ^= Hash >> 33;
+    return (uint32_t)Hash;
+}
+
+//
+// Allocates a zeroed, cache line aligned, bucket array for the table.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicCidTableAllocate(
+    _Inout_ QUIC_CID_TABLE* Table,
+    _In_ uint32_t BucketCount
+    )
+{
+    const size_t AllocSize =
+        (size_t)BucketCount * sizeof(QUIC_CID_TABLE_BUCKET) +
+        QUIC_CID_TABLE_ALIGNMENT - 1;
+    void* Allocation = QUIC_ALLOC_NONPAGED(AllocSize, QUIC_POOL_CID_TABLE);
+    if (Allocation == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "CID table",
+            AllocSize);
+        return FALSE;
+    }
+
+    Table->Allocation = Allocation;
+    Table->Buckets =
+        (QUIC_CID_TABLE_BUCKET*)
+            (((uintptr_t)Allocation + QUIC_CID_TABLE_ALIGNMENT - 1) &
+             ~(uintptr_t)(QUIC_CID_TABLE_ALIGNMENT - 1));
+    Table->BucketCount = BucketCount;
+    Table->EntryCount = 0;
+    QuicZeroMemory(Table->Buckets, (size_t)BucketCount * sizeof(QUIC_CID_TABLE_BUCKET));
+
+    return TRUE;
+}
+
+//
+// Initializes the table with enough buckets for the given number of entries.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicCidTableInitialize(
+    _Out_ QUIC_CID_TABLE* Table,
+    _In_ uint32_t EntryCount
+    )
+{
+    uint32_t BucketCount = QUIC_CID_TABLE_MIN_BUCKETS;
+    while (BucketCount * QUIC_CID_TABLE_SLOTS * 3 / 4 < EntryCount) {
+        BucketCount <<= 1;
+    }
+    return QuicCidTableAllocate(Table, BucketCount);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicCidTableUninitialize(
+    _In_ QUIC_CID_TABLE* Table
+    )
+{
+    QUIC_FREE(Table->Allocation, QUIC_POOL_CID_TABLE);
+}
+
+//
+// Places the entry in the first free slot of its probe sequence. The table
+// must have at least one free slot.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicCidTablePlace(
+    _Inout_ QUIC_CID_TABLE* Table,
+    _In_ uint32_t Hash,
+    _In_ QUIC_CID_HASH_ENTRY* Entry
+    )
+{
+    QUIC_DBG_ASSERT(Table->EntryCount < Table->BucketCount * QUIC_CID_TABLE_SLOTS);
+
+    const uint32_t Mask = Table->BucketCount - 1;
+    uint32_t Index = Hash & Mask;
+    while (TRUE) {
+        QUIC_CID_TABLE_BUCKET* Bucket = &Table->Buckets[Index];
+        for (uint8_t i = 0; i < QUIC_CID_TABLE_SLOTS; ++i) {
+            if (Bucket->Fingerprints[i] == 0) {
+                Bucket->Fingerprints[i] = QUIC_CID_TABLE_FINGERPRINT(Hash);
+                Bucket->Entries[i] = Entry;
+                Table->EntryCount++;
+                return;
+            }
+        }
+        if (Bucket->OverflowCount != UINT8_MAX) {
+            Bucket->OverflowCount++;
+        }
+        Index = (Index + 1) & Mask;
+    }
+}
+
+//
+// Doubles the number of buckets in the table and rehashes all the entries.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicCidTableGrow(
+    _Inout_ QUIC_CID_TABLE* Table
+    )
+{
+    QUIC_CID_TABLE OldTable = *Table;
+    if (!QuicCidTableAllocate(Table, OldTable.BucketCount << 1)) {
+        *Table = OldTable;
+        return FALSE;
+    }
+
+    for (uint32_t i = 0; i < OldTable.BucketCount; ++i) {
+        const QUIC_CID_TABLE_BUCKET* Bucket = &OldTable.Buckets[i];
+        for (uint8_t j = 0; j < QUIC_CID_TABLE_SLOTS; ++j) {
+            if (Bucket->Fingerprints[j] != 0) {
+                QUIC_CID_HASH_ENTRY* Entry = Bucket->Entries[j];
+                QuicCidTablePlace(
+                    Table,
+                    QuicLookupHashCid(Entry->CID.Length, Entry->CID.Data),
+                    Entry);
+            }
+        }
+    }
+
+    QUIC_DBG_ASSERT(Table->EntryCount == OldTable.EntryCount);
+    QuicCidTableUninitialize(&OldTable);
+    return TRUE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicCidTableInsert(
+    _Inout_ QUIC_CID_TABLE* Table,
+    _In_ uint32_t Hash,
+    _In_ QUIC_CID_HASH_ENTRY* Entry
+    )
+{
+    if (Table->EntryCount >= Table->BucketCount * QUIC_CID_TABLE_SLOTS * 3 / 4 &&
+        !QuicCidTableGrow(Table) &&
+        Table->EntryCount == Table->BucketCount * QUIC_CID_TABLE_SLOTS) {
+        return FALSE; // Completely full and couldn't grow.
+    }
+
+    QuicCidTablePlace(Table, Hash, Entry);
+    return TRUE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicCidTableRemove(
+    _Inout_ QUIC_CID_TABLE* Table,
+    _In_ uint32_t Hash,
+    _In_ const QUIC_CID_HASH_ENTRY* Entry
+    )
+{
+    const uint32_t Mask = Table->BucketCount - 1;
+    uint32_t Index = Hash & Mask;
+    for (uint32_t Probes = 0; Probes < Table->BucketCount; ++Probes) {
+        QUIC_CID_TABLE_BUCKET* Bucket = &Table->Buckets[Index];
+        for (uint8_t i = 0; i < QUIC_CID_TABLE_SLOTS; ++i) {
+            if (Bucket->Fingerprints[i] != 0 && Bucket->Entries[i] == Entry) {
+                Bucket->Fingerprints[i] = 0;
+                Bucket->Entries[i] = NULL;
+                Table->EntryCount--;
+                return;
+            }
+        }
+        //
+        // The entry probed past this bucket when it was inserted.
+        //
+        QUIC_DBG_ASSERT(Bucket->OverflowCount != 0);
+        if (Bucket->OverflowCount != UINT8_MAX) {
+            Bucket->OverflowCount--;
+        }
+        Index = (Index + 1) & Mask;
+    }
+    QUIC_DBG_ASSERT(FALSE); // Entry not found!
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_CID_HASH_ENTRY*
+QuicCidTableLookup(
+    _In_ const QUIC_CID_TABLE* Table,
+    _In_ uint32_t Hash,
+    _In_reads_(Length)
+        const uint8_t* const Cid,
+    _In_ uint8_t Length
+    )
+{
+    const uint8_t Fingerprint = QUIC_CID_TABLE_FINGERPRINT(Hash);
+    const uint32_t Mask = Table->BucketCount - 1;
+    uint32_t Index = Hash & Mask;
+    for (uint32_t Probes = 0; Probes < Table->BucketCount; ++Probes) {
+        const QUIC_CID_TABLE_BUCKET* Bucket = &Table->Buckets[Index];
+        for (uint8_t i = 0; i < QUIC_CID_TABLE_SLOTS; ++i) {
+            if (Bucket->Fingerprints[i] == Fingerprint) {
+                QUIC_CID_HASH_ENTRY* Entry = Bucket->Entries[i];
+                if (Entry->CID.Length == Length &&
+                    memcmp(Cid, Entry->CID.Data, Length) == 0) {
+                    return Entry;
+                }
+            }
+        }
+        if (Bucket->OverflowCount == 0) {
+            break;
+        }
+        Index = (Index + 1) & Mask;
+    }
+    return NULL;
+}
+
+//
+// Returns the partitioned table the CID belongs in, based on the partition ID
+// encoded in the CID.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_PARTITIONED_HASHTABLE*
+QuicLookupGetPartitionedTable(
+    _In_ const QUIC_LOOKUP* Lookup,
+    _In_reads_(MsQuicLib.CidServerIdLength + MSQUIC_CID_PID_LENGTH)
+        const uint8_t* const Cid
+    )
+{
+    QUIC_STATIC_ASSERT(MSQUIC_CID_PID_LENGTH == 2, "The code below assumes 2 bytes");
+    uint16_t PartitionIndex;
+    QuicCopyMemory(&PartitionIndex, Cid + MsQuicLib.CidServerIdLength, 2);
+    PartitionIndex &= MsQuicLib.PartitionMask;
+    PartitionIndex %= Lookup->PartitionCount;
+    return &Lookup->HASH.Tables[PartitionIndex];
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 BOOLEAN
 QuicLookupInsertLocalCid(
@@ -54,11 +338,8 @@ QuicLookupUninitialize(
         QUIC_DBG_ASSERT(Lookup->HASH.Tables != NULL);
         for (uint16_t i = 0; i < Lookup->PartitionCount; i++) {
             QUIC_PARTITIONED_HASHTABLE* Table = &Lookup->HASH.Tables[i];
-            QUIC_DBG_ASSERT(Table->Table.NumEntries == 0);
-#pragma warning(push)
-#pragma warning(disable:6001)
-            QuicHashtableUninitialize(&Table->Table);
-#pragma warning(pop)
+            QUIC_DBG_ASSERT(Table->Table.EntryCount == 0);
+            QuicCidTableUninitialize(&Table->Table);
             QuicDispatchRwLockUninitialize(&Table->RwLock);
         }
         QUIC_FREE(Lookup->HASH.Tables, QUIC_POOL_LOOKUP_HASHTABLE);
@@ -73,13 +354,15 @@ QuicLookupUninitialize(
 }
 
 //
-// Allocates and initializes a new partitioned hash table.
+// Allocates and initializes a new partitioned hash table, with each partition
+// sized to hold EntryCount entries without growing.
 //
 _IRQL_requires_max_(DISPATCH_LEVEL)
 BOOLEAN
 QuicLookupCreateHashTable(
     _In_ QUIC_LOOKUP* Lookup,
-    _In_range_(>, 0) uint16_t PartitionCount
+    _In_range_(>, 0) uint16_t PartitionCount,
+    _In_ uint32_t EntryCount
     )
 {
     QUIC_DBG_ASSERT(Lookup->LookupTable == NULL);
@@ -92,17 +375,17 @@ QuicLookupCreateHashTable(
 
     if (Lookup->HASH.Tables != NULL) {
 
-        uint16_t Cleanup = 0;
-        for (uint16_t i = 0; i < PartitionCount; i++) {
-            if (!QuicHashtableInitializeEx(&Lookup->HASH.Tables[i].Table, QUIC_HASH_MIN_SIZE)) {
-                Cleanup = i;
+        uint16_t Initialized = 0;
+        for (; Initialized < PartitionCount; Initialized++) {
+            if (!QuicCidTableInitialize(&Lookup->HASH.Tables[Initialized].Table, EntryCount)) {
                 break;
             }
-            QuicDispatchRwLockInitialize(&Lookup->HASH.Tables[i].RwLock);
+            QuicDispatchRwLockInitialize(&Lookup->HASH.Tables[Initialized].RwLock);
         }
-        if (Cleanup != 0) {
-            for (uint16_t i = 0; i < Cleanup; i++) {
-                QuicHashtableUninitialize(&Lookup->HASH.Tables[i].Table);
+        if (Initialized != PartitionCount) {
+            for (uint16_t i = 0; i < Initialized; i++) {
+                QuicCidTableUninitialize(&Lookup->HASH.Tables[i].Table);
+                QuicDispatchRwLockUninitialize(&Lookup->HASH.Tables[i].RwLock);
             }
             QUIC_FREE(Lookup->HASH.Tables, QUIC_POOL_LOOKUP_HASHTABLE);
             Lookup->HASH.Tables = NULL;
@@ -156,7 +439,7 @@ QuicLookupRebalance(
 
         QUIC_DBG_ASSERT(PartitionCount != 0);
 
-        if (!QuicLookupCreateHashTable(Lookup, PartitionCount)) {
+        if (!QuicLookupCreateHashTable(Lookup, PartitionCount, Lookup->CidCount)) {
             Lookup->LookupTable = PreviousLookup;
             return FALSE;
         }
@@ -184,7 +467,7 @@ QuicLookupRebalance(
                             Link);
                     (void)QuicLookupInsertLocalCid(
                         Lookup,
-                        QuicHashSimple(CID->CID.Length, CID->CID.Data),
+                        QuicLookupHashCid(CID->CID.Length, CID->CID.Data),
                         CID,
                         FALSE);
                     Entry = Entry->Next;
@@ -200,35 +483,23 @@ QuicLookupRebalance(
 
             QUIC_PARTITIONED_HASHTABLE* PreviousTable = PreviousLookup;
             for (uint16_t i = 0; i < PreviousPartitionCount; i++) {
-                QUIC_HASHTABLE_ENUMERATOR Enumerator;
-#pragma warning(push)
-#pragma warning(disable:6001)
-                QuicHashtableEnumerateBegin(&PreviousTable[i].Table, &Enumerator);
-#pragma warning(pop)
-                while (TRUE) {
-                    QUIC_HASHTABLE_ENTRY* Entry =
-                        QuicHashtableEnumerateNext(&PreviousTable[i].Table, &Enumerator);
-                    if (Entry == NULL) {
-                        QuicHashtableEnumerateEnd(&PreviousTable[i].Table, &Enumerator);
-                        break;
+                QUIC_CID_TABLE* Table = &PreviousTable[i].Table;
+                for (uint32_t j = 0; j < Table->BucketCount; j++) {
+                    QUIC_CID_TABLE_BUCKET* Bucket = &Table->Buckets[j];
+                    for (uint8_t k = 0; k < QUIC_CID_TABLE_SLOTS; k++) {
+                        if (Bucket->Fingerprints[k] == 0) {
+                            continue;
+                        }
+                        QUIC_CID_HASH_ENTRY *CID = Bucket->Entries[k];
+                        (void)QuicLookupInsertLocalCid(
+                            Lookup,
+                            QuicLookupHashCid(CID->CID.Length, CID->CID.Data),
+                            CID,
+                            FALSE);
                     }
-                    QuicHashtableRemove(&PreviousTable[i].Table, Entry, NULL);
-
-                    QUIC_CID_HASH_ENTRY *CID =
-                        QUIC_CONTAINING_RECORD(
-                            Entry,
-                            QUIC_CID_HASH_ENTRY,
-                            Entry);
-                    (void)QuicLookupInsertLocalCid(
-                        Lookup,
-                        QuicHashSimple(CID->CID.Length, CID->CID.Data),
-                        CID,
-                        FALSE);
                 }
-#pragma warning(push)
-#pragma warning(disable:6001)
-                QuicHashtableUninitialize(&PreviousTable[i].Table);
-#pragma warning(pop)
+                QuicCidTableUninitialize(Table);
+                QuicDispatchRwLockUninitialize(&PreviousTable[i].RwLock);
             }
             QUIC_FREE(PreviousTable, QUIC_POOL_LOOKUP_HASHTABLE);
         }
@@ -296,39 +567,6 @@ QuicCidMatchConnection(
     return FALSE;
 }
 
-//
-// Uses the hash and destination connection ID to look up the connection in the
-// hash table. Returns the pointer to the connection if found; NULL otherwise.
-//
-_IRQL_requires_max_(DISPATCH_LEVEL)
-QUIC_CONNECTION*
-QuicHashLookupConnection(
-    _In_ QUIC_HASHTABLE* Table,
-    _In_reads_(Length)
-        const uint8_t* const DestCid,
-    _In_ uint8_t Length,
-    _In_ uint32_t Hash
-    )
-{
-    QUIC_HASHTABLE_LOOKUP_CONTEXT Context;
-    QUIC_HASHTABLE_ENTRY* TableEntry =
-        QuicHashtableLookup(Table, Hash, &Context);
-
-    while (TableEntry != NULL) {
-        QUIC_CID_HASH_ENTRY* CIDEntry =
-            QUIC_CONTAINING_RECORD(TableEntry, QUIC_CID_HASH_ENTRY, Entry);
-
-        if (CIDEntry->CID.Length == Length &&
-            memcmp(DestCid, CIDEntry->CID.Data, Length) == 0) {
-            return CIDEntry->Connection;
-        }
-
-        TableEntry = QuicHashtableLookupNext(Table, &Context);
-    }
-
-    return NULL;
-}
-
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_CONNECTION*
 QuicLookupFindConnectionByLocalCidInternal(
@@ -356,24 +594,18 @@ QuicLookupFindConnectionByLocalCidInternal(
         QUIC_DBG_ASSERT(CID != NULL);
 
         //
-        // Use the destination connection ID to get the index into the
-        // partitioned hash table array, and look up the connection in that
-        // hash table.
+        // Use the destination connection ID to get the partitioned hash table,
+        // and look up the connection in that hash table.
         //
-        QUIC_STATIC_ASSERT(MSQUIC_CID_PID_LENGTH == 2, "The code below assumes 2 bytes");
-        uint16_t PartitionIndex;
-        QuicCopyMemory(&PartitionIndex, CID + MsQuicLib.CidServerIdLength, 2);
-        PartitionIndex &= MsQuicLib.PartitionMask;
-        PartitionIndex %= Lookup->PartitionCount;
-        QUIC_PARTITIONED_HASHTABLE* Table = &Lookup->HASH.Tables[PartitionIndex];
+        QUIC_PARTITIONED_HASHTABLE* Table =
+            QuicLookupGetPartitionedTable(Lookup, CID);
 
         QuicDispatchRwLockAcquireShared(&Table->RwLock);
-        Connection =
-            QuicHashLookupConnection(
-                &Table->Table,
-                CID,
-                CIDLen,
-                Hash);
+        QUIC_CID_HASH_ENTRY* Entry =
+            QuicCidTableLookup(&Table->Table, Hash, CID, CIDLen);
+        if (Entry != NULL) {
+            Connection = Entry->Connection;
+        }
         QuicDispatchRwLockReleaseShared(&Table->RwLock);
     }
 
@@ -479,20 +711,15 @@ QuicLookupInsertLocalCid(
         //
         // Insert the source connection ID into the hash table.
         //
-        QUIC_STATIC_ASSERT(MSQUIC_CID_PID_LENGTH == 2, "The code below assumes 2 bytes");
-        uint16_t PartitionIndex;
-        QuicCopyMemory(&PartitionIndex, SourceCid->CID.Data + MsQuicLib.CidServerIdLength, 2);
-        PartitionIndex &= MsQuicLib.PartitionMask;
-        PartitionIndex %= Lookup->PartitionCount;
-        QUIC_PARTITIONED_HASHTABLE* Table = &Lookup->HASH.Tables[PartitionIndex];
+        QUIC_PARTITIONED_HASHTABLE* Table =
+            QuicLookupGetPartitionedTable(Lookup, SourceCid->CID.Data);
 
         QuicDispatchRwLockAcquireExclusive(&Table->RwLock);
-        QuicHashtableInsert(
-            &Table->Table,
-            &SourceCid->Entry,
-            Hash,
-            NULL);
+        BOOLEAN Inserted = QuicCidTableInsert(&Table->Table, Hash, SourceCid);
         QuicDispatchRwLockReleaseExclusive(&Table->RwLock);
+        if (!Inserted) {
+            return FALSE;
+        }
     }
 
     if (UpdateRefCount) {
@@ -610,14 +837,13 @@ QuicLookupRemoveLocalCidInt(
         //
         // Remove the source connection ID from the multi-hash table.
         //
-        QUIC_STATIC_ASSERT(MSQUIC_CID_PID_LENGTH == 2, "The code below assumes 2 bytes");
-        uint16_t PartitionIndex;
-        QuicCopyMemory(&PartitionIndex, SourceCid->CID.Data + MsQuicLib.CidServerIdLength, 2);
-        PartitionIndex &= MsQuicLib.PartitionMask;
-        PartitionIndex %= Lookup->PartitionCount;
-        QUIC_PARTITIONED_HASHTABLE* Table = &Lookup->HASH.Tables[PartitionIndex];
+        QUIC_PARTITIONED_HASHTABLE* Table =
+            QuicLookupGetPartitionedTable(Lookup, SourceCid->CID.Data);
         QuicDispatchRwLockAcquireExclusive(&Table->RwLock);
-        QuicHashtableRemove(&Table->Table, &SourceCid->Entry, NULL);
+        QuicCidTableRemove(
+            &Table->Table,
+            QuicLookupHashCid(SourceCid->CID.Length, SourceCid->CID.Data),
+            SourceCid);
         QuicDispatchRwLockReleaseExclusive(&Table->RwLock);
     }
 }
@@ -631,7 +857,7 @@ QuicLookupFindConnectionByLocalCid(
     _In_ uint8_t CIDLen
     )
 {
-    uint32_t Hash = QuicHashSimple(CIDLen, CID);
+    uint32_t Hash = QuicLookupHashCid(CIDLen, CID);
 
     QuicDispatchRwLockAcquireShared(&Lookup->RwLock);
 
@@ -651,6 +877,57 @@ QuicLookupFindConnectionByLocalCid(
     return ExistingConnection;
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLookupFindConnectionsByLocalCid(
+    _In_ QUIC_LOOKUP* Lookup,
+    _In_range_(1, QUIC_LOOKUP_MAX_BATCH) uint32_t Count,
+    _In_reads_(Count) const uint8_t* const* CIDs,
+    _In_reads_(Count) const uint8_t* CIDLens,
+    _Out_writes_(Count) QUIC_CONNECTION** Connections
+    )
+{
+    QUIC_DBG_ASSERT(Count != 0 && Count <= QUIC_LOOKUP_MAX_BATCH);
+
+    uint32_t Hashes[QUIC_LOOKUP_MAX_BATCH];
+    for (uint32_t i = 0; i < Count; ++i) {
+        Hashes[i] = QuicLookupHashCid(CIDLens[i], CIDs[i]);
+    }
+
+    QuicDispatchRwLockAcquireShared(&Lookup->RwLock);
+
+    if (Lookup->PartitionCount != 0) {
+        //
+        // Start loading all the buckets up front so that the cache misses
+        // overlap instead of being taken one at a time. The partition lock is
+        // held while reading the bucket array, since an insert can grow (and
+        // free) it.
+        //
+        for (uint32_t i = 0; i < Count; ++i) {
+            QUIC_PARTITIONED_HASHTABLE* Table =
+                QuicLookupGetPartitionedTable(Lookup, CIDs[i]);
+            QuicDispatchRwLockAcquireShared(&Table->RwLock);
+            QuicPrefetch(
+                &Table->Table.Buckets[Hashes[i] & (Table->Table.BucketCount - 1)]);
+            QuicDispatchRwLockReleaseShared(&Table->RwLock);
+        }
+    }
+
+    for (uint32_t i = 0; i < Count; ++i) {
+        Connections[i] =
+            QuicLookupFindConnectionByLocalCidInternal(
+                Lookup,
+                CIDs[i],
+                CIDLens[i],
+                Hashes[i]);
+        if (Connections[i] != NULL) {
+            QuicConnAddRef(Connections[i], QUIC_CONN_REF_LOOKUP_RESULT);
+        }
+    }
+
+    QuicDispatchRwLockReleaseShared(&Lookup->RwLock);
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_CONNECTION*
 QuicLookupFindConnectionByRemoteHash(
@@ -731,7 +1008,7 @@ QuicLookupAddLocalCid(
 {
     BOOLEAN Result;
     QUIC_CONNECTION* ExistingConnection;
-    uint32_t Hash = QuicHashSimple(SourceCid->CID.Length, SourceCid->CID.Data);
+    uint32_t Hash = QuicLookupHashCid(SourceCid->CID.Length, SourceCid->CID.Data);
 
     QuicDispatchRwLockAcquireExclusive(&Lookup->RwLock);
 
@@ -927,7 +1204,7 @@ QuicLookupMoveLocalConnectionIDs(
             BOOLEAN Result =
                 QuicLookupInsertLocalCid(
                     LookupDest,
-                    QuicHashSimple(CID->CID.Length, CID->CID.Data),
+                    QuicLookupHashCid(CID->CID.Length, CID->CID.Data),
                     CID,
                     TRUE);
             QUIC_DBG_ASSERT(Result);
@@ -5,6 +5,132 @@
 
 --*/
 
+//
+// The local CIDs are stored in open-addressed hash tables made up of cache
+// line sized buckets. Each bucket keeps a one byte fingerprint of the hash of
+// the CID in each of its slots, inline with the entry pointers. So a lookup
+// generally only touches a single bucket (and the matching entry), whether or
+// not the CID is found.
+//
+#define QUIC_CID_TABLE_SLOTS                7
+#define QUIC_CID_TABLE_MIN_BUCKETS          16
+#define QUIC_CID_TABLE_ALIGNMENT            64
+
+//
+// The (non-zero) fingerprint of a hash. The low bits of the hash pick the
+// bucket, so the fingerprint comes from the high bits.
+//
+#define QUIC_CID_TABLE_FINGERPRINT(Hash) ((uint8_t)(((Hash) >> 24) | 0x80))
+
+typedef struct QUIC_CID_TABLE_BUCKET {
+
+    //
+    // Fingerprint of the CID in each slot, or zero if the slot is empty.
+    //
+    uint8_t Fingerprints[QUIC_CID_TABLE_SLOTS];
+
+    //
+    // Number of entries that probed past this bucket because it (or an
+    // earlier bucket) was full. Lookups stop at the first bucket with no
+    // overflow. Saturates at UINT8_MAX.
+    //
+    uint8_t OverflowCount;
+
+    QUIC_CID_HASH_ENTRY* Entries[QUIC_CID_TABLE_SLOTS];
+
+} QUIC_CID_TABLE_BUCKET;
+
+typedef struct QUIC_CID_TABLE {
+
+    //
+    // Number of buckets in the table. Always a power of 2.
+    //
+    uint32_t BucketCount;
+    uint32_t EntryCount;
+    QUIC_CID_TABLE_BUCKET* Buckets;
+    void* Allocation;
+
+} QUIC_CID_TABLE;
+
+//
+// Hashes a CID for the local CID tables.
+//
+uint32_t
+QuicLookupHashCid(
+    _In_ uint8_t Length,
+    _In_reads_(Length)
+        const uint8_t* Data
+    );
+
+//
+// Initializes the table with enough buckets for the given number of entries.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicCidTableInitialize(
+    _Out_ QUIC_CID_TABLE* Table,
+    _In_ uint32_t EntryCount
+    );
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicCidTableUninitialize(
+    _In_ QUIC_CID_TABLE* Table
+    );
+
+//
+// Places the entry in the first free slot of its probe sequence, without
+// growing the table. The table must have at least one free slot.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicCidTablePlace(
+    _Inout_ QUIC_CID_TABLE* Table,
+    _In_ uint32_t Hash,
+    _In_ QUIC_CID_HASH_ENTRY* Entry
+    );
+
+//
+// Doubles the number of buckets in the table and rehashes all the entries.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicCidTableGrow(
+    _Inout_ QUIC_CID_TABLE* Table
+    );
+
+//
+// Inserts the entry, growing the table first if it is three quarters full.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicCidTableInsert(
+    _Inout_ QUIC_CID_TABLE* Table,
+    _In_ uint32_t Hash,
+    _In_ QUIC_CID_HASH_ENTRY* Entry
+    );
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicCidTableRemove(
+    _Inout_ QUIC_CID_TABLE* Table,
+    _In_ uint32_t Hash,
+    _In_ const QUIC_CID_HASH_ENTRY* Entry
+    );
+
+//
+// Returns the entry with the given CID, or NULL.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_CID_HASH_ENTRY*
+QuicCidTableLookup(
+    _In_ const QUIC_CID_TABLE* Table,
+    _In_ uint32_t Hash,
+    _In_reads_(Length)
+        const uint8_t* const Cid,
+    _In_ uint8_t Length
+    );
+
 typedef struct QUIC_PARTITIONED_HASHTABLE QUIC_PARTITIONED_HASHTABLE;
 
 typedef struct QUIC_REMOTE_HASH_ENTRY {
@@ -110,6 +236,25 @@ QuicLookupFindConnectionByLocalCid(
     _In_ uint8_t CIDLen
     );
 
+//
+// The maximum number of CIDs that can be looked up in a single batch.
+//
+#define QUIC_LOOKUP_MAX_BATCH 16
+
+//
+// Looks up a batch of local CIDs at once, returning the connection (or NULL)
+// for each.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLookupFindConnectionsByLocalCid(
+    _In_ QUIC_LOOKUP* Lookup,
+    _In_range_(1, QUIC_LOOKUP_MAX_BATCH) uint32_t Count,
+    _In_reads_(Count) const uint8_t* const* CIDs,
+    _In_reads_(Count) const uint8_t* CIDLens,
+    _Out_writes_(Count) QUIC_CONNECTION** Connections
+    );
+
 //
 // Returns the connection with the given remote hash, or NULL.
 //
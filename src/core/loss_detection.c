@@ -71,6 +71,13 @@ QuicLossDetectionInitializeInternalState(
 {
     LossDetection->PacketsInFlight = 0;
     LossDetection->ProbeCount = 0;
+    LossDetection->AppLimited = FALSE;
+    LossDetection->AppLimitedPacketNumber = 0;
+    LossDetection->TotalBytesDelivered = 0;
+    LossDetection->DeliveredTime = 0;
+    LossDetection->FirstSentTime = 0;
+    LossDetection->EstimatedBandwidth = 0;
+    LossDetection->EstimatedBandwidthTime = 0;
 }
 
 #if DEBUG
@@ -431,6 +438,8 @@ QuicLossDetectionOnPacketSent(
             QuicConnResetIdleTimeout(Connection);
         }
 
+        QuicLossDetectionSaveRateSampleState(LossDetection, SentPacket);
+
         Connection->Stats.Send.RetransmittablePackets++;
         LossDetection->PacketsInFlight++;
         LossDetection->TimeOfLastPacketSent = SentPacket->SentTime;
@@ -449,12 +458,146 @@ QuicLossDetectionOnPacketSent(
     return QUIC_STATUS_SUCCESS;
 }
 
+//
+// The number of streams whose acknowledged data can be coalesced at once while
+// processing an ACK frame.
+//
+#define QUIC_STREAM_ACK_BATCH_SIZE 4
+
+//
+// A contiguous range of acknowledged stream data, coalesced from one or more
+// STREAM frames.
+//
+typedef struct QUIC_STREAM_ACK_RANGE {
+
+    QUIC_STREAM* Stream;
+    uint64_t Offset;
+    uint32_t Length;
+    uint8_t Flags; // QUIC_SENT_FRAME_FLAG_*
+    QUIC_SEND_PACKET_FLAGS PacketFlags;
+
+} QUIC_STREAM_ACK_RANGE;
+
+//
+// Collects the STREAM frames acknowledged by a single ACK frame so that each
+// stream gets one QuicStreamOnAck call per contiguous range, instead of one
+// call per frame. For bulk transfers, that is typically one call per stream
+// per ACK frame.
+//
+typedef struct QUIC_STREAM_ACK_BATCH {
+
+    uint32_t Count;
+    QUIC_STREAM_ACK_RANGE Ranges[QUIC_STREAM_ACK_BATCH_SIZE];
+
+} QUIC_STREAM_ACK_BATCH;
+
+//
+// Indicates the range to the stream and releases the batch's reference on it.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamAckRangeFlush(
+    _In_ QUIC_STREAM_ACK_RANGE* Range
+    )
+{
+    QuicStreamOnAck(
+        Range->Stream,
+        Range->PacketFlags,
+        Range->Offset,
+        Range->Length,
+        Range->Flags);
+    QuicStreamRelease(Range->Stream, QUIC_STREAM_REF_SEND_PACKET);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamAckBatchFlush(
+    _Inout_ QUIC_STREAM_ACK_BATCH* Batch
+    )
+{
+    for (uint32_t i = 0; i < Batch->Count; ++i) {
+        QuicStreamAckRangeFlush(&Batch->Ranges[i]);
+    }
+    Batch->Count = 0;
+}
+
+//
+// Adds an acknowledged STREAM frame to the batch, extending the stream's
+// pending range if the frame directly follows it.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamAckBatchAdd(
+    _Inout_ QUIC_STREAM_ACK_BATCH* Batch,
+    _In_ QUIC_SEND_PACKET_FLAGS PacketFlags,
+    _In_ const QUIC_SENT_FRAME_METADATA* Frame
+    )
+{
+    QUIC_STREAM* Stream = Frame->STREAM.Stream;
+    QUIC_STREAM_ACK_RANGE* Range = NULL;
+
+    for (uint32_t i = 0; i < Batch->Count; ++i) {
+        if (Batch->Ranges[i].Stream == Stream) {
+            Range = &Batch->Ranges[i];
+            break;
+        }
+    }
+
+    if (Range != NULL) {
+        if (Range->Offset + Range->Length == Frame->StreamOffset &&
+            Range->PacketFlags.KeyType == PacketFlags.KeyType &&
+            (uint64_t)Range->Length + Frame->StreamLength <= UINT32_MAX) {
+            Range->Length += Frame->StreamLength;
+            Range->Flags |= Frame->Flags;
+            return;
+        }
+
+        //
+        // Not contiguous, so indicate what has been collected so far and
+        // start a new range. The batch's reference is reused.
+        //
+        QuicStreamOnAck(
+            Range->Stream,
+            Range->PacketFlags,
+            Range->Offset,
+            Range->Length,
+            Range->Flags);
+
+    } else {
+        if (Batch->Count == QUIC_STREAM_ACK_BATCH_SIZE) {
+            //
+            // No more room. Indicate the oldest range to make space.
+            //
+            QuicStreamAckRangeFlush(&Batch->Ranges[0]);
+            QuicMoveMemory(
+                &Batch->Ranges[0],
+                &Batch->Ranges[1],
+                (QUIC_STREAM_ACK_BATCH_SIZE - 1) * sizeof(QUIC_STREAM_ACK_RANGE));
+            Batch->Count--;
+        }
+        Range = &Batch->Ranges[Batch->Count++];
+        Range->Stream = Stream;
+
+        //
+        // Keep the stream alive until the range is indicated, since the
+        // packet's reference is released as soon as the packet is processed.
+        //
+        QuicStreamAddRef(Stream, QUIC_STREAM_REF_SEND_PACKET);
+    }
+
+    Range->Offset = Frame->StreamOffset;
+    Range->Length = Frame->StreamLength;
+    Range->Flags = Frame->Flags;
+    Range->PacketFlags = PacketFlags;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicLossDetectionOnPacketAcknowledged(
     _In_ QUIC_LOSS_DETECTION* LossDetection,
     _In_ QUIC_ENCRYPT_LEVEL EncryptLevel,
-    _In_ QUIC_SENT_PACKET_METADATA* Packet
+    _In_ QUIC_SENT_PACKET_METADATA* Packet,
+    _Inout_opt_ QUIC_STREAM_ACK_BATCH* StreamAcks
     )
 {
     QUIC_CONNECTION* Connection = QuicLossDetectionGetConnection(LossDetection);
@@ -514,10 +657,16 @@ QuicLossDetectionOnPacketAcknowledged(
         case QUIC_FRAME_STREAM_5:
         case QUIC_FRAME_STREAM_6:
         case QUIC_FRAME_STREAM_7:
-            QuicStreamOnAck(
-                Packet->Frames[i].STREAM.Stream,
-                Packet->Flags,
-                &Packet->Frames[i]);
+            if (StreamAcks != NULL) {
+                QuicStreamAckBatchAdd(StreamAcks, Packet->Flags, &Packet->Frames[i]);
+            } else {
+                QuicStreamOnAck(
+                    Packet->Frames[i].STREAM.Stream,
+                    Packet->Flags,
+                    Packet->Frames[i].StreamOffset,
+                    Packet->Frames[i].StreamLength,
+                    Packet->Frames[i].Flags);
+            }
             break;
 
         case QUIC_FRAME_STREAM_DATA_BLOCKED:
@@ -591,21 +740,44 @@ QuicLossDetectionOnPacketAcknowledged(
                 Path->ID);
         }
 
-        if (PacketMtu > Path->Mtu) {
-            Path->Mtu = PacketMtu;
-            QuicTraceLogConnInfo(
-                PathMtuUpdated,
-                Connection,
-                "Path[%hhu] MTU updated to %hu bytes",
-                Path->ID,
-                Path->Mtu);
-            QuicDatagramOnSendStateChanged(&Connection->Datagram);
+        if (Packet->Flags.IsPMTUD) {
+            QuicMtuDiscoveryOnProbeAcknowledged(Connection, Path, PacketMtu);
+        } else {
+            QuicMtuDiscoveryOnPacketAcknowledged(Path, PacketMtu);
         }
     }
 
     QuicSentPacketPoolReturnPacketMetadata(&Connection->Worker->SentPacketPool, Packet);
 }
 
+//
+// Updates the path MTU discovery state of the path the lost packet was sent on.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicLossDetectionOnPacketLost(
+    _In_ QUIC_LOSS_DETECTION* LossDetection,
+    _In_ const QUIC_SENT_PACKET_METADATA* Packet
+    )
+{
+    QUIC_CONNECTION* Connection = QuicLossDetectionGetConnection(LossDetection);
+    uint8_t PathIndex;
+    QUIC_PATH* Path = QuicConnGetPathByID(Connection, Packet->PathId, &PathIndex);
+    UNREFERENCED_PARAMETER(PathIndex);
+
+    if (Path != NULL) {
+        uint16_t PacketMtu =
+            PacketSizeFromUdpPayloadSize(
+                QuicAddrGetFamily(&Path->RemoteAddress),
+                Packet->PacketLength);
+        if (Packet->Flags.IsPMTUD) {
+            QuicMtuDiscoveryOnProbeLost(Connection, Path, PacketMtu);
+        } else {
+            QuicMtuDiscoveryOnPacketLost(Connection, Path, PacketMtu);
+        }
+    }
+}
+
 //
 // Marks all the frames in the packet that can be retransmitted as needing to be
 // retransmitted. Returns TRUE if some new data was queued up to be sent.
@@ -933,7 +1105,17 @@ QuicLossDetectionDetectAndHandleLostPackets(
             QuicPerfCounterIncrement(QUIC_PERF_COUNTER_PKTS_SUSPECTED_LOST);
             if (Packet->Flags.IsAckEliciting) {
                 LossDetection->PacketsInFlight--;
-                LostRetransmittableBytes += Packet->PacketLength;
+                QuicLossDetectionOnPacketLost(LossDetection, Packet);
+                if (Packet->Flags.IsPMTUD) {
+                    //
+                    // Lost path MTU probes aren't a sign of congestion.
+                    //
+                    QuicCongestionControlOnDataInvalidated(
+                        &Connection->CongestionControl,
+                        Packet->PacketLength);
+                } else {
+                    LostRetransmittableBytes += Packet->PacketLength;
+                }
                 QuicLossDetectionRetransmitFrames(LossDetection, Packet, FALSE);
             }
 
@@ -959,12 +1141,13 @@ QuicLossDetectionDetectAndHandleLostPackets(
         QuicLossValidate(LossDetection);
 
         if (LostRetransmittableBytes > 0) {
-            QuicCongestionControlOnDataLost(
-                &Connection->CongestionControl,
+            QUIC_LOSS_EVENT LossEvent = {
                 LargestLostPacketNumber,
                 LossDetection->LargestSentPacketNumber,
                 LostRetransmittableBytes,
-                LossDetection->ProbeCount > QUIC_PERSISTENT_CONGESTION_THRESHOLD);
+                LossDetection->ProbeCount > QUIC_PERSISTENT_CONGESTION_THRESHOLD
+            };
+            QuicCongestionControlOnDataLost(&Connection->CongestionControl, &LossEvent);
             //
             // Send packets from any previously blocked streams.
             //
@@ -1026,7 +1209,7 @@ QuicLossDetectionDiscardPackets(
                 Connection,
                 Packet->PacketNumber,
                 QuicPacketTraceType(Packet));
-            QuicLossDetectionOnPacketAcknowledged(LossDetection, EncryptLevel, Packet);
+            QuicLossDetectionOnPacketAcknowledged(LossDetection, EncryptLevel, Packet, NULL);
 
             Packet = NextPacket;
 
@@ -1073,7 +1256,7 @@ QuicLossDetectionDiscardPackets(
                 AckedRetransmittableBytes += Packet->PacketLength;
             }
 
-            QuicLossDetectionOnPacketAcknowledged(LossDetection, EncryptLevel, Packet);
+            QuicLossDetectionOnPacketAcknowledged(LossDetection, EncryptLevel, Packet, NULL);
 
             Packet = NextPacket;
 
@@ -1087,12 +1270,16 @@ QuicLossDetectionDiscardPackets(
 
     if (AckedRetransmittableBytes > 0) {
         const QUIC_PATH* Path = &Connection->Paths[0]; // TODO - Correct?
+        QUIC_ACK_EVENT AckEvent;
+        QuicZeroMemory(&AckEvent, sizeof(AckEvent));
+        AckEvent.TimeNow = QuicTimeUs64();
+        AckEvent.LargestAck = LossDetection->LargestAck;
+        AckEvent.LargestSentPacketNumber = LossDetection->LargestSentPacketNumber;
+        AckEvent.NumRetransmittableBytes = AckedRetransmittableBytes;
+        AckEvent.SmoothedRtt = Path->SmoothedRtt;
         if (QuicCongestionControlOnDataAcknowledged(
                 &Connection->CongestionControl,
-                US_TO_MS(TimeNow),
-                LossDetection->LargestAck,
-                AckedRetransmittableBytes,
-                Path->SmoothedRtt)) {
+                &AckEvent)) {
             //
             // We were previously blocked and are now unblocked.
             //
@@ -1169,6 +1356,118 @@ QuicLossDetectionOnZeroRttRejected(
     }
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicLossDetectionOnAppLimited(
+    _In_ QUIC_LOSS_DETECTION* LossDetection
+    )
+{
+    LossDetection->AppLimited = TRUE;
+    LossDetection->AppLimitedPacketNumber =
+        LossDetection->LargestSentPacketNumber;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicLossDetectionSaveRateSampleState(
+    _In_ QUIC_LOSS_DETECTION* LossDetection,
+    _Inout_ QUIC_SENT_PACKET_METADATA* SentPacket
+    )
+{
+    if (LossDetection->PacketsInFlight == 0) {
+        //
+        // Nothing is in flight, so rate samples restart from this packet
+        // instead of measuring the idle time.
+        //
+        LossDetection->FirstSentTime = SentPacket->SentTime;
+        LossDetection->DeliveredTime = SentPacket->SentTime;
+    }
+
+    SentPacket->TotalBytesDelivered = LossDetection->TotalBytesDelivered;
+    SentPacket->DeliveredTime = LossDetection->DeliveredTime;
+    SentPacket->FirstSentTime = LossDetection->FirstSentTime;
+    SentPacket->Flags.IsAppLimited = LossDetection->AppLimited;
+}
+
+//
+// Accounts an acknowledged ack eliciting packet as delivered and, if it is
+// the most recently sent packet acknowledged so far, starts the rate sample
+// from the state saved when it was sent.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicLossDetectionUpdateRateSample(
+    _In_ QUIC_LOSS_DETECTION* LossDetection,
+    _In_ const QUIC_SENT_PACKET_METADATA* Packet,
+    _In_ uint32_t TimeNow,
+    _Inout_ QUIC_RATE_SAMPLE* Sample
+    )
+{
+    LossDetection->TotalBytesDelivered += Packet->PacketLength;
+    LossDetection->DeliveredTime = TimeNow;
+
+    if (!Sample->IsValid ||
+        Packet->TotalBytesDelivered >= Sample->PriorDelivered) {
+        Sample->IsValid = TRUE;
+        Sample->IsAppLimited = Packet->Flags.IsAppLimited;
+        Sample->PriorTime = Packet->DeliveredTime;
+        Sample->PriorDelivered = Packet->TotalBytesDelivered;
+        Sample->SendElapsed =
+            QuicTimeAtOrBefore32(Packet->FirstSentTime, Packet->SentTime) ?
+                QuicTimeDiff32(Packet->FirstSentTime, Packet->SentTime) : 0;
+        LossDetection->FirstSentTime = Packet->SentTime;
+    }
+}
+
+//
+// Computes the delivery rate from the sample and folds it into the bandwidth
+// estimate. Returns FALSE if the sample interval is too short to be reliable.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicLossDetectionGenerateRateSample(
+    _In_ QUIC_LOSS_DETECTION* LossDetection,
+    _In_ const QUIC_PATH* Path,
+    _In_ const QUIC_RATE_SAMPLE* Sample,
+    _Out_ uint64_t* DeliveryRate
+    )
+{
+    *DeliveryRate = 0;
+
+    if (!Sample->IsValid || !Path->GotFirstRttSample) {
+        return FALSE;
+    }
+
+    //
+    // The send rate and ACK rate of the sampled packets are both upper
+    // bounds of the delivery rate, so use the longer of the two intervals.
+    // Intervals shorter than the min RTT are too compressed by ACK
+    // aggregation to be trusted.
+    //
+    uint32_t AckElapsed =
+        QuicTimeDiff32(Sample->PriorTime, LossDetection->DeliveredTime);
+    uint32_t Interval = max(Sample->SendElapsed, AckElapsed);
+    if (Interval == 0 || Interval < Path->MinRtt) {
+        return FALSE;
+    }
+
+    *DeliveryRate =
+        (LossDetection->TotalBytesDelivered - Sample->PriorDelivered) *
+        1000000 / Interval;
+
+    uint32_t Window = QUIC_BANDWIDTH_ESTIMATE_WINDOW_RTTS * Path->SmoothedRtt;
+    if (*DeliveryRate >= LossDetection->EstimatedBandwidth ||
+        (!Sample->IsAppLimited &&
+         QuicTimeDiff32(
+            LossDetection->EstimatedBandwidthTime,
+            LossDetection->DeliveredTime) > Window)) {
+        LossDetection->EstimatedBandwidth = *DeliveryRate;
+        LossDetection->EstimatedBandwidthTime = LossDetection->DeliveredTime;
+    }
+
+    return TRUE;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicLossDetectionProcessAckBlocks(
@@ -1197,6 +1496,9 @@ QuicLossDetectionProcessAckBlocks(
     QUIC_SENT_PACKET_METADATA** SentPacketsStart = &LossDetection->SentPackets;
     QUIC_SENT_PACKET_METADATA* LargestAckedPacket = NULL;
 
+    QUIC_RATE_SAMPLE RateSample;
+    QuicZeroMemory(&RateSample, sizeof(RateSample));
+
     uint32_t i = 0;
     QUIC_SUBRANGE* AckBlock;
     while ((AckBlock = QuicRangeGetSafe(AckBlocks, i++)) != NULL) {
@@ -1294,6 +1596,9 @@ QuicLossDetectionProcessAckBlocks(
         return;
     }
 
+    QUIC_STREAM_ACK_BATCH StreamAcks;
+    StreamAcks.Count = 0;
+
     while (AckedPackets != NULL) {
 
         QUIC_SENT_PACKET_METADATA* Packet = AckedPackets;
@@ -1308,11 +1613,18 @@ QuicLossDetectionProcessAckBlocks(
                 "[conn][%p] ERROR, %s.",
                 Connection,
                 "Incorrect ACK encryption level");
+            QuicStreamAckBatchFlush(&StreamAcks);
             *InvalidAckBlock = TRUE;
             return;
         }
 
-        uint32_t PacketRtt = QuicTimeDiff32(Packet->SentTime, TimeNow);
+        //
+        // Packets paced by the datapath are tracked with their departure
+        // time, which is only still in the future if the kernel ignored it.
+        //
+        uint32_t PacketRtt =
+            QuicTimeAtOrBefore32(Packet->SentTime, TimeNow) ?
+                QuicTimeDiff32(Packet->SentTime, TimeNow) : 0;
         QuicTraceLogVerbose(
             PacketTxAcked,
             "[%c][TX][%llu] ACKed (%u.%03u ms)",
@@ -1329,9 +1641,17 @@ QuicLossDetectionProcessAckBlocks(
 
         SmallestRtt = min(SmallestRtt, PacketRtt);
 
-        QuicLossDetectionOnPacketAcknowledged(LossDetection, EncryptLevel, Packet);
+        if (Packet->Flags.IsAckEliciting) {
+            QuicLossDetectionUpdateRateSample(
+                LossDetection, Packet, TimeNow, &RateSample);
+        }
+
+        QuicLossDetectionOnPacketAcknowledged(
+            LossDetection, EncryptLevel, Packet, &StreamAcks);
     }
 
+    QuicStreamAckBatchFlush(&StreamAcks);
+
     QuicLossValidate(LossDetection);
 
     if (NewLargestAckRetransmittable && !NewLargestAckDifferentPath) {
@@ -1349,6 +1669,20 @@ QuicLossDetectionProcessAckBlocks(
         QuicConnUpdateRtt(Connection, Path, SmallestRtt);
     }
 
+    if (LossDetection->AppLimited &&
+        LossDetection->LargestAck > LossDetection->AppLimitedPacketNumber) {
+        //
+        // Everything sent before the connection became app limited has been
+        // acknowledged, so new samples will reflect the network again.
+        //
+        LossDetection->AppLimited = FALSE;
+    }
+
+    uint64_t DeliveryRate;
+    BOOLEAN HasRateSample =
+        QuicLossDetectionGenerateRateSample(
+            LossDetection, Path, &RateSample, &DeliveryRate);
+
     if (NewLargestAck) {
         //
         // Handle packet loss (and any possible congestion events) before
@@ -1359,12 +1693,25 @@ QuicLossDetectionProcessAckBlocks(
     }
 
     if (NewLargestAck || AckedRetransmittableBytes > 0) {
+        QUIC_ACK_EVENT AckEvent;
+        QuicZeroMemory(&AckEvent, sizeof(AckEvent));
+        AckEvent.TimeNow = QuicTimeUs64();
+        AckEvent.LargestAck = LossDetection->LargestAck;
+        AckEvent.LargestSentPacketNumber = LossDetection->LargestSentPacketNumber;
+        AckEvent.NumRetransmittableBytes = AckedRetransmittableBytes;
+        AckEvent.SmoothedRtt = Connection->Paths[0].SmoothedRtt;
+        if (NewLargestAckRetransmittable && !NewLargestAckDifferentPath) {
+            AckEvent.HasRttSample = TRUE;
+            AckEvent.LatestRtt = Path->LatestRttSample;
+        }
+        if (HasRateSample) {
+            AckEvent.HasRateSample = TRUE;
+            AckEvent.IsAppLimited = RateSample.IsAppLimited;
+            AckEvent.DeliveryRate = DeliveryRate;
+        }
         if (QuicCongestionControlOnDataAcknowledged(
                 &Connection->CongestionControl,
-                US_TO_MS(TimeNow),
-                LossDetection->LargestAck,
-                AckedRetransmittableBytes,
-                Connection->Paths[0].SmoothedRtt)) {
+                &AckEvent)) {
             //
             // We were previously blocked and are now unblocked.
             //
@@ -1441,6 +1788,9 @@ QuicLossDetectionProcessAckFrame(
                 AckDelay,
                 &Connection->DecodedAckRanges,
                 InvalidFrame);
+
+            QuicMtuDiscoveryCheckSearchCompleteTimeout(
+                Connection, &Connection->Paths[0], QuicTimeUs64());
         }
     }
 
@@ -1467,6 +1817,9 @@ QuicLossDetectionScheduleProbe(
         "probe round %lu",
         LossDetection->ProbeCount);
 
+    QuicMtuDiscoveryOnProbeTimeout(
+        Connection, &Connection->Paths[0], LossDetection->ProbeCount);
+
     //
     // Below, we will schedule a fixed number packets to be retransmitted. What
     // we'd like to do here send only that number of packets' worth of fresh
@@ -1488,17 +1841,20 @@ QuicLossDetectionScheduleProbe(
 
     if (Connection->Crypto.TlsState.WriteKey == QUIC_PACKET_KEY_1_RTT) {
         //
-        // Check to see if any streams have fresh data to send out.
+        // Check to see if any streams have fresh data to send out. Streams
+        // parked as blocked can't, so only the send lists are checked.
         //
-        for (QUIC_LIST_ENTRY* Entry = Connection->Send.SendStreams.Flink;
-            Entry != &Connection->Send.SendStreams;
-            Entry = Entry->Flink) {
-
-            QUIC_STREAM* Stream =
-                QUIC_CONTAINING_RECORD(Entry, QUIC_STREAM, SendLink);
-            if (QuicStreamCanSendNow(Stream, FALSE)) {
-                if (--NumPackets == 0) {
-                    return;
+        for (uint32_t i = 0; i < QUIC_STREAM_PRIORITY_LEVEL_COUNT; ++i) {
+            for (QUIC_LIST_ENTRY* Entry = Connection->Send.SendStreams[i].Flink;
+                Entry != &Connection->Send.SendStreams[i];
+                Entry = Entry->Flink) {
+
+                QUIC_STREAM* Stream =
+                    QUIC_CONTAINING_RECORD(Entry, QUIC_STREAM, SendLink);
+                if (QuicStreamCanSendNow(Stream, FALSE)) {
+                    if (--NumPackets == 0) {
+                        return;
+                    }
                 }
             }
         }
@@ -54,6 +54,32 @@ typedef struct QUIC_LOSS_DETECTION {
     //
     uint16_t ProbeCount;
 
+    //
+    // TRUE while packets are sent without the connection having enough data
+    // to fill the congestion window. Rate samples of these packets only give
+    // a lower bound of the available bandwidth. Cleared once a packet sent
+    // after AppLimitedPacketNumber is acknowledged.
+    //
+    BOOLEAN AppLimited;
+    uint64_t AppLimitedPacketNumber;
+
+    //
+    // Delivery rate estimation state. TotalBytesDelivered counts the
+    // acknowledged bytes of ack eliciting packets and DeliveredTime is the
+    // time it last increased. FirstSentTime is the send time of the packet
+    // which the last rate sample started from.
+    //
+    uint64_t TotalBytesDelivered;
+    uint32_t DeliveredTime; // In microseconds
+    uint32_t FirstSentTime; // In microseconds
+
+    //
+    // The max delivery rate sampled over the last
+    // QUIC_BANDWIDTH_ESTIMATE_WINDOW_RTTS round trips.
+    //
+    uint64_t EstimatedBandwidth; // bytes/sec
+    uint32_t EstimatedBandwidthTime; // In microseconds
+
 } QUIC_LOSS_DETECTION;
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -125,6 +151,66 @@ QuicLossDetectionOnPacketSent(
     _In_ QUIC_SENT_PACKET_METADATA* SentPacket
     );
 
+//
+// Called when the connection runs out of data to send before filling the
+// congestion window.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicLossDetectionOnAppLimited(
+    _In_ QUIC_LOSS_DETECTION* LossDetection
+    );
+
+//
+// A delivery rate sample taken over the packets acknowledged by a single ACK
+// frame. The sample interval starts at the most recently sent of them.
+//
+typedef struct QUIC_RATE_SAMPLE {
+
+    BOOLEAN IsValid;
+    BOOLEAN IsAppLimited;
+    uint32_t PriorTime; // In microseconds
+    uint32_t SendElapsed; // In microseconds
+    uint64_t PriorDelivered;
+
+} QUIC_RATE_SAMPLE;
+
+//
+// Saves the delivery state in a newly sent ack eliciting packet, for the
+// rate sample taken when it is acknowledged.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicLossDetectionSaveRateSampleState(
+    _In_ QUIC_LOSS_DETECTION* LossDetection,
+    _Inout_ QUIC_SENT_PACKET_METADATA* SentPacket
+    );
+
+//
+// Accounts an acknowledged ack eliciting packet in the rate sample.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicLossDetectionUpdateRateSample(
+    _In_ QUIC_LOSS_DETECTION* LossDetection,
+    _In_ const QUIC_SENT_PACKET_METADATA* Packet,
+    _In_ uint32_t TimeNow,
+    _Inout_ QUIC_RATE_SAMPLE* Sample
+    );
+
+//
+// Computes the delivery rate of the sample and updates EstimatedBandwidth.
+// Returns FALSE if there is no usable sample.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicLossDetectionGenerateRateSample(
+    _In_ QUIC_LOSS_DETECTION* LossDetection,
+    _In_ const QUIC_PATH* Path,
+    _In_ const QUIC_RATE_SAMPLE* Sample,
+    _Out_ uint64_t* DeliveryRate
+    );
+
 //
 // Processes a received ACK frame. Returns true if the frame could be
 // successfully processed. On failure, 'InvalidFrame' indicates if the frame
@@ -0,0 +1,324 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Datagram packetization layer path MTU discovery (DPLPMTUD, RFC 8899).
+
+    Each path starts at the base (minimum QUIC) MTU. Once the handshake is
+    complete (or a new path is validated), the search probes for the largest
+    MTU allowed by the local interface and the peer's max_udp_payload_size
+    transport parameter, optimistically trying the maximum first. Probes are
+    padded PING packets; a probe that is lost QUIC_DPLPMTUD_MAX_PROBES times
+    in a row marks its size as too large, and the search continues with a
+    binary search between the largest acknowledged size and the largest size
+    not yet known to fail.
+
+    If the search completes below the maximum MTU, another attempt to raise
+    it is made after QUIC_DPLPMTUD_RAISE_TIMER. If packets larger than the
+    base MTU start getting lost consistently (or repeated probe timeouts
+    occur), the path is assumed to have become a black hole for the current
+    MTU, which is then reset to the base MTU before searching again.
+
+    Lost probes are not considered a congestion signal.
+
+--*/
+
+#include "precomp.h"
+#ifdef QUIC_CLOG
+#include "mtu_discovery.c.clog.h"
+#endif
+
+//
+// Returns the largest MTU allowed on the path by both endpoints.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+uint16_t
+QuicMtuDiscoveryGetMaxMtu(
+    _In_ const QUIC_CONNECTION* Connection,
+    _In_ const QUIC_PATH* Path
+    )
+{
+    uint16_t MaxMtu =
+        QuicDataPathBindingGetLocalMtu(Path->Binding->DatapathBinding);
+    if (MaxMtu > QUIC_MAX_MTU) {
+        MaxMtu = QUIC_MAX_MTU; // Send buffers are never larger than this.
+    }
+
+    if ((Connection->PeerTransportParams.Flags & QUIC_TP_FLAG_MAX_UDP_PAYLOAD_SIZE) &&
+        Connection->PeerTransportParams.MaxUdpPayloadSize < QUIC_MAX_MTU) {
+        uint16_t PeerMaxMtu =
+            PacketSizeFromUdpPayloadSize(
+                QuicAddrGetFamily(&Path->RemoteAddress),
+                (uint16_t)Connection->PeerTransportParams.MaxUdpPayloadSize);
+        if (PeerMaxMtu < MaxMtu) {
+            MaxMtu = PeerMaxMtu;
+        }
+    }
+
+    return MaxMtu;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicMtuDiscoveryUpdateMtu(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_PATH* Path,
+    _In_ uint16_t Mtu
+    )
+{
+    Path->Mtu = Mtu;
+    QuicTraceLogConnInfo(
+        PathMtuUpdated,
+        Connection,
+        "Path[%hhu] MTU updated to %hu bytes",
+        Path->ID,
+        Path->Mtu);
+    QuicDatagramOnSendStateChanged(&Connection->Datagram);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicMtuDiscoveryMoveToSearchComplete(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_PATH* Path
+    )
+{
+    QUIC_MTU_DISCOVERY* MtuDiscovery = &Path->MtuDiscovery;
+    MtuDiscovery->State = QUIC_PATH_MTU_SEARCH_STATE_COMPLETE;
+    MtuDiscovery->ProbeSize = 0;
+    MtuDiscovery->ProbeLostCount = 0;
+    MtuDiscovery->SearchCompleteTime = QuicTimeUs64();
+
+    QuicTraceLogConnInfo(
+        PathMtuSearchComplete,
+        Connection,
+        "Path[%hhu] MTU search complete at %hu bytes",
+        Path->ID,
+        Path->Mtu);
+}
+
+//
+// Queues the next probe of the search, or completes the search if the range of
+// possible MTUs is small enough.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicMtuDiscoveryProbeNext(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_PATH* Path
+    )
+{
+    QUIC_MTU_DISCOVERY* MtuDiscovery = &Path->MtuDiscovery;
+    if (MtuDiscovery->SearchHigh < MtuDiscovery->SearchLow + QUIC_DPLPMTUD_SEARCH_GRANULARITY) {
+        QuicMtuDiscoveryMoveToSearchComplete(Connection, Path);
+        return;
+    }
+
+    MtuDiscovery->ProbeSize =
+        MtuDiscovery->SearchLow +
+        (MtuDiscovery->SearchHigh - MtuDiscovery->SearchLow + 1) / 2;
+    MtuDiscovery->ProbeLostCount = 0;
+    QuicSendSetSendFlag(&Connection->Send, QUIC_CONN_SEND_FLAG_PMTUD);
+}
+
+//
+// Starts searching from the currently validated MTU up to (and including)
+// SearchHigh, by probing SearchHigh first.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicMtuDiscoverySearch(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_PATH* Path,
+    _In_ uint16_t SearchHigh
+    )
+{
+    QUIC_MTU_DISCOVERY* MtuDiscovery = &Path->MtuDiscovery;
+    MtuDiscovery->SearchLow = Path->Mtu;
+    MtuDiscovery->SearchHigh = SearchHigh;
+    MtuDiscovery->LostLargePacketCount = 0;
+
+    if (MtuDiscovery->SearchHigh <= MtuDiscovery->SearchLow) {
+        MtuDiscovery->SearchHigh = MtuDiscovery->SearchLow;
+        QuicMtuDiscoveryMoveToSearchComplete(Connection, Path);
+        return;
+    }
+
+    QuicTraceLogConnInfo(
+        PathMtuSearchStart,
+        Connection,
+        "Path[%hhu] MTU search started (%hu to %hu bytes)",
+        Path->ID,
+        MtuDiscovery->SearchLow,
+        MtuDiscovery->SearchHigh);
+
+    MtuDiscovery->State = QUIC_PATH_MTU_SEARCH_STATE_SEARCHING;
+    MtuDiscovery->ProbeSize = MtuDiscovery->SearchHigh;
+    MtuDiscovery->ProbeLostCount = 0;
+    QuicSendSetSendFlag(&Connection->Send, QUIC_CONN_SEND_FLAG_PMTUD);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicMtuDiscoveryStartSearch(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_PATH* Path
+    )
+{
+    QUIC_DBG_ASSERT(Path->IsActive);
+    QuicMtuDiscoverySearch(
+        Connection, Path, QuicMtuDiscoveryGetMaxMtu(Connection, Path));
+}
+
+//
+// The path no longer delivers packets of the current MTU. Fall back to the
+// base MTU and search again, below the MTU that stopped working.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicMtuDiscoveryOnBlackHole(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_PATH* Path
+    )
+{
+    uint16_t PrevMtu = Path->Mtu;
+
+    QuicTraceLogConnWarning(
+        PathMtuBlackHole,
+        Connection,
+        "Path[%hhu] MTU black hole detected at %hu bytes",
+        Path->ID,
+        PrevMtu);
+    Connection->Stats.Send.PathMtuBlackHoleCount++;
+
+    QuicMtuDiscoveryUpdateMtu(Connection, Path, QUIC_DEFAULT_PATH_MTU);
+
+    uint16_t SearchHigh = QuicMtuDiscoveryGetMaxMtu(Connection, Path);
+    if (SearchHigh >= PrevMtu) {
+        SearchHigh = PrevMtu - 1;
+    }
+    QuicMtuDiscoverySearch(Connection, Path, SearchHigh);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicMtuDiscoveryOnProbeAcknowledged(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_PATH* Path,
+    _In_ uint16_t PacketMtu
+    )
+{
+    QUIC_MTU_DISCOVERY* MtuDiscovery = &Path->MtuDiscovery;
+    MtuDiscovery->LostLargePacketCount = 0;
+
+    //
+    // Any acknowledged probe (even a stale one) proves its size works.
+    //
+    if (PacketMtu > Path->Mtu) {
+        QuicMtuDiscoveryUpdateMtu(Connection, Path, PacketMtu);
+    }
+    if (PacketMtu > MtuDiscovery->SearchLow) {
+        MtuDiscovery->SearchLow = PacketMtu;
+        if (MtuDiscovery->SearchHigh < PacketMtu) {
+            MtuDiscovery->SearchHigh = PacketMtu;
+        }
+    }
+
+    if (MtuDiscovery->State == QUIC_PATH_MTU_SEARCH_STATE_SEARCHING &&
+        PacketMtu == MtuDiscovery->ProbeSize) {
+        QuicMtuDiscoveryProbeNext(Connection, Path);
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicMtuDiscoveryOnProbeLost(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_PATH* Path,
+    _In_ uint16_t PacketMtu
+    )
+{
+    QUIC_MTU_DISCOVERY* MtuDiscovery = &Path->MtuDiscovery;
+    if (MtuDiscovery->State != QUIC_PATH_MTU_SEARCH_STATE_SEARCHING ||
+        PacketMtu != MtuDiscovery->ProbeSize) {
+        return; // Stale probe.
+    }
+
+    if (++MtuDiscovery->ProbeLostCount < QUIC_DPLPMTUD_MAX_PROBES) {
+        //
+        // Try the same size again.
+        //
+        QuicSendSetSendFlag(&Connection->Send, QUIC_CONN_SEND_FLAG_PMTUD);
+        return;
+    }
+
+    QuicTraceLogConnInfo(
+        PathMtuProbeFailed,
+        Connection,
+        "Path[%hhu] MTU probe of %hu bytes failed",
+        Path->ID,
+        PacketMtu);
+
+    MtuDiscovery->SearchHigh = PacketMtu - 1;
+    QuicMtuDiscoveryProbeNext(Connection, Path);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicMtuDiscoveryOnPacketAcknowledged(
+    _In_ QUIC_PATH* Path,
+    _In_ uint16_t PacketMtu
+    )
+{
+    if (PacketMtu > QUIC_DEFAULT_PATH_MTU) {
+        Path->MtuDiscovery.LostLargePacketCount = 0;
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicMtuDiscoveryOnPacketLost(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_PATH* Path,
+    _In_ uint16_t PacketMtu
+    )
+{
+    if (PacketMtu > QUIC_DEFAULT_PATH_MTU &&
+        Path->Mtu > QUIC_DEFAULT_PATH_MTU &&
+        ++Path->MtuDiscovery.LostLargePacketCount >= QUIC_DPLPMTUD_BLACK_HOLE_LOST_PACKETS) {
+        QuicMtuDiscoveryOnBlackHole(Connection, Path);
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicMtuDiscoveryOnProbeTimeout(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_PATH* Path,
+    _In_ uint32_t ProbeTimeoutCount
+    )
+{
+    if (ProbeTimeoutCount == QUIC_DPLPMTUD_BLACK_HOLE_PROBE_TIMEOUTS &&
+        Path->Mtu > QUIC_DEFAULT_PATH_MTU) {
+        QuicMtuDiscoveryOnBlackHole(Connection, Path);
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicMtuDiscoveryCheckSearchCompleteTimeout(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_PATH* Path,
+    _In_ uint64_t TimeNow
+    )
+{
+    const QUIC_MTU_DISCOVERY* MtuDiscovery = &Path->MtuDiscovery;
+    if (MtuDiscovery->State == QUIC_PATH_MTU_SEARCH_STATE_COMPLETE &&
+        QuicTimeDiff64(MtuDiscovery->SearchCompleteTime, TimeNow) >= QUIC_DPLPMTUD_RAISE_TIMER &&
+        Path->Mtu < QuicMtuDiscoveryGetMaxMtu(Connection, Path)) {
+        QuicMtuDiscoveryStartSearch(Connection, Path);
+    }
+}
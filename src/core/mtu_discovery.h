@@ -0,0 +1,125 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+--*/
+
+//
+// Per path state of the datagram packetization layer path MTU discovery
+// (DPLPMTUD, RFC 8899) search.
+//
+typedef struct QUIC_MTU_DISCOVERY {
+
+    //
+    // The current state of the search.
+    //
+    QUIC_PATH_MTU_SEARCH_STATE State;
+
+    //
+    // The largest MTU the path is known to support.
+    //
+    uint16_t SearchLow;
+
+    //
+    // The largest MTU the path might support. Sizes above this either failed
+    // to be acknowledged or aren't allowed by either endpoint.
+    //
+    uint16_t SearchHigh;
+
+    //
+    // The MTU of the outstanding (or next) probe. Zero if none.
+    //
+    uint16_t ProbeSize;
+
+    //
+    // The number of consecutive lost probes of ProbeSize.
+    //
+    uint8_t ProbeLostCount;
+
+    //
+    // The number of consecutive lost packets larger than the base MTU, used
+    // for black hole detection.
+    //
+    uint8_t LostLargePacketCount;
+
+    //
+    // The time (in microseconds) the search last completed.
+    //
+    uint64_t SearchCompleteTime;
+
+} QUIC_MTU_DISCOVERY;
+
+//
+// Starts (or restarts) the search for the path's MTU, starting from the
+// currently validated MTU.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicMtuDiscoveryStartSearch(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_PATH* Path
+    );
+
+//
+// Called when a path MTU probe packet is acknowledged.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicMtuDiscoveryOnProbeAcknowledged(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_PATH* Path,
+    _In_ uint16_t PacketMtu
+    );
+
+//
+// Called when a path MTU probe packet is inferred lost.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicMtuDiscoveryOnProbeLost(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_PATH* Path,
+    _In_ uint16_t PacketMtu
+    );
+
+//
+// Called when a (non-probe) packet is acknowledged or inferred lost, for black
+// hole detection.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicMtuDiscoveryOnPacketAcknowledged(
+    _In_ QUIC_PATH* Path,
+    _In_ uint16_t PacketMtu
+    );
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicMtuDiscoveryOnPacketLost(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_PATH* Path,
+    _In_ uint16_t PacketMtu
+    );
+
+//
+// Called on each probe timeout, for black hole detection.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicMtuDiscoveryOnProbeTimeout(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_PATH* Path,
+    _In_ uint32_t ProbeTimeoutCount
+    );
+
+//
+// Restarts the search if it completed below the maximum MTU long enough ago.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicMtuDiscoveryCheckSearchCompleteTimeout(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_PATH* Path,
+    _In_ uint64_t TimeNow
+    );
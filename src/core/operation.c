@@ -20,6 +20,10 @@ Abstract:
     is the only thread that touches the connection itself, which simplifies
     synchronization.
 
+    Producers never take a lock: they push onto a lock-free stack with a
+    single compare-exchange. When the worker runs out of operations it takes
+    the whole stack with one atomic exchange and reverses it into order.
+
 --*/
 
 #include "precomp.h"
@@ -33,8 +37,8 @@ QuicOperationQueueInitialize(
     _Inout_ QUIC_OPERATION_QUEUE* OperQ
     )
 {
-    OperQ->ActivelyProcessing = FALSE;
-    QuicDispatchLockInitialize(&OperQ->Lock);
+    OperQ->PendingHead = NULL;
+    OperQ->PriorityHead = NULL;
     QuicListInitializeHead(&OperQ->List);
 }
 
@@ -45,8 +49,9 @@ QuicOperationQueueUninitialize(
     )
 {
     UNREFERENCED_PARAMETER(OperQ);
+    QUIC_DBG_ASSERT(OperQ->PendingHead == NULL);
+    QUIC_DBG_ASSERT(OperQ->PriorityHead == NULL);
     QUIC_DBG_ASSERT(QuicListIsEmpty(&OperQ->List));
-    QuicDispatchLockUninitialize(&OperQ->Lock);
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -134,17 +139,21 @@ QuicOperationEnqueue(
     _In_ QUIC_OPERATION* Oper
     )
 {
-    BOOLEAN StartProcessing;
-    QuicDispatchLockAcquire(&OperQ->Lock);
+    void* Head;
 #if DEBUG
     QUIC_DBG_ASSERT(Oper->Link.Flink == NULL);
 #endif
-    StartProcessing = QuicListIsEmpty(&OperQ->List) && !OperQ->ActivelyProcessing;
-    QuicListInsertTail(&OperQ->List, &Oper->Link);
-    QuicDispatchLockRelease(&OperQ->Lock);
+    do {
+        Head = OperQ->PendingHead;
+        Oper->Link.Flink =
+            (QUIC_LIST_ENTRY*)((uintptr_t)Head & ~QUIC_OPERATION_QUEUE_ACTIVE);
+    } while (InterlockedCompareExchangePointer(
+                &OperQ->PendingHead,
+                (void*)((uintptr_t)&Oper->Link | ((uintptr_t)Head & QUIC_OPERATION_QUEUE_ACTIVE)),
+                Head) != Head);
     QuicPerfCounterIncrement(QUIC_PERF_COUNTER_CONN_OPER_QUEUED);
     QuicPerfCounterIncrement(QUIC_PERF_COUNTER_CONN_OPER_QUEUE_DEPTH);
-    return StartProcessing;
+    return Head == NULL;
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -154,17 +163,72 @@ QuicOperationEnqueueFront(
     _In_ QUIC_OPERATION* Oper
     )
 {
-    BOOLEAN StartProcessing;
-    QuicDispatchLockAcquire(&OperQ->Lock);
+    QUIC_LIST_ENTRY* Head;
 #if DEBUG
     QUIC_DBG_ASSERT(Oper->Link.Flink == NULL);
 #endif
-    StartProcessing = QuicListIsEmpty(&OperQ->List) && !OperQ->ActivelyProcessing;
-    QuicListInsertHead(&OperQ->List, &Oper->Link);
-    QuicDispatchLockRelease(&OperQ->Lock);
+    do {
+        Head = OperQ->PriorityHead;
+        Oper->Link.Flink = Head;
+    } while (InterlockedCompareExchangePointer(
+                (void* volatile*)&OperQ->PriorityHead,
+                &Oper->Link,
+                Head) != Head);
     QuicPerfCounterIncrement(QUIC_PERF_COUNTER_CONN_OPER_QUEUED);
     QuicPerfCounterIncrement(QUIC_PERF_COUNTER_CONN_OPER_QUEUE_DEPTH);
-    return StartProcessing;
+
+    //
+    // The priority stack doesn't track whether the queue is being drained, so
+    // always have the caller (re)queue the connection. This is only used for
+    // rare, shutdown related operations.
+    //
+    return TRUE;
+}
+
+//
+// Moves all the operations on the priority stack to the front of the list.
+// They were pushed newest first, which is also the order they run in.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicOperationQueueTakePriority(
+    _In_ QUIC_OPERATION_QUEUE* OperQ,
+    _Inout_ QUIC_LIST_ENTRY* List
+    )
+{
+    QUIC_LIST_ENTRY* Entry =
+        (QUIC_LIST_ENTRY*)InterlockedExchangePointer(
+            (void* volatile*)&OperQ->PriorityHead, NULL);
+    QUIC_LIST_ENTRY* Tail = List;
+    while (Entry != NULL) {
+        QUIC_LIST_ENTRY* Next = Entry->Flink;
+        QuicListInsertHead(Tail, Entry);
+        Tail = Entry;
+        Entry = Next;
+    }
+}
+
+//
+// Moves all the operations on the pending stack, in the order they were
+// enqueued, to the end of the list. Leaves the queue in the given state.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicOperationQueueTakePending(
+    _In_ QUIC_OPERATION_QUEUE* OperQ,
+    _In_ uintptr_t NewState,
+    _Inout_ QUIC_LIST_ENTRY* List
+    )
+{
+    QUIC_LIST_ENTRY* Entry =
+        (QUIC_LIST_ENTRY*)((uintptr_t)InterlockedExchangePointer(
+            &OperQ->PendingHead, (void*)NewState) & ~QUIC_OPERATION_QUEUE_ACTIVE);
+    QUIC_LIST_ENTRY* Head = List->Blink;
+    while (Entry != NULL) {
+        QUIC_LIST_ENTRY* Next = Entry->Flink;
+        QuicListInsertHead(Head, Entry);
+        Entry = Next;
+    }
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -173,25 +237,32 @@ QuicOperationDequeue(
     _In_ QUIC_OPERATION_QUEUE* OperQ
     )
 {
-    QUIC_OPERATION* Oper;
-    QuicDispatchLockAcquire(&OperQ->Lock);
-    if (QuicListIsEmpty(&OperQ->List)) {
-        OperQ->ActivelyProcessing = FALSE;
-        Oper = NULL;
-    } else {
-        OperQ->ActivelyProcessing = TRUE;
-        Oper =
-            QUIC_CONTAINING_RECORD(
-                QuicListRemoveHead(&OperQ->List), QUIC_OPERATION, Link);
-#if DEBUG
-        Oper->Link.Flink = NULL;
-#endif
+    if (OperQ->PriorityHead != NULL) {
+        QuicOperationQueueTakePriority(OperQ, &OperQ->List);
     }
-    QuicDispatchLockRelease(&OperQ->Lock);
 
-    if (Oper != NULL) {
-        QuicPerfCounterDecrement(QUIC_PERF_COUNTER_CONN_OPER_QUEUE_DEPTH);
+    while (QuicListIsEmpty(&OperQ->List)) {
+        //
+        // Nothing left to process. Try to mark the queue idle, so that the
+        // next enqueue has the connection queued on its worker again. If more
+        // operations were pushed in the meantime, take them and keep going.
+        //
+        void* Head =
+            InterlockedCompareExchangePointer(
+                &OperQ->PendingHead, NULL, (void*)QUIC_OPERATION_QUEUE_ACTIVE);
+        if (Head == NULL || Head == (void*)QUIC_OPERATION_QUEUE_ACTIVE) {
+            return NULL;
+        }
+        QuicOperationQueueTakePending(OperQ, QUIC_OPERATION_QUEUE_ACTIVE, &OperQ->List);
     }
+
+    QUIC_OPERATION* Oper =
+        QUIC_CONTAINING_RECORD(
+            QuicListRemoveHead(&OperQ->List), QUIC_OPERATION, Link);
+#if DEBUG
+    Oper->Link.Flink = NULL;
+#endif
+    QuicPerfCounterDecrement(QUIC_PERF_COUNTER_CONN_OPER_QUEUE_DEPTH);
     return Oper;
 }
 
@@ -205,10 +276,9 @@ QuicOperationQueueClear(
     QUIC_LIST_ENTRY OldList;
     QuicListInitializeHead(&OldList);
 
-    QuicDispatchLockAcquire(&OperQ->Lock);
-    OperQ->ActivelyProcessing = FALSE;
     QuicListMoveItems(&OperQ->List, &OldList);
-    QuicDispatchLockRelease(&OperQ->Lock);
+    QuicOperationQueueTakePriority(OperQ, &OldList);
+    QuicOperationQueueTakePending(OperQ, 0, &OldList);
 
     int64_t OperationsDequeued = 0;
 
@@ -271,18 +271,27 @@ QuicOperLog(
 typedef struct QUIC_OPERATION_QUEUE {
 
     //
-    // TRUE if the queue is being drained.
+    // Lock-free stack (newest first) of operations posted by any thread,
+    // linked through their Link.Flink. The low bit is set while the queue is
+    // being drained (QUIC_OPERATION_QUEUE_ACTIVE).
     //
-    BOOLEAN ActivelyProcessing;
+    void* volatile PendingHead;
 
     //
-    // Queue of pending operations.
+    // Lock-free stack of operations to be processed before any others.
+    //
+    QUIC_LIST_ENTRY* volatile PriorityHead;
+
+    //
+    // Operations taken off the stacks, in processing order. Only accessed by
+    // the draining worker.
     //
-    QUIC_DISPATCH_LOCK Lock;
     QUIC_LIST_ENTRY List;
 
 } QUIC_OPERATION_QUEUE;
 
+#define QUIC_OPERATION_QUEUE_ACTIVE ((uintptr_t)1)
+
 //
 // Initializes an operation queue.
 //
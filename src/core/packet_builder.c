@@ -73,11 +73,34 @@ QuicPacketBuilderInitialize(
     } else {
         TimeSinceLastSend = 0;
     }
-    Builder->SendAllowance =
-        QuicCongestionControlGetSendAllowance(
-            &Connection->CongestionControl,
-            TimeSinceLastSend,
-            Connection->Send.LastFlushTimeValid);
+
+    Builder->DatapathPacing =
+        Connection->Settings.PacingEnabled &&
+        Connection->Settings.DatapathPacingEnabled &&
+        Connection->Paths[0].GotFirstRttSample &&
+        (QuicDataPathGetSupportedFeatures(MsQuicLib.Datapath) &
+            QUIC_DATAPATH_FEATURE_SEND_TXTIME);
+    Builder->BatchDepartureTime = 0;
+
+    if (Builder->DatapathPacing) {
+        //
+        // The whole window can be sent now, since the datapath holds each
+        // batch until its departure time.
+        //
+        Builder->SendAllowance =
+            QuicCongestionControlGetSendAllowance(
+                &Connection->CongestionControl,
+                0,
+                FALSE);
+        Builder->PacingQuantum =
+            QuicCongestionControlGetPacingQuantum(&Connection->CongestionControl);
+    } else {
+        Builder->SendAllowance =
+            QuicCongestionControlGetSendAllowance(
+                &Connection->CongestionControl,
+                TimeSinceLastSend,
+                Connection->Send.LastFlushTimeValid);
+    }
     if (Builder->SendAllowance > Path->Allowance) {
         Builder->SendAllowance = Path->Allowance;
     }
@@ -204,7 +227,8 @@ QuicPacketBuilderPrepare(
         uint16_t NewDatagramLength =
             MaxUdpPayloadSizeForFamily(
                 QuicAddrGetFamily(&Builder->Path->RemoteAddress),
-                IsPathMtuDiscovery ? QUIC_MAX_MTU : DatagramSize);
+                IsPathMtuDiscovery ?
+                    Builder->Path->MtuDiscovery.ProbeSize : DatagramSize);
         if ((Connection->PeerTransportParams.Flags & QUIC_TP_FLAG_MAX_UDP_PAYLOAD_SIZE) &&
             NewDatagramLength > Connection->PeerTransportParams.MaxUdpPayloadSize) {
             NewDatagramLength = (uint16_t)Connection->PeerTransportParams.MaxUdpPayloadSize;
@@ -289,6 +313,7 @@ QuicPacketBuilderPrepare(
         Builder->Metadata->Flags.IsAckEliciting = FALSE;
         Builder->Metadata->Flags.IsPMTUD = IsPathMtuDiscovery;
         Builder->Metadata->Flags.SuspectedLost = FALSE;
+        Builder->Metadata->Flags.IsAppLimited = FALSE;
 #if DEBUG
         Builder->Metadata->Flags.Freed = FALSE;
 #endif
@@ -530,15 +555,68 @@ QuicPacketBuilderPrepareForStreamFrames(
     return QuicPacketBuilderPrepare(Builder, PacketKeyType, IsTailLossProbe, FALSE);
 }
 
+//
+// Encrypts the batched short header packets and then applies header
+// protection to them, using the ciphertext as the sample.
+//
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
-QuicPacketBuilderFinalizeHeaderProtection(
+QuicPacketBuilderFinalizeCryptoBatch(
     _Inout_ QUIC_PACKET_BUILDER* Builder
     )
 {
     QUIC_DBG_ASSERT(Builder->Key != NULL);
+    QUIC_DBG_ASSERT(Builder->BatchCount != 0);
+
+    QUIC_CRYPT_BATCH_ENTRY Batch[QUIC_MAX_CRYPTO_BATCH_COUNT];
+    uint8_t Iv[QUIC_MAX_CRYPTO_BATCH_COUNT][QUIC_MAX_IV_LENGTH];
+
+    for (uint8_t i = 0; i < Builder->BatchCount; ++i) {
+        QuicCryptoCombineIvAndPacketNumber(
+            Builder->Key->Iv,
+            (uint8_t*)&Builder->PacketNumberBatch[i],
+            Iv[i]);
+        Batch[i].Iv = Iv[i];
+        Batch[i].AuthData = Builder->HeaderBatch[i];
+        Batch[i].AuthDataLength = Builder->HeaderLength;
+        Batch[i].Buffer = Builder->HeaderBatch[i] + Builder->HeaderLength;
+        Batch[i].BufferLength = Builder->PayloadLengthBatch[i];
+    }
 
     QUIC_STATUS Status;
+    if (Builder->Connection->Settings.CryptoOffloadEnabled) {
+        Status =
+            QuicCryptoOffloadBatch(
+                MsQuicLib.CryptoOffload,
+                Builder->Key,
+                TRUE,
+                Builder->BatchCount,
+                Batch);
+    } else {
+        Status =
+            QuicEncryptBatch(
+                Builder->Key->PacketKey,
+                Builder->BatchCount,
+                Batch);
+    }
+    if (QUIC_FAILED(Status)) {
+        QuicConnFatalError(Builder->Connection, Status, "Encryption failure");
+        Builder->BatchCount = 0;
+        return;
+    }
+
+    if (!Builder->Connection->State.HeaderProtectionEnabled) {
+        Builder->BatchCount = 0;
+        return;
+    }
+
+    for (uint8_t i = 0; i < Builder->BatchCount; ++i) {
+        QuicCopyMemory(
+            Builder->CipherBatch + i * QUIC_HP_SAMPLE_LENGTH,
+            Batch[i].Buffer - Builder->PacketNumberLength + 4,
+            QUIC_HP_SAMPLE_LENGTH);
+    }
+
     if (QUIC_FAILED(
         Status =
         QuicHpComputeMask(
@@ -548,6 +626,7 @@ QuicPacketBuilderFinalizeHeaderProtection(
             Builder->HpMask))) {
         QUIC_TEL_ASSERT(FALSE);
         QuicConnFatalError(Builder->Connection, Status, "HP failure");
+        Builder->BatchCount = 0;
         return;
     }
 
@@ -714,46 +793,46 @@ QuicPacketBuilderFinalize(
 
         uint8_t* Payload = Header + Builder->HeaderLength;
 
-        uint8_t Iv[QUIC_MAX_IV_LENGTH];
-        QuicCryptoCombineIvAndPacketNumber(Builder->Key->Iv, (uint8_t*) &Builder->Metadata->PacketNumber, Iv);
-
         QUIC_STATUS Status;
-        if (QUIC_FAILED(
-            Status =
-            QuicEncrypt(
-                Builder->Key->PacketKey,
-                Iv,
-                Builder->HeaderLength,
-                Header,
-                PayloadLength,
-                Payload))) {
-            QuicConnFatalError(Connection, Status, "Encryption failure");
-            goto Exit;
-        }
-
-        if (Connection->State.HeaderProtectionEnabled) {
+        if (Builder->PacketType == SEND_PACKET_SHORT_HEADER_TYPE) {
+            QUIC_DBG_ASSERT(Builder->BatchCount < QUIC_MAX_CRYPTO_BATCH_COUNT);
 
-            uint8_t* PnStart = Payload - Builder->PacketNumberLength;
+            //
+            // Batch the encryption and header protection for short header
+            // packets, as they all use the same keys.
+            //
 
-            if (Builder->PacketType == SEND_PACKET_SHORT_HEADER_TYPE) {
-                QUIC_DBG_ASSERT(Builder->BatchCount < QUIC_MAX_CRYPTO_BATCH_COUNT);
+            Builder->HeaderBatch[Builder->BatchCount] = Header;
+            Builder->PacketNumberBatch[Builder->BatchCount] =
+                Builder->Metadata->PacketNumber;
+            Builder->PayloadLengthBatch[Builder->BatchCount] = PayloadLength;
 
-                //
-                // Batch the header protection for short header packets.
-                //
+            if (++Builder->BatchCount == QUIC_MAX_CRYPTO_BATCH_COUNT) {
+                QuicPacketBuilderFinalizeCryptoBatch(Builder);
+            }
 
-                QuicCopyMemory(
-                    Builder->CipherBatch + Builder->BatchCount * QUIC_HP_SAMPLE_LENGTH,
-                    PnStart + 4,
-                    QUIC_HP_SAMPLE_LENGTH);
-                Builder->HeaderBatch[Builder->BatchCount] = Header;
+        } else {
+            QUIC_DBG_ASSERT(Builder->BatchCount == 0);
+
+            uint8_t Iv[QUIC_MAX_IV_LENGTH];
+            QuicCryptoCombineIvAndPacketNumber(Builder->Key->Iv, (uint8_t*) &Builder->Metadata->PacketNumber, Iv);
+
+            if (QUIC_FAILED(
+                Status =
+                QuicEncrypt(
+                    Builder->Key->PacketKey,
+                    Iv,
+                    Builder->HeaderLength,
+                    Header,
+                    PayloadLength,
+                    Payload))) {
+                QuicConnFatalError(Connection, Status, "Encryption failure");
+                goto Exit;
+            }
 
-                if (++Builder->BatchCount == QUIC_MAX_CRYPTO_BATCH_COUNT) {
-                    QuicPacketBuilderFinalizeHeaderProtection(Builder);
-                }
+            if (Connection->State.HeaderProtectionEnabled) {
 
-            } else {
-                QUIC_DBG_ASSERT(Builder->BatchCount == 0);
+                uint8_t* PnStart = Payload - Builder->PacketNumberLength;
 
                 //
                 // Individually do header protection for long header packets as
@@ -795,6 +874,13 @@ QuicPacketBuilderFinalize(
             !PacketSpace->AwaitingKeyPhaseConfirmation &&
             Connection->State.HandshakeConfirmed) {
 
+            //
+            // The batched packets must be encrypted with the current keys.
+            //
+            if (Builder->BatchCount != 0) {
+                QuicPacketBuilderFinalizeCryptoBatch(Builder);
+            }
+
             Status = QuicCryptoGenerateNewKeys(Connection);
             if (QUIC_FAILED(Status)) {
                 QuicTraceEvent(
@@ -823,7 +909,21 @@ QuicPacketBuilderFinalize(
     // Track the sent packet.
     //
 
-    Builder->Metadata->SentTime = QuicTimeUs32();
+    if (Builder->DatapathPacing) {
+        //
+        // Packets are tracked as sent when they depart, so all packets in the
+        // batch use the batch's departure time.
+        //
+        if (Builder->BatchDepartureTime == 0) {
+            Builder->BatchDepartureTime =
+                QuicCongestionControlGetDepartureTime(
+                    &Connection->CongestionControl,
+                    QuicTimeUs64());
+        }
+        Builder->Metadata->SentTime = (uint32_t)Builder->BatchDepartureTime;
+    } else {
+        Builder->Metadata->SentTime = QuicTimeUs32();
+    }
     Builder->Metadata->PacketLength =
         Builder->HeaderLength + PayloadLength;
 
@@ -871,9 +971,12 @@ Exit:
             Builder->TotalDatagramsLength += Builder->DatagramLength;
         }
 
-        if (FlushBatchedDatagrams || QuicDataPathBindingIsSendContextFull(Builder->SendContext)) {
+        if (FlushBatchedDatagrams ||
+            QuicDataPathBindingIsSendContextFull(Builder->SendContext) ||
+            (Builder->DatapathPacing &&
+             Builder->TotalDatagramsLength >= Builder->PacingQuantum)) {
             if (Builder->BatchCount != 0) {
-                QuicPacketBuilderFinalizeHeaderProtection(Builder);
+                QuicPacketBuilderFinalizeCryptoBatch(Builder);
             }
             QuicPacketBuilderSendBatch(Builder);
         }
@@ -901,6 +1004,16 @@ QuicPacketBuilderSendBatch(
         "Sending batch. %hu datagrams",
         (uint16_t)Builder->TotalCountDatagrams);
 
+    if (Builder->BatchDepartureTime != 0) {
+        QuicDataPathBindingSetSendDepartureTime(
+            Builder->SendContext,
+            Builder->BatchDepartureTime);
+        QuicCongestionControlAdvanceDepartureTime(
+            &Builder->Connection->CongestionControl,
+            Builder->TotalDatagramsLength);
+        Builder->BatchDepartureTime = 0;
+    }
+
     QuicBindingSend(
         Builder->Path->Binding,
         &Builder->Path->LocalAddress,
@@ -57,6 +57,13 @@ typedef struct QUIC_PACKET_BUILDER {
     //
     uint8_t* HeaderBatch[QUIC_MAX_CRYPTO_BATCH_COUNT];
 
+    //
+    // Packet numbers and payload lengths (including the encryption overhead)
+    // of the batched packets, which are encrypted together.
+    //
+    uint64_t PacketNumberBatch[QUIC_MAX_CRYPTO_BATCH_COUNT];
+    uint16_t PayloadLengthBatch[QUIC_MAX_CRYPTO_BATCH_COUNT];
+
     //
     // Indicates a batch of packets has been sent.
     //
@@ -69,10 +76,16 @@ typedef struct QUIC_PACKET_BUILDER {
     uint8_t PacketBatchRetransmittable : 1;
 
     //
-    // The number of batched packets to do header protection on.
+    // The number of batched packets to encrypt and do header protection on.
     //
     uint8_t BatchCount : 4;
 
+    //
+    // Indicates pacing is done by the datapath, using departure times for
+    // each batch, instead of limiting the send allowance.
+    //
+    uint8_t DatapathPacing : 1;
+
     //
     // The total number of datagrams that have been created.
     //
@@ -136,6 +149,17 @@ typedef struct QUIC_PACKET_BUILDER {
     //
     uint32_t SendAllowance;
 
+    //
+    // The number of bytes to send in each batch when DatapathPacing is set.
+    //
+    uint32_t PacingQuantum;
+
+    //
+    // The departure time of the current batch when DatapathPacing is set;
+    // zero if not determined yet.
+    //
+    uint64_t BatchDepartureTime;
+
     //
     // Represents the metadata of the current QUIC packet.
     //
@@ -224,7 +248,7 @@ QuicPacketBuilderHasAllowance(
 {
     return
         Builder->SendAllowance > 0 ||
-        Builder->Connection->CongestionControl.Exemptions > 0;
+        QuicCongestionControlGetExemptions(&Builder->Connection->CongestionControl) > 0;
 }
 
 //
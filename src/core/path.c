@@ -129,15 +129,17 @@ QuicPathSetValid(
     Path->IsPeerValidated = TRUE;
     QuicPathSetAllowance(Connection, Path, UINT32_MAX);
 
-    if (Path->IsPeerValidated && Reason == QUIC_PATH_VALID_PATH_RESPONSE) {
+    if (Path->IsActive &&
+        Connection->State.Connected &&
+        Reason == QUIC_PATH_VALID_PATH_RESPONSE) {
         //
-        // If the active path was just validated, then let's queue up a PMTUD
-        // packet.
+        // If the active path was just validated, then let's start searching
+        // for its MTU.
         //
         // TODO - If minimum MTU was not validated, we might want to validate
         // that first instead.
         //
-        QuicSendSetSendFlag(&Connection->Send, QUIC_CONN_SEND_FLAG_PMTUD);
+        QuicMtuDiscoveryStartSearch(Connection, Path);
     }
 }
 
@@ -240,6 +242,8 @@ QuicPathSetActive(
             // We assume port only changes don't change the PMTU.
             //
             Path->IsMinMtuValidated = PrevActivePath.IsMinMtuValidated;
+            Path->Mtu = PrevActivePath.Mtu;
+            Path->MtuDiscovery = PrevActivePath.MtuDiscovery;
         }
 
         Connection->Paths[0] = *Path;
@@ -256,4 +260,16 @@ QuicPathSetActive(
     if (!UdpPortChangeOnly) {
         QuicCongestionControlReset(&Connection->CongestionControl);
     }
+
+    if (Connection->Paths[0].MtuDiscovery.State == QUIC_PATH_MTU_SEARCH_STATE_SEARCHING) {
+        //
+        // Any outstanding probe was sent on the previous path, so send it
+        // again on this one.
+        //
+        QuicSendSetSendFlag(&Connection->Send, QUIC_CONN_SEND_FLAG_PMTUD);
+    } else if (Connection->Paths[0].MtuDiscovery.State == QUIC_PATH_MTU_SEARCH_STATE_DISABLED &&
+        Connection->Paths[0].IsPeerValidated &&
+        Connection->State.Connected) {
+        QuicMtuDiscoveryStartSearch(Connection, &Connection->Paths[0]);
+    }
 }
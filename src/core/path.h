@@ -72,6 +72,11 @@ typedef struct QUIC_PATH {
     //
     uint16_t Mtu;
 
+    //
+    // The state of the search for a larger path MTU.
+    //
+    QUIC_MTU_DISCOVERY MtuDiscovery;
+
     //
     // The binding used for sending/receiving UDP packets.
     //
@@ -41,10 +41,13 @@ extern "C" {
 //
 #include "quicdef.h"
 #include "cid.h"
+#include "mtu_discovery.h"
 #include "path.h"
 #include "transport_params.h"
 #include "lookup.h"
 #include "timer_wheel.h"
+#include "crypto_offload.h"
+#include "handshake_offload.h"
 #include "settings.h"
 #include "library.h"
 #include "binding.h"
@@ -60,6 +63,8 @@ extern "C" {
 #include "worker.h"
 #include "ack_tracker.h"
 #include "packet_space.h"
+#include "cubic.h"
+#include "bbr.h"
 #include "congestion_control.h"
 #include "loss_detection.h"
 #include "send.h"
@@ -16,6 +16,7 @@ typedef struct QUIC_CONNECTION QUIC_CONNECTION;
 typedef struct QUIC_STREAM QUIC_STREAM;
 typedef struct QUIC_PACKET_BUILDER QUIC_PACKET_BUILDER;
 typedef struct QUIC_PATH QUIC_PATH;
+typedef struct QUIC_CONGESTION_CONTROL QUIC_CONGESTION_CONTROL;
 
 /*************************************************************
                     PROTOCOL CONSTANTS
@@ -82,6 +83,12 @@ typedef struct QUIC_PATH QUIC_PATH;
 //
 #define QUIC_PERSISTENT_CONGESTION_WINDOW_PACKETS   2
 
+//
+// The number of smoothed RTTs a delivery rate sample is kept as the bandwidth
+// estimate before a smaller sample may replace it.
+//
+#define QUIC_BANDWIDTH_ESTIMATE_WINDOW_RTTS     10
+
 //
 // The minimum number of ACK eliciting packets to receive before overriding ACK
 // delay.
@@ -132,6 +139,30 @@ typedef struct QUIC_PATH QUIC_PATH;
 //
 #define QUIC_MAX_WORKER_QUEUE_DELAY             250
 
+//
+// The minimum amount of time (in us) a connection stays on the worker it was
+// rebalanced to before it may be rebalanced again.
+//
+#define QUIC_WORKER_REBALANCE_HOLD_TIME_US      100000
+
+//
+// The default amount of time (in us) worker and datapath threads spin looking
+// for new work before blocking. Zero disables spinning.
+//
+#define QUIC_DEFAULT_SPIN_TIME_US               0
+
+//
+// The maximum amount of time (in us) threads may be configured to spin before
+// blocking.
+//
+#define QUIC_MAX_SPIN_TIME_US                   10000
+
+//
+// The default amount of time (in us) the kernel busy polls the device queue on
+// socket receives. Zero disables busy polling.
+//
+#define QUIC_DEFAULT_BUSY_POLL_US               0
+
 //
 // The maximum number of simultaneous stateless operations that can be queued on
 // a single worker.
@@ -236,6 +267,32 @@ QUIC_STATIC_ASSERT(IS_POWER_OF_TWO(QUIC_MAX_RANGE_DECODE_ACKS), L"Must be power
 //
 #define QUIC_DEFAULT_PATH_MTU                   QUIC_MIN_MTU
 
+//
+// The number of consecutive lost probes of a given size before path MTU
+// discovery decides that size doesn't fit the path (MAX_PROBES in RFC 8899).
+//
+#define QUIC_DPLPMTUD_MAX_PROBES                3
+
+//
+// Path MTU discovery stops searching once the range of possible MTUs is no
+// larger than this many bytes.
+//
+#define QUIC_DPLPMTUD_SEARCH_GRANULARITY        16
+
+//
+// The time after the path MTU search completes below the maximum MTU until
+// another attempt is made to raise it (PMTU_RAISE_TIMER in RFC 8899).
+//
+#define QUIC_DPLPMTUD_RAISE_TIMER               MS_TO_US(600000) // 10 minutes, in us
+
+//
+// The number of consecutive lost packets larger than the base MTU (without
+// any such packet being acknowledged) or consecutive probe timeouts after
+// which the path is assumed to have become a black hole for the current MTU.
+//
+#define QUIC_DPLPMTUD_BLACK_HOLE_LOST_PACKETS   8
+#define QUIC_DPLPMTUD_BLACK_HOLE_PROBE_TIMEOUTS 3
+
 //
 // The maximum time an app callback can take before we log a warning.
 // Apps should generally take less than a millisecond for each callback if at
@@ -388,6 +445,36 @@ QUIC_STATIC_ASSERT(
 //
 #define QUIC_DEFAULT_DATAGRAM_RECEIVE_ENABLED   FALSE
 
+//
+// The default value for large sends being done without copying the data into
+// the kernel.
+//
+#define QUIC_DEFAULT_ZEROCOPY_SEND_ENABLED      FALSE
+
+//
+// The default value for pacing being offloaded to the kernel with per-send
+// departure times. Off by default, as only some qdiscs (fq) honor them.
+//
+#define QUIC_DEFAULT_DATAPATH_PACING_ENABLED    FALSE
+
+//
+// The default value for spreading a connection's packet encryption and
+// decryption across helper threads. Off by default, as it trades extra CPU
+// for the throughput of a single connection.
+//
+#define QUIC_DEFAULT_CRYPTO_OFFLOAD_ENABLED     FALSE
+
+//
+// The default value for running server TLS handshake processing on the
+// handshake offload threads instead of the connection's worker.
+//
+#define QUIC_DEFAULT_HANDSHAKE_OFFLOAD_ENABLED  FALSE
+
+//
+// The default congestion control algorithm.
+//
+#define QUIC_DEFAULT_CONGESTION_CONTROL_ALGORITHM QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC
+
 //
 // The default max_datagram_frame_length transport parameter value we send. Set
 // to max uint16 to not explicitly limit the length of datagrams.
@@ -431,11 +518,18 @@ QUIC_STATIC_ASSERT(
 #define QUIC_SETTING_MAX_WORKER_QUEUE_DELAY     "MaxWorkerQueueDelayMs"
 #define QUIC_SETTING_MAX_STATELESS_OPERATIONS   "MaxStatelessOperations"
 #define QUIC_SETTING_MAX_OPERATIONS_PER_DRAIN   "MaxOperationsPerDrain"
+#define QUIC_SETTING_SPIN_TIME                  "SpinTimeUs"
+#define QUIC_SETTING_BUSY_POLL                  "BusyPollUs"
 
 #define QUIC_SETTING_SEND_BUFFERING_DEFAULT     "SendBufferingDefault"
 #define QUIC_SETTING_SEND_PACING_DEFAULT        "SendPacingDefault"
 #define QUIC_SETTING_MIGRATION_ENABLED          "MigrationEnabled"
 #define QUIC_SETTING_DATAGRAM_RECEIVE_ENABLED   "DatagramReceiveEnabled"
+#define QUIC_SETTING_ZEROCOPY_SEND_ENABLED      "ZeroCopySendEnabled"
+#define QUIC_SETTING_DATAPATH_PACING_ENABLED    "DatapathPacingEnabled"
+#define QUIC_SETTING_CRYPTO_OFFLOAD_ENABLED     "CryptoOffloadEnabled"
+#define QUIC_SETTING_HANDSHAKE_OFFLOAD_ENABLED  "HandshakeOffloadEnabled"
+#define QUIC_SETTING_CONGESTION_CONTROL_ALGORITHM "CongestionControlAlgorithm"
 
 #define QUIC_SETTING_INITIAL_WINDOW_PACKETS     "InitialWindowPackets"
 #define QUIC_SETTING_SEND_IDLE_TIMEOUT_MS       "SendIdleTimeoutMs"
@@ -349,11 +349,20 @@ QuicRegistrationAcceptConnection(
     uint16_t Index =
         Registration->NoPartitioning ? 0 : QuicPartitionIdGetIndex(Connection->PartitionID);
 
+    if (!QuicWorkerIsOverloaded(&Registration->WorkerPool->Workers[Index])) {
+        return TRUE;
+    }
+
+    if (Registration->NoPartitioning) {
+        return FALSE;
+    }
+
     //
-    // TODO - Look for other worker instead if the proposed worker is overloaded?
+    // The proposed worker is overloaded, but the connection can still be
+    // accepted if any other worker has capacity. It will be placed on the
+    // least loaded worker when it's queued to the registration.
     //
-
-    return !QuicWorkerIsOverloaded(&Registration->WorkerPool->Workers[Index]);
+    return !QuicWorkerPoolIsOverloaded(Registration->WorkerPool);
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -363,16 +372,30 @@ QuicRegistrationQueueNewConnection(
     _In_ QUIC_CONNECTION* Connection
     )
 {
+    QUIC_WORKER_POOL* WorkerPool = Registration->WorkerPool;
     uint16_t Index =
         Registration->NoPartitioning ? 0 : QuicPartitionIdGetIndex(Connection->PartitionID);
 
-    //
-    // TODO - Look for other worker instead if the proposed worker is overloaded?
-    //
+    if (!Registration->NoPartitioning &&
+        QuicWorkerIsOverloaded(&WorkerPool->Workers[Index])) {
+        //
+        // The proposed worker is overloaded, so use the least loaded worker
+        // instead, if it's actually doing better. The connection keeps its
+        // partition ID; the app learns about the new worker's processor via
+        // the IDEAL_PROCESSOR_CHANGED event when the worker is updated.
+        //
+        // The connection's current worker is never picked this way; it's
+        // being moved because it should leave that worker.
+        //
+        uint16_t LeastLoaded = QuicWorkerPoolGetLeastLoadedWorker(WorkerPool);
+        if (&WorkerPool->Workers[LeastLoaded] != Connection->Worker &&
+            WorkerPool->Workers[LeastLoaded].AverageQueueDelay <
+                WorkerPool->Workers[Index].AverageQueueDelay) {
+            Index = LeastLoaded;
+        }
+    }
 
-    QuicWorkerAssignConnection(
-        &Registration->WorkerPool->Workers[Index],
-        Connection);
+    QuicWorkerAssignConnection(&WorkerPool->Workers[Index], Connection);
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
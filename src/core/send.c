@@ -32,10 +32,62 @@ QuicSendInitialize(
     _In_ const QUIC_SETTINGS* Settings
     )
 {
-    QuicListInitializeHead(&Send->SendStreams);
+    for (uint32_t i = 0; i < QUIC_STREAM_PRIORITY_LEVEL_COUNT; ++i) {
+        QuicListInitializeHead(&Send->SendStreams[i]);
+    }
+    QuicListInitializeHead(&Send->BlockedStreams);
     Send->MaxData = Settings->ConnFlowControlWindow;
 }
 
+//
+// Removes all queued streams (active and blocked), releasing Send's references
+// on them.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSendRemoveAllStreams(
+    _In_ QUIC_SEND* Send
+    )
+{
+    for (uint32_t i = 0; i <= QUIC_STREAM_PRIORITY_LEVEL_COUNT; ++i) {
+        QUIC_LIST_ENTRY* Head =
+            i < QUIC_STREAM_PRIORITY_LEVEL_COUNT ?
+                &Send->SendStreams[i] : &Send->BlockedStreams;
+        while (!QuicListIsEmpty(Head)) {
+
+            QUIC_STREAM* Stream =
+                QUIC_CONTAINING_RECORD(
+                    QuicListRemoveHead(Head), QUIC_STREAM, SendLink);
+
+            QUIC_DBG_ASSERT(Stream->SendFlags != 0);
+            Stream->SendFlags = 0;
+            Stream->SendLink.Flink = NULL;
+            Stream->Flags.SendBlocked = FALSE;
+
+            QuicStreamRelease(Stream, QUIC_STREAM_REF_SEND);
+        }
+    }
+}
+
+//
+// Removes a single queued stream from the send (or blocked) lists and releases
+// Send's reference on it.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSendRemoveStream(
+    _In_ QUIC_SEND* Send,
+    _In_ QUIC_STREAM* Stream
+    )
+{
+    UNREFERENCED_PARAMETER(Send);
+    QUIC_DBG_ASSERT(Stream->SendLink.Flink != NULL);
+    QuicListEntryRemove(&Stream->SendLink);
+    Stream->SendLink.Flink = NULL;
+    Stream->Flags.SendBlocked = FALSE;
+    QuicStreamRelease(Stream, QUIC_STREAM_REF_SEND);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicSendUninitialize(
@@ -52,19 +104,7 @@ QuicSendUninitialize(
     //
     // Release all the stream refs.
     //
-    QUIC_LIST_ENTRY* Entry = Send->SendStreams.Flink;
-    while (Entry != &Send->SendStreams) {
-
-        QUIC_STREAM* Stream =
-            QUIC_CONTAINING_RECORD(Entry, QUIC_STREAM, SendLink);
-        QUIC_DBG_ASSERT(Stream->SendFlags != 0);
-
-        Entry = Entry->Flink;
-        Stream->SendFlags = 0;
-        Stream->SendLink.Flink = NULL;
-
-        QuicStreamRelease(Stream, QUIC_STREAM_REF_SEND);
-    }
+    QuicSendRemoveAllStreams(Send);
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -149,7 +189,7 @@ QuicSendQueueFlushForStream(
         // Not previously queued, so add the stream to the end of the queue.
         //
         QUIC_DBG_ASSERT(Stream->SendLink.Flink == NULL);
-        QuicListInsertTail(&Send->SendStreams, &Stream->SendLink);
+        QuicListInsertTail(&Send->SendStreams[Stream->SendPriority], &Stream->SendLink);
         QuicStreamAddRef(Stream, QUIC_STREAM_REF_SEND);
     }
 
@@ -240,18 +280,7 @@ QuicSendSetSendFlag(
         //
         // Remove any queued up streams.
         //
-        while (!QuicListIsEmpty(&Send->SendStreams)) {
-
-            QUIC_STREAM* Stream =
-                QUIC_CONTAINING_RECORD(
-                    QuicListRemoveHead(&Send->SendStreams), QUIC_STREAM, SendLink);
-
-            QUIC_DBG_ASSERT(Stream->SendFlags != 0);
-            Stream->SendFlags = 0;
-            Stream->SendLink.Flink = NULL;
-
-            QuicStreamRelease(Stream, QUIC_STREAM_REF_SEND);
-        }
+        QuicSendRemoveAllStreams(Send);
     }
 
     QuicSendValidate(Send);
@@ -351,6 +380,14 @@ QuicSendSetStreamSendFlag(
         SendFlags &= ~QUIC_STREAM_SEND_FLAG_MAX_DATA;
     }
 
+    if (SendFlags != 0 && Stream->Flags.SendBlocked) {
+        //
+        // New (or renewed, i.e. lost) frames may make the stream sendable
+        // again, so give it another chance.
+        //
+        QuicSendUnblockStream(Send, Stream);
+    }
+
     if ((Stream->SendFlags | SendFlags) != Stream->SendFlags) {
 
         QuicTraceLogStreamVerbose(
@@ -382,8 +419,6 @@ QuicSendClearStreamSendFlag(
     _In_ uint32_t SendFlags
     )
 {
-    UNREFERENCED_PARAMETER(Send);
-
     if (Stream->SendFlags & SendFlags) {
 
         QuicTraceLogStreamVerbose(
@@ -401,10 +436,7 @@ QuicSendClearStreamSendFlag(
             //
             // Since there are no flags left, remove the stream from the queue.
             //
-            QUIC_DBG_ASSERT(Stream->SendLink.Flink != NULL);
-            QuicListEntryRemove(&Stream->SendLink);
-            Stream->SendLink.Flink = NULL;
-            QuicStreamRelease(Stream, QUIC_STREAM_REF_SEND);
+            QuicSendRemoveStream(Send, Stream);
         }
     }
 }
@@ -680,8 +712,7 @@ QuicSendWriteFrames(
                     SourceCid->CID.Data,
                     SourceCid->CID.Length);
                 QUIC_DBG_ASSERT(SourceCid->CID.Length == MsQuicLib.CidTotalLength);
-                QuicBindingGenerateStatelessResetToken(
-                    Builder->Path->Binding,
+                QuicLibraryGenerateStatelessResetToken(
                     SourceCid->CID.Data,
                     Frame.Buffer + SourceCid->CID.Length);
 
@@ -817,6 +848,64 @@ QuicSendCanSendStreamNow(
     return FALSE;
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicSendHasStreams(
+    _In_ const QUIC_SEND* Send
+    )
+{
+    for (uint32_t i = 0; i < QUIC_STREAM_PRIORITY_LEVEL_COUNT; ++i) {
+        if (!QuicListIsEmpty(&Send->SendStreams[i])) {
+            return TRUE;
+        }
+    }
+    return !QuicListIsEmpty(&Send->BlockedStreams);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSendUnblockStream(
+    _In_ QUIC_SEND* Send,
+    _In_ QUIC_STREAM* Stream
+    )
+{
+    if (Stream->Flags.SendBlocked) {
+        QUIC_DBG_ASSERT(Stream->SendLink.Flink != NULL);
+        QuicListEntryRemove(&Stream->SendLink);
+        QuicListInsertTail(&Send->SendStreams[Stream->SendPriority], &Stream->SendLink);
+        Stream->Flags.SendBlocked = FALSE;
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSendUnblockAllStreams(
+    _In_ QUIC_SEND* Send
+    )
+{
+    while (!QuicListIsEmpty(&Send->BlockedStreams)) {
+        QUIC_STREAM* Stream =
+            QUIC_CONTAINING_RECORD(
+                QuicListRemoveHead(&Send->BlockedStreams), QUIC_STREAM, SendLink);
+        QUIC_DBG_ASSERT(Stream->Flags.SendBlocked);
+        QuicListInsertTail(&Send->SendStreams[Stream->SendPriority], &Stream->SendLink);
+        Stream->Flags.SendBlocked = FALSE;
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSendUpdateStreamPriority(
+    _In_ QUIC_SEND* Send,
+    _In_ QUIC_STREAM* Stream
+    )
+{
+    if (Stream->SendLink.Flink != NULL && !Stream->Flags.SendBlocked) {
+        QuicListEntryRemove(&Stream->SendLink);
+        QuicListInsertTail(&Send->SendStreams[Stream->SendPriority], &Stream->SendLink);
+    }
+}
+
 _Success_(return != NULL)
 QUIC_STREAM*
 QuicSendGetNextStream(
@@ -825,41 +914,46 @@ QuicSendGetNextStream(
     )
 {
     QUIC_CONNECTION* Connection = QuicSendGetConnection(Send);
-    QUIC_DBG_ASSERT(!QuicConnIsClosed(Connection) || QuicListIsEmpty(&Send->SendStreams));
+    QUIC_DBG_ASSERT(!QuicConnIsClosed(Connection) || !QuicSendHasStreams(Send));
 
-    QUIC_LIST_ENTRY* Entry = Send->SendStreams.Flink;
-    while (Entry != &Send->SendStreams) {
+    //
+    // Take the first stream that can send from the highest priority level.
+    // Streams that can't send are parked on the blocked list as they are
+    // found, so that each is only checked once until it might be unblocked.
+    //
+    for (int32_t Level = QUIC_STREAM_PRIORITY_LEVEL_COUNT - 1; Level >= 0; --Level) {
 
-        //
-        // TODO: performance: We currently search through blocked
-        // streams repeatedly as we loop.
-        //
+        QUIC_LIST_ENTRY* Head = &Send->SendStreams[Level];
+        while (!QuicListIsEmpty(Head)) {
 
-        QUIC_STREAM* Stream = QUIC_CONTAINING_RECORD(Entry, QUIC_STREAM, SendLink);
+            QUIC_STREAM* Stream = QUIC_CONTAINING_RECORD(Head->Flink, QUIC_STREAM, SendLink);
 
-        //
-        // Make sure, given the current state of the connection and the stream,
-        // that we can use the stream to frame a packet.
-        //
-        if (QuicSendCanSendStreamNow(Stream)) {
+            //
+            // Make sure, given the current state of the connection and the
+            // stream, that we can use the stream to frame a packet.
+            //
+            if (QuicSendCanSendStreamNow(Stream)) {
 
-            if (Connection->State.UseRoundRobinStreamScheduling) {
-                //
-                // Move the stream to the end of the queue.
-                //
-                QuicListEntryRemove(&Stream->SendLink);
-                QuicListInsertTail(&Send->SendStreams, &Stream->SendLink);
+                if (Connection->State.UseRoundRobinStreamScheduling) {
+                    //
+                    // Move the stream to the end of its level's queue.
+                    //
+                    QuicListEntryRemove(&Stream->SendLink);
+                    QuicListInsertTail(Head, &Stream->SendLink);
 
-                *PacketCount = QUIC_STREAM_SEND_BATCH_COUNT;
+                    *PacketCount = QUIC_STREAM_SEND_BATCH_COUNT * Stream->SendWeight;
 
-            } else { // FIFO prioritization scheme
-                *PacketCount = UINT32_MAX;
+                } else { // FIFO prioritization scheme
+                    *PacketCount = UINT32_MAX;
+                }
+
+                return Stream;
             }
 
-            return Stream;
+            QuicListEntryRemove(&Stream->SendLink);
+            QuicListInsertTail(&Send->BlockedStreams, &Stream->SendLink);
+            Stream->Flags.SendBlocked = TRUE;
         }
-
-        Entry = Entry->Flink;
     }
 
     return NULL;
@@ -972,7 +1066,7 @@ QuicSendFlush(
     QuicConnRemoveOutFlowBlockedReason(
         Connection, QUIC_FLOW_BLOCKED_SCHEDULING | QUIC_FLOW_BLOCKED_PACING);
 
-    if (Send->SendFlags == 0 && QuicListIsEmpty(&Send->SendStreams)) {
+    if (Send->SendFlags == 0 && !QuicSendHasStreams(Send)) {
         return TRUE;
     }
 
@@ -1113,9 +1207,7 @@ QuicSendFlush(
                 // If the stream no longer has anything to send, remove it from the
                 // list and release Send's reference on it.
                 //
-                QuicListEntryRemove(&Stream->SendLink);
-                Stream->SendLink.Flink = NULL;
-                QuicStreamRelease(Stream, QUIC_STREAM_REF_SEND);
+                QuicSendRemoveStream(Send, Stream);
                 Stream = NULL;
 
             } else if ((WrotePacketFrames && --StreamPacketCount == 0) ||
@@ -1127,19 +1219,30 @@ QuicSendFlush(
             }
 
         } else if (SendFlags == QUIC_CONN_SEND_FLAG_PMTUD) {
+            if (Path->MtuDiscovery.ProbeSize == 0) {
+                //
+                // The search is no longer waiting on a probe (i.e. the active
+                // path changed since the probe was queued).
+                //
+                Send->SendFlags &= ~QUIC_CONN_SEND_FLAG_PMTUD;
+                continue;
+            }
             if (!QuicPacketBuilderPrepareForPathMtuDiscovery(&Builder)) {
                 break;
             }
             FlushBatchedDatagrams = TRUE;
             Send->SendFlags &= ~QUIC_CONN_SEND_FLAG_PMTUD;
+            Connection->Stats.Send.PathMtuProbeCount++;
             if (Builder.Metadata->FrameCount < QUIC_MAX_FRAMES_PER_PACKET &&
                 Builder.DatagramLength < Builder.Datagram->Length - Builder.EncryptionOverhead) {
                 //
                 // We are doing PMTUD, so make sure there is a PING frame in there, if
-                // we have room, just to make sure we get an ACK.
+                // we have room, just to make sure we get an ACK. The probe is
+                // ack eliciting so that its loss gets detected too.
                 //
                 Builder.Datagram->Buffer[Builder.DatagramLength++] = QUIC_FRAME_PING;
                 Builder.Metadata->Frames[Builder.Metadata->FrameCount++].Type = QUIC_FRAME_PING;
+                Builder.Metadata->Flags.IsAckEliciting = TRUE;
                 WrotePacketFrames = TRUE;
             } else {
                 WrotePacketFrames = FALSE;
@@ -1149,6 +1252,13 @@ QuicSendFlush(
             //
             // Nothing else left to send right now.
             //
+            if (QuicCongestionControlCanSend(&Connection->CongestionControl)) {
+                //
+                // Congestion control would have allowed more, so rate samples
+                // of the packets in flight are limited by the app.
+                //
+                QuicLossDetectionOnAppLimited(&Connection->LossDetection);
+            }
             Result = QUIC_SEND_COMPLETE;
             break;
         }
@@ -220,9 +220,14 @@ typedef struct QUIC_SEND {
     uint32_t SendFlags;
 
     //
-    // List of streams with data or control frames to send.
+    // Lists of streams with data or control frames to send, one per priority
+    // level. Streams found unable to send (i.e. blocked by flow control, the
+    // peer's stream limit or the current keys) are parked on BlockedStreams,
+    // instead of being checked over and over, until something happens that
+    // might unblock them.
     //
-    QUIC_LIST_ENTRY SendStreams;
+    QUIC_LIST_ENTRY SendStreams[QUIC_STREAM_PRIORITY_LEVEL_COUNT];
+    QUIC_LIST_ENTRY BlockedStreams;
 
     //
     // The current token to send with an Initial packet.
@@ -309,6 +314,59 @@ QuicSendQueueFlushForStream(
     _In_ BOOLEAN WasPreviouslyQueued
     );
 
+//
+// Returns TRUE if any streams are queued to send, including blocked ones.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicSendHasStreams(
+    _In_ const QUIC_SEND* Send
+    );
+
+//
+// Moves the stream back to its priority level's send list, if it was parked as
+// blocked. The caller is responsible for queuing a flush.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSendUnblockStream(
+    _In_ QUIC_SEND* Send,
+    _In_ QUIC_STREAM* Stream
+    );
+
+//
+// Moves all blocked streams back to their send lists. Used when connection
+// wide state that blocks all streams changes (i.e. MAX_DATA or new keys).
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSendUnblockAllStreams(
+    _In_ QUIC_SEND* Send
+    );
+
+//
+// Returns the next stream to frame packets for, from the highest priority
+// level with a stream that can send, and the number of packets it may send
+// before the next stream gets a turn. Streams found unable to send are parked
+// on the blocked list.
+//
+_Success_(return != NULL)
+QUIC_STREAM*
+QuicSendGetNextStream(
+    _In_ QUIC_SEND* Send,
+    _Out_ uint32_t* PacketCount
+    );
+
+//
+// Moves a queued stream to the send list for its new priority level.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSendUpdateStreamPriority(
+    _In_ QUIC_SEND* Send,
+    _In_ QUIC_STREAM* Stream
+    );
+
 //
 // Tries to drain all queued data that needs to be sent. Returns TRUE if all the
 // data was drained.
@@ -148,42 +148,53 @@ QuicSendBufferFill(
 
     QUIC_DBG_ASSERT(Connection->Settings.SendBufferingEnabled);
 
-    Entry = Connection->Send.SendStreams.Flink;
-    while (QuicSendBufferHasSpace(&Connection->SendBuffer) && Entry != &(Connection->Send.SendStreams)) {
+    //
+    // Walk the queued streams from the highest priority level down, followed
+    // by the blocked streams.
+    //
+    for (uint32_t i = 0; i <= QUIC_STREAM_PRIORITY_LEVEL_COUNT; ++i) {
+
+        QUIC_LIST_ENTRY* Head =
+            i < QUIC_STREAM_PRIORITY_LEVEL_COUNT ?
+                &Connection->Send.SendStreams[QUIC_STREAM_PRIORITY_LEVEL_COUNT - 1 - i] :
+                &Connection->Send.BlockedStreams;
 
-        QUIC_STREAM* Stream = QUIC_CONTAINING_RECORD(Entry, QUIC_STREAM, SendLink);
-        Entry = Entry->Flink;
+        Entry = Head->Flink;
+        while (QuicSendBufferHasSpace(&Connection->SendBuffer) && Entry != Head) {
+
+            QUIC_STREAM* Stream = QUIC_CONTAINING_RECORD(Entry, QUIC_STREAM, SendLink);
+            Entry = Entry->Flink;
 
 #if DEBUG
-        //
-        // Sanity check: SendBufferBookmark should always point to the
-        // first unbuffered send request (if there is one), and no requests
-        // after SendBufferBookmark should be buffered yet (i.e., buffering
-        // should happen in order).
-        //
-        Req = Stream->SendRequests;
-        while (Req != NULL && !!(Req->Flags & QUIC_SEND_FLAG_BUFFERED)) {
-            Req = Req->Next;
-        }
-        QUIC_DBG_ASSERT(Req == Stream->SendBufferBookmark);
-        while (Req != NULL) {
-            QUIC_DBG_ASSERT(!(Req->Flags & QUIC_SEND_FLAG_BUFFERED));
-            Req = Req->Next;
-        }
+            //
+            // Sanity check: SendBufferBookmark should always point to the
+            // first unbuffered send request (if there is one), and no requests
+            // after SendBufferBookmark should be buffered yet (i.e., buffering
+            // should happen in order).
+            //
+            Req = Stream->SendRequests;
+            while (Req != NULL && !!(Req->Flags & QUIC_SEND_FLAG_BUFFERED)) {
+                Req = Req->Next;
+            }
+            QUIC_DBG_ASSERT(Req == Stream->SendBufferBookmark);
+            while (Req != NULL) {
+                QUIC_DBG_ASSERT(!(Req->Flags & QUIC_SEND_FLAG_BUFFERED));
+                Req = Req->Next;
+            }
 #endif
 
-        Req = Stream->SendBufferBookmark;
+            Req = Stream->SendBufferBookmark;
 
-        //
-        // Buffer as many requests as we can before moving to the next stream.
-        //
-        while (Req != NULL && QuicSendBufferHasSpace(&Connection->SendBuffer)) {
-            if (QUIC_FAILED(QuicStreamSendBufferRequest(Stream, Req))) {
-                return;
+            //
+            // Buffer as many requests as we can before moving to the next stream.
+            //
+            while (Req != NULL && QuicSendBufferHasSpace(&Connection->SendBuffer)) {
+                if (QUIC_FAILED(QuicStreamSendBufferRequest(Stream, Req))) {
+                    return;
+                }
+                Req = Req->Next;
             }
-            Req = Req->Next;
         }
-
     }
 }
 
@@ -258,7 +269,8 @@ QuicSendBufferConnectionAdjust(
     }
 
     const uint64_t NewIdealBytes =
-        QuicGetNextIdealBytes(Connection->CongestionControl.BytesInFlightMax);
+        QuicGetNextIdealBytes(
+            QuicCongestionControlGetBytesInFlightMax(&Connection->CongestionControl));
 
     //
     // TODO: Currently, IdealBytes only grows and never shrinks. Add appropriate
@@ -81,6 +81,7 @@ typedef struct QUIC_SEND_PACKET_FLAGS {
     BOOLEAN IsPMTUD                 : 1;
     BOOLEAN KeyPhase                : 1;
     BOOLEAN SuspectedLost           : 1;
+    BOOLEAN IsAppLimited            : 1;
 #if DEBUG
     BOOLEAN Freed                   : 1;
 #endif
@@ -95,6 +96,16 @@ typedef struct QUIC_SENT_PACKET_METADATA {
     struct QUIC_SENT_PACKET_METADATA *Next;
 
     uint64_t PacketNumber;
+
+    //
+    // Delivery rate estimation state of the connection when the packet was
+    // sent. When the packet is acknowledged, the bytes and time delivered
+    // since then give a sample of the delivery rate.
+    //
+    uint64_t TotalBytesDelivered;
+    uint32_t DeliveredTime; // In microseconds
+    uint32_t FirstSentTime; // In microseconds
+
     uint32_t SentTime; // In microseconds
     uint16_t PacketLength;
     uint8_t PathId;
@@ -32,6 +32,21 @@ QuicSettingsSetDefault(
     if (!Settings->IsSet.DatagramReceiveEnabled) {
         Settings->DatagramReceiveEnabled = QUIC_DEFAULT_DATAGRAM_RECEIVE_ENABLED;
     }
+    if (!Settings->IsSet.ZeroCopySendEnabled) {
+        Settings->ZeroCopySendEnabled = QUIC_DEFAULT_ZEROCOPY_SEND_ENABLED;
+    }
+    if (!Settings->IsSet.DatapathPacingEnabled) {
+        Settings->DatapathPacingEnabled = QUIC_DEFAULT_DATAPATH_PACING_ENABLED;
+    }
+    if (!Settings->IsSet.CryptoOffloadEnabled) {
+        Settings->CryptoOffloadEnabled = QUIC_DEFAULT_CRYPTO_OFFLOAD_ENABLED;
+    }
+    if (!Settings->IsSet.HandshakeOffloadEnabled) {
+        Settings->HandshakeOffloadEnabled = QUIC_DEFAULT_HANDSHAKE_OFFLOAD_ENABLED;
+    }
+    if (!Settings->IsSet.CongestionControlAlgorithm) {
+        Settings->CongestionControlAlgorithm = QUIC_DEFAULT_CONGESTION_CONTROL_ALGORITHM;
+    }
     if (!Settings->IsSet.MaxOperationsPerDrain) {
         Settings->MaxOperationsPerDrain = QUIC_MAX_OPERATIONS_PER_DRAIN;
     }
@@ -98,6 +113,12 @@ QuicSettingsSetDefault(
     if (!Settings->IsSet.ServerResumptionLevel) {
         Settings->ServerResumptionLevel = QUIC_DEFAULT_SERVER_RESUMPTION_LEVEL;
     }
+    if (!Settings->IsSet.SpinTimeUs) {
+        Settings->SpinTimeUs = QUIC_DEFAULT_SPIN_TIME_US;
+    }
+    if (!Settings->IsSet.BusyPollUs) {
+        Settings->BusyPollUs = QUIC_DEFAULT_BUSY_POLL_US;
+    }
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -119,6 +140,21 @@ QuicSettingsCopy(
     if (!Destination->IsSet.DatagramReceiveEnabled) {
         Destination->DatagramReceiveEnabled = Source->DatagramReceiveEnabled;
     }
+    if (!Destination->IsSet.ZeroCopySendEnabled) {
+        Destination->ZeroCopySendEnabled = Source->ZeroCopySendEnabled;
+    }
+    if (!Destination->IsSet.DatapathPacingEnabled) {
+        Destination->DatapathPacingEnabled = Source->DatapathPacingEnabled;
+    }
+    if (!Destination->IsSet.CryptoOffloadEnabled) {
+        Destination->CryptoOffloadEnabled = Source->CryptoOffloadEnabled;
+    }
+    if (!Destination->IsSet.HandshakeOffloadEnabled) {
+        Destination->HandshakeOffloadEnabled = Source->HandshakeOffloadEnabled;
+    }
+    if (!Destination->IsSet.CongestionControlAlgorithm) {
+        Destination->CongestionControlAlgorithm = Source->CongestionControlAlgorithm;
+    }
     if (!Destination->IsSet.MaxOperationsPerDrain) {
         Destination->MaxOperationsPerDrain = Source->MaxOperationsPerDrain;
     }
@@ -185,6 +221,12 @@ QuicSettingsCopy(
     if (!Destination->IsSet.ServerResumptionLevel) {
         Destination->ServerResumptionLevel = Source->ServerResumptionLevel;
     }
+    if (!Destination->IsSet.SpinTimeUs) {
+        Destination->SpinTimeUs = Source->SpinTimeUs;
+    }
+    if (!Destination->IsSet.BusyPollUs) {
+        Destination->BusyPollUs = Source->BusyPollUs;
+    }
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -199,7 +241,17 @@ QuicSettingApply(
     )
 {
     // TODO - Input validation
-    UNREFERENCED_PARAMETER(NewSettingsSize); // TODO - Use to validate new settings
+
+    QUIC_SETTINGS SourceCopy;
+    if (NewSettingsSize < sizeof(QUIC_SETTINGS)) {
+        //
+        // Settings from an app built against a smaller, older QUIC_SETTINGS
+        // don't have the newer fields, so don't read past the end of them.
+        //
+        QuicZeroMemory(&SourceCopy, sizeof(SourceCopy));
+        QuicCopyMemory(&SourceCopy, Source, NewSettingsSize);
+        Source = &SourceCopy;
+    }
 
     if (Source->IsSet.SendBufferingEnabled && (!Destination->IsSet.SendBufferingEnabled || OverWrite)) {
         Destination->SendBufferingEnabled = Source->SendBufferingEnabled;
@@ -217,6 +269,29 @@ QuicSettingApply(
         Destination->DatagramReceiveEnabled = Source->DatagramReceiveEnabled;
         Destination->IsSet.DatagramReceiveEnabled = TRUE;
     }
+    if (Source->IsSet.ZeroCopySendEnabled && (!Destination->IsSet.ZeroCopySendEnabled || OverWrite)) {
+        Destination->ZeroCopySendEnabled = Source->ZeroCopySendEnabled;
+        Destination->IsSet.ZeroCopySendEnabled = TRUE;
+    }
+    if (Source->IsSet.DatapathPacingEnabled && (!Destination->IsSet.DatapathPacingEnabled || OverWrite)) {
+        Destination->DatapathPacingEnabled = Source->DatapathPacingEnabled;
+        Destination->IsSet.DatapathPacingEnabled = TRUE;
+    }
+    if (Source->IsSet.CryptoOffloadEnabled && (!Destination->IsSet.CryptoOffloadEnabled || OverWrite)) {
+        Destination->CryptoOffloadEnabled = Source->CryptoOffloadEnabled;
+        Destination->IsSet.CryptoOffloadEnabled = TRUE;
+    }
+    if (Source->IsSet.HandshakeOffloadEnabled && (!Destination->IsSet.HandshakeOffloadEnabled || OverWrite)) {
+        Destination->HandshakeOffloadEnabled = Source->HandshakeOffloadEnabled;
+        Destination->IsSet.HandshakeOffloadEnabled = TRUE;
+    }
+    if (Source->IsSet.CongestionControlAlgorithm && (!Destination->IsSet.CongestionControlAlgorithm || OverWrite)) {
+        if (Source->CongestionControlAlgorithm >= QUIC_CONGESTION_CONTROL_ALGORITHM_MAX) {
+            return FALSE;
+        }
+        Destination->CongestionControlAlgorithm = Source->CongestionControlAlgorithm;
+        Destination->IsSet.CongestionControlAlgorithm = TRUE;
+    }
     if (Source->IsSet.MaxOperationsPerDrain && (!Destination->IsSet.MaxOperationsPerDrain || OverWrite)) {
         Destination->MaxOperationsPerDrain = Source->MaxOperationsPerDrain;
         Destination->IsSet.MaxOperationsPerDrain = TRUE;
@@ -329,6 +404,17 @@ QuicSettingApply(
         Destination->ServerResumptionLevel = Source->ServerResumptionLevel;
         Destination->IsSet.ServerResumptionLevel = TRUE;
     }
+    if (Source->IsSet.SpinTimeUs && (!Destination->IsSet.SpinTimeUs || OverWrite)) {
+        if (Source->SpinTimeUs > QUIC_MAX_SPIN_TIME_US) {
+            return FALSE;
+        }
+        Destination->SpinTimeUs = Source->SpinTimeUs;
+        Destination->IsSet.SpinTimeUs = TRUE;
+    }
+    if (Source->IsSet.BusyPollUs && (!Destination->IsSet.BusyPollUs || OverWrite)) {
+        Destination->BusyPollUs = Source->BusyPollUs;
+        Destination->IsSet.BusyPollUs = TRUE;
+    }
     return TRUE;
 }
 
@@ -391,6 +477,64 @@ QuicSettingsLoad(
         Settings->DatagramReceiveEnabled = !!Value;
     }
 
+    if (!Settings->IsSet.ZeroCopySendEnabled) {
+        Value = QUIC_DEFAULT_ZEROCOPY_SEND_ENABLED;
+        ValueLen = sizeof(Value);
+        QuicStorageReadValue(
+            Storage,
+            QUIC_SETTING_ZEROCOPY_SEND_ENABLED,
+            (uint8_t*)&Value,
+            &ValueLen);
+        Settings->ZeroCopySendEnabled = !!Value;
+    }
+
+    if (!Settings->IsSet.DatapathPacingEnabled) {
+        Value = QUIC_DEFAULT_DATAPATH_PACING_ENABLED;
+        ValueLen = sizeof(Value);
+        QuicStorageReadValue(
+            Storage,
+            QUIC_SETTING_DATAPATH_PACING_ENABLED,
+            (uint8_t*)&Value,
+            &ValueLen);
+        Settings->DatapathPacingEnabled = !!Value;
+    }
+
+    if (!Settings->IsSet.CryptoOffloadEnabled) {
+        Value = QUIC_DEFAULT_CRYPTO_OFFLOAD_ENABLED;
+        ValueLen = sizeof(Value);
+        QuicStorageReadValue(
+            Storage,
+            QUIC_SETTING_CRYPTO_OFFLOAD_ENABLED,
+            (uint8_t*)&Value,
+            &ValueLen);
+        Settings->CryptoOffloadEnabled = !!Value;
+    }
+
+    if (!Settings->IsSet.HandshakeOffloadEnabled) {
+        Value = QUIC_DEFAULT_HANDSHAKE_OFFLOAD_ENABLED;
+        ValueLen = sizeof(Value);
+        QuicStorageReadValue(
+            Storage,
+            QUIC_SETTING_HANDSHAKE_OFFLOAD_ENABLED,
+            (uint8_t*)&Value,
+            &ValueLen);
+        Settings->HandshakeOffloadEnabled = !!Value;
+    }
+
+    if (!Settings->IsSet.CongestionControlAlgorithm) {
+        Value = QUIC_DEFAULT_CONGESTION_CONTROL_ALGORITHM;
+        ValueLen = sizeof(Value);
+        QuicStorageReadValue(
+            Storage,
+            QUIC_SETTING_CONGESTION_CONTROL_ALGORITHM,
+            (uint8_t*)&Value,
+            &ValueLen);
+        if (Value >= QUIC_CONGESTION_CONTROL_ALGORITHM_MAX) {
+            Value = QUIC_DEFAULT_CONGESTION_CONTROL_ALGORITHM;
+        }
+        Settings->CongestionControlAlgorithm = (uint16_t)Value;
+    }
+
     if (!Settings->IsSet.MaxOperationsPerDrain) {
         Value = QUIC_MAX_OPERATIONS_PER_DRAIN;
         ValueLen = sizeof(Value);
@@ -624,6 +768,27 @@ QuicSettingsLoad(
         }
         Settings->ServerResumptionLevel = (uint8_t)Value;
     }
+
+    if (!Settings->IsSet.SpinTimeUs) {
+        ValueLen = sizeof(Settings->SpinTimeUs);
+        QuicStorageReadValue(
+            Storage,
+            QUIC_SETTING_SPIN_TIME,
+            (uint8_t*)&Settings->SpinTimeUs,
+            &ValueLen);
+        if (Settings->SpinTimeUs > QUIC_MAX_SPIN_TIME_US) {
+            Settings->SpinTimeUs = QUIC_MAX_SPIN_TIME_US;
+        }
+    }
+
+    if (!Settings->IsSet.BusyPollUs) {
+        ValueLen = sizeof(Settings->BusyPollUs);
+        QuicStorageReadValue(
+            Storage,
+            QUIC_SETTING_BUSY_POLL,
+            (uint8_t*)&Settings->BusyPollUs,
+            &ValueLen);
+    }
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -636,6 +801,11 @@ QuicSettingsDump(
     QuicTraceLogVerbose(SettingDumpPacingEnabled,           "[sett] PacingEnabled          = %hhu", Settings->PacingEnabled);
     QuicTraceLogVerbose(SettingDumpMigrationEnabled,        "[sett] MigrationEnabled       = %hhu", Settings->MigrationEnabled);
     QuicTraceLogVerbose(SettingDumpDatagramReceiveEnabled,  "[sett] DatagramReceiveEnabled = %hhu", Settings->DatagramReceiveEnabled);
+    QuicTraceLogVerbose(SettingDumpZeroCopySendEnabled,     "[sett] ZeroCopySendEnabled    = %hhu", Settings->ZeroCopySendEnabled);
+    QuicTraceLogVerbose(SettingDumpDatapathPacingEnabled,   "[sett] DatapathPacingEnabled  = %hhu", Settings->DatapathPacingEnabled);
+    QuicTraceLogVerbose(SettingDumpCryptoOffloadEnabled,    "[sett] CryptoOffloadEnabled   = %hhu", Settings->CryptoOffloadEnabled);
+    QuicTraceLogVerbose(SettingDumpHandshakeOffloadEnabled, "[sett] HandshakeOffloadEnabled = %hhu", Settings->HandshakeOffloadEnabled);
+    QuicTraceLogVerbose(SettingDumpCongestionControlAlgorithm, "[sett] CongestionControlAlgorithm = %hu", Settings->CongestionControlAlgorithm);
     QuicTraceLogVerbose(SettingDumpMaxOperationsPerDrain,   "[sett] MaxOperationsPerDrain  = %hhu", Settings->MaxOperationsPerDrain);
     QuicTraceLogVerbose(SettingDumpRetryMemoryLimit,        "[sett] RetryMemoryLimit       = %hu", Settings->RetryMemoryLimit);
     QuicTraceLogVerbose(SettingDumpLoadBalancingMode,       "[sett] LoadBalancingMode      = %hu", Settings->LoadBalancingMode);
@@ -658,6 +828,8 @@ QuicSettingsDump(
     QuicTraceLogVerbose(SettingDumpConnFlowControlWindow,   "[sett] ConnFlowControlWindow  = %u", Settings->ConnFlowControlWindow);
     QuicTraceLogVerbose(SettingDumpMaxBytesPerKey,          "[sett] MaxBytesPerKey         = %llu", Settings->MaxBytesPerKey);
     QuicTraceLogVerbose(SettingDumpServerResumptionLevel,   "[sett] ServerResumptionLevel  = %hhu", Settings->ServerResumptionLevel);
+    QuicTraceLogVerbose(SettingDumpSpinTimeUs,              "[sett] SpinTimeUs             = %u", Settings->SpinTimeUs);
+    QuicTraceLogVerbose(SettingDumpBusyPollUs,              "[sett] BusyPollUs             = %u", Settings->BusyPollUs);
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -669,7 +841,12 @@ QuicSettingsDumpNew(
         const QUIC_SETTINGS* Settings
     )
 {
-    UNREFERENCED_PARAMETER(SettingsSize); // TODO - Use when reading settings
+    QUIC_SETTINGS SettingsCopy;
+    if (SettingsSize < sizeof(QUIC_SETTINGS)) {
+        QuicZeroMemory(&SettingsCopy, sizeof(SettingsCopy));
+        QuicCopyMemory(&SettingsCopy, Settings, SettingsSize);
+        Settings = &SettingsCopy;
+    }
 
     if (Settings->IsSet.SendBufferingEnabled) {
         QuicTraceLogVerbose(SettingDumpSendBufferingEnabled,    "[sett] SendBufferingEnabled   = %hhu", Settings->SendBufferingEnabled);
@@ -683,6 +860,21 @@ QuicSettingsDumpNew(
     if (Settings->IsSet.DatagramReceiveEnabled) {
         QuicTraceLogVerbose(SettingDumpDatagramReceiveEnabled,  "[sett] DatagramReceiveEnabled = %hhu", Settings->DatagramReceiveEnabled);
     }
+    if (Settings->IsSet.ZeroCopySendEnabled) {
+        QuicTraceLogVerbose(SettingDumpZeroCopySendEnabled,     "[sett] ZeroCopySendEnabled    = %hhu", Settings->ZeroCopySendEnabled);
+    }
+    if (Settings->IsSet.DatapathPacingEnabled) {
+        QuicTraceLogVerbose(SettingDumpDatapathPacingEnabled,   "[sett] DatapathPacingEnabled  = %hhu", Settings->DatapathPacingEnabled);
+    }
+    if (Settings->IsSet.CryptoOffloadEnabled) {
+        QuicTraceLogVerbose(SettingDumpCryptoOffloadEnabled,    "[sett] CryptoOffloadEnabled   = %hhu", Settings->CryptoOffloadEnabled);
+    }
+    if (Settings->IsSet.HandshakeOffloadEnabled) {
+        QuicTraceLogVerbose(SettingDumpHandshakeOffloadEnabled, "[sett] HandshakeOffloadEnabled = %hhu", Settings->HandshakeOffloadEnabled);
+    }
+    if (Settings->IsSet.CongestionControlAlgorithm) {
+        QuicTraceLogVerbose(SettingDumpCongestionControlAlgorithm, "[sett] CongestionControlAlgorithm = %hu", Settings->CongestionControlAlgorithm);
+    }
     if (Settings->IsSet.MaxOperationsPerDrain) {
         QuicTraceLogVerbose(SettingDumpMaxOperationsPerDrain,   "[sett] MaxOperationsPerDrain  = %hhu", Settings->MaxOperationsPerDrain);
     }
@@ -749,4 +941,10 @@ QuicSettingsDumpNew(
     if (Settings->IsSet.ServerResumptionLevel) {
         QuicTraceLogVerbose(SettingDumpServerResumptionLevel,   "[sett] ServerResumptionLevel  = %hhu", Settings->ServerResumptionLevel);
     }
+    if (Settings->IsSet.SpinTimeUs) {
+        QuicTraceLogVerbose(SettingDumpSpinTimeUs,              "[sett] SpinTimeUs             = %u", Settings->SpinTimeUs);
+    }
+    if (Settings->IsSet.BusyPollUs) {
+        QuicTraceLogVerbose(SettingDumpBusyPollUs,              "[sett] BusyPollUs             = %u", Settings->BusyPollUs);
+    }
 }
@@ -5,6 +5,13 @@
 
 --*/
 
+//
+// The size of the original QUIC_SETTINGS struct. Apps built against it can
+// still set and query settings; the fields added since are treated as not set.
+//
+#define QUIC_SETTINGS_V1_SIZE \
+    (uint32_t)FIELD_OFFSET(QUIC_SETTINGS, SpinTimeUs)
+
 //
 // Initializes all settings to default values, if not already set by the app.
 //
@@ -48,9 +48,10 @@ QuicStreamInitialize(
     Stream->Flags.SendEnabled = TRUE;
     Stream->Flags.ReceiveEnabled = TRUE;
     Stream->RecvMaxLength = UINT64_MAX;
+    Stream->SendPriority = QUIC_STREAM_PRIORITY_LEVEL_DEFAULT;
+    Stream->SendWeight = QUIC_STREAM_PRIORITY_WEIGHT_DEFAULT;
     Stream->RefCount = 1;
     Stream->SendRequestsTail = &Stream->SendRequests;
-    QuicDispatchLockInitialize(&Stream->ApiSendRequestLock);
     QuicRefInitialize(&Stream->RefCount);
     QuicRangeInitialize(
         QUIC_MAX_RANGE_ALLOC_SIZE,
@@ -82,6 +83,7 @@ QuicStreamInitialize(
             Stream->Flags.LocalCloseAcked = TRUE;
             Stream->Flags.SendEnabled = FALSE;
             Stream->Flags.HandleSendShutdown = TRUE;
+            Stream->ApiSendRequests = QUIC_API_SEND_REQUESTS_CLOSED;
         }
     }
 
@@ -136,7 +138,6 @@ QuicStreamInitialize(
 Exit:
 
     if (Stream) {
-        QuicDispatchLockUninitialize(&Stream->ApiSendRequestLock);
         Stream->Flags.Freed = TRUE;
         QuicPoolFree(&Worker->StreamPool, Stream);
     }
@@ -165,7 +166,9 @@ QuicStreamFree(
 
     Stream->Flags.Uninitialized = TRUE;
 
-    QUIC_TEL_ASSERT(Stream->ApiSendRequests == NULL);
+    QUIC_TEL_ASSERT(
+        Stream->ApiSendRequests == NULL ||
+        Stream->ApiSendRequests == QUIC_API_SEND_REQUESTS_CLOSED);
     QUIC_TEL_ASSERT(Stream->SendRequests == NULL);
 
 #if DEBUG
@@ -176,7 +179,6 @@ QuicStreamFree(
 
     QuicRecvBufferUninitialize(&Stream->RecvBuffer);
     QuicRangeUninitialize(&Stream->SparseAckRanges);
-    QuicDispatchLockUninitialize(&Stream->ApiSendRequestLock);
     QuicRefUninitialize(&Stream->RefCount);
 
     if (Stream->RecvBuffer.PreallocatedBuffer) {
@@ -526,11 +528,47 @@ QuicStreamParamSet(
         const void* Buffer
     )
 {
-    UNREFERENCED_PARAMETER(Stream);
-    UNREFERENCED_PARAMETER(Param);
-    UNREFERENCED_PARAMETER(BufferLength);
-    UNREFERENCED_PARAMETER(Buffer);
-    return QUIC_STATUS_INVALID_PARAMETER;
+    QUIC_STATUS Status;
+
+    switch (Param)
+    {
+    case QUIC_PARAM_STREAM_PRIORITY: {
+
+        if (BufferLength != sizeof(QUIC_STREAM_PRIORITY)) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        const QUIC_STREAM_PRIORITY* Priority = (const QUIC_STREAM_PRIORITY*)Buffer;
+        if (Priority->Level >= QUIC_STREAM_PRIORITY_LEVEL_COUNT ||
+            Priority->Weight == 0) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        QuicTraceLogStreamInfo(
+            UpdatePriority,
+            Stream,
+            "New send priority = %hhu, weight = %hhu",
+            Priority->Level,
+            Priority->Weight);
+
+        Stream->SendWeight = Priority->Weight;
+        if (Stream->SendPriority != Priority->Level) {
+            Stream->SendPriority = Priority->Level;
+            QuicSendUpdateStreamPriority(&Stream->Connection->Send, Stream);
+        }
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    default:
+        Status = QUIC_STATUS_INVALID_PARAMETER;
+        break;
+    }
+
+    return Status;
 }
 
 QUIC_STATUS
@@ -615,6 +653,26 @@ QuicStreamParamGet(
         Status = QUIC_STATUS_SUCCESS;
         break;
 
+    case QUIC_PARAM_STREAM_PRIORITY:
+
+        if (*BufferLength < sizeof(QUIC_STREAM_PRIORITY)) {
+            *BufferLength = sizeof(QUIC_STREAM_PRIORITY);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *BufferLength = sizeof(QUIC_STREAM_PRIORITY);
+        ((QUIC_STREAM_PRIORITY*)Buffer)->Level = Stream->SendPriority;
+        ((QUIC_STREAM_PRIORITY*)Buffer)->Weight = Stream->SendWeight;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
     default:
         Status = QUIC_STATUS_INVALID_PARAMETER;
         break;
@@ -99,6 +99,11 @@ typedef struct QUIC_SEND_REQUEST {
 
 } QUIC_SEND_REQUEST;
 
+//
+// Value of a stream's ApiSendRequests once no more sends may be queued.
+//
+#define QUIC_API_SEND_REQUESTS_CLOSED ((QUIC_SEND_REQUEST*)(uintptr_t)1)
+
 //
 // Different flags of a stream.
 // Note - Keep quictypes.h's copy up to date.
@@ -114,6 +119,7 @@ typedef union QUIC_STREAM_FLAGS {
 
         BOOLEAN SendOpen                : 1;    // Send a STREAM frame immediately on start.
         BOOLEAN SendOpenAcked           : 1;    // A STREAM frame has been acknowledged.
+        BOOLEAN SendBlocked             : 1;    // Queued on the blocked streams list.
 
         BOOLEAN LocalNotAllowed         : 1;    // Peer's unidirectional stream.
         BOOLEAN LocalCloseFin           : 1;    // Locally closed (graceful).
@@ -209,7 +215,7 @@ typedef struct QUIC_STREAM {
     };
 
     //
-    // The list entry in the output module's send list.
+    // The list entry in the output module's send (or blocked) stream lists.
     //
     QUIC_LIST_ENTRY SendLink;
 
@@ -246,6 +252,12 @@ typedef struct QUIC_STREAM {
     //
     uint8_t OutFlowBlockedReasons; // Set of QUIC_FLOW_BLOCKED_* flags
 
+    //
+    // The send priority level and round robin weight (QUIC_STREAM_PRIORITY).
+    //
+    uint8_t SendPriority;
+    uint8_t SendWeight;
+
     //
     // Send State
     //
@@ -258,10 +270,11 @@ typedef struct QUIC_STREAM {
     //
     // API calls to StreamSend queue the send request here and then queue the
     // send operation. That operation moves the send request onto the
-    // SendRequests list.
+    // SendRequests list. This is a lock-free stack (newest first), which the
+    // worker takes all at once; it's set to QUIC_API_SEND_REQUESTS_CLOSED once
+    // the send direction is shut down.
     //
-    QUIC_DISPATCH_LOCK ApiSendRequestLock;
-    QUIC_SEND_REQUEST* ApiSendRequests;
+    QUIC_SEND_REQUEST* volatile ApiSendRequests;
 
     //
     // Queued send requests.
@@ -701,6 +714,17 @@ QuicStreamIndicateSendShutdownComplete(
     _In_ BOOLEAN GracefulShutdown
     );
 
+//
+// Takes all the send requests queued by the app, in the order they were
+// queued. If Close is TRUE, any further sends by the app are rejected.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_SEND_REQUEST*
+QuicStreamTakeApiSendRequests(
+    _In_ QUIC_STREAM* Stream,
+    _In_ BOOLEAN Close
+    );
+
 //
 // Indicates data has been queued up to be sent out on the stream.
 //
@@ -744,14 +768,17 @@ QuicStreamOnLoss(
     );
 
 //
-// Called when an ACK is received for a stream frame.
+// Called when an ACK is received for a stream frame, or for a contiguous range
+// of stream data coalesced from several STREAM frames.
 //
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicStreamOnAck(
     _In_ QUIC_STREAM* Stream,
     _In_ QUIC_SEND_PACKET_FLAGS PacketFlags,
-    _In_ QUIC_SENT_FRAME_METADATA* FrameMetadata
+    _In_ uint64_t Offset,
+    _In_ uint32_t Length,
+    _In_ uint8_t FrameFlags // QUIC_SENT_FRAME_FLAG_*
     );
 
 //
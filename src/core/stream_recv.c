@@ -508,6 +508,7 @@ QuicStreamRecv(
                 &Stream->Connection->Send,
                 Stream,
                 QUIC_STREAM_SEND_FLAG_DATA_BLOCKED);
+            QuicSendUnblockStream(&Stream->Connection->Send, Stream);
             QuicStreamSendDumpState(Stream);
 
             QuicSendQueueFlush(
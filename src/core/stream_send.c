@@ -82,7 +82,7 @@ QuicStreamIndicateSendShutdownComplete(
     )
 {
     QUIC_DBG_ASSERT(!Stream->Flags.SendEnabled);
-    QUIC_DBG_ASSERT(Stream->ApiSendRequests == NULL);
+    QUIC_DBG_ASSERT(Stream->ApiSendRequests == QUIC_API_SEND_REQUESTS_CLOSED);
     QUIC_DBG_ASSERT(Stream->SendRequests == NULL);
 
     if (!Stream->Flags.HandleSendShutdown) {
@@ -116,11 +116,8 @@ QuicStreamSendShutdown(
         goto Exit;
     }
 
-    QuicDispatchLockAcquire(&Stream->ApiSendRequestLock);
     Stream->Flags.SendEnabled = FALSE;
-    QUIC_SEND_REQUEST* ApiSendRequests = Stream->ApiSendRequests;
-    Stream->ApiSendRequests = NULL;
-    QuicDispatchLockRelease(&Stream->ApiSendRequestLock);
+    QUIC_SEND_REQUEST* ApiSendRequests = QuicStreamTakeApiSendRequests(Stream, TRUE);
 
     if (Graceful) {
         QUIC_DBG_ASSERT(!Silent);
@@ -476,16 +473,61 @@ QuicStreamSendBufferRequest(
     return QUIC_STATUS_SUCCESS;
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_SEND_REQUEST*
+QuicStreamTakeApiSendRequests(
+    _In_ QUIC_STREAM* Stream,
+    _In_ BOOLEAN Close
+    )
+{
+    QUIC_SEND_REQUEST* Head;
+
+    if (Close) {
+        Head =
+            (QUIC_SEND_REQUEST*)InterlockedExchangePointer(
+                (void* volatile*)&Stream->ApiSendRequests,
+                QUIC_API_SEND_REQUESTS_CLOSED);
+    } else {
+        //
+        // Can't just swap in NULL, as that would reopen a closed queue.
+        //
+        do {
+            Head = Stream->ApiSendRequests;
+            if (Head == QUIC_API_SEND_REQUESTS_CLOSED) {
+                break;
+            }
+        } while (InterlockedCompareExchangePointer(
+                    (void* volatile*)&Stream->ApiSendRequests,
+                    NULL,
+                    Head) != Head);
+    }
+
+    if (Head == QUIC_API_SEND_REQUESTS_CLOSED) {
+        return NULL;
+    }
+
+    //
+    // The app pushes new requests onto the head, so reverse the list to get
+    // them back in the order they were queued.
+    //
+    QUIC_SEND_REQUEST* ApiSendRequests = NULL;
+    while (Head != NULL) {
+        QUIC_SEND_REQUEST* Next = Head->Next;
+        Head->Next = ApiSendRequests;
+        ApiSendRequests = Head;
+        Head = Next;
+    }
+
+    return ApiSendRequests;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicStreamSendFlush(
     _In_ QUIC_STREAM* Stream
     )
 {
-    QuicDispatchLockAcquire(&Stream->ApiSendRequestLock);
-    QUIC_SEND_REQUEST* ApiSendRequests = Stream->ApiSendRequests;
-    Stream->ApiSendRequests = NULL;
-    QuicDispatchLockRelease(&Stream->ApiSendRequestLock);
+    QUIC_SEND_REQUEST* ApiSendRequests = QuicStreamTakeApiSendRequests(Stream, FALSE);
     int64_t TotalBytesSent = 0;
 
     BOOLEAN Start = FALSE;
@@ -1291,12 +1333,11 @@ void
 QuicStreamOnAck(
     _In_ QUIC_STREAM* Stream,
     _In_ QUIC_SEND_PACKET_FLAGS PacketFlags,
-    _In_ QUIC_SENT_FRAME_METADATA* FrameMetadata
+    _In_ uint64_t Offset,
+    _In_ uint32_t Length,
+    _In_ uint8_t FrameFlags
     )
 {
-    uint64_t Offset = FrameMetadata->StreamOffset;
-    uint32_t Length = FrameMetadata->StreamLength;
-
     //
     // The offset directly following this frame.
     //
@@ -1312,7 +1353,7 @@ QuicStreamOnAck(
         "Received ack for %d bytes, offset=%llu, FF=0x%hx",
         Length,
         Offset,
-        FrameMetadata->Flags);
+        FrameFlags);
 
     if (PacketFlags.KeyType == QUIC_PACKET_KEY_0_RTT &&
         Stream->Sent0Rtt < FollowingOffset) {
@@ -1333,7 +1374,7 @@ QuicStreamOnAck(
         RemoveSendFlags |= QUIC_STREAM_SEND_FLAG_OPEN;
     }
 
-    if (FrameMetadata->Flags & QUIC_SENT_FRAME_FLAG_STREAM_FIN) {
+    if (FrameFlags & QUIC_SENT_FRAME_FLAG_STREAM_FIN) {
         Stream->Flags.FinAcked = TRUE;
         RemoveSendFlags |= QUIC_STREAM_SEND_FLAG_FIN;
     }
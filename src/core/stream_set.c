@@ -313,6 +313,7 @@ QuicStreamSetInitializeTransportParameters(
             if (FlowBlockedFlagsToRemove) {
                 QuicStreamRemoveOutFlowBlockedReason(
                     Stream, FlowBlockedFlagsToRemove);
+                QuicSendUnblockStream(&Connection->Send, Stream);
                 QuicStreamSendDumpState(Stream);
                 MightBeUnblocked = TRUE;
             }
@@ -388,6 +389,7 @@ QuicStreamSetUpdateMaxStreams(
                     FlushSend = TRUE;
                     QuicStreamRemoveOutFlowBlockedReason(
                         Stream, QUIC_FLOW_BLOCKED_STREAM_ID_FLOW_CONTROL);
+                    QuicSendUnblockStream(&Connection->Send, Stream);
                 }
             }
             QuicHashtableEnumerateEnd(StreamSet->StreamTable, &Enumerator);
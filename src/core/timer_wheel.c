@@ -21,27 +21,34 @@ Abstract:
         The timer wheel itself doesn't care about anything other than that value
         from the connection.
 
-        Slots - This is a very simple hash table of time slots. Each slot holds
-        all connections with a next expiration time modulo the total slot count.
-
-        Slot Entry - Each slot is made up of a sorted, doubly-linked list of
-        connections.
-
-        Next Expiration - Along with all the connections in the timer wheel, the
-        timer wheel also explicitly keeps track of the next expiration time and
-        connection for quick next delay calculations.
-
-    With these parts, the timer wheel is able to support insertion, update and
-    removal of any number of timers (and their associated connection).
-
-    Insertion or update consists of getting the next expiration time from the
-    connection, calculating the correct slot and then doing an insert into the
-    slot's sorted list of connections. Additionally, the next expiration is
-    updated if the new timer is the soonest to expire.
-
-    Removal consists of removing the connection from the doubly-linked list and
-    updating the timer wheel's next expiration if this connection was currently
-    next to expire.
+        Levels - The timer wheel is hierarchical. Expiration times are in
+        microseconds and each level covers the next QUIC_TIMER_WHEEL_LEVEL_BITS
+        bits of the time, so level 0 has a granularity of 1us, level 1 of 64us,
+        level 2 of ~4ms, level 3 of ~262ms and so on, up to the full 64-bit
+        range.
+
+        Slots - Each level is an array of QUIC_TIMER_WHEEL_SLOT_COUNT slots,
+        each an unsorted, doubly-linked list of connections. A connection is
+        placed in the lowest level where its expiration time shares all the
+        higher bits with the wheel's current time, in the slot given by that
+        level's bits of the expiration time. A per-level bitmap tracks which
+        slots are non-empty.
+
+        Next Expiration - The timer wheel also keeps track of the earliest time
+        the next timer may expire, for quick next delay calculations. Since the
+        slots are unsorted, this is the start time of the first non-empty slot.
+        That is exact in level 0 and a lower bound in the higher levels.
+
+    Insertion, update and removal are all O(1): computing the level and slot
+    only takes the expiration time and the wheel's current time, and the slot
+    lists are unsorted.
+
+    Processing expired timers advances the wheel's current time. Any slot
+    that is now entirely in the past holds only expired connections. The one
+    slot per level that contains the new current time is 'cascaded': each of
+    its connections is either expired or reinserted into a lower level. So
+    each connection is moved at most once per level over its lifetime in the
+    wheel.
 
 --*/
 
@@ -51,20 +58,31 @@ Abstract:
 #endif
 
 //
-// The initial count of slots in the timer wheel.
+// Helper to get the slot list head for a given level and slot index.
 //
-#define QUIC_TIMER_WHEEL_INITIAL_SLOT_COUNT     32
+#define TIMER_WHEEL_SLOT(TimerWheel, Level, Index) \
+    (&(TimerWheel)->Slots[((Level) * QUIC_TIMER_WHEEL_SLOT_COUNT) + (Index)])
 
 //
-// On average, the max number of connections per slot.
+// Returns the index of the lowest set bit. Value must be non-zero.
 //
-#define QUIC_TIMER_WHEEL_MAX_LOAD_FACTOR    32
-
-//
-// Helper to get the slot index for a given time.
-//
-#define TIME_TO_SLOT_INDEX(TimerWheel, TimeUs) \
-    ((US_TO_MS(TimeUs) / 1000) % (TimerWheel)->SlotCount)
+uint32_t
+QuicTimerWheelLowestBit(
+    _In_ uint64_t Value
+    )
+{
+    QUIC_DBG_ASSERT(Value != 0);
+#ifdef _MSC_VER
+    unsigned long Index;
+    if (_BitScanForward(&Index, (unsigned long)Value)) {
+        return (uint32_t)Index;
+    }
+    _BitScanForward(&Index, (unsigned long)(Value >> 32));
+    return (uint32_t)Index + 32;
+#else
+    return (uint32_t)__builtin_ctzll(Value);
+#endif
+}
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
@@ -72,21 +90,24 @@ QuicTimerWheelInitialize(
     _Inout_ QUIC_TIMER_WHEEL* TimerWheel
     )
 {
+    const uint32_t SlotCount =
+        QUIC_TIMER_WHEEL_LEVEL_COUNT * QUIC_TIMER_WHEEL_SLOT_COUNT;
+
     TimerWheel->NextExpirationTime = UINT64_MAX;
     TimerWheel->ConnectionCount = 0;
-    TimerWheel->NextConnection = NULL;
-    TimerWheel->SlotCount = QUIC_TIMER_WHEEL_INITIAL_SLOT_COUNT;
+    TimerWheel->CurrentTime = QuicTimeUs64();
+    QuicZeroMemory(TimerWheel->SlotBitmaps, sizeof(TimerWheel->SlotBitmaps));
     TimerWheel->Slots =
-        QUIC_ALLOC_NONPAGED(QUIC_TIMER_WHEEL_INITIAL_SLOT_COUNT * sizeof(QUIC_LIST_ENTRY), QUIC_POOL_TIMERWHEEL);
+        QUIC_ALLOC_NONPAGED(SlotCount * sizeof(QUIC_LIST_ENTRY), QUIC_POOL_TIMERWHEEL);
     if (TimerWheel->Slots == NULL) {
         QuicTraceEvent(
             AllocFailure,
             "Allocation of '%s' failed. (%llu bytes)", "timerwheel slots",
-            QUIC_TIMER_WHEEL_INITIAL_SLOT_COUNT * sizeof(QUIC_LIST_ENTRY));
+            SlotCount * sizeof(QUIC_LIST_ENTRY));
         return QUIC_STATUS_OUT_OF_MEMORY;
     }
 
-    for (uint32_t i = 0; i < TimerWheel->SlotCount; ++i) {
+    for (uint32_t i = 0; i < SlotCount; ++i) {
         QuicListInitializeHead(&TimerWheel->Slots[i]);
     }
 
@@ -100,7 +121,9 @@ QuicTimerWheelUninitialize(
     )
 {
     if (TimerWheel->Slots != NULL) {
-        for (uint32_t i = 0; i < TimerWheel->SlotCount; ++i) {
+        const uint32_t SlotCount =
+            QUIC_TIMER_WHEEL_LEVEL_COUNT * QUIC_TIMER_WHEEL_SLOT_COUNT;
+        for (uint32_t i = 0; i < SlotCount; ++i) {
             QUIC_LIST_ENTRY* ListHead = &TimerWheel->Slots[i];
             QUIC_LIST_ENTRY* Entry = ListHead->Flink;
             while (Entry != ListHead) {
@@ -115,142 +138,136 @@ QuicTimerWheelUninitialize(
             QUIC_TEL_ASSERT(QuicListIsEmpty(&TimerWheel->Slots[i]));
         }
         QUIC_TEL_ASSERT(TimerWheel->ConnectionCount == 0);
-        QUIC_TEL_ASSERT(TimerWheel->NextConnection == NULL);
         QUIC_TEL_ASSERT(TimerWheel->NextExpirationTime == UINT64_MAX);
 
         QUIC_FREE(TimerWheel->Slots, QUIC_POOL_TIMERWHEEL);
     }
 }
 
+//
+// Called to recalculate NextExpirationTime when a slot is emptied or the
+// current time advances.
+//
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
-QuicTimerWheelResize(
+QuicTimerWheelUpdate(
     _Inout_ QUIC_TIMER_WHEEL* TimerWheel
     )
 {
-    uint32_t NewSlotCount = TimerWheel->SlotCount * 2;
-    if (NewSlotCount <= TimerWheel->SlotCount) {
-        //
-        // Max size has been reached.
-        //
-        return;
-    }
+    TimerWheel->NextExpirationTime = UINT64_MAX;
 
-    QUIC_LIST_ENTRY* NewSlots =
-        QUIC_ALLOC_NONPAGED(NewSlotCount * sizeof(QUIC_LIST_ENTRY), QUIC_POOL_TIMERWHEEL);
-    if (NewSlots == NULL) {
-        QuicTraceEvent(
-            AllocFailure,
-            "Allocation of '%s' failed. (%llu bytes)", "timerwheel slots (realloc)",
-            NewSlotCount * sizeof(QUIC_LIST_ENTRY));
-        return;
+    //
+    // Every connection in a level expires after all the connections in the
+    // levels below it, so the first non-empty slot of the lowest non-empty
+    // level is the next one to expire.
+    //
+    for (uint32_t Level = 0; Level < QUIC_TIMER_WHEEL_LEVEL_COUNT; ++Level) {
+        if (TimerWheel->SlotBitmaps[Level] != 0) {
+            uint32_t Shift = Level * QUIC_TIMER_WHEEL_LEVEL_BITS;
+            uint32_t UpperShift = Shift + QUIC_TIMER_WHEEL_LEVEL_BITS;
+            uint64_t UpperBits =
+                UpperShift >= 64 ?
+                    0 : (TimerWheel->CurrentTime >> UpperShift) << UpperShift;
+            uint64_t Index = QuicTimerWheelLowestBit(TimerWheel->SlotBitmaps[Level]);
+            TimerWheel->NextExpirationTime = UpperBits | (Index << Shift);
+            break;
+        }
     }
 
-    QuicTraceLogVerbose(
-        TimerWheelResize,
-        "[time][%p] Resizing timer wheel (new slot count = %u).",
-        TimerWheel,
-        NewSlotCount);
-
-    for (uint32_t i = 0; i < NewSlotCount; ++i) {
-        QuicListInitializeHead(&NewSlots[i]);
+    if (TimerWheel->NextExpirationTime == UINT64_MAX) {
+        QuicTraceLogVerbose(
+            TimerWheelNextExpirationNull,
+            "[time][%p] Next Expiration = {NULL}.",
+            TimerWheel);
+    } else {
+        QuicTraceLogVerbose(
+            TimerWheelNextExpirationTime,
+            "[time][%p] Next Expiration = %llu.",
+            TimerWheel,
+            TimerWheel->NextExpirationTime);
     }
+}
 
-    uint32_t OldSlotCount = TimerWheel->SlotCount;
-    QUIC_LIST_ENTRY* OldSlots = TimerWheel->Slots;
-
-    TimerWheel->SlotCount = NewSlotCount;
-    TimerWheel->Slots = NewSlots;
+//
+// Inserts the connection into the slot for its expiration time, relative to
+// the timer wheel's current time.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicTimerWheelInsert(
+    _Inout_ QUIC_TIMER_WHEEL* TimerWheel,
+    _Inout_ QUIC_CONNECTION* Connection,
+    _In_ uint64_t ExpirationTime
+    )
+{
+    uint32_t Level = 0;
+    uint32_t Index;
 
-    for (uint32_t i = 0; i < OldSlotCount; ++i) {
+    if (ExpirationTime <= TimerWheel->CurrentTime) {
         //
-        // Iterate through each old slot, remove all connections and add them
-        // to the new slots.
+        // Already expired. Put it in the current slot so that it is picked up
+        // by the next call to QuicTimerWheelGetExpired.
         //
-        while (!QuicListIsEmpty(&OldSlots[i])) {
-            QUIC_CONNECTION* Connection =
-                QUIC_CONTAINING_RECORD(
-                    QuicListRemoveHead(&OldSlots[i]),
-                    QUIC_CONNECTION,
-                    TimerLink);
-            uint64_t ExpirationTime = QuicConnGetNextExpirationTime(Connection);
-            QUIC_DBG_ASSERT(TimerWheel->SlotCount != 0);
-            uint32_t SlotIndex = TIME_TO_SLOT_INDEX(TimerWheel, ExpirationTime);
-
-            //
-            // Insert the connection into the slot, in the correct order. We search
-            // the slot's list in reverse order, with the assumption that most new
-            // timers will on average be later than existing ones.
-            //
-            QUIC_LIST_ENTRY* ListHead = &TimerWheel->Slots[SlotIndex];
-            QUIC_LIST_ENTRY* Entry = ListHead->Blink;
-
-            while (Entry != ListHead) {
-                QUIC_CONNECTION* ConnectionEntry =
-                    QUIC_CONTAINING_RECORD(Entry, QUIC_CONNECTION, TimerLink);
-                uint64_t EntryExpirationTime = QuicConnGetNextExpirationTime(ConnectionEntry);
+        Index = (uint32_t)(TimerWheel->CurrentTime & (QUIC_TIMER_WHEEL_SLOT_COUNT - 1));
 
-                if (ExpirationTime > EntryExpirationTime) {
-                    break;
-                }
+    } else {
+        //
+        // The level is determined by the highest bits that differ from the
+        // current time.
+        //
+        uint64_t Delta =
+            (ExpirationTime ^ TimerWheel->CurrentTime) >> QUIC_TIMER_WHEEL_LEVEL_BITS;
+        while (Delta != 0) {
+            Delta >>= QUIC_TIMER_WHEEL_LEVEL_BITS;
+            Level++;
+        }
+        Index =
+            (uint32_t)(ExpirationTime >> (Level * QUIC_TIMER_WHEEL_LEVEL_BITS)) &
+            (QUIC_TIMER_WHEEL_SLOT_COUNT - 1);
+    }
 
-                Entry = Entry->Blink;
-            }
+    QuicListInsertTail(TIMER_WHEEL_SLOT(TimerWheel, Level, Index), &Connection->TimerLink);
+    TimerWheel->SlotBitmaps[Level] |= (1ull << Index);
 
-            //
-            // Insert after the current entry.
-            //
-            QuicListInsertHead(Entry, &Connection->TimerLink);
-        }
+    //
+    // Make sure the next expiration time is still correct.
+    //
+    uint64_t SlotStartTime =
+        ExpirationTime & ~((1ull << (Level * QUIC_TIMER_WHEEL_LEVEL_BITS)) - 1);
+    if (SlotStartTime < TimerWheel->NextExpirationTime) {
+        TimerWheel->NextExpirationTime = SlotStartTime;
+        QuicTraceLogVerbose(
+            TimerWheelNextExpirationTime,
+            "[time][%p] Next Expiration = %llu.",
+            TimerWheel,
+            SlotStartTime);
     }
-    QUIC_FREE(OldSlots, QUIC_POOL_TIMERWHEEL);
 }
 
 //
-// Called to update NextConnection and NextExpirationTime when the
-// current NextConnection is updated.
+// Unlinks the connection from its slot. Returns TRUE if the slot is now empty.
 //
 _IRQL_requires_max_(PASSIVE_LEVEL)
-void
-QuicTimerWheelUpdate(
-    _Inout_ QUIC_TIMER_WHEEL* TimerWheel
+BOOLEAN
+QuicTimerWheelUnlink(
+    _Inout_ QUIC_TIMER_WHEEL* TimerWheel,
+    _Inout_ QUIC_CONNECTION* Connection
     )
 {
-    TimerWheel->NextExpirationTime = UINT64_MAX;
-    TimerWheel->NextConnection = NULL;
+    QUIC_LIST_ENTRY* Next = Connection->TimerLink.Flink;
+    if (!QuicListEntryRemove(&Connection->TimerLink)) {
+        return FALSE;
+    }
 
     //
-    // Loop over the slots to find the connection with the earliest
-    // expiration time.
+    // The list is now empty, so the remaining entry is the slot's head.
     //
-    for (uint32_t i = 0; i < TimerWheel->SlotCount; ++i) {
-        if (!QuicListIsEmpty(&TimerWheel->Slots[i])) {
-            QUIC_CONNECTION* ConnectionEntry =
-                QUIC_CONTAINING_RECORD(
-                    TimerWheel->Slots[i].Flink,
-                    QUIC_CONNECTION,
-                    TimerLink);
-            uint64_t EntryExpirationTime = QuicConnGetNextExpirationTime(ConnectionEntry);
-            if (EntryExpirationTime < TimerWheel->NextExpirationTime) {
-                TimerWheel->NextExpirationTime = EntryExpirationTime;
-                TimerWheel->NextConnection = ConnectionEntry;
-            }
-        }
-    }
-
-    if (TimerWheel->NextConnection == NULL) {
-        QuicTraceLogVerbose(
-            TimerWheelNextExpirationNull,
-            "[time][%p] Next Expiration = {NULL}.",
-            TimerWheel);
-    } else {
-        QuicTraceLogVerbose(
-            TimerWheelNextExpiration,
-            "[time][%p] Next Expiration = {%llu, %p}.",
-            TimerWheel,
-            TimerWheel->NextExpirationTime,
-            TimerWheel->NextConnection);
-    }
+    uint32_t SlotIndex = (uint32_t)(Next - TimerWheel->Slots);
+    QUIC_DBG_ASSERT(
+        SlotIndex < QUIC_TIMER_WHEEL_LEVEL_COUNT * QUIC_TIMER_WHEEL_SLOT_COUNT);
+    TimerWheel->SlotBitmaps[SlotIndex / QUIC_TIMER_WHEEL_SLOT_COUNT] &=
+        ~(1ull << (SlotIndex % QUIC_TIMER_WHEEL_SLOT_COUNT));
+    return TRUE;
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -270,11 +287,11 @@ QuicTimerWheelRemoveConnection(
             "[time][%p] Removing Connection %p.",
             TimerWheel,
             Connection);
-        QuicListEntryRemove(&Connection->TimerLink);
+        BOOLEAN SlotEmptied = QuicTimerWheelUnlink(TimerWheel, Connection);
         Connection->TimerLink.Flink = NULL;
         TimerWheel->ConnectionCount--;
 
-        if (Connection == TimerWheel->NextConnection) {
+        if (SlotEmptied) {
             QuicTimerWheelUpdate(TimerWheel);
         }
     }
@@ -288,12 +305,13 @@ QuicTimerWheelUpdateConnection(
     )
 {
     uint64_t ExpirationTime = QuicConnGetNextExpirationTime(Connection);
+    BOOLEAN SlotEmptied = FALSE;
 
     if (Connection->TimerLink.Flink != NULL) {
         //
         // Connection is already in the timer wheel, so remove it first.
         //
-        QuicListEntryRemove(&Connection->TimerLink);
+        SlotEmptied = QuicTimerWheelUnlink(TimerWheel, Connection);
 
         if (ExpirationTime == UINT64_MAX) {
             TimerWheel->ConnectionCount--;
@@ -321,70 +339,19 @@ QuicTimerWheelUpdateConnection(
             TimerWheel,
             Connection);
 
-        if (Connection == TimerWheel->NextConnection) {
-            QuicTimerWheelUpdate(TimerWheel);
-        }
-
     } else {
 
-        QUIC_DBG_ASSERT(TimerWheel->SlotCount != 0);
-        uint32_t SlotIndex = TIME_TO_SLOT_INDEX(TimerWheel, ExpirationTime);
-
-        //
-        // Insert the connection into the slot, in the correct order. We search
-        // the slot's list in reverse order, with the assumption that most new
-        // timers will on average be later than existing ones.
-        //
-        QUIC_LIST_ENTRY* ListHead = &TimerWheel->Slots[SlotIndex];
-        QUIC_LIST_ENTRY* Entry = ListHead->Blink;
-
-        while (Entry != ListHead) {
-            QUIC_CONNECTION* ConnectionEntry =
-                QUIC_CONTAINING_RECORD(Entry, QUIC_CONNECTION, TimerLink);
-            uint64_t EntryExpirationTime = QuicConnGetNextExpirationTime(ConnectionEntry);
-
-            if (ExpirationTime > EntryExpirationTime) {
-                break;
-            }
-
-            Entry = Entry->Blink;
-        }
-
-        //
-        // Insert after the current entry.
-        //
-        QuicListInsertHead(Entry, &Connection->TimerLink);
+        QuicTimerWheelInsert(TimerWheel, Connection, ExpirationTime);
 
         QuicTraceLogVerbose(
             TimerWheelUpdateConnection,
             "[time][%p] Updating Connection %p.",
             TimerWheel,
             Connection);
+    }
 
-        //
-        // Make sure the next expiration time/connection is still correct.
-        //
-        if (ExpirationTime < TimerWheel->NextExpirationTime) {
-            TimerWheel->NextExpirationTime = ExpirationTime;
-            TimerWheel->NextConnection = Connection;
-            QuicTraceLogVerbose(
-                TimerWheelNextExpiration,
-                "[time][%p] Next Expiration = {%llu, %p}.",
-                TimerWheel,
-                ExpirationTime,
-                Connection);
-        } else if (Connection == TimerWheel->NextConnection) {
-            QuicTimerWheelUpdate(TimerWheel);
-        }
-
-        //
-        // Resize the timer wheel if we have too many connections for the
-        // current size.
-        //
-        if (TimerWheel->ConnectionCount >
-            TimerWheel->SlotCount * QUIC_TIMER_WHEEL_MAX_LOAD_FACTOR) {
-            QuicTimerWheelResize(TimerWheel);
-        }
+    if (SlotEmptied) {
+        QuicTimerWheelUpdate(TimerWheel);
     }
 }
 
@@ -428,24 +395,76 @@ QuicTimerWheelGetExpired(
     _Inout_ QUIC_LIST_ENTRY* OutputListHead
     )
 {
+    if (TimeNow < TimerWheel->CurrentTime) {
+        TimeNow = TimerWheel->CurrentTime;
+    }
+
+    const uint64_t ChangedBits = TimerWheel->CurrentTime ^ TimeNow;
+    TimerWheel->CurrentTime = TimeNow;
+
     //
-    // Iterate through every slot to find all the connections that now have
-    // expired timers.
+    // Walk the levels from the bottom up. Connections cascaded down from a
+    // level are reinserted relative to the new current time, so they always
+    // land in a level that has already been processed.
     //
-    for (uint32_t i = 0; i < TimerWheel->SlotCount; ++i) {
-        QUIC_LIST_ENTRY* ListHead = &TimerWheel->Slots[i];
-        QUIC_LIST_ENTRY* Entry = ListHead->Flink;
-        while (Entry != ListHead) {
-            QUIC_CONNECTION* ConnectionEntry =
-                QUIC_CONTAINING_RECORD(Entry, QUIC_CONNECTION, TimerLink);
-            uint64_t EntryExpirationTime = QuicConnGetNextExpirationTime(ConnectionEntry);
-            if (EntryExpirationTime > TimeNow) {
-                break;
+    for (uint32_t Level = 0; Level < QUIC_TIMER_WHEEL_LEVEL_COUNT; ++Level) {
+        uint32_t Shift = Level * QUIC_TIMER_WHEEL_LEVEL_BITS;
+        uint32_t UpperShift = Shift + QUIC_TIMER_WHEEL_LEVEL_BITS;
+
+        if (Level != 0 && (ChangedBits >> Shift) == 0) {
+            //
+            // The current time didn't move out of any slot at this level (or
+            // above), so there is nothing left to process.
+            //
+            break;
+        }
+
+        uint64_t SlotMask;
+        if (UpperShift < 64 && (ChangedBits >> UpperShift) != 0) {
+            //
+            // The current time moved past this entire level; every slot is in
+            // the past.
+            //
+            SlotMask = UINT64_MAX;
+        } else {
+            //
+            // Every slot up to and including the current one.
+            //
+            uint32_t CurrentIndex =
+                (uint32_t)(TimeNow >> Shift) & (QUIC_TIMER_WHEEL_SLOT_COUNT - 1);
+            SlotMask =
+                CurrentIndex == QUIC_TIMER_WHEEL_SLOT_COUNT - 1 ?
+                    UINT64_MAX : (1ull << (CurrentIndex + 1)) - 1;
+        }
+
+        uint64_t Pending = TimerWheel->SlotBitmaps[Level] & SlotMask;
+        TimerWheel->SlotBitmaps[Level] &= ~Pending;
+
+        while (Pending != 0) {
+            uint32_t Index = QuicTimerWheelLowestBit(Pending);
+            Pending &= Pending - 1;
+
+            QUIC_LIST_ENTRY SlotEntries;
+            QuicListInitializeHead(&SlotEntries);
+            QuicListMoveItems(TIMER_WHEEL_SLOT(TimerWheel, Level, Index), &SlotEntries);
+
+            while (!QuicListIsEmpty(&SlotEntries)) {
+                QUIC_CONNECTION* ConnectionEntry =
+                    QUIC_CONTAINING_RECORD(
+                        QuicListRemoveHead(&SlotEntries),
+                        QUIC_CONNECTION,
+                        TimerLink);
+                uint64_t EntryExpirationTime = QuicConnGetNextExpirationTime(ConnectionEntry);
+                if (EntryExpirationTime <= TimeNow) {
+                    QuicListInsertTail(OutputListHead, &ConnectionEntry->TimerLink);
+                    TimerWheel->ConnectionCount--;
+                } else {
+                    QUIC_DBG_ASSERT(Level != 0);
+                    QuicTimerWheelInsert(TimerWheel, ConnectionEntry, EntryExpirationTime);
+                }
             }
-            Entry = Entry->Flink;
-            QuicListEntryRemove(&ConnectionEntry->TimerLink);
-            QuicListInsertTail(OutputListHead, &ConnectionEntry->TimerLink);
-            TimerWheel->ConnectionCount--;
         }
     }
+
+    QuicTimerWheelUpdate(TimerWheel);
 }
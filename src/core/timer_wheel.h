@@ -7,10 +7,29 @@
 
 typedef struct QUIC_CONNECTION QUIC_CONNECTION;
 
+//
+// The number of bits of the expiration time (in us) covered by each level of
+// the timer wheel.
+//
+#define QUIC_TIMER_WHEEL_LEVEL_BITS     6
+
+//
+// The number of slots in each level of the timer wheel.
+//
+#define QUIC_TIMER_WHEEL_SLOT_COUNT     (1 << QUIC_TIMER_WHEEL_LEVEL_BITS)
+
+//
+// The number of levels needed to cover the full 64-bit expiration time.
+//
+#define QUIC_TIMER_WHEEL_LEVEL_COUNT \
+    ((64 + QUIC_TIMER_WHEEL_LEVEL_BITS - 1) / QUIC_TIMER_WHEEL_LEVEL_BITS)
+
 typedef struct QUIC_TIMER_WHEEL {
 
     //
-    // The expiration time (in us) for the next timer in the timer wheel.
+    // The earliest time (in us) at which the next timer in the timer wheel may
+    // expire. This is exact for timers in the lowest level and a lower bound
+    // (the start of the slot) for timers in higher levels.
     //
     uint64_t NextExpirationTime;
 
@@ -20,17 +39,19 @@ typedef struct QUIC_TIMER_WHEEL {
     uint64_t ConnectionCount;
 
     //
-    // The connection with the timer that expires next.
+    // The time (in us) the timer wheel was last advanced to. All slot
+    // positions are relative to this time.
     //
-    QUIC_CONNECTION* NextConnection;
+    uint64_t CurrentTime;
 
     //
-    // The number of slots in the Slots array.
+    // A bitmap of the non-empty slots, per level.
     //
-    uint32_t SlotCount;
+    uint64_t SlotBitmaps[QUIC_TIMER_WHEEL_LEVEL_COUNT];
 
     //
-    // An array of slots in the timer wheel.
+    // An array of QUIC_TIMER_WHEEL_LEVEL_COUNT * QUIC_TIMER_WHEEL_SLOT_COUNT
+    // slots in the timer wheel.
     //
     QUIC_LIST_ENTRY* Slots;
 
@@ -76,7 +97,7 @@ QuicTimerWheelUpdateConnection(
     );
 
 //
-// Returns the time (in us) until the next timer elapses.
+// Returns the time (in ms) until the next timer elapses.
 //
 _IRQL_requires_max_(PASSIVE_LEVEL)
 uint64_t
@@ -0,0 +1,167 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Unit test for the local CID lookup table.
+
+--*/
+
+#include "main.h"
+#ifdef QUIC_CLOG
+#include "CidTableTest.cpp.clog.h"
+#endif
+
+#define CID_TABLE_TEST_CID_LENGTH 8
+
+struct SmartCidTable {
+    QUIC_CID_TABLE Table;
+    std::vector<QUIC_CID_HASH_ENTRY*> Entries;
+    SmartCidTable(uint32_t EntryCount = 0) {
+        if (!QuicCidTableInitialize(&Table, EntryCount)) {
+            throw std::bad_alloc();
+        }
+    }
+    ~SmartCidTable() {
+        QuicCidTableUninitialize(&Table);
+        for (auto Entry : Entries) {
+            free(Entry);
+        }
+    }
+    QUIC_CID_HASH_ENTRY* NewEntry(uint32_t Index) {
+        QUIC_CID_HASH_ENTRY* Entry =
+            (QUIC_CID_HASH_ENTRY*)calloc(
+                1, sizeof(QUIC_CID_HASH_ENTRY) + CID_TABLE_TEST_CID_LENGTH);
+        if (Entry == nullptr) {
+            throw std::bad_alloc();
+        }
+        Entry->CID.Length = CID_TABLE_TEST_CID_LENGTH;
+        memcpy(Entry->CID.Data, &Index, sizeof(Index));
+        Entries.push_back(Entry);
+        return Entry;
+    }
+    static uint32_t Hash(const QUIC_CID_HASH_ENTRY* Entry) {
+        return QuicLookupHashCid(Entry->CID.Length, Entry->CID.Data);
+    }
+    QUIC_CID_HASH_ENTRY* Lookup(uint32_t Hash, const QUIC_CID_HASH_ENTRY* Entry) {
+        return QuicCidTableLookup(&Table, Hash, Entry->CID.Data, Entry->CID.Length);
+    }
+};
+
+TEST(CidTableTest, InsertLookupRemove)
+{
+    SmartCidTable Table;
+    ASSERT_EQ((uint32_t)QUIC_CID_TABLE_MIN_BUCKETS, Table.Table.BucketCount);
+
+    const uint32_t Count = 1000;
+    for (uint32_t i = 0; i < Count; ++i) {
+        QUIC_CID_HASH_ENTRY* Entry = Table.NewEntry(i);
+        ASSERT_TRUE(QuicCidTableInsert(&Table.Table, SmartCidTable::Hash(Entry), Entry));
+    }
+    ASSERT_EQ(Count, Table.Table.EntryCount);
+
+    for (auto Entry : Table.Entries) {
+        ASSERT_EQ(Entry, Table.Lookup(SmartCidTable::Hash(Entry), Entry));
+    }
+
+    QUIC_CID_HASH_ENTRY* Missing = Table.NewEntry(Count);
+    ASSERT_EQ(nullptr, Table.Lookup(SmartCidTable::Hash(Missing), Missing));
+
+    for (uint32_t i = 0; i < Count; i += 2) {
+        QUIC_CID_HASH_ENTRY* Entry = Table.Entries[i];
+        QuicCidTableRemove(&Table.Table, SmartCidTable::Hash(Entry), Entry);
+    }
+    ASSERT_EQ(Count / 2, Table.Table.EntryCount);
+    for (uint32_t i = 0; i < Count; ++i) {
+        QUIC_CID_HASH_ENTRY* Entry = Table.Entries[i];
+        ASSERT_EQ(
+            i % 2 == 0 ? nullptr : Entry,
+            Table.Lookup(SmartCidTable::Hash(Entry), Entry));
+    }
+
+    for (uint32_t i = 1; i < Count; i += 2) {
+        QUIC_CID_HASH_ENTRY* Entry = Table.Entries[i];
+        QuicCidTableRemove(&Table.Table, SmartCidTable::Hash(Entry), Entry);
+    }
+    ASSERT_EQ(0u, Table.Table.EntryCount);
+    for (uint32_t i = 0; i < Table.Table.BucketCount; ++i) {
+        ASSERT_EQ(0, Table.Table.Buckets[i].OverflowCount);
+    }
+}
+
+TEST(CidTableTest, InitializeSized)
+{
+    const uint32_t Count = 1000;
+    SmartCidTable Table(Count);
+    const uint32_t BucketCount = Table.Table.BucketCount;
+    ASSERT_GE(BucketCount * QUIC_CID_TABLE_SLOTS * 3 / 4, Count);
+
+    for (uint32_t i = 0; i < Count; ++i) {
+        QUIC_CID_HASH_ENTRY* Entry = Table.NewEntry(i);
+        ASSERT_TRUE(QuicCidTableInsert(&Table.Table, SmartCidTable::Hash(Entry), Entry));
+    }
+    ASSERT_EQ(BucketCount, Table.Table.BucketCount);
+}
+
+TEST(CidTableTest, Grow)
+{
+    SmartCidTable Table;
+    const uint32_t Count = QUIC_CID_TABLE_MIN_BUCKETS * QUIC_CID_TABLE_SLOTS / 2;
+    for (uint32_t i = 0; i < Count; ++i) {
+        QUIC_CID_HASH_ENTRY* Entry = Table.NewEntry(i);
+        QuicCidTablePlace(&Table.Table, SmartCidTable::Hash(Entry), Entry);
+    }
+
+    ASSERT_TRUE(QuicCidTableGrow(&Table.Table));
+    ASSERT_EQ((uint32_t)QUIC_CID_TABLE_MIN_BUCKETS * 2, Table.Table.BucketCount);
+    ASSERT_EQ(Count, Table.Table.EntryCount);
+    ASSERT_EQ(0u, (uintptr_t)Table.Table.Buckets % QUIC_CID_TABLE_ALIGNMENT);
+
+    for (auto Entry : Table.Entries) {
+        ASSERT_EQ(Entry, Table.Lookup(SmartCidTable::Hash(Entry), Entry));
+    }
+}
+
+TEST(CidTableTest, OverflowSaturates)
+{
+    //
+    // Force every entry into the same bucket, so that all but the first few
+    // probe past it.
+    //
+    const uint32_t Hash = 0;
+    const uint32_t Overflow = UINT8_MAX + 5;
+    const uint32_t Count = QUIC_CID_TABLE_SLOTS + Overflow;
+    SmartCidTable Table(Count);
+    for (uint32_t i = 0; i < Count; ++i) {
+        QuicCidTablePlace(&Table.Table, Hash, Table.NewEntry(i));
+    }
+    ASSERT_EQ(UINT8_MAX, Table.Table.Buckets[0].OverflowCount);
+    ASSERT_EQ(Overflow - QUIC_CID_TABLE_SLOTS, Table.Table.Buckets[1].OverflowCount);
+
+    for (auto Entry : Table.Entries) {
+        ASSERT_EQ(Entry, Table.Lookup(Hash, Entry));
+    }
+    QUIC_CID_HASH_ENTRY* Missing = Table.NewEntry(Count);
+    ASSERT_EQ(nullptr, Table.Lookup(Hash, Missing));
+
+    for (uint32_t i = 0; i < Count; ++i) {
+        QuicCidTableRemove(&Table.Table, Hash, Table.Entries[i]);
+        if (i + 1 < Count) {
+            ASSERT_EQ(Table.Entries[i + 1], Table.Lookup(Hash, Table.Entries[i + 1]));
+        }
+    }
+    ASSERT_EQ(0u, Table.Table.EntryCount);
+
+    //
+    // A saturated count can't be decremented, so it sticks until the table is
+    // rehashed. Lookups still terminate.
+    //
+    ASSERT_EQ(UINT8_MAX, Table.Table.Buckets[0].OverflowCount);
+    ASSERT_EQ(0, Table.Table.Buckets[1].OverflowCount);
+    ASSERT_EQ(nullptr, Table.Lookup(Hash, Missing));
+
+    ASSERT_TRUE(QuicCidTableGrow(&Table.Table));
+    ASSERT_EQ(0, Table.Table.Buckets[0].OverflowCount);
+}
@@ -0,0 +1,375 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Unit test for the delivery rate estimate and BBR congestion control, on a
+    simulated bottleneck link.
+
+--*/
+
+#include "main.h"
+#include "TestConnection.h"
+#include <algorithm>
+#include <deque>
+#ifdef QUIC_CLOG
+#include "CongestionControlTest.cpp.clog.h"
+#endif
+
+#define LINK_TEST_MTU           1280
+#define LINK_TEST_RTT           20000 // microsec
+#define LINK_TEST_START_TIME    1000000 // microsec
+#define LINK_TEST_PACKET_THRESHOLD 3
+
+//
+// The estimate must be within this percent of the bottleneck rate.
+//
+#define LINK_TEST_TOLERANCE_PERCENT 10
+
+//
+// A sender with unlimited data on a path with a single bottleneck link of a
+// fixed rate. Packets are dropped at random before reaching the link. Each
+// packet that made it through is acknowledged one RTT after it leaves the
+// link, and a dropped packet is inferred lost once a packet sent
+// LINK_TEST_PACKET_THRESHOLD after it is acknowledged. If AckAggregation is
+// set, the ACKs are held and released together at that interval, as on
+// links that aggregate frames.
+//
+// The sender is limited either by the connection's congestion control or, if
+// Window is set, by a fixed window (and then SendRate, if set).
+//
+struct SimulatedLink {
+    struct SimPacket {
+        QUIC_SENT_PACKET_METADATA Metadata;
+        uint64_t AckTime; // microsec
+        bool Dropped;
+        bool Done;
+    };
+
+    QUIC_CONNECTION* Connection;
+    QUIC_CONGESTION_CONTROL* Cc;
+    QUIC_LOSS_DETECTION* LossDetection;
+    QUIC_PATH* Path;
+
+    const uint64_t LinkRate; // bytes/sec
+    const uint32_t LossPerMille;
+    uint32_t Window {0}; // bytes
+    uint64_t SendRate {0}; // bytes/sec
+    uint32_t AckAggregation {0}; // microsec
+
+    uint64_t Now {LINK_TEST_START_TIME}; // microsec
+    uint64_t NextSendTime {0}; // microsec
+    uint64_t NextPaceTime {0}; // microsec
+    uint64_t LinkFreeTimeNs {0};
+    uint64_t NextPacketNumber {0};
+    uint64_t BytesDelivered {0};
+    uint32_t RandomState {0x2545F491};
+    std::deque<SimPacket> Outstanding;
+
+    SimulatedLink(
+        QUIC_CONGESTION_CONTROL_ALGORITHM Algorithm,
+        uint64_t LinkRate,
+        uint32_t LossPerMille = 0) :
+        LinkRate(LinkRate), LossPerMille(LossPerMille) {
+        Connection =
+            QuicTestCongestionConnectionAllocate(
+                Algorithm, LINK_TEST_MTU, LINK_TEST_RTT);
+        if (Connection == nullptr) {
+            throw std::bad_alloc();
+        }
+        Cc = QuicTestConnectionCongestionControl(Connection);
+        LossDetection = QuicTestConnectionLossDetection(Connection);
+        Path = QuicTestConnectionPath(Connection);
+    }
+
+    ~SimulatedLink() {
+        QuicTestConnectionsFree(Connection);
+    }
+
+    uint64_t Bdp() const {
+        return LinkRate * LINK_TEST_RTT / 1000000;
+    }
+
+    const QUIC_CONN_STATS* Stats() const {
+        return QuicTestConnectionStats(Connection);
+    }
+
+    uint32_t Random() {
+        RandomState ^= RandomState << 13;
+        RandomState ^= RandomState >> 17;
+        RandomState ^= RandomState << 5;
+        return RandomState;
+    }
+
+    bool CanSend() const {
+        if (Window == 0) {
+            return QuicCongestionControlCanSend(Cc);
+        }
+        return LossDetection->PacketsInFlight * LINK_TEST_MTU < Window;
+    }
+
+    void SendPacket() {
+        SimPacket Packet;
+        QuicZeroMemory(&Packet, sizeof(Packet));
+        Packet.Metadata.PacketNumber = NextPacketNumber++;
+        Packet.Metadata.SentTime = (uint32_t)Now;
+        Packet.Metadata.PacketLength = LINK_TEST_MTU;
+        Packet.Metadata.Flags.IsAckEliciting = TRUE;
+
+        QuicLossDetectionSaveRateSampleState(LossDetection, &Packet.Metadata);
+        LossDetection->PacketsInFlight++;
+        LossDetection->LargestSentPacketNumber = Packet.Metadata.PacketNumber;
+        if (Window == 0) {
+            QuicCongestionControlOnDataSent(Cc, LINK_TEST_MTU);
+        }
+
+        Packet.Dropped = Random() % 1000 < LossPerMille;
+        if (!Packet.Dropped) {
+            LinkFreeTimeNs =
+                std::max(LinkFreeTimeNs, Now * 1000) +
+                LINK_TEST_MTU * 1000000000ull / LinkRate;
+            Packet.AckTime = LinkFreeTimeNs / 1000 + LINK_TEST_RTT;
+            if (AckAggregation != 0) {
+                Packet.AckTime += AckAggregation - Packet.AckTime % AckAggregation;
+            }
+        }
+        Outstanding.push_back(Packet);
+    }
+
+    void Send() {
+        NextSendTime = UINT64_MAX;
+        while (CanSend()) {
+            uint64_t DepartureTime =
+                Window == 0 ?
+                    QuicCongestionControlGetDepartureTime(Cc, Now) :
+                    std::max(Now, NextPaceTime);
+            if (DepartureTime > Now) {
+                NextSendTime = DepartureTime;
+                return;
+            }
+            SendPacket();
+            if (Window == 0) {
+                QuicCongestionControlAdvanceDepartureTime(Cc, LINK_TEST_MTU);
+            } else if (SendRate != 0) {
+                NextPaceTime = Now + LINK_TEST_MTU * 1000000ull / SendRate;
+            }
+        }
+    }
+
+    uint64_t NextAckTime() const {
+        for (auto& Packet : Outstanding) {
+            if (!Packet.Dropped && !Packet.Done) {
+                return Packet.AckTime;
+            }
+        }
+        return UINT64_MAX;
+    }
+
+    void ProcessAck() {
+        QUIC_RATE_SAMPLE RateSample;
+        QuicZeroMemory(&RateSample, sizeof(RateSample));
+        QUIC_ACK_EVENT AckEvent;
+        QuicZeroMemory(&AckEvent, sizeof(AckEvent));
+
+        for (auto& Packet : Outstanding) {
+            if (Packet.Dropped || Packet.Done) {
+                continue;
+            }
+            if (Packet.AckTime > Now) {
+                break;
+            }
+            Packet.Done = true;
+            QuicLossDetectionUpdateRateSample(
+                LossDetection, &Packet.Metadata, (uint32_t)Now, &RateSample);
+            LossDetection->PacketsInFlight--;
+            AckEvent.NumRetransmittableBytes += LINK_TEST_MTU;
+            AckEvent.LargestAck = Packet.Metadata.PacketNumber;
+            AckEvent.LatestRtt = (uint32_t)(Now - Packet.Metadata.SentTime);
+        }
+        if (AckEvent.NumRetransmittableBytes == 0) {
+            return;
+        }
+        BytesDelivered += AckEvent.NumRetransmittableBytes;
+
+        QUIC_LOSS_EVENT LossEvent;
+        QuicZeroMemory(&LossEvent, sizeof(LossEvent));
+        for (auto& Packet : Outstanding) {
+            if (Packet.Metadata.PacketNumber + LINK_TEST_PACKET_THRESHOLD > AckEvent.LargestAck) {
+                break;
+            }
+            if (Packet.Dropped && !Packet.Done) {
+                Packet.Done = true;
+                LossDetection->PacketsInFlight--;
+                LossEvent.NumRetransmittableBytes += LINK_TEST_MTU;
+                LossEvent.LargestPacketNumberLost = Packet.Metadata.PacketNumber;
+            }
+        }
+        while (!Outstanding.empty() && Outstanding.front().Done) {
+            Outstanding.pop_front();
+        }
+
+        uint64_t DeliveryRate;
+        BOOLEAN HasRateSample =
+            QuicLossDetectionGenerateRateSample(
+                LossDetection, Path, &RateSample, &DeliveryRate);
+
+        if (Window != 0) {
+            return;
+        }
+
+        if (LossEvent.NumRetransmittableBytes != 0) {
+            LossEvent.LargestSentPacketNumber = LossDetection->LargestSentPacketNumber;
+            QuicCongestionControlOnDataLost(Cc, &LossEvent);
+        }
+
+        AckEvent.TimeNow = Now;
+        AckEvent.LargestSentPacketNumber = LossDetection->LargestSentPacketNumber;
+        AckEvent.SmoothedRtt = Path->SmoothedRtt;
+        AckEvent.HasRttSample = TRUE;
+        if (HasRateSample) {
+            AckEvent.HasRateSample = TRUE;
+            AckEvent.IsAppLimited = RateSample.IsAppLimited;
+            AckEvent.DeliveryRate = DeliveryRate;
+        }
+        (void)QuicCongestionControlOnDataAcknowledged(Cc, &AckEvent);
+    }
+
+    //
+    // Runs the transfer for Duration and returns the delivery rate over it.
+    //
+    uint64_t Run(uint64_t Duration) {
+        const uint64_t StartTime = Now;
+        const uint64_t StartDelivered = BytesDelivered;
+        const uint64_t EndTime = Now + Duration;
+        while (true) {
+            Send();
+            uint64_t NextTime = std::min(NextSendTime, NextAckTime());
+            if (NextTime > EndTime) {
+                break;
+            }
+            Now = std::max(Now, NextTime);
+            ProcessAck();
+        }
+        Now = EndTime;
+        return (BytesDelivered - StartDelivered) * 1000000 / (Now - StartTime);
+    }
+};
+
+static
+void
+AssertWithinTolerance(
+    uint64_t Expected,
+    uint64_t Actual
+    )
+{
+    ASSERT_GE(Actual * 100, Expected * (100 - LINK_TEST_TOLERANCE_PERCENT));
+    ASSERT_LE(Actual * 100, Expected * (100 + LINK_TEST_TOLERANCE_PERCENT));
+}
+
+TEST(CongestionControlTest, DeliveryRateMatchesLinkRate)
+{
+    const uint64_t LinkRates[] = {
+        1250000,    // 10 Mbps
+        12500000,   // 100 Mbps
+        125000000   // 1 Gbps
+    };
+    for (auto LinkRate : LinkRates) {
+        for (uint32_t LossPerMille : {0, 10}) {
+            for (uint32_t AckAggregation : {0, LINK_TEST_RTT / 4}) {
+                SimulatedLink Link(
+                    QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC, LinkRate, LossPerMille);
+                Link.Window = (uint32_t)(2 * Link.Bdp());
+                Link.AckAggregation = AckAggregation;
+
+                uint64_t DeliveryRate = Link.Run(2000000);
+                AssertWithinTolerance(LinkRate, DeliveryRate);
+                AssertWithinTolerance(LinkRate, Link.LossDetection->EstimatedBandwidth);
+            }
+        }
+    }
+}
+
+TEST(CongestionControlTest, DeliveryRateMatchesSendRate)
+{
+    //
+    // When the sender is slower than the link, that is what gets measured.
+    //
+    const uint64_t LinkRate = 12500000;
+    SimulatedLink Link(QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC, LinkRate);
+    Link.Window = (uint32_t)(4 * Link.Bdp());
+    Link.SendRate = LinkRate / 2;
+
+    uint64_t DeliveryRate = Link.Run(2000000);
+    AssertWithinTolerance(Link.SendRate, DeliveryRate);
+    AssertWithinTolerance(Link.SendRate, Link.LossDetection->EstimatedBandwidth);
+}
+
+//
+// Runs BBR over the link with and without 1% random loss, and returns the
+// delivery rate of both after STARTUP.
+//
+static
+void
+BbrRunWithRandomLoss(
+    SimulatedLink& Lossless,
+    SimulatedLink& Lossy,
+    uint64_t* LosslessRate,
+    uint64_t* LossyRate
+    )
+{
+    const uint64_t Warmup = 2000000;
+    const uint64_t Duration = 8000000;
+    Lossless.Run(Warmup);
+    *LosslessRate = Lossless.Run(Duration);
+    Lossy.Run(Warmup);
+    *LossyRate = Lossy.Run(Duration);
+}
+
+TEST(CongestionControlTest, BbrRandomLoss)
+{
+    //
+    // With a BDP of thousands of packets, 1% random loss stays well below
+    // BBR's loss threshold in every round, so it must not be taken as
+    // congestion at all.
+    //
+    const uint64_t LinkRate = 125000000; // 1 Gbps
+    SimulatedLink Lossless(QUIC_CONGESTION_CONTROL_ALGORITHM_BBR, LinkRate);
+    SimulatedLink Lossy(QUIC_CONGESTION_CONTROL_ALGORITHM_BBR, LinkRate, 10);
+    uint64_t LosslessRate, LossyRate;
+    BbrRunWithRandomLoss(Lossless, Lossy, &LosslessRate, &LossyRate);
+
+    AssertWithinTolerance(LinkRate, LosslessRate);
+    AssertWithinTolerance(LinkRate, LossyRate);
+    ASSERT_EQ(0u, Lossy.Stats()->Send.CongestionCount);
+    ASSERT_EQ(0u, Lossy.Stats()->Send.PersistentCongestionCount);
+
+    const QUIC_CONGESTION_CONTROL_BBR* Bbr = &Lossy.Cc->Bbr;
+    ASSERT_EQ((uint8_t)BBR_STATE_PROBE_BW, Bbr->State);
+    AssertWithinTolerance(LinkRate, std::max(Bbr->MaxBwFilter[0], Bbr->MaxBwFilter[1]));
+    ASSERT_EQ((uint32_t)UINT32_MAX, Bbr->InflightHi);
+    ASSERT_GE(Bbr->CongestionWindow, Lossy.Bdp());
+}
+
+TEST(CongestionControlTest, BbrRandomLossSmallBdp)
+{
+    //
+    // With a BDP of a couple hundred packets, a few rounds see more than the
+    // threshold of loss by chance. Backing off for those must not compound
+    // from round to round.
+    //
+    const uint64_t LinkRate = 12500000; // 100 Mbps
+    SimulatedLink Lossless(QUIC_CONGESTION_CONTROL_ALGORITHM_BBR, LinkRate);
+    SimulatedLink Lossy(QUIC_CONGESTION_CONTROL_ALGORITHM_BBR, LinkRate, 10);
+    uint64_t LosslessRate, LossyRate;
+    BbrRunWithRandomLoss(Lossless, Lossy, &LosslessRate, &LossyRate);
+
+    AssertWithinTolerance(LinkRate, LosslessRate);
+    ASSERT_NE(0u, Lossy.Stats()->Send.CongestionCount);
+    ASSERT_EQ(0u, Lossy.Stats()->Send.PersistentCongestionCount);
+    ASSERT_GE(LossyRate * 100, LosslessRate * (100 - LINK_TEST_TOLERANCE_PERCENT));
+
+    const QUIC_CONGESTION_CONTROL_BBR* Bbr = &Lossy.Cc->Bbr;
+    AssertWithinTolerance(LinkRate, std::max(Bbr->MaxBwFilter[0], Bbr->MaxBwFilter[1]));
+}
@@ -0,0 +1,137 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Unit test for the stream send scheduling.
+
+--*/
+
+#include "main.h"
+#include "TestConnection.h"
+#ifdef QUIC_CLOG
+#include "SendTest.cpp.clog.h"
+#endif
+
+struct SmartSendConnection {
+    QUIC_CONNECTION* Connection;
+    std::vector<QUIC_STREAM*> Streams;
+    SmartSendConnection() {
+        Connection = QuicTestSendConnectionAllocate();
+        if (Connection == nullptr) {
+            throw std::bad_alloc();
+        }
+    }
+    ~SmartSendConnection() {
+        QuicTestSendConnectionFree(Connection);
+        for (auto Stream : Streams) {
+            QuicTestStreamFree(Stream);
+        }
+    }
+    QUIC_STREAM* NewStream(uint64_t MaxAllowedSendOffset = UINT64_MAX) {
+        QUIC_STREAM* Stream =
+            QuicTestStreamAllocate(
+                Connection, Streams.size() * 4, MaxAllowedSendOffset);
+        if (Stream == nullptr) {
+            throw std::bad_alloc();
+        }
+        Streams.push_back(Stream);
+        return Stream;
+    }
+    QUIC_STREAM* Next() {
+        return QuicTestSendGetNextStream(Connection);
+    }
+};
+
+TEST(SendTest, HigherPriorityFirst)
+{
+    SmartSendConnection Conn;
+    QUIC_STREAM* Default = Conn.NewStream();
+    QUIC_STREAM* High = Conn.NewStream();
+    QUIC_STREAM* Low = Conn.NewStream();
+    TEST_QUIC_SUCCEEDED(QuicTestStreamSetPriority(High, QUIC_STREAM_PRIORITY_LEVEL_DEFAULT + 2));
+    TEST_QUIC_SUCCEEDED(QuicTestStreamSetPriority(Low, QUIC_STREAM_PRIORITY_LEVEL_DEFAULT - 2));
+
+    //
+    // Queued in the reverse order of their priority.
+    //
+    QuicTestStreamQueueData(Low, 1000);
+    QuicTestStreamQueueData(Default, 1000);
+    QuicTestStreamQueueData(High, 1000);
+
+    ASSERT_EQ(High, Conn.Next());
+    ASSERT_EQ(High, Conn.Next());
+    QuicTestStreamClearData(High);
+    ASSERT_EQ(Default, Conn.Next());
+    QuicTestStreamClearData(Default);
+    ASSERT_EQ(Low, Conn.Next());
+
+    //
+    // Raising the priority of a queued stream takes effect immediately.
+    //
+    QuicTestStreamQueueData(Default, 1000);
+    ASSERT_EQ(Default, Conn.Next());
+    TEST_QUIC_SUCCEEDED(QuicTestStreamSetPriority(Low, QUIC_STREAM_PRIORITY_LEVEL_COUNT - 1));
+    ASSERT_EQ(Low, Conn.Next());
+
+    QuicTestStreamClearData(Low);
+    QuicTestStreamClearData(Default);
+    ASSERT_EQ(nullptr, Conn.Next());
+}
+
+TEST(SendTest, RoundRobinWithinLevel)
+{
+    SmartSendConnection Conn;
+    QUIC_STREAM* First = Conn.NewStream();
+    QUIC_STREAM* Second = Conn.NewStream();
+    QuicTestStreamQueueData(First, 1000);
+    QuicTestStreamQueueData(Second, 1000);
+
+    ASSERT_EQ(First, Conn.Next());
+    ASSERT_EQ(Second, Conn.Next());
+    ASSERT_EQ(First, Conn.Next());
+
+    QuicTestStreamClearData(First);
+    QuicTestStreamClearData(Second);
+}
+
+TEST(SendTest, UnblockedWhenFlowControlOpens)
+{
+    SmartSendConnection Conn;
+    QUIC_STREAM* Blocked = Conn.NewStream(0);
+    QUIC_STREAM* Open = Conn.NewStream();
+    TEST_QUIC_SUCCEEDED(QuicTestStreamSetPriority(Blocked, QUIC_STREAM_PRIORITY_LEVEL_COUNT - 1));
+    QuicTestStreamQueueData(Blocked, 1000);
+    QuicTestStreamQueueData(Open, 1000);
+
+    //
+    // The higher priority stream has no flow control credit, so it's parked
+    // and the other stream is sent instead.
+    //
+    ASSERT_FALSE(QuicTestStreamIsSendBlocked(Blocked));
+    ASSERT_EQ(Open, Conn.Next());
+    ASSERT_TRUE(QuicTestStreamIsSendBlocked(Blocked));
+    QuicTestStreamClearData(Open);
+    ASSERT_EQ(nullptr, Conn.Next());
+    ASSERT_TRUE(QuicTestStreamIsSendBlocked(Blocked));
+
+    //
+    // A MAX_STREAM_DATA frame that doesn't raise the limit changes nothing.
+    //
+    TEST_QUIC_SUCCEEDED(QuicTestStreamRecvMaxStreamData(Blocked, 0));
+    ASSERT_TRUE(QuicTestStreamIsSendBlocked(Blocked));
+
+    //
+    // Once the peer opens flow control, the stream is taken off the blocked
+    // list and sent ahead of lower priority streams again.
+    //
+    QuicTestStreamQueueData(Open, 1000);
+    TEST_QUIC_SUCCEEDED(QuicTestStreamRecvMaxStreamData(Blocked, 2000));
+    ASSERT_FALSE(QuicTestStreamIsSendBlocked(Blocked));
+    ASSERT_EQ(Blocked, Conn.Next());
+
+    QuicTestStreamClearData(Blocked);
+    QuicTestStreamClearData(Open);
+}
@@ -0,0 +1,287 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Helpers for unit tests that need bare QUIC_CONNECTION and QUIC_STREAM
+    objects.
+
+--*/
+
+#include "precomp.h"
+#include "TestConnection.h"
+
+QUIC_CONNECTION*
+QuicTestConnectionsAllocate(
+    _In_ uint32_t Count
+    )
+{
+    QUIC_CONNECTION* Connections =
+        (QUIC_CONNECTION*)calloc(Count, sizeof(QUIC_CONNECTION));
+    if (Connections != NULL) {
+        for (uint32_t i = 0; i < Count; ++i) {
+            for (uint32_t j = 0; j < ARRAYSIZE(Connections[i].Timers); ++j) {
+                Connections[i].Timers[j].ExpirationTime = UINT64_MAX;
+            }
+        }
+    }
+    return Connections;
+}
+
+void
+QuicTestConnectionsFree(
+    _In_ QUIC_CONNECTION* Connections
+    )
+{
+    free(Connections);
+}
+
+QUIC_CONNECTION*
+QuicTestConnectionAt(
+    _In_ QUIC_CONNECTION* Connections,
+    _In_ uint32_t Index
+    )
+{
+    return &Connections[Index];
+}
+
+uint32_t
+QuicTestConnectionIndex(
+    _In_ const QUIC_CONNECTION* Connections,
+    _In_ const QUIC_CONNECTION* Connection
+    )
+{
+    return (uint32_t)(Connection - Connections);
+}
+
+uint64_t*
+QuicTestConnectionExpirationTime(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    return &Connection->Timers[0].ExpirationTime;
+}
+
+QUIC_LIST_ENTRY*
+QuicTestConnectionTimerLink(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    return &Connection->TimerLink;
+}
+
+QUIC_CONNECTION*
+QuicTestConnectionFromTimerLink(
+    _In_ QUIC_LIST_ENTRY* TimerLink
+    )
+{
+    return QUIC_CONTAINING_RECORD(TimerLink, QUIC_CONNECTION, TimerLink);
+}
+
+QUIC_CONNECTION*
+QuicTestSendConnectionAllocate(
+    void
+    )
+{
+    QUIC_CONNECTION* Connection = QuicTestConnectionsAllocate(1);
+    if (Connection != NULL) {
+        QuicSendInitialize(&Connection->Send, &MsQuicLib.Settings);
+        Connection->Send.PeerMaxData = UINT64_MAX;
+        Connection->Send.FlushOperationPending = TRUE;
+        Connection->Crypto.TlsState.WriteKey = QUIC_PACKET_KEY_1_RTT;
+        Connection->State.UseRoundRobinStreamScheduling = TRUE;
+        for (uint32_t i = 0; i < ARRAYSIZE(Connection->Streams.Types); ++i) {
+            Connection->Streams.Types[i].MaxTotalStreamCount = UINT64_MAX;
+        }
+    }
+    return Connection;
+}
+
+void
+QuicTestSendConnectionFree(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    QuicSendUninitialize(&Connection->Send);
+    QuicTestConnectionsFree(Connection);
+}
+
+QUIC_STREAM*
+QuicTestSendGetNextStream(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    uint32_t PacketCount;
+    return QuicSendGetNextStream(&Connection->Send, &PacketCount);
+}
+
+QUIC_STREAM*
+QuicTestStreamAllocate(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ uint64_t ID,
+    _In_ uint64_t MaxAllowedSendOffset
+    )
+{
+    QUIC_STREAM* Stream = (QUIC_STREAM*)calloc(1, sizeof(QUIC_STREAM));
+    if (Stream != NULL) {
+        Stream->Connection = Connection;
+        Stream->ID = ID;
+        Stream->Flags.Started = TRUE;
+        Stream->SendPriority = QUIC_STREAM_PRIORITY_LEVEL_DEFAULT;
+        Stream->SendWeight = QUIC_STREAM_PRIORITY_WEIGHT_DEFAULT;
+        Stream->MaxAllowedSendOffset = MaxAllowedSendOffset;
+        QuicRefInitialize(&Stream->RefCount);
+#if DEBUG
+        Stream->RefTypeCount[QUIC_STREAM_REF_APP] = 1;
+#endif
+    }
+    return Stream;
+}
+
+void
+QuicTestStreamFree(
+    _In_ QUIC_STREAM* Stream
+    )
+{
+    QUIC_DBG_ASSERT(Stream->SendLink.Flink == NULL);
+    free(Stream);
+}
+
+QUIC_STATUS
+QuicTestStreamSetPriority(
+    _In_ QUIC_STREAM* Stream,
+    _In_ uint8_t Level
+    )
+{
+    QUIC_STREAM_PRIORITY Priority;
+    Priority.Level = Level;
+    Priority.Weight = QUIC_STREAM_PRIORITY_WEIGHT_DEFAULT;
+    return
+        QuicStreamParamSet(
+            Stream,
+            QUIC_PARAM_STREAM_PRIORITY,
+            sizeof(Priority),
+            &Priority);
+}
+
+void
+QuicTestStreamQueueData(
+    _In_ QUIC_STREAM* Stream,
+    _In_ uint64_t Length
+    )
+{
+    Stream->QueuedSendOffset += Length;
+    QuicSendSetStreamSendFlag(
+        &Stream->Connection->Send,
+        Stream,
+        QUIC_STREAM_SEND_FLAG_DATA);
+}
+
+void
+QuicTestStreamClearData(
+    _In_ QUIC_STREAM* Stream
+    )
+{
+    Stream->NextSendOffset = Stream->QueuedSendOffset;
+    QuicSendClearStreamSendFlag(
+        &Stream->Connection->Send,
+        Stream,
+        QUIC_STREAM_SEND_FLAG_DATA);
+}
+
+BOOLEAN
+QuicTestStreamIsSendBlocked(
+    _In_ const QUIC_STREAM* Stream
+    )
+{
+    return Stream->Flags.SendBlocked;
+}
+
+QUIC_STATUS
+QuicTestStreamRecvMaxStreamData(
+    _In_ QUIC_STREAM* Stream,
+    _In_ uint64_t MaximumData
+    )
+{
+    QUIC_MAX_STREAM_DATA_EX Frame;
+    Frame.StreamID = Stream->ID;
+    Frame.MaximumData = MaximumData;
+
+    uint8_t Buffer[32];
+    uint16_t Length = 0;
+    if (!QuicMaxStreamDataFrameEncode(&Frame, &Length, sizeof(Buffer), Buffer)) {
+        return QUIC_STATUS_INTERNAL_ERROR;
+    }
+
+    uint16_t Offset = sizeof(uint8_t); // Skip the frame type.
+    BOOLEAN UpdatedFlowControl = FALSE;
+    return
+        QuicStreamRecv(
+            Stream,
+            FALSE,
+            QUIC_FRAME_MAX_STREAM_DATA,
+            Length,
+            Buffer,
+            &Offset,
+            &UpdatedFlowControl);
+}
+
+QUIC_CONNECTION*
+QuicTestCongestionConnectionAllocate(
+    _In_ QUIC_CONGESTION_CONTROL_ALGORITHM Algorithm,
+    _In_ uint16_t Mtu,
+    _In_ uint32_t Rtt
+    )
+{
+    QUIC_CONNECTION* Connection = QuicTestConnectionsAllocate(1);
+    if (Connection != NULL) {
+        QuicSettingsSetDefault(&Connection->Settings);
+        Connection->Settings.CongestionControlAlgorithm = (uint16_t)Algorithm;
+        Connection->PathsCount = 1;
+        QUIC_PATH* Path = &Connection->Paths[0];
+        Path->IsActive = TRUE;
+        Path->Mtu = Mtu;
+        Path->GotFirstRttSample = TRUE;
+        Path->SmoothedRtt = Rtt;
+        Path->LatestRttSample = Rtt;
+        Path->MinRtt = Rtt;
+        Path->RttVariance = Rtt / 2;
+        QuicCongestionControlInitialize(
+            &Connection->CongestionControl, &Connection->Settings);
+    }
+    return Connection;
+}
+
+QUIC_CONGESTION_CONTROL*
+QuicTestConnectionCongestionControl(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    return &Connection->CongestionControl;
+}
+
+QUIC_LOSS_DETECTION*
+QuicTestConnectionLossDetection(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    return &Connection->LossDetection;
+}
+
+QUIC_PATH*
+QuicTestConnectionPath(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    return &Connection->Paths[0];
+}
+
+QUIC_CONN_STATS*
+QuicTestConnectionStats(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    return &Connection->Stats;
+}
@@ -0,0 +1,179 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Helpers for unit tests that need bare QUIC_CONNECTION and QUIC_STREAM
+    objects.
+
+    QUIC_CONNECTION and QUIC_STREAM start with an anonymous
+    'struct QUIC_HANDLE;' member, which C expands in place but C++ treats as a
+    nested declaration, so their layout differs between the two. The objects
+    are allocated and their fields accessed in C, so the tests always see the
+    real layout.
+
+--*/
+
+#pragma once
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+//
+// Allocates an array of zeroed connections, with their timers unset.
+//
+QUIC_CONNECTION*
+QuicTestConnectionsAllocate(
+    _In_ uint32_t Count
+    );
+
+void
+QuicTestConnectionsFree(
+    _In_ QUIC_CONNECTION* Connections
+    );
+
+QUIC_CONNECTION*
+QuicTestConnectionAt(
+    _In_ QUIC_CONNECTION* Connections,
+    _In_ uint32_t Index
+    );
+
+uint32_t
+QuicTestConnectionIndex(
+    _In_ const QUIC_CONNECTION* Connections,
+    _In_ const QUIC_CONNECTION* Connection
+    );
+
+//
+// The connection's next timer expiration, as used by the timer wheel.
+//
+uint64_t*
+QuicTestConnectionExpirationTime(
+    _In_ QUIC_CONNECTION* Connection
+    );
+
+QUIC_LIST_ENTRY*
+QuicTestConnectionTimerLink(
+    _In_ QUIC_CONNECTION* Connection
+    );
+
+QUIC_CONNECTION*
+QuicTestConnectionFromTimerLink(
+    _In_ QUIC_LIST_ENTRY* TimerLink
+    );
+
+//
+// Allocates a connection that is ready to schedule stream sends: it has
+// 1-RTT keys, no connection-wide flow control limit and round robin stream
+// scheduling. Flushes are never queued.
+//
+QUIC_CONNECTION*
+QuicTestSendConnectionAllocate(
+    void
+    );
+
+void
+QuicTestSendConnectionFree(
+    _In_ QUIC_CONNECTION* Connection
+    );
+
+//
+// Returns the next stream the connection would send on, or NULL.
+//
+QUIC_STREAM*
+QuicTestSendGetNextStream(
+    _In_ QUIC_CONNECTION* Connection
+    );
+
+//
+// Allocates a started, locally opened stream with the default priority.
+//
+QUIC_STREAM*
+QuicTestStreamAllocate(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ uint64_t ID,
+    _In_ uint64_t MaxAllowedSendOffset
+    );
+
+//
+// Frees a stream, which must not be queued to send.
+//
+void
+QuicTestStreamFree(
+    _In_ QUIC_STREAM* Stream
+    );
+
+QUIC_STATUS
+QuicTestStreamSetPriority(
+    _In_ QUIC_STREAM* Stream,
+    _In_ uint8_t Level
+    );
+
+//
+// Queues new data on the stream, as an app send would.
+//
+void
+QuicTestStreamQueueData(
+    _In_ QUIC_STREAM* Stream,
+    _In_ uint64_t Length
+    );
+
+//
+// Removes the stream's pending data, as if it had all been sent.
+//
+void
+QuicTestStreamClearData(
+    _In_ QUIC_STREAM* Stream
+    );
+
+BOOLEAN
+QuicTestStreamIsSendBlocked(
+    _In_ const QUIC_STREAM* Stream
+    );
+
+//
+// Processes a MAX_STREAM_DATA frame from the peer for the stream.
+//
+QUIC_STATUS
+QuicTestStreamRecvMaxStreamData(
+    _In_ QUIC_STREAM* Stream,
+    _In_ uint64_t MaximumData
+    );
+
+//
+// Allocates a connection on a single path with the given MTU and RTT, for
+// driving congestion control with the given algorithm.
+//
+QUIC_CONNECTION*
+QuicTestCongestionConnectionAllocate(
+    _In_ QUIC_CONGESTION_CONTROL_ALGORITHM Algorithm,
+    _In_ uint16_t Mtu,
+    _In_ uint32_t Rtt // microsec
+    );
+
+QUIC_CONGESTION_CONTROL*
+QuicTestConnectionCongestionControl(
+    _In_ QUIC_CONNECTION* Connection
+    );
+
+QUIC_LOSS_DETECTION*
+QuicTestConnectionLossDetection(
+    _In_ QUIC_CONNECTION* Connection
+    );
+
+QUIC_PATH*
+QuicTestConnectionPath(
+    _In_ QUIC_CONNECTION* Connection
+    );
+
+QUIC_CONN_STATS*
+QuicTestConnectionStats(
+    _In_ QUIC_CONNECTION* Connection
+    );
+
+#if defined(__cplusplus)
+}
+#endif
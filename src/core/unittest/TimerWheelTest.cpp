@@ -0,0 +1,224 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Unit test and benchmark for the hierarchical timer wheel.
+
+--*/
+
+#include "main.h"
+#include "TestConnection.h"
+#ifdef QUIC_CLOG
+#include "TimerWheelTest.cpp.clog.h"
+#endif
+
+struct TestRandom {
+    uint64_t State;
+    TestRandom(uint64_t Seed) : State(Seed) { }
+    uint64_t Next() {
+        State ^= State << 13;
+        State ^= State >> 7;
+        State ^= State << 17;
+        return State;
+    }
+    uint64_t Next(uint64_t Max) {
+        return Next() % Max;
+    }
+};
+
+struct SmartTimerWheel {
+    QUIC_TIMER_WHEEL TimerWheel;
+    QUIC_CONNECTION* Connections;
+    uint32_t ConnectionCount;
+    SmartTimerWheel(uint32_t Count) : ConnectionCount(Count) {
+        EXPECT_EQ(QUIC_STATUS_SUCCESS, QuicTimerWheelInitialize(&TimerWheel));
+        Connections = QuicTestConnectionsAllocate(Count);
+        if (Connections == nullptr) {
+            throw std::bad_alloc();
+        }
+    }
+    ~SmartTimerWheel() {
+        for (uint32_t i = 0; i < ConnectionCount; ++i) {
+            QuicTimerWheelRemoveConnection(&TimerWheel, Connection(i));
+        }
+        QuicTimerWheelUninitialize(&TimerWheel);
+        QuicTestConnectionsFree(Connections);
+    }
+    QUIC_CONNECTION* Connection(uint32_t Index) {
+        return QuicTestConnectionAt(Connections, Index);
+    }
+    uint64_t& ExpirationTime(uint32_t Index) {
+        return *QuicTestConnectionExpirationTime(Connection(Index));
+    }
+    QUIC_LIST_ENTRY* TimerLink(uint32_t Index) {
+        return QuicTestConnectionTimerLink(Connection(Index));
+    }
+    uint64_t Now() const {
+        return TimerWheel.CurrentTime;
+    }
+    void Set(uint32_t Index, uint64_t Time) {
+        ExpirationTime(Index) = Time;
+        QuicTimerWheelUpdateConnection(&TimerWheel, Connection(Index));
+    }
+    void Remove(uint32_t Index) {
+        ExpirationTime(Index) = UINT64_MAX;
+        QuicTimerWheelRemoveConnection(&TimerWheel, Connection(Index));
+    }
+    uint32_t Expire(uint64_t TimeNow) {
+        QUIC_LIST_ENTRY ExpiredTimers;
+        QuicListInitializeHead(&ExpiredTimers);
+        QuicTimerWheelGetExpired(&TimerWheel, TimeNow, &ExpiredTimers);
+        uint32_t Count = 0;
+        while (!QuicListIsEmpty(&ExpiredTimers)) {
+            QUIC_LIST_ENTRY* Entry = QuicListRemoveHead(&ExpiredTimers);
+            Entry->Flink = NULL;
+            uint32_t Index =
+                QuicTestConnectionIndex(
+                    Connections, QuicTestConnectionFromTimerLink(Entry));
+            EXPECT_LE(ExpirationTime(Index), TimeNow);
+            ExpirationTime(Index) = UINT64_MAX;
+            Count++;
+        }
+        return Count;
+    }
+    void Validate() {
+        //
+        // Nothing expired may be left behind, and the next expiration time
+        // must never be later than the earliest remaining timer.
+        //
+        uint64_t Earliest = UINT64_MAX;
+        uint64_t Count = 0;
+        for (uint32_t i = 0; i < ConnectionCount; ++i) {
+            uint64_t Time = ExpirationTime(i);
+            if (Time != UINT64_MAX) {
+                ASSERT_NE(nullptr, TimerLink(i)->Flink);
+                ASSERT_GT(Time, Now());
+                if (Time < Earliest) {
+                    Earliest = Time;
+                }
+                Count++;
+            } else {
+                ASSERT_EQ(nullptr, TimerLink(i)->Flink);
+            }
+        }
+        ASSERT_EQ(Count, TimerWheel.ConnectionCount);
+        ASSERT_LE(TimerWheel.NextExpirationTime, Earliest);
+        if (Count == 0) {
+            ASSERT_EQ(UINT64_MAX, TimerWheel.NextExpirationTime);
+        }
+    }
+};
+
+TEST(TimerWheelTest, Empty)
+{
+    SmartTimerWheel Wheel(1);
+    ASSERT_EQ(UINT64_MAX, QuicTimerWheelGetWaitTime(&Wheel.TimerWheel));
+    ASSERT_EQ(0u, Wheel.Expire(Wheel.Now() + 1000000));
+    Wheel.Validate();
+}
+
+TEST(TimerWheelTest, ExactExpiration)
+{
+    SmartTimerWheel Wheel(3);
+    const uint64_t Start = Wheel.Now();
+    Wheel.Set(0, Start + 1);
+    Wheel.Set(1, Start + 100);
+    Wheel.Set(2, Start + 5000000);
+    ASSERT_EQ(Start + 1, Wheel.TimerWheel.NextExpirationTime);
+
+    ASSERT_EQ(0u, Wheel.Expire(Start));
+    ASSERT_EQ(1u, Wheel.Expire(Start + 1));
+    ASSERT_EQ(0u, Wheel.Expire(Start + 99));
+    Wheel.Validate();
+    ASSERT_EQ(1u, Wheel.Expire(Start + 100));
+    ASSERT_EQ(0u, Wheel.Expire(Start + 4999999));
+    Wheel.Validate();
+    ASSERT_EQ(Start + 5000000, Wheel.TimerWheel.NextExpirationTime);
+    ASSERT_EQ(1u, Wheel.Expire(Start + 5000000));
+    Wheel.Validate();
+}
+
+TEST(TimerWheelTest, AlreadyExpired)
+{
+    SmartTimerWheel Wheel(2);
+    const uint64_t Start = Wheel.Now();
+    Wheel.Set(0, Start - 10);
+    Wheel.Set(1, 0);
+    ASSERT_EQ(0ull, QuicTimerWheelGetWaitTime(&Wheel.TimerWheel));
+    ASSERT_EQ(2u, Wheel.Expire(Start));
+    Wheel.Validate();
+}
+
+TEST(TimerWheelTest, Randomized)
+{
+    const uint32_t ConnectionCount = 1000;
+    SmartTimerWheel Wheel(ConnectionCount);
+    TestRandom Random(0x123456789ull);
+
+    for (uint32_t Round = 0; Round < 200; ++Round) {
+        //
+        // Arm, move and cancel timers with delays spread over every level.
+        //
+        for (uint32_t i = 0; i < ConnectionCount / 2; ++i) {
+            uint32_t Index = (uint32_t)Random.Next(ConnectionCount);
+            if (Random.Next(8) == 0) {
+                Wheel.Remove(Index);
+            } else {
+                uint64_t Delay = Random.Next(1ull << Random.Next(40)) + 1;
+                Wheel.Set(Index, Wheel.Now() + Delay);
+            }
+        }
+        Wheel.Validate();
+
+        //
+        // Advance time by a random step, sometimes by a very large one.
+        //
+        uint64_t Step = Random.Next(1ull << Random.Next(Round % 10 == 0 ? 40 : 20));
+        Wheel.Expire(Wheel.Now() + Step);
+        Wheel.Validate();
+    }
+}
+
+//
+// Not part of the default run. Use --gtest_also_run_disabled_tests to run it.
+//
+TEST(TimerWheelTest, DISABLED_UpdateBenchmark)
+{
+    //
+    // Simulates a worker with many connections that constantly reschedule
+    // their timers (ACK delay, loss detection, idle), while time advances.
+    //
+    const uint32_t ConnectionCount = 10000;
+    const uint32_t UpdateCount = 4000000;
+    SmartTimerWheel Wheel(ConnectionCount);
+    TestRandom Random(0x987654321ull);
+    uint64_t SimTime = Wheel.Now();
+    uint32_t ExpiredCount = 0;
+
+    uint64_t TimeStart = QuicTimeUs64();
+    for (uint32_t i = 0; i < UpdateCount; ++i) {
+        uint32_t Index = (uint32_t)Random.Next(ConnectionCount);
+        uint64_t Delay;
+        switch (Random.Next(4)) {
+        case 0:  Delay = 25000; break;                              // ACK delay
+        case 1:  Delay = 1000 + Random.Next(200000); break;         // Loss detection
+        case 2:  Delay = 30000000; break;                           // Idle
+        default: Delay = Random.Next(1000); break;                  // Pacing
+        }
+        Wheel.Set(Index, SimTime + Delay);
+        if ((i & 63) == 0) {
+            SimTime += 50;
+            ExpiredCount += Wheel.Expire(SimTime);
+        }
+    }
+    uint64_t TimeEnd = QuicTimeUs64();
+
+    Wheel.Validate();
+    uint64_t ElapsedUs = QuicTimeDiff64(TimeStart, TimeEnd);
+    printf("%u updates (%u expirations) in %llu us (%llu ns/update)\n",
+        UpdateCount, ExpiredCount, (unsigned long long)ElapsedUs,
+        (unsigned long long)(ElapsedUs * 1000 / UpdateCount));
+}
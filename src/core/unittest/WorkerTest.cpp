@@ -0,0 +1,122 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Unit test for the worker pool rebalancing logic.
+
+--*/
+
+#include "main.h"
+#ifdef QUIC_CLOG
+#include "WorkerTest.cpp.clog.h"
+#endif
+
+struct SmartWorkerPool {
+    QUIC_WORKER_POOL* Pool;
+    uint32_t PrevMaxWorkerQueueDelayUs;
+    SmartWorkerPool(uint16_t WorkerCount) {
+        Pool =
+            (QUIC_WORKER_POOL*)calloc(
+                1, sizeof(QUIC_WORKER_POOL) + WorkerCount * sizeof(QUIC_WORKER));
+        Pool->WorkerCount = WorkerCount;
+        for (uint16_t i = 0; i < WorkerCount; ++i) {
+            Pool->Workers[i].Enabled = TRUE;
+        }
+        PrevMaxWorkerQueueDelayUs = MsQuicLib.Settings.MaxWorkerQueueDelayUs;
+        MsQuicLib.Settings.MaxWorkerQueueDelayUs = MS_TO_US(QUIC_MAX_WORKER_QUEUE_DELAY);
+    }
+    ~SmartWorkerPool() {
+        MsQuicLib.Settings.MaxWorkerQueueDelayUs = PrevMaxWorkerQueueDelayUs;
+        free(Pool);
+    }
+    QUIC_WORKER* operator[](uint16_t Index) { return &Pool->Workers[Index]; }
+    void SetOverloaded(uint16_t Index) {
+        Pool->Workers[Index].IsActive = TRUE;
+        Pool->Workers[Index].AverageQueueDelay =
+            MsQuicLib.Settings.MaxWorkerQueueDelayUs + 1;
+    }
+    void SetIdle(uint16_t Index, uint32_t QueueDelay) {
+        Pool->Workers[Index].IsActive = FALSE;
+        Pool->Workers[Index].AverageQueueDelay = QueueDelay;
+    }
+    QUIC_WORKER* Target(uint16_t Index, uint32_t LastRebalanceTime = 0, uint32_t TimeNow = 1000) {
+        return
+            QuicWorkerPoolGetRebalanceTarget(
+                Pool, &Pool->Workers[Index], LastRebalanceTime, TimeNow);
+    }
+};
+
+TEST(WorkerTest, RebalanceNotOverloaded)
+{
+    SmartWorkerPool Pool(4);
+    Pool.SetIdle(0, 1000);
+    Pool.SetIdle(1, 0);
+    ASSERT_EQ(nullptr, Pool.Target(0));
+}
+
+TEST(WorkerTest, RebalanceToLeastLoadedIdlePeer)
+{
+    SmartWorkerPool Pool(4);
+    Pool.SetOverloaded(0);
+    Pool.SetIdle(1, 2000);
+    Pool[2]->IsActive = TRUE; // Busy, even though its queue delay is lowest.
+    Pool.SetIdle(3, 1000);
+    ASSERT_EQ(Pool[3], Pool.Target(0));
+
+    Pool[2]->IsSpinning = TRUE; // Spinning workers are idle.
+    ASSERT_EQ(Pool[2], Pool.Target(0));
+
+    Pool[2]->Enabled = FALSE;
+    ASSERT_EQ(Pool[3], Pool.Target(0));
+}
+
+TEST(WorkerTest, RebalanceNeverPicksCurrentWorker)
+{
+    //
+    // Even with every other worker unsuitable, the connection's own worker is
+    // never returned as the target.
+    //
+    SmartWorkerPool Pool(2);
+    Pool.SetOverloaded(0);
+    Pool.SetOverloaded(1);
+    ASSERT_EQ(nullptr, Pool.Target(0));
+
+    SmartWorkerPool Single(1);
+    Single.SetOverloaded(0);
+    Single[0]->IsSpinning = TRUE;
+    ASSERT_EQ(nullptr, Single.Target(0));
+}
+
+TEST(WorkerTest, RebalanceHysteresis)
+{
+    SmartWorkerPool Pool(2);
+    Pool.SetOverloaded(0);
+
+    //
+    // A peer that's idle but near the overload threshold isn't a target.
+    //
+    Pool.SetIdle(1, MsQuicLib.Settings.MaxWorkerQueueDelayUs / 2 + 1);
+    ASSERT_EQ(nullptr, Pool.Target(0));
+    Pool.SetIdle(1, MsQuicLib.Settings.MaxWorkerQueueDelayUs / 2);
+    ASSERT_EQ(Pool[1], Pool.Target(0));
+
+    //
+    // A connection that was just moved stays put until the hold time passes,
+    // even if its new worker becomes overloaded and the old one goes idle.
+    //
+    const uint32_t MovedTime = 5000;
+    Pool.SetOverloaded(1);
+    Pool.SetIdle(0, 0);
+    ASSERT_EQ(nullptr, Pool.Target(1, MovedTime, MovedTime));
+    ASSERT_EQ(nullptr, Pool.Target(1, MovedTime, MovedTime + QUIC_WORKER_REBALANCE_HOLD_TIME_US - 1));
+    ASSERT_EQ(Pool[0], Pool.Target(1, MovedTime, MovedTime + QUIC_WORKER_REBALANCE_HOLD_TIME_US));
+
+    //
+    // The hold time is measured correctly across the 32-bit time wrap.
+    //
+    const uint32_t WrapTime = UINT32_MAX - 10;
+    ASSERT_EQ(nullptr, Pool.Target(1, WrapTime, WrapTime + 20));
+}
@@ -185,7 +185,7 @@ QuicWorkerQueueConnection(
 
     BOOLEAN WakeWorkerThread;
     if (!Connection->WorkerProcessing && !Connection->HasQueuedWork) {
-        WakeWorkerThread = QuicWorkerIsIdle(Worker);
+        WakeWorkerThread = QuicWorkerIsIdle(Worker) && !Worker->IsSpinning;
         Connection->Stats.Schedule.LastQueueTime = QuicTimeUs32();
         QuicTraceEvent(
             ConnScheduleState,
@@ -223,7 +223,7 @@ QuicWorkerMoveConnection(
 
     QuicDispatchLockAcquire(&Worker->Lock);
 
-    BOOLEAN WakeWorkerThread = QuicWorkerIsIdle(Worker);
+    BOOLEAN WakeWorkerThread = QuicWorkerIsIdle(Worker) && !Worker->IsSpinning;
 
     if (Connection->HasQueuedWork) {
         Connection->Stats.Schedule.LastQueueTime = QuicTimeUs32();
@@ -256,7 +256,7 @@ QuicWorkerQueueOperation(
     if (Worker->OperationCount < MsQuicLib.Settings.MaxStatelessOperations &&
         QuicLibraryTryAddRefBinding(Operation->STATELESS.Context->Binding)) {
         Operation->STATELESS.Context->HasBindingRef = TRUE;
-        WakeWorkerThread = QuicWorkerIsIdle(Worker);
+        WakeWorkerThread = QuicWorkerIsIdle(Worker) && !Worker->IsSpinning;
         QuicListInsertTail(&Worker->Operations, &Operation->Link);
         Worker->OperationCount++;
         Operation = NULL;
@@ -425,6 +425,42 @@ QuicWorkerProcessTimers(
     }
 }
 
+//
+// Returns the worker in the connection's registration pool the connection
+// should be handed off to, because this worker is overloaded while that one
+// sits idle, or NULL if it should stay. The connection's timer wheel state can
+// only be handed off from the thread currently owning it, so rather than having
+// idle workers pull queued connections out from under the overloaded worker,
+// the overloaded worker pushes them out as it dequeues them.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_WORKER*
+QuicWorkerGetRebalanceTarget(
+    _In_ QUIC_WORKER* Worker,
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    if (Connection->Registration == NULL ||
+        Connection->Registration->NoPartitioning ||
+        !Connection->State.ExternalOwner ||
+        Connection->State.HandleClosed) {
+        return NULL;
+    }
+
+    QUIC_WORKER_POOL* WorkerPool = Connection->Registration->WorkerPool;
+    if (Worker < WorkerPool->Workers ||
+        Worker >= WorkerPool->Workers + WorkerPool->WorkerCount) {
+        return NULL; // Not (yet) running on one of the registration's workers.
+    }
+
+    return
+        QuicWorkerPoolGetRebalanceTarget(
+            WorkerPool,
+            Worker,
+            Connection->Stats.Schedule.LastRebalanceTime,
+            QuicTimeUs32());
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicWorkerProcessConnection(
@@ -453,6 +489,7 @@ QuicWorkerProcessConnection(
     Connection->WorkerThreadID = Worker->ThreadID;
     Connection->Stats.Schedule.DrainCount++;
 
+    QUIC_WORKER* RebalanceWorker = NULL;
     if (Connection->State.UpdateWorker) {
         //
         // If the connection is uninitialized already, it shouldn't have been
@@ -479,6 +516,17 @@ QuicWorkerProcessConnection(
             Connection,
             "Indicating QUIC_CONNECTION_EVENT_IDEAL_PROCESSOR_CHANGED");
         (void)QuicConnIndicateEvent(Connection, &Event);
+
+    } else if ((RebalanceWorker = QuicWorkerGetRebalanceTarget(Worker, Connection)) != NULL) {
+        //
+        // Instead of making the connection wait behind this worker's backlog
+        // again, move it (and any queued operations) to the idle worker. This
+        // uses the same path as a partition change. Setting UpdateWorker
+        // keeps the operations below from changing the partition meanwhile.
+        //
+        Connection->State.UpdateWorker = TRUE;
+        Connection->Stats.Schedule.LastRebalanceTime = QuicTimeUs32();
+        QuicPerfCounterIncrement(QUIC_PERF_COUNTER_WORK_CONN_REBALANCED);
     }
 
     //
@@ -533,8 +581,11 @@ QuicWorkerProcessConnection(
             //
             QuicTimerWheelRemoveConnection(&Worker->TimerWheel, Connection);
             QUIC_FRE_ASSERT(Connection->Registration != NULL);
-            QuicRegistrationQueueNewConnection(Connection->Registration, Connection);
-            QUIC_DBG_ASSERT(Worker != Connection->Worker);
+            if (RebalanceWorker != NULL) {
+                QuicWorkerAssignConnection(RebalanceWorker, Connection);
+            } else {
+                QuicRegistrationQueueNewConnection(Connection->Registration, Connection);
+            }
             QuicWorkerMoveConnection(Connection->Worker, Connection);
         }
 
@@ -546,6 +597,50 @@ QuicWorkerProcessConnection(
     }
 }
 
+//
+// Spins for up to the configured spin time (bounded by the next timer
+// expiration), polling for newly queued connections or operations before the
+// worker falls back to blocking on its ready event. Avoids the cost of a
+// sleep/wake round trip when new work arrives shortly after the worker runs
+// dry. Returns TRUE if new work was found.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicWorkerSpin(
+    _In_ QUIC_WORKER* Worker,
+    _In_ uint64_t DelayMs
+    )
+{
+    uint64_t SpinTimeUs = MsQuicLib.Settings.SpinTimeUs;
+    if (SpinTimeUs == 0) {
+        return FALSE;
+    }
+    if (DelayMs != UINT64_MAX && MS_TO_US(DelayMs) < SpinTimeUs) {
+        SpinTimeUs = MS_TO_US(DelayMs);
+    }
+
+    const uint64_t SpinStart = QuicTimeUs64();
+
+    //
+    // The lock is briefly released on each iteration to let producers in. They
+    // skip setting the ready event while IsSpinning is set, so it must only be
+    // cleared under the lock, after a final check for work.
+    //
+    QuicDispatchLockAcquire(&Worker->Lock);
+    Worker->IsSpinning = TRUE;
+    while (QuicWorkerIsIdle(Worker) &&
+           Worker->Enabled &&
+           QuicTimeDiff64(SpinStart, QuicTimeUs64()) < SpinTimeUs) {
+        QuicDispatchLockRelease(&Worker->Lock);
+        QuicDispatchLockAcquire(&Worker->Lock);
+    }
+    const BOOLEAN FoundWork = !QuicWorkerIsIdle(Worker);
+    Worker->IsSpinning = FALSE;
+    QuicDispatchLockRelease(&Worker->Lock);
+
+    return FoundWork;
+}
+
 QUIC_THREAD_CALLBACK(QuicWorkerThread, Context)
 {
     QUIC_WORKER* Worker = (QUIC_WORKER*)Context;
@@ -607,17 +702,31 @@ QUIC_THREAD_CALLBACK(QuicWorkerThread, Context)
             //
             continue;
 
+        } else if (QuicWorkerSpin(Worker, Delay)) {
+            //
+            // New work was queued while spinning, so go straight back to
+            // processing it without blocking.
+            //
+            QuicPerfCounterIncrement(QUIC_PERF_COUNTER_WORK_SPIN_WAKES);
+
         } else if (Delay != UINT64_MAX) {
             //
             // Since we have no connections and no stateless operations to
             // process at the moment, we need to wait for the ready event or the
             // next timer to expire.
             //
+            if (MsQuicLib.Settings.SpinTimeUs != 0) {
+                //
+                // Account for any time spent spinning.
+                //
+                Delay = QuicTimerWheelGetWaitTime(&Worker->TimerWheel);
+            }
             if (Delay >= (uint64_t)UINT32_MAX) {
                 Delay = UINT32_MAX - 1; // Max has special meaning for most platforms.
             }
             QuicWorkerToggleActivityState(Worker, (uint32_t)Delay);
             QuicWorkerResetQueueDelay(Worker);
+            QuicPerfCounterIncrement(QUIC_PERF_COUNTER_WORK_SLEEPS);
             BOOLEAN ReadySet =
                 QuicEventWaitWithTimeout(Worker->Ready, (uint32_t)Delay);
             QuicWorkerToggleActivityState(Worker, ReadySet);
@@ -632,6 +741,7 @@ QUIC_THREAD_CALLBACK(QuicWorkerThread, Context)
             //
             QuicWorkerToggleActivityState(Worker, UINT32_MAX);
             QuicWorkerResetQueueDelay(Worker);
+            QuicPerfCounterIncrement(QUIC_PERF_COUNTER_WORK_SLEEPS);
             QuicEventWaitForever(Worker->Ready);
             QuicWorkerToggleActivityState(Worker, TRUE);
         }
@@ -768,6 +878,49 @@ QuicWorkerPoolIsOverloaded(
     return TRUE;
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_WORKER*
+QuicWorkerPoolGetRebalanceTarget(
+    _In_ QUIC_WORKER_POOL* WorkerPool,
+    _In_ QUIC_WORKER* Worker,
+    _In_ uint32_t LastRebalanceTime,
+    _In_ uint32_t TimeNow
+    )
+{
+    if (!QuicWorkerIsOverloaded(Worker)) {
+        return NULL;
+    }
+
+    //
+    // A connection that was just moved stays put for a while, so it doesn't
+    // bounce between workers whose loads are oscillating.
+    //
+    if (LastRebalanceTime != 0 &&
+        QuicTimeDiff32(LastRebalanceTime, TimeNow) < QUIC_WORKER_REBALANCE_HOLD_TIME_US) {
+        return NULL;
+    }
+
+    //
+    // Only move to an idle worker that is well under the overload threshold,
+    // so that taking on the connection doesn't immediately make it overloaded
+    // (and a candidate to move the connection back).
+    //
+    const uint32_t MaxTargetQueueDelay = MsQuicLib.Settings.MaxWorkerQueueDelayUs / 2;
+    QUIC_WORKER* Target = NULL;
+    for (uint16_t i = 0; i < WorkerPool->WorkerCount; ++i) {
+        QUIC_WORKER* Peer = &WorkerPool->Workers[i];
+        if (Peer != Worker &&
+            Peer->Enabled &&
+            (!Peer->IsActive || Peer->IsSpinning) &&
+            Peer->AverageQueueDelay <= MaxTargetQueueDelay &&
+            (Target == NULL || Peer->AverageQueueDelay < Target->AverageQueueDelay)) {
+            Target = Peer;
+        }
+    }
+
+    return Target;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 uint16_t
 QuicWorkerPoolGetLeastLoadedWorker(
@@ -20,6 +20,12 @@ typedef struct QUIC_CACHEALIGN QUIC_WORKER {
     //
     BOOLEAN IsActive;
 
+    //
+    // TRUE if the worker is spinning, looking for new work before blocking.
+    // Producers don't need to set the ready event while this is set.
+    //
+    BOOLEAN IsSpinning;
+
     //
     // The worker's ideal processor.
     //
@@ -153,6 +159,20 @@ QuicWorkerPoolGetLeastLoadedWorker(
     _In_ QUIC_WORKER_POOL* WorkerPool
     );
 
+//
+// Gets the worker a connection on the given (overloaded) worker should be
+// moved to, or NULL if it should stay. LastRebalanceTime is when the
+// connection was last moved, or zero if never.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_WORKER*
+QuicWorkerPoolGetRebalanceTarget(
+    _In_ QUIC_WORKER_POOL* WorkerPool,
+    _In_ QUIC_WORKER* Worker,
+    _In_ uint32_t LastRebalanceTime,
+    _In_ uint32_t TimeNow
+    );
+
 //
 // Assigns the connection to a worker.
 //
@@ -120,6 +120,12 @@ typedef enum QUIC_SERVER_RESUMPTION_LEVEL {
     QUIC_SERVER_RESUME_AND_ZERORTT
 } QUIC_SERVER_RESUMPTION_LEVEL;
 
+typedef enum QUIC_CONGESTION_CONTROL_ALGORITHM {
+    QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC,
+    QUIC_CONGESTION_CONTROL_ALGORITHM_BBR,
+    QUIC_CONGESTION_CONTROL_ALGORITHM_MAX
+} QUIC_CONGESTION_CONTROL_ALGORITHM;
+
 typedef enum QUIC_SEND_RESUMPTION_FLAGS {
     QUIC_SEND_RESUMPTION_FLAG_NONE          = 0x0000,
     QUIC_SEND_RESUMPTION_FLAG_FINAL         = 0x0001    // Free TLS state after sending this ticket.
@@ -133,6 +139,20 @@ typedef enum QUIC_STREAM_SCHEDULING_SCHEME {
     QUIC_STREAM_SCHEDULING_SCHEME_COUNT                     // The number of stream scheduling schemes.
 } QUIC_STREAM_SCHEDULING_SCHEME;
 
+//
+// Streams at a higher priority level are always sent before streams at a lower
+// level. Streams at the same level are scheduled per the connection's stream
+// scheduling scheme, with round robin turns sized by each stream's weight.
+//
+#define QUIC_STREAM_PRIORITY_LEVEL_COUNT        8
+#define QUIC_STREAM_PRIORITY_LEVEL_DEFAULT      4
+#define QUIC_STREAM_PRIORITY_WEIGHT_DEFAULT     1
+
+typedef struct QUIC_STREAM_PRIORITY {
+    uint8_t Level;      // 0 (lowest) to QUIC_STREAM_PRIORITY_LEVEL_COUNT - 1 (highest).
+    uint8_t Weight;     // Relative share of round robin turns within a level. Must be non-zero.
+} QUIC_STREAM_PRIORITY;
+
 typedef enum QUIC_STREAM_OPEN_FLAGS {
     QUIC_STREAM_OPEN_FLAG_NONE              = 0x0000,
     QUIC_STREAM_OPEN_FLAG_UNIDIRECTIONAL    = 0x0001,   // Indicates the stream is unidirectional.
@@ -274,6 +294,15 @@ typedef struct QUIC_NEW_CONNECTION_INFO {
     const char* ServerName;
 } QUIC_NEW_CONNECTION_INFO;
 
+//
+// The state of the path MTU search (DPLPMTUD) on a connection's current path.
+//
+typedef enum QUIC_PATH_MTU_SEARCH_STATE {
+    QUIC_PATH_MTU_SEARCH_STATE_DISABLED,    // Not started; at the base MTU.
+    QUIC_PATH_MTU_SEARCH_STATE_SEARCHING,   // Probing for a larger MTU.
+    QUIC_PATH_MTU_SEARCH_STATE_COMPLETE     // Done, until the next raise attempt.
+} QUIC_PATH_MTU_SEARCH_STATE;
+
 //
 // All statistics available to query about a connection.
 //
@@ -320,6 +349,14 @@ typedef struct QUIC_STATISTICS {
     struct {
         uint32_t KeyUpdateCount;
     } Misc;
+    //
+    // Fields below were added after the original version of this struct, and
+    // are only returned if the caller's buffer is big enough to hold them.
+    //
+    uint32_t PathMtuSearchState;        // QUIC_PATH_MTU_SEARCH_STATE of the current path.
+    uint32_t PathMtuProbeCount;         // Number of path MTU probes sent.
+    uint32_t PathMtuBlackHoleCount;     // Number of times the path MTU was reset to the base.
+    uint64_t EstimatedBandwidth;        // Recent max delivery rate, in bytes per second.
 } QUIC_STATISTICS;
 
 typedef struct QUIC_LISTENER_STATISTICS {
@@ -362,6 +399,11 @@ typedef enum QUIC_PERFORMANCE_COUNTERS {
     QUIC_PERF_COUNTER_WORK_OPER_QUEUE_DEPTH,// Current worker operations queued.
     QUIC_PERF_COUNTER_WORK_OPER_QUEUED,     // Total worker operations queued ever.
     QUIC_PERF_COUNTER_WORK_OPER_COMPLETED,  // Total worker operations processed ever.
+    QUIC_PERF_COUNTER_WORK_SPIN_WAKES,      // Total times a spinning worker found work.
+    QUIC_PERF_COUNTER_WORK_SLEEPS,          // Total times a worker blocked waiting for work.
+    QUIC_PERF_COUNTER_UDP_SPIN_WAKES,       // Total times a spinning datapath thread found events.
+    QUIC_PERF_COUNTER_UDP_SLEEPS,           // Total times a datapath thread blocked waiting for events.
+    QUIC_PERF_COUNTER_WORK_CONN_REBALANCED, // Total connections moved off an overloaded worker.
     QUIC_PERF_COUNTER_MAX
 } QUIC_PERFORMANCE_COUNTERS;
 
@@ -396,7 +438,14 @@ typedef struct QUIC_SETTINGS {
             uint64_t MigrationEnabled           : 1;
             uint64_t DatagramReceiveEnabled     : 1;
             uint64_t ServerResumptionLevel      : 1;
-            uint64_t RESERVED                   : 38;
+            uint64_t SpinTimeUs                 : 1;
+            uint64_t BusyPollUs                 : 1;
+            uint64_t ZeroCopySendEnabled        : 1;
+            uint64_t DatapathPacingEnabled      : 1;
+            uint64_t CryptoOffloadEnabled       : 1;
+            uint64_t HandshakeOffloadEnabled    : 1;
+            uint64_t CongestionControlAlgorithm : 1;
+            uint64_t RESERVED                   : 31;
         } IsSet;
     };
 
@@ -426,7 +475,13 @@ typedef struct QUIC_SETTINGS {
     uint8_t MigrationEnabled        : 1;
     uint8_t DatagramReceiveEnabled  : 1;
     uint8_t ServerResumptionLevel   : 2;    // QUIC_SERVER_RESUMPTION_LEVEL
-    uint8_t RESERVED                : 2;
+    uint8_t ZeroCopySendEnabled     : 1;    // Global only
+    uint8_t DatapathPacingEnabled   : 1;
+    uint32_t SpinTimeUs;                    // Global only
+    uint32_t BusyPollUs;                    // Global only
+    uint8_t CryptoOffloadEnabled    : 1;
+    uint8_t HandshakeOffloadEnabled : 1;
+    uint16_t CongestionControlAlgorithm;    // QUIC_CONGESTION_CONTROL_ALGORITHM
 
 } QUIC_SETTINGS;
 
@@ -541,6 +596,7 @@ typedef struct QUIC_SCHANNEL_CONTEXT_ATTRIBUTE_W {
 #define QUIC_PARAM_STREAM_ID                            0   // QUIC_UINT62
 #define QUIC_PARAM_STREAM_0RTT_LENGTH                   1   // uint64_t
 #define QUIC_PARAM_STREAM_IDEAL_SEND_BUFFER_SIZE        2   // uint64_t - bytes
+#define QUIC_PARAM_STREAM_PRIORITY                      3   // QUIC_STREAM_PRIORITY
 
 typedef
 _IRQL_requires_max_(PASSIVE_LEVEL)
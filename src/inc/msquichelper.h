@@ -516,6 +516,12 @@ WriteSslKeyLogFile(
     _In_ QUIC_TLS_SECRETS& TlsSecrets
     )
 {
+    const uint8_t SecretLength = TlsSecrets.SecretLength;
+    if (SecretLength > QUIC_TLS_SECRETS_MAX_SECRET_LEN) {
+        printf("Invalid TLS secret length %hhu\n", SecretLength);
+        return;
+    }
+
     FILE* File = nullptr;
 #ifdef _WIN32
     if (fopen_s(&File, FileName, "ab")) {
@@ -545,7 +551,7 @@ WriteSslKeyLogFile(
     if (TlsSecrets.IsSet.ClientEarlyTrafficSecret) {
         EncodeHexBuffer(
             TlsSecrets.ClientEarlyTrafficSecret,
-            TlsSecrets.SecretLength,
+            SecretLength,
             TempHexBuffer);
         fprintf(
             File,
@@ -557,7 +563,7 @@ WriteSslKeyLogFile(
     if (TlsSecrets.IsSet.ClientHandshakeTrafficSecret) {
         EncodeHexBuffer(
             TlsSecrets.ClientHandshakeTrafficSecret,
-            TlsSecrets.SecretLength,
+            SecretLength,
             TempHexBuffer);
         fprintf(
             File,
@@ -569,7 +575,7 @@ WriteSslKeyLogFile(
     if (TlsSecrets.IsSet.ServerHandshakeTrafficSecret) {
         EncodeHexBuffer(
             TlsSecrets.ServerHandshakeTrafficSecret,
-            TlsSecrets.SecretLength,
+            SecretLength,
             TempHexBuffer);
         fprintf(
             File,
@@ -581,7 +587,7 @@ WriteSslKeyLogFile(
     if (TlsSecrets.IsSet.ClientTrafficSecret0) {
         EncodeHexBuffer(
             TlsSecrets.ClientTrafficSecret0,
-            TlsSecrets.SecretLength,
+            SecretLength,
             TempHexBuffer);
         fprintf(
             File,
@@ -593,7 +599,7 @@ WriteSslKeyLogFile(
     if (TlsSecrets.IsSet.ServerTrafficSecret0) {
         EncodeHexBuffer(
             TlsSecrets.ServerTrafficSecret0,
-            TlsSecrets.SecretLength,
+            SecretLength,
             TempHexBuffer);
         fprintf(
             File,
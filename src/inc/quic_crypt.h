@@ -148,6 +148,12 @@ typedef enum QUIC_PACKET_KEY_TYPE {
 
 } QUIC_PACKET_KEY_TYPE;
 
+//
+// The maximum number of duplicates of a packet key that may be used to
+// encrypt or decrypt packets on other threads at the same time.
+//
+#define QUIC_PACKET_KEY_MAX_DUPLICATES 4
+
 #pragma warning(disable:4200)  // nonstandard extension used: zero-length array in struct/union
 
 typedef struct QUIC_PACKET_KEY {
@@ -155,6 +161,13 @@ typedef struct QUIC_PACKET_KEY {
     QUIC_PACKET_KEY_TYPE Type;
     QUIC_KEY* PacketKey;
     QUIC_HP_KEY* HeaderKey;
+
+    //
+    // Lazily created copies of PacketKey (see QuicKeyDuplicate). Freed along
+    // with the packet key.
+    //
+    QUIC_KEY* PacketKeyDuplicates[QUIC_PACKET_KEY_MAX_DUPLICATES];
+
     uint8_t Iv[QUIC_IV_LENGTH];
     QUIC_SECRET TrafficSecret[0]; // Only preset for Type == QUIC_PACKET_KEY_1_RTT
 
@@ -225,6 +238,17 @@ QuicKeyFree(
     _In_opt_ QUIC_KEY* Key
     );
 
+//
+// Creates an independent copy of the key. A key may only be used by one thread
+// at a time, so each thread working on the same connection needs its own copy.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QuicKeyDuplicate(
+    _In_ QUIC_KEY* Key,
+    _Out_ QUIC_KEY** NewKey
+    );
+
 static_assert(
     sizeof(uint64_t) < QUIC_IV_LENGTH,
     "Packet Number Length is less than IV Length");
@@ -300,6 +324,58 @@ QuicDecrypt(
         uint8_t* Buffer
     );
 
+//
+// A single packet of a batched encryption or decryption. The fields match the
+// parameters of QuicEncrypt and QuicDecrypt.
+//
+typedef struct QUIC_CRYPT_BATCH_ENTRY {
+
+    _Field_size_bytes_(QUIC_IV_LENGTH)
+    const uint8_t* Iv;
+
+    _Field_size_bytes_opt_(AuthDataLength)
+    const uint8_t* AuthData;
+
+    _Field_size_bytes_(BufferLength)
+    uint8_t* Buffer;
+
+    uint16_t AuthDataLength;
+    uint16_t BufferLength;
+
+    //
+    // Output: the result for this packet.
+    //
+    QUIC_STATUS Status;
+
+} QUIC_CRYPT_BATCH_ENTRY;
+
+//
+// Encrypts a batch of packets with the given key, as QuicEncrypt does for
+// each. Returns the first failure, if any.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QuicEncryptBatch(
+    _In_ QUIC_KEY* Key,
+    _In_ uint8_t BatchSize,
+    _Inout_updates_(BatchSize)
+        QUIC_CRYPT_BATCH_ENTRY* Batch
+    );
+
+//
+// Decrypts a batch of packets with the given key, as QuicDecrypt does for
+// each. A packet failing to decrypt doesn't stop the rest of the batch, so
+// each entry's Status must be checked. Returns the first failure, if any.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QuicDecryptBatch(
+    _In_ QUIC_KEY* Key,
+    _In_ uint8_t BatchSize,
+    _Inout_updates_(BatchSize)
+        QUIC_CRYPT_BATCH_ENTRY* Batch
+    );
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
 QuicHpKeyCreate(
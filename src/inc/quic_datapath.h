@@ -275,6 +275,9 @@ QuicDataPathUninitialize(
 #define QUIC_DATAPATH_FEATURE_RECV_SIDE_SCALING     0x0001
 #define QUIC_DATAPATH_FEATURE_RECV_COALESCING       0x0002
 #define QUIC_DATAPATH_FEATURE_SEND_SEGMENTATION     0x0004
+#define QUIC_DATAPATH_FEATURE_CID_STEERING          0x0008
+#define QUIC_DATAPATH_FEATURE_SEND_ZEROCOPY         0x0010
+#define QUIC_DATAPATH_FEATURE_SEND_TXTIME           0x0020
 
 //
 // Queries the currently supported features of the datapath.
@@ -294,6 +297,43 @@ QuicDataPathIsPaddingPreferred(
     _In_ QUIC_DATAPATH* Datapath
     );
 
+//
+// Sets how long datapath threads spin polling for new events before blocking,
+// and the kernel busy poll time (SO_BUSY_POLL) applied to newly created
+// sockets. Zero disables either. Platforms without support ignore them.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicDataPathSetPolling(
+    _In_ QUIC_DATAPATH* Datapath,
+    _In_ uint32_t SpinTimeUs,
+    _In_ uint32_t BusyPollUs
+    );
+
+//
+// Queries the number of times datapath threads found new events while
+// spinning, and the number of times they blocked waiting for events.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicDataPathGetPollingStats(
+    _In_ QUIC_DATAPATH* Datapath,
+    _Out_ uint64_t* SpinWakes,
+    _Out_ uint64_t* Sleeps
+    );
+
+//
+// Sets whether large segmented sends are done without copying the data into
+// the kernel. Only has an effect if QUIC_DATAPATH_FEATURE_SEND_ZEROCOPY is
+// supported.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicDataPathSetZeroCopySend(
+    _In_ QUIC_DATAPATH* Datapath,
+    _In_ BOOLEAN Enabled
+    );
+
 //
 // Resolves a hostname to an IP address.
 //
@@ -309,6 +349,19 @@ QuicDataPathResolveAddress(
 // The following APIs are specific to a single UDP port abstraction.
 //
 
+//
+// Binding creation flags.
+//
+#define QUIC_DATAPATH_BINDING_FLAG_NONE             0x0000
+
+//
+// Lets other sockets on the same port share the binding's receives, so that
+// QUIC_DATAPATH_BINDING_PARAM_CID_STEERING can be set on it later. Only for
+// bindings without a remote address, and only takes effect if the datapath
+// supports QUIC_DATAPATH_FEATURE_CID_STEERING.
+//
+#define QUIC_DATAPATH_BINDING_FLAG_CID_STEERING     0x0001
+
 //
 // Creates a datapath binding handle for the given local address and/or remote
 // address. This function immediately registers for receive upcalls from the
@@ -321,6 +374,7 @@ QuicDataPathBindingCreate(
     _In_opt_ const QUIC_ADDR* LocalAddress,
     _In_opt_ const QUIC_ADDR* RemoteAddress,
     _In_opt_ void* RecvCallbackContext,
+    _In_ uint32_t Flags, // QUIC_DATAPATH_BINDING_FLAG_*
     _Out_ QUIC_DATAPATH_BINDING** Binding
     );
 
@@ -430,6 +484,19 @@ QuicDataPathBindingIsSendContextFull(
     _In_ QUIC_DATAPATH_SEND_CONTEXT* SendContext
     );
 
+//
+// Sets the earliest time, on the QuicTimeUs64 clock, the kernel may put the
+// datagrams of the send context on the wire. Zero (the default) sends them
+// immediately. Only has an effect if QUIC_DATAPATH_FEATURE_SEND_TXTIME is
+// supported.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicDataPathBindingSetSendDepartureTime(
+    _In_ QUIC_DATAPATH_SEND_CONTEXT* SendContext,
+    _In_ uint64_t DepartureTimeUs
+    );
+
 //
 // Sends data to a remote host. Note, the buffer must remain valid for
 // the duration of the send operation.
@@ -443,6 +510,34 @@ QuicDataPathBindingSend(
     _In_ QUIC_DATAPATH_SEND_CONTEXT* SendContext
     );
 
+//
+// Binding parameters.
+//
+
+//
+// Steers received short header packets on a binding without a remote address
+// to the processor whose index is encoded in their destination connection ID.
+// Requires QUIC_DATAPATH_FEATURE_CID_STEERING and a binding created with
+// QUIC_DATAPATH_BINDING_FLAG_CID_STEERING.
+//
+#define QUIC_DATAPATH_BINDING_PARAM_CID_STEERING    1   // QUIC_DATAPATH_CID_STEERING
+
+typedef struct QUIC_DATAPATH_CID_STEERING {
+
+    //
+    // Offset of the 2 byte partition ID, in host byte order, in the
+    // destination connection ID.
+    //
+    uint8_t PartitionIdOffset;
+
+    //
+    // The processor index is (PartitionId & PartitionMask) % PartitionCount.
+    //
+    uint16_t PartitionMask;
+    uint16_t PartitionCount;
+
+} QUIC_DATAPATH_CID_STEERING;
+
 //
 // Sets a parameter on the binding.
 //
@@ -78,6 +78,10 @@ Usage examples:
 
 #pragma once
 
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
 #pragma warning(disable:4201)  // nonstandard extension used: nameless struct/union
 
 #define QUIC_HASH_ALLOCATED_HEADER 0x00000001
@@ -128,10 +132,8 @@ typedef struct QUIC_HASHTABLE {
 
     // Entries used in bucket computation.
     uint32_t TableSize;
-#ifdef QUIC_HASHTABLE_RESIZE_SUPPORT
     uint32_t Pivot;
     uint32_t DivisorMask;
-#endif
 
     // Counters
     uint32_t NumEntries;
@@ -225,20 +227,24 @@ QuicHashtableEnumerateEnd(
     _Inout_ QUIC_HASHTABLE_ENUMERATOR* Enumerator
     );
 
-#ifdef QUIC_HASHTABLE_RESIZE_SUPPORT
-
+//
+// Grows the table by one bucket, splitting one existing chain. Fails if the
+// table is at its maximum size, is being enumerated or on allocation failure.
+//
 BOOLEAN
 QuicHashTableExpand(
     _Inout_ QUIC_HASHTABLE* HashTable
     );
 
+//
+// Shrinks the table by one bucket, merging two chains. Fails if the table is
+// at its initial minimum size or is being enumerated.
+//
 BOOLEAN
 QuicHashTableContract(
     _Inout_ QUIC_HASHTABLE* HashTable
     );
 
-#endif // QUIC_HASHTABLE_RESIZE_SUPPORT
-
 //
 // Simple helper hash function.
 //
@@ -257,3 +263,7 @@ QuicHashSimple(
     }
     return Hash;
 }
+
+#if defined(__cplusplus)
+}
+#endif
@@ -124,6 +124,9 @@ typedef struct QUIC_SINGLE_LIST_ENTRY {
 #define QUIC_POOL_STATELESS_CTX             'C3cQ' // Qc3C - QUIC Stateless Context
 #define QUIC_POOL_OPER                      'D3cQ' // Qc3D - QUIC Operation
 #define QUIC_POOL_EVENT                     'E3cQ' // Qc3E - QUIC Event
+#define QUIC_POOL_CID_TABLE                 'F3cQ' // Qc3F - QUIC CID Table
+#define QUIC_POOL_CRYPTO_OFFLOAD            '04cQ' // Qc40 - QUIC Crypto Offload
+#define QUIC_POOL_HANDSHAKE_OFFLOAD         '14cQ' // Qc41 - QUIC Handshake Offload
 
 typedef enum QUIC_THREAD_FLAGS {
     QUIC_THREAD_FLAG_NONE               = 0x0000,
@@ -104,6 +104,29 @@ BOOLEAN
     _In_ QUIC_DATAPATH* Datapath
     );
 
+typedef
+void
+(*QUIC_DATAPATH_SET_POLLING)(
+    _In_ QUIC_DATAPATH* Datapath,
+    _In_ uint32_t SpinTimeUs,
+    _In_ uint32_t BusyPollUs
+    );
+
+typedef
+void
+(*QUIC_DATAPATH_GET_POLLING_STATS)(
+    _In_ QUIC_DATAPATH* Datapath,
+    _Out_ uint64_t* SpinWakes,
+    _Out_ uint64_t* Sleeps
+    );
+
+typedef
+void
+(*QUIC_DATAPATH_SET_ZEROCOPY_SEND)(
+    _In_ QUIC_DATAPATH* Datapath,
+    _In_ BOOLEAN Enabled
+    );
+
 typedef
 QUIC_STATUS
 (*QUIC_DATAPATH_RESOLVE_ADDRESS)(
@@ -119,6 +142,7 @@ QUIC_STATUS
     _In_opt_ const QUIC_ADDR* LocalAddress,
     _In_opt_ const QUIC_ADDR* RemoteAddress,
     _In_opt_ void* RecvCallbackContext,
+    _In_ uint32_t Flags,
     _Out_ QUIC_DATAPATH_BINDING** Binding
     );
 
@@ -187,6 +211,13 @@ BOOLEAN
     _In_ QUIC_DATAPATH_SEND_CONTEXT* SendContext
     );
 
+typedef
+void
+(*QUIC_DATAPATH_BINDING_SET_SEND_DEPARTURE_TIME)(
+    _In_ QUIC_DATAPATH_SEND_CONTEXT* SendContext,
+    _In_ uint64_t DepartureTimeUs
+    );
+
 typedef
 QUIC_STATUS
 (*QUIC_DATAPATH_BINDING_SEND)(
@@ -239,6 +270,9 @@ typedef struct QUIC_PLATFORM_DISPATCH {
     QUIC_DATAPATH_RECVCONTEXT_TO_RECVBUFFER DatapathRecvContextToRecvPacket;
     QUIC_DATAPATH_RECVBUFFER_TO_RECVCONTEXT DatapathRecvPacketToRecvContext;
     QUIC_DATAPATH_IS_PADDING_PREFERRED DatapathIsPaddingPreferred;
+    QUIC_DATAPATH_SET_POLLING DatapathSetPolling;
+    QUIC_DATAPATH_GET_POLLING_STATS DatapathGetPollingStats;
+    QUIC_DATAPATH_SET_ZEROCOPY_SEND DatapathSetZeroCopySend;
     QUIC_DATAPATH_RESOLVE_ADDRESS DatapathResolveAddress;
     QUIC_DATAPATH_BINDING_CREATE DatapathBindingCreate;
     QUIC_DATAPATH_BINDING_DELETE DatapathBindingDelete;
@@ -249,6 +283,7 @@ typedef struct QUIC_PLATFORM_DISPATCH {
     QUIC_DATAPATH_BINDING_ALLOC_SEND_CONTEXT DatapathBindingAllocSendContext;
     QUIC_DATAPATH_BINDING_FREE_SEND_CONTEXT DatapathBindingFreeSendContext;
     QUIC_DATAPATH_BINDING_IS_SEND_CONTEXT_FULL DatapathBindingIsSendContextFull;
+    QUIC_DATAPATH_BINDING_SET_SEND_DEPARTURE_TIME DatapathBindingSetSendDepartureTime;
     QUIC_DATAPATH_BINDING_ALLOC_SEND_BUFFER DatapathBindingAllocSendBuffer;
     QUIC_DATAPATH_BINDING_FREE_SEND_BUFFER DatapathBindingFreeSendBuffer;
     QUIC_DATAPATH_BINDING_SEND DatapathBindingSend;
@@ -98,6 +98,12 @@ QuicPlatformUninitialize(
 #define SIZEOF_STRUCT_MEMBER(StructType, StructMember) sizeof(((StructType *)0)->StructMember)
 #define TYPEOF_STRUCT_MEMBER(StructType, StructMember) typeof(((StructType *)0)->StructMember)
 
+#define ALIGN_DOWN(length, type) \
+    ((uint32_t)(length) & ~(sizeof(type) - 1))
+
+#define ALIGN_UP(length, type) \
+    (ALIGN_DOWN(((uint32_t)(length) + sizeof(type) - 1), type))
+
 #if defined(__GNUC__) && __GNUC__ >= 7
 #define __fallthrough __attribute__((fallthrough))
 #else
@@ -137,6 +143,17 @@ InterlockedExchangeAdd64(
     return __sync_fetch_and_add(Addend, Value);
 }
 
+inline
+long
+InterlockedCompareExchange(
+    _Inout_ _Interlocked_operand_ long volatile *Destination,
+    _In_ long ExChange,
+    _In_ long Comperand
+    )
+{
+    return __sync_val_compare_and_swap(Destination, Comperand, ExChange);
+}
+
 inline
 short
 InterlockedCompareExchange16(
@@ -148,6 +165,35 @@ InterlockedCompareExchange16(
     return __sync_val_compare_and_swap(Destination, Comperand, ExChange);
 }
 
+inline
+void*
+InterlockedCompareExchangePointer(
+    _Inout_ _Interlocked_operand_ void* volatile *Destination,
+    _In_opt_ void* ExChange,
+    _In_opt_ void* Comperand
+    )
+{
+    return __sync_val_compare_and_swap(Destination, Comperand, ExChange);
+}
+
+inline
+void*
+InterlockedExchangePointer(
+    _Inout_ _Interlocked_operand_ void* volatile *Target,
+    _In_opt_ void* Value
+    )
+{
+    return __atomic_exchange_n(Target, Value, __ATOMIC_SEQ_CST);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+#define YieldProcessor() __builtin_ia32_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+#define YieldProcessor() __asm__ __volatile__("yield")
+#else
+#define YieldProcessor() __asm__ __volatile__("" ::: "memory")
+#endif
+
 inline
 short
 InterlockedIncrement16(
@@ -252,16 +298,24 @@ QuicFree(
 #define QUIC_FREE(Mem, Tag) QuicFree((void*)Mem, Tag)
 
 //
-// Represents a QUIC memory pool used for fixed sized allocations.
+// The size of a cache line.
 //
 
-typedef struct QUIC_POOL {
+#define QUIC_CACHE_LINE_SIZE 64
+
+//
+// A per-processor cache (magazine) of free pool entries. Each cache is aligned
+// to (and so also padded to fill) its own cache line.
+//
+
+typedef struct __attribute__((aligned(QUIC_CACHE_LINE_SIZE))) QUIC_POOL_CACHE {
 
     //
-    // List of free entries.
+    // Spin lock to synchronize access to the cache. It is only contended when
+    // a thread is moved to another processor while using the cache.
     //
 
-    QUIC_SINGLE_LIST_ENTRY ListHead;
+    long volatile Lock;
 
     //
     // Number of free entries in the list.
@@ -270,11 +324,63 @@ typedef struct QUIC_POOL {
     uint16_t ListDepth;
 
     //
-    // Lock to synchronize access to the List.
-    // LINUX_TODO: Check how to make this lock free?
+    // List of free entries.
+    //
+
+    QUIC_SINGLE_LIST_ENTRY ListHead;
+
+    //
+    // The last entry in the list, so that the whole list can be moved to the
+    // spill list at once.
+    //
+
+    QUIC_SINGLE_LIST_ENTRY* ListTail;
+
+} QUIC_POOL_CACHE;
+
+//
+// Represents a QUIC memory pool used for fixed sized allocations.
+//
+
+typedef struct QUIC_POOL {
+
+    //
+    // Per-processor caches of free entries.
+    //
+
+    QUIC_POOL_CACHE* Caches;
+
+    //
+    // Number of per-processor caches.
+    //
+
+    uint32_t CacheCount;
+
+    //
+    // Maximum number of free entries in each per-processor cache.
+    //
+
+    uint16_t MaxDepth;
+
+    //
+    // Whether entries are zeroed on allocation.
+    //
+
+    BOOLEAN ZeroOnAlloc;
+
+    //
+    // Lock-free list of free entries spilled from full per-processor caches.
+    // Chains of entries are only ever pushed on, or the whole list taken at
+    // once, so the list doesn't suffer from the ABA problem.
     //
 
-    pthread_mutex_t Lock;
+    QUIC_SINGLE_LIST_ENTRY* volatile SpillHead;
+
+    //
+    // Approximate number of entries in the spill list.
+    //
+
+    long volatile SpillDepth;
 
     //
     // Size of entries.
@@ -292,6 +398,21 @@ typedef struct QUIC_POOL {
 
 #define QUIC_POOL_MAXIMUM_DEPTH   256 // Copied from EX_MAXIMUM_LOOKASIDE_DEPTH_BASE
 
+//
+// Per-processor caches of pools with large entries are kept shallower, so that
+// each caches at most this many bytes.
+//
+#define QUIC_POOL_MAXIMUM_CACHE_SIZE (1024 * 1024)
+
+//
+// The spill list holds up to this many times the per-processor cache depth.
+//
+#define QUIC_POOL_SPILL_FACTOR    4
+
+//
+// Initializes a pool whose entries are not zeroed on allocation, like on
+// Windows.
+//
 void
 QuicPoolInitialize(
     _In_ BOOLEAN IsPaged,
@@ -300,6 +421,19 @@ QuicPoolInitialize(
     _Inout_ QUIC_POOL* Pool
     );
 
+//
+// Initializes a pool, optionally zeroing entries on allocation for callers
+// that don't initialize every field themselves.
+//
+void
+QuicPoolInitializeEx(
+    _In_ BOOLEAN IsPaged,
+    _In_ uint32_t Size,
+    _In_ uint32_t Tag,
+    _In_ BOOLEAN ZeroOnAlloc,
+    _Inout_ QUIC_POOL* Pool
+    );
+
 void
 QuicPoolUninitialize(
     _Inout_ QUIC_POOL* Pool
@@ -325,6 +459,8 @@ QuicPoolFree(
 #define QuicByteSwapUint32(value) __builtin_bswap32((value))
 #define QuicByteSwapUint64(value) __builtin_bswap64((value))
 
+#define QuicPrefetch(Address) __builtin_prefetch((Address))
+
 //
 // Lock interfaces.
 //
@@ -286,6 +286,8 @@ typedef LOOKASIDE_LIST_EX QUIC_POOL;
 #define QuicByteSwapUint32 RtlUlongByteSwap
 #define QuicByteSwapUint64 RtlUlonglongByteSwap
 
+#define QuicPrefetch(Address) PreFetchCacheLine(PF_TEMPORAL_LEVEL_1, (Address))
+
 //
 // Locking Interfaces
 //
@@ -364,6 +364,8 @@ QuicPoolFree(
 #define QuicByteSwapUint32 _byteswap_ulong
 #define QuicByteSwapUint64 _byteswap_uint64
 
+#define QuicPrefetch(Address) PreFetchCacheLine(PF_TEMPORAL_LEVEL_1, (Address))
+
 //
 // Locking Interfaces
 //
@@ -146,6 +146,10 @@
 #define _Inout_updates_bytes_opt_(...)
 #endif
 
+#ifndef _Inout_updates_
+#define _Inout_updates_(...)
+#endif
+
 #ifndef _Out_opt_
 #define _Out_opt_
 #endif
@@ -29,49 +29,75 @@ Abstract:
 
 extern "C" _IRQL_requires_max_(PASSIVE_LEVEL) void QuicTraceRundown(void) { }
 
+//
+// Forward declaration because of include issues with math.h
+//
+extern "C" {
+    double sqrt(double value);
+}
+
 QUIC_STATUS
 QuicHandleRpsClient(
     _In_reads_(Length) uint8_t* ExtraData,
     _In_ uint32_t Length,
     _In_opt_z_ const char* FileName)
 {
-    if (Length < sizeof(uint32_t) + sizeof(uint32_t)) {
+    if (Length < sizeof(uint32_t) + sizeof(uint64_t)) {
         return QUIC_STATUS_INVALID_PARAMETER;
     }
     uint32_t RunTime;
-    uint32_t CachedCompletedRequests;
+    uint64_t CachedCompletedRequests;
     QuicCopyMemory(&RunTime, ExtraData, sizeof(RunTime));
     ExtraData += sizeof(RunTime);
     QuicCopyMemory(&CachedCompletedRequests, ExtraData, sizeof(CachedCompletedRequests));
     ExtraData += sizeof(CachedCompletedRequests);
-    uint32_t RestOfBufferLength = Length - sizeof(RunTime) - sizeof(CachedCompletedRequests);
-    RestOfBufferLength &= 0xFFFFFFFC; // Round down to nearest multiple of 4
-    uint32_t MaxCount = min(CachedCompletedRequests, RestOfBufferLength);
+    uint32_t BucketCount =
+        (Length - sizeof(RunTime) - sizeof(CachedCompletedRequests)) / sizeof(LatencyBucket);
 
     uint32_t RPS = (uint32_t)((CachedCompletedRequests * 1000ull) / (uint64_t)RunTime);
-    if (RPS == 0) {
+    if (RPS == 0 || BucketCount == 0) {
         printf("Error: No requests were completed\n");
         return QUIC_STATUS_SUCCESS;
     }
 
-    uint32_t* Data = (uint32_t*)ExtraData;
-    Statistics LatencyStats;
-    Percentiles PercentileStats;
-    GetStatistics(Data, MaxCount, &LatencyStats, &PercentileStats);
+    //
+    // Rebuild the merged latency histogram from its non-empty buckets. The
+    // buckets use the same layout, so nothing is lost.
+    //
+    LatencyBucket* Buckets = (LatencyBucket*)ExtraData;
+    uint64_t MaxValue = 2;
+    for (uint32_t i = 0; i < BucketCount; i++) {
+        if (Buckets[i].Value > MaxValue) {
+            MaxValue = Buckets[i].Value;
+        }
+    }
+
+    struct hdr_histogram* Histogram = nullptr;
+    if (hdr_init(1, (int64_t)MaxValue, 3, &Histogram) != 0) {
+        return QUIC_STATUS_OUT_OF_MEMORY;
+    }
+    for (uint32_t i = 0; i < BucketCount; i++) {
+        hdr_record_values(Histogram, (int64_t)Buckets[i].Value, (int64_t)Buckets[i].Count);
+    }
+
     WriteOutput(
         "Result: %u RPS, Min: %d, Max: %d, 50th: %f, 90th: %f, 99th: %f, 99.9th: %f, 99.99th: %f, 99.999th: %f, 99.9999th: %f, StdErr: %f\n",
         RPS,
-        LatencyStats.Min,
-        LatencyStats.Max,
-        PercentileStats.P50,
-        PercentileStats.P90,
-        PercentileStats.P99,
-        PercentileStats.P99p9,
-        PercentileStats.P99p99,
-        PercentileStats.P99p999,
-        PercentileStats.P99p9999,
-        LatencyStats.StandardError);
+        (int)hdr_min(Histogram),
+        (int)hdr_max(Histogram),
+        (double)hdr_value_at_percentile(Histogram, 50),
+        (double)hdr_value_at_percentile(Histogram, 90),
+        (double)hdr_value_at_percentile(Histogram, 99),
+        (double)hdr_value_at_percentile(Histogram, 99.9),
+        (double)hdr_value_at_percentile(Histogram, 99.99),
+        (double)hdr_value_at_percentile(Histogram, 99.999),
+        (double)hdr_value_at_percentile(Histogram, 99.9999),
+        hdr_stddev(Histogram) / sqrt((double)Histogram->total_count));
 
+    //
+    // Write the full percentile spectrum to the output file, or the console
+    // if there isn't one.
+    //
     QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
     if (FileName != nullptr) {
         FILE* FilePtr = nullptr;
@@ -83,21 +109,16 @@ QuicHandleRpsClient(
         int FileErr = (FilePtr == nullptr) ? 1 : 0;
 #endif
         if (FileErr == 0) {
-            struct hdr_histogram* histogram = nullptr;
-            int HstStatus = hdr_init(1, LatencyStats.Max, 3, &histogram);
-            if (HstStatus == 0) {
-                for (size_t i = 0; i < MaxCount; i++) {
-                    hdr_record_value(histogram, Data[i]);
-                }
-                hdr_percentiles_print(histogram, FilePtr, 5, 1.0, CLASSIC);
-            } else {
-                Status = QUIC_STATUS_OUT_OF_MEMORY;
-            }
+            hdr_percentiles_print(Histogram, FilePtr, 5, 1.0, CLASSIC);
             fclose(FilePtr);
         } else {
             Status = QUIC_STATUS_INVALID_PARAMETER;
         }
+    } else {
+        hdr_percentiles_print(Histogram, stdout, 5, 1.0, CLASSIC);
     }
+
+    hdr_close(Histogram);
     return Status;
 }
 
@@ -28,6 +28,7 @@ PrintHelp(
         "  -port:<####>                The UDP port of the server. (def:%u)\n"
         "  -parallel:<####>            The number of parallel connections per core. (def:%u)\n"
         "  -threads:<####>             The number of threads to use. Defaults and capped to number of cores/threads\n"
+        "  -bindings:<####>            The number of additional idle UDP bindings to keep open. (def:0)\n"
         "\n",
         HPS_DEFAULT_RUN_TIME,
         PERF_DEFAULT_PORT,
@@ -88,6 +89,7 @@ HpsClient::Init(
     TryGetValue(argc, argv, "runtime", &RunTime);
     TryGetValue(argc, argv, "port", &Port);
     TryGetValue(argc, argv, "parallel", &Parallel);
+    TryGetValue(argc, argv, "bindings", &IdleBindingCount);
 
     return QUIC_STATUS_SUCCESS;
 }
@@ -114,7 +116,11 @@ HpsClient::Start(
     ) {
     CompletionEvent = StopEvent;
 
-    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+    QUIC_STATUS Status = OpenIdleBindings();
+    if (QUIC_FAILED(Status)) {
+        return Status;
+    }
+
     for (uint32_t Proc = 0; Proc < ActiveProcCount; ++Proc) {
         Contexts[Proc].pThis = this;
         Contexts[Proc].Processor = (uint16_t)Proc;
@@ -177,6 +183,57 @@ HpsClient::Wait(
     return QUIC_STATUS_SUCCESS;
 }
 
+QUIC_STATUS
+HpsClient::OpenIdleBindings(
+    ) {
+    //
+    // Each listener started on an unspecified port gets its own UDP binding,
+    // which stays alive (but idle) for the duration of the run. This allows
+    // for measuring the handshake rate as a function of the number of live
+    // bindings in the process.
+    //
+    if (IdleBindingCount == 0) {
+        return QUIC_STATUS_SUCCESS;
+    }
+
+    IdleBindings.reset(new(std::nothrow) ListenerScope[IdleBindingCount]);
+    if (!IdleBindings.get()) {
+        return QUIC_STATUS_OUT_OF_MEMORY;
+    }
+
+    for (uint32_t i = 0; i < IdleBindingCount; ++i) {
+        QUIC_STATUS Status =
+            MsQuic->ListenerOpen(
+                Registration,
+                [](HQUIC, void*, QUIC_LISTENER_EVENT*) -> QUIC_STATUS {
+                    return QUIC_STATUS_CONNECTION_REFUSED;
+                },
+                nullptr,
+                &IdleBindings[i].Handle);
+        if (QUIC_FAILED(Status)) {
+            WriteOutput("ListenerOpen failed, 0x%x\n", Status);
+            return Status;
+        }
+
+        //
+        // The OS may hand out an ephemeral port that is already in use by a
+        // (reusable) binding, in which case the binding is shared. A unique
+        // ALPN per listener keeps that from failing the listener start.
+        //
+        char AlpnName[32];
+        snprintf(AlpnName, sizeof(AlpnName), "idle%u", i);
+        const MsQuicAlpn Alpn(AlpnName);
+        Status = MsQuic->ListenerStart(IdleBindings[i], Alpn, Alpn.Length(), nullptr);
+        if (QUIC_FAILED(Status)) {
+            WriteOutput("ListenerStart failed, 0x%x\n", Status);
+            return Status;
+        }
+    }
+
+    WriteOutput("Opened %u idle bindings\n", IdleBindingCount);
+    return QUIC_STATUS_SUCCESS;
+}
+
 void
 HpsClient::GetExtraDataMetadata(
     _Out_ PerfExtraDataMetadata* Result
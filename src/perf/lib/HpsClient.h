@@ -91,6 +91,8 @@ public:
 
     void StartConnection(HpsWorkerContext* Context);
 
+    QUIC_STATUS OpenIdleBindings();
+
     HpsWorkerContext Contexts[PERF_MAX_THREAD_COUNT];
     MsQuicRegistration Registration;
     MsQuicConfiguration Configuration {
@@ -107,6 +109,8 @@ public:
     UniquePtr<char[]> Target;
     uint32_t RunTime {HPS_DEFAULT_RUN_TIME};
     uint32_t Parallel {HPS_DEFAULT_PARALLEL_COUNT};
+    uint32_t IdleBindingCount {0};
+    UniquePtr<ListenerScope[]> IdleBindings;
     QUIC_EVENT* CompletionEvent {nullptr};
     uint64_t CreatedConnections {0};
     uint64_t StartedConnections {0};
@@ -5,143 +5,128 @@
 
 Abstract:
 
-    Latency math helpers.
+    Latency histogram helpers.
+
+    Latencies are recorded into fixed size histograms using the HdrHistogram
+    bucket layout, with a lowest discernible value of 1 and 3 significant
+    figures, covering any 32-bit latency in microseconds. The memory used is
+    independent of how many latencies are recorded, and recording is integer
+    only so it works in kernel mode too.
 
 --*/
 
 #pragma once
 
+#define LATENCY_SUB_BUCKET_HALF_COUNT_MAGNITUDE 10
+#define LATENCY_SUB_BUCKET_HALF_COUNT           (1 << LATENCY_SUB_BUCKET_HALF_COUNT_MAGNITUDE)
+#define LATENCY_SUB_BUCKET_MASK                 ((2 * LATENCY_SUB_BUCKET_HALF_COUNT) - 1)
+#define LATENCY_BUCKET_COUNT                    22 // Up to UINT32_MAX
+#define LATENCY_COUNTS_LENGTH                   ((LATENCY_BUCKET_COUNT + 1) * LATENCY_SUB_BUCKET_HALF_COUNT)
+
 //
-// Forward declaration because of include issues with math.h
+// A non-empty histogram bucket, as passed in the RPS client's extra data.
 //
-extern "C" {
-    double sqrt(double value);
-}
-
-struct Statistics {
-    double Mean {0};
-    double Variance {0};
-    double StandardDeviation {0};
-    double StandardError {0};
-    uint32_t Min {0};
-    uint32_t Max {0};
-};
-
-struct Percentiles {
-    double P50 {0};
-    double P90 {0};
-    double P99 {0};
-    double P99p9 {0};
-    double P99p99 {0};
-    double P99p999 {0};
-    double P99p9999 {0};
+struct LatencyBucket {
+    uint64_t Value; // The lowest latency in the bucket
+    uint64_t Count;
 };
 
-#ifdef _KERNEL_MODE
-__declspec(noinline)
-#endif
-static
-double
-ComputeVariance(
-    _In_reads_(Length) uint32_t* Measurements,
-    _In_ size_t Length,
-    _In_ double Mean
-    )
-{
-    if (Length <= 1) {
-        return 0;
-    }
-    double Variance = 0;
-    for (size_t i = 0; i < Length; i++) {
-        uint32_t Value = Measurements[i];
-        Variance += (Value - Mean) * (Value - Mean) / (Length - 1);
-    }
-    return Variance;
-}
+struct LatencyHistogram {
+    UniquePtr<uint64_t[]> Counts {nullptr};
+    uint64_t TotalCount {0};
 
-#ifdef _KERNEL_MODE
-__declspec(noinline)
-#endif
-static
-void
-GetStatistics(
-    _In_reads_(DataLength) uint32_t* Data,
-    _In_ size_t DataLength,
-    _Out_ Statistics* AllStatistics,
-    _Out_ Percentiles* PercentileStats
-    )
-{
-    if (DataLength == 0) {
-        return;
+    bool Initialize() {
+        Counts.reset(new(std::nothrow) uint64_t[LATENCY_COUNTS_LENGTH]);
+        if (!Counts) {
+            return false;
+        }
+        Reset();
+        return true;
     }
 
-    uint64_t Sum = 0;
-    uint32_t Min = 0xFFFFFFFF;
-    uint32_t Max = 0;
-    for (size_t i = 0; i < DataLength; i++) {
-        uint32_t Value = Data[i];
-        Sum += Value;
-        if (Value > Max) {
-            Max = Value;
-        }
-        if (Value < Min) {
-            Min = Value;
-        }
+    void Reset() {
+        QuicZeroMemory(Counts.get(), sizeof(uint64_t) * LATENCY_COUNTS_LENGTH);
+        TotalCount = 0;
     }
-    double Mean = Sum / (double)DataLength;
-    double Variance =
-        ComputeVariance(
-            Data,
-            DataLength,
-            Mean);
-    double StandardDeviation = sqrt(Variance);
-    double StandardError = StandardDeviation / sqrt((double)DataLength);
-    *AllStatistics = Statistics {
-        Mean,
-        Variance,
-        StandardDeviation,
-        StandardError,
-        Min,
-        Max
-    };
 
+    static uint32_t GetIndex(uint32_t Value) {
 #ifdef _WIN32
-    qsort_s(
-        Data,
-        DataLength,
-        sizeof(uint32_t),
-        [](void*, const void* Left, const void* Right) -> int {
-            return *(const uint32_t*)Left - *(const uint32_t*)Right;
-        },
-        nullptr);
+        unsigned long HighBit;
+        _BitScanReverse(&HighBit, Value | LATENCY_SUB_BUCKET_MASK);
 #else
-    qsort(
-        Data,
-        DataLength,
-        sizeof(uint32_t),
-        [](const void* Left, const void* Right) -> int {
-            return *(const uint32_t*)Left - *(const uint32_t*)Right;
-        });
+        uint32_t HighBit = 31 - __builtin_clz(Value | LATENCY_SUB_BUCKET_MASK);
 #endif
+        uint32_t BucketIndex = (uint32_t)HighBit - LATENCY_SUB_BUCKET_HALF_COUNT_MAGNITUDE;
+        uint32_t SubBucketIndex = Value >> BucketIndex;
+        return
+            ((BucketIndex + 1) << LATENCY_SUB_BUCKET_HALF_COUNT_MAGNITUDE) +
+            (SubBucketIndex - LATENCY_SUB_BUCKET_HALF_COUNT);
+    }
 
-    uint32_t PercentileIndex = (uint32_t)(DataLength * 0.5);
-    PercentileStats->P50 = Data[PercentileIndex];
-
-    PercentileIndex = (uint32_t)(DataLength * 0.9);
-    PercentileStats->P90 = Data[PercentileIndex];
+    static uint64_t GetValue(uint32_t Index) {
+        uint32_t BucketIndex = Index >> LATENCY_SUB_BUCKET_HALF_COUNT_MAGNITUDE;
+        uint32_t SubBucketIndex = (Index & (LATENCY_SUB_BUCKET_HALF_COUNT - 1));
+        if (BucketIndex == 0) {
+            return SubBucketIndex;
+        }
+        return (uint64_t)(SubBucketIndex + LATENCY_SUB_BUCKET_HALF_COUNT) << (BucketIndex - 1);
+    }
 
-    PercentileIndex = (uint32_t)(DataLength * 0.99);
-    PercentileStats->P99 = Data[PercentileIndex];
+    //
+    // May be called concurrently. TotalCount is only updated when histograms
+    // are merged.
+    //
+    void Record(uint32_t Value) {
+        InterlockedIncrement64((int64_t*)&Counts[GetIndex(Value)]);
+    }
 
-    PercentileIndex = (uint32_t)(DataLength * 0.999);
-    PercentileStats->P99p9 = Data[PercentileIndex];
+    void Add(const LatencyHistogram& Other) {
+        for (uint32_t i = 0; i < LATENCY_COUNTS_LENGTH; ++i) {
+            Counts[i] += Other.Counts[i];
+            TotalCount += Other.Counts[i];
+        }
+    }
 
-    PercentileIndex = (uint32_t)(DataLength * 0.9999);
-    PercentileStats->P99p99 = Data[PercentileIndex];
+    //
+    // Leaves only the counts recorded since Snapshot was taken, and replaces
+    // Snapshot with the current counts.
+    //
+    void SubtractSnapshot(LatencyHistogram& Snapshot) {
+        TotalCount = 0;
+        for (uint32_t i = 0; i < LATENCY_COUNTS_LENGTH; ++i) {
+            uint64_t Count = Counts[i];
+            Counts[i] = Count - Snapshot.Counts[i];
+            Snapshot.Counts[i] = Count;
+            TotalCount += Counts[i];
+        }
+    }
 
-    PercentileIndex = (uint32_t)(DataLength * 0.99999);
-    PercentileStats->P99p999 = Data[PercentileIndex];
+    uint32_t GetNonEmptyBucketCount() const {
+        uint32_t BucketCount = 0;
+        for (uint32_t i = 0; i < LATENCY_COUNTS_LENGTH; ++i) {
+            if (Counts[i] != 0) {
+                BucketCount++;
+            }
+        }
+        return BucketCount;
+    }
 
-    PercentileIndex = (uint32_t)(DataLength * 0.999999);
-    PercentileStats->P99p9999 = Data[PercentileIndex];
-}
+    //
+    // Returns the lowest latency of the bucket containing the given
+    // percentile, in parts per million.
+    //
+    uint64_t GetValueAtPercentile(uint32_t PartsPerMillion) const {
+        uint64_t Threshold = (TotalCount * PartsPerMillion + 999999) / 1000000;
+        if (Threshold == 0) {
+            Threshold = 1;
+        }
+        uint64_t Cumulative = 0;
+        for (uint32_t i = 0; i < LATENCY_COUNTS_LENGTH; ++i) {
+            Cumulative += Counts[i];
+            if (Cumulative >= Threshold) {
+                return GetValue(i);
+            }
+        }
+        return 0;
+    }
+};
@@ -25,7 +25,6 @@ Abstract:
 #define TPUT_DEFAULT_IDLE_TIMEOUT           (1 * 1000)
 
 #define RPS_MAX_CLIENT_PORT_COUNT           256
-#define RPS_MAX_REQUESTS_PER_SECOND         1500000 // 1.5 million RPS max as a guess
 #define RPS_DEFAULT_RUN_TIME                (10 * 1000)
 #define RPS_DEFAULT_CONNECTION_COUNT        1000
 #define RPS_DEFAULT_REQUEST_LENGTH          0
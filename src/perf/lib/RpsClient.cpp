@@ -32,6 +32,7 @@ PrintHelp(
         "  -response:<####>            The length of request payloads. (def:%u)\n"
         "  -threads:<####>             The number of threads to use. Defaults and capped to number of cores\n"
         "  -affinitize:<0/1>           Affinitizes threads to a core. (def:0)\n"
+        "  -interval:<####>            Prints the latency of each interval (in ms). (def:0, disabled)\n"
         "\n",
         RPS_DEFAULT_RUN_TIME,
         PERF_DEFAULT_PORT,
@@ -77,6 +78,7 @@ RpsClient::Init(
     TryGetValue(argc, argv, "requests", &RequestCount);
     TryGetValue(argc, argv, "request", &RequestLength);
     TryGetValue(argc, argv, "response", &ResponseLength);
+    TryGetValue(argc, argv, "interval", &SnapshotInterval);
 
     uint32_t Affinitize;
     if (TryGetValue(argc, argv, "affinitize", &Affinitize)) {
@@ -110,16 +112,29 @@ RpsClient::Init(
         RequestBuffer.Buffer->Buffer[sizeof(uint64_t) + i] = (uint8_t)i;
     }
 
-    MaxLatencyIndex = ((uint64_t)RunTime / 1000) * RPS_MAX_REQUESTS_PER_SECOND;
-    if (MaxLatencyIndex > (UINT32_MAX / sizeof(uint32_t))) {
-        MaxLatencyIndex = UINT32_MAX / sizeof(uint32_t);
+    //
+    // Each worker records the latency of its connections' requests into its
+    // own histogram. Without worker threads, connections are spread over the
+    // active processors instead.
+    //
+    HistogramCount = WorkerCount;
+    if (HistogramCount == 0) {
+        HistogramCount = QuicProcActiveCount();
+        if (HistogramCount > PERF_MAX_THREAD_COUNT) {
+            HistogramCount = PERF_MAX_THREAD_COUNT;
+        }
     }
-
-    LatencyValues = UniquePtr<uint32_t[]>(new(std::nothrow) uint32_t[(size_t)MaxLatencyIndex]);
-    if (LatencyValues == nullptr) {
+    for (uint32_t i = 0; i < HistogramCount; ++i) {
+        if (!Workers[i].Latency.Initialize()) {
+            return QUIC_STATUS_OUT_OF_MEMORY;
+        }
+    }
+    if (!Latency.Initialize()) {
+        return QUIC_STATUS_OUT_OF_MEMORY;
+    }
+    if (SnapshotInterval != 0 && !LatencySnapshot.Initialize()) {
         return QUIC_STATUS_OUT_OF_MEMORY;
     }
-    QuicZeroMemory(LatencyValues.get(), (size_t)(sizeof(uint32_t) * MaxLatencyIndex));
 
     return QUIC_STATUS_SUCCESS;
 }
@@ -296,7 +311,26 @@ RpsClient::Wait(
         Timeout = RunTime;
     }
 
-    QuicEventWaitWithTimeout(*CompletionEvent, Timeout);
+    if (SnapshotInterval == 0) {
+        QuicEventWaitWithTimeout(*CompletionEvent, Timeout);
+    } else {
+        uint64_t StartTime = QuicTimeUs64();
+        uint64_t SnapshotTime = StartTime;
+        uint64_t Elapsed = 0;
+        while (Elapsed < (uint64_t)Timeout) {
+            uint64_t WaitTime = (uint64_t)Timeout - Elapsed;
+            if (WaitTime > SnapshotInterval) {
+                WaitTime = SnapshotInterval;
+            }
+            if (QuicEventWaitWithTimeout(*CompletionEvent, (uint32_t)WaitTime)) {
+                break;
+            }
+            uint64_t TimeNow = QuicTimeUs64();
+            PrintIntervalLatency(QuicTimeDiff64(SnapshotTime, TimeNow));
+            SnapshotTime = TimeNow;
+            Elapsed = QuicTimeDiff64(StartTime, TimeNow) / 1000;
+        }
+    }
 
     Running = false;
     for (uint32_t i = 0; i < WorkerCount; ++i) {
@@ -304,18 +338,51 @@ RpsClient::Wait(
     }
 
     CachedCompletedRequests = CompletedRequests;
+    MergeLatency();
     return QUIC_STATUS_SUCCESS;
 }
 
+void
+RpsClient::MergeLatency(
+    )
+{
+    Latency.Reset();
+    for (uint32_t i = 0; i < HistogramCount; ++i) {
+        Latency.Add(Workers[i].Latency);
+    }
+}
+
+void
+RpsClient::PrintIntervalLatency(
+    _In_ uint64_t IntervalUs
+    )
+{
+    MergeLatency();
+    Latency.SubtractSnapshot(LatencySnapshot);
+    if (IntervalUs == 0) {
+        return;
+    }
+
+    WriteOutput(
+        "Interval: %llu RPS, 50th: %llu, 90th: %llu, 99th: %llu, 99.9th: %llu, 99.99th: %llu, Max: %llu\n",
+        (unsigned long long)(Latency.TotalCount * 1000000 / IntervalUs),
+        (unsigned long long)Latency.GetValueAtPercentile(500000),
+        (unsigned long long)Latency.GetValueAtPercentile(900000),
+        (unsigned long long)Latency.GetValueAtPercentile(990000),
+        (unsigned long long)Latency.GetValueAtPercentile(999000),
+        (unsigned long long)Latency.GetValueAtPercentile(999900),
+        (unsigned long long)Latency.GetValueAtPercentile(1000000));
+}
+
 void
 RpsClient::GetExtraDataMetadata(
     _Out_ PerfExtraDataMetadata* Result
     )
 {
     Result->TestType = PerfTestType::RpsClient;
-    uint64_t DataLength = sizeof(RunTime) + sizeof(CachedCompletedRequests) + (CachedCompletedRequests * sizeof(uint32_t));
-    QUIC_FRE_ASSERT(DataLength <= UINT32_MAX); // TODO Limit values properly
-    Result->ExtraDataLength = (uint32_t)DataLength;
+    Result->ExtraDataLength =
+        sizeof(RunTime) + sizeof(CachedCompletedRequests) +
+        Latency.GetNonEmptyBucketCount() * sizeof(LatencyBucket);
 }
 
 QUIC_STATUS
@@ -324,17 +391,26 @@ RpsClient::GetExtraData(
     _Inout_ uint32_t* Length
     )
 {
-    QUIC_FRE_ASSERT(*Length > sizeof(RunTime) + sizeof(CachedCompletedRequests));
+    QUIC_FRE_ASSERT(*Length >= sizeof(RunTime) + sizeof(CachedCompletedRequests));
     QuicCopyMemory(Data, &RunTime, sizeof(RunTime));
     Data += sizeof(RunTime);
     QuicCopyMemory(Data, &CachedCompletedRequests, sizeof(CachedCompletedRequests));
-    Data += sizeof(RunTime);
-    uint64_t BufferLength = *Length - sizeof(RunTime) - sizeof(CachedCompletedRequests);
-    if (BufferLength > CachedCompletedRequests * sizeof(uint32_t)) {
-        BufferLength = CachedCompletedRequests * sizeof(uint32_t);
-        *Length = (uint32_t)(BufferLength + sizeof(RunTime) + sizeof(CachedCompletedRequests));
+    Data += sizeof(CachedCompletedRequests);
+    uint32_t BufferLength = *Length - sizeof(RunTime) - sizeof(CachedCompletedRequests);
+    *Length = sizeof(RunTime) + sizeof(CachedCompletedRequests);
+
+    //
+    // Only the non-empty buckets are passed on.
+    //
+    for (uint32_t i = 0; i < LATENCY_COUNTS_LENGTH && BufferLength >= sizeof(LatencyBucket); ++i) {
+        if (Latency.Counts[i] != 0) {
+            LatencyBucket Bucket = { LatencyHistogram::GetValue(i), Latency.Counts[i] };
+            QuicCopyMemory(Data, &Bucket, sizeof(Bucket));
+            Data += sizeof(Bucket);
+            BufferLength -= sizeof(Bucket);
+            *Length += sizeof(Bucket);
+        }
     }
-    QuicCopyMemory(Data, LatencyValues.get(), (uint32_t)BufferLength);
     return QUIC_STATUS_SUCCESS;
 }
 
@@ -369,15 +445,13 @@ RpsConnectionContext::StreamCallback(
     switch (Event->Type) {
     case QUIC_STREAM_EVENT_RECEIVE:
         if (Event->RECEIVE.Flags & QUIC_RECEIVE_FLAG_FIN) {
-            uint64_t ToPlaceIndex = (uint64_t)InterlockedIncrement64((int64_t*)&Worker->Client->CompletedRequests) - 1;
+            InterlockedIncrement64((int64_t*)&Worker->Client->CompletedRequests);
             uint64_t EndTime = QuicTimeUs64();
             uint64_t Delta = QuicTimeDiff64(StrmContext->StartTime, EndTime);
-            if (ToPlaceIndex < Worker->Client->MaxLatencyIndex) {
-                if (Delta > UINT32_MAX) {
-                    Delta = UINT32_MAX;
-                }
-                Worker->Client->LatencyValues[(size_t)ToPlaceIndex] = (uint32_t)Delta;
+            if (Delta > UINT32_MAX) {
+                Delta = UINT32_MAX;
             }
+            Worker->Latency.Record((uint32_t)Delta);
         }
         break;
     case QUIC_STREAM_EVENT_SEND_COMPLETE:
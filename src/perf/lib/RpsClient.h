@@ -16,6 +16,7 @@ Abstract:
 #include "PerfHelpers.h"
 #include "PerfBase.h"
 #include "PerfCommon.h"
+#include "LatencyHelpers.h"
 
 struct RpsConnectionContext;
 struct RpsWorkerContext;
@@ -56,6 +57,7 @@ struct RpsWorkerContext {
     QUIC_EVENT WakeEvent;
     bool ThreadStarted {false};
     uint32_t RequestCount {0};
+    LatencyHistogram Latency;
     RpsWorkerContext() {
         QuicLockInitialize(&Lock);
         QuicEventInitialize(&WakeEvent, FALSE, FALSE);
@@ -145,6 +147,15 @@ public:
         _Inout_ QUIC_CONNECTION_EVENT* Event
         );
 
+    void
+    MergeLatency(
+        );
+
+    void
+    PrintIntervalLatency(
+        _In_ uint64_t IntervalUs
+        );
+
     MsQuicRegistration Registration {true};
     MsQuicConfiguration Configuration {
         Registration,
@@ -164,6 +175,8 @@ public:
     uint32_t RequestCount {RPS_DEFAULT_CONNECTION_COUNT * 2};
     uint32_t RequestLength {RPS_DEFAULT_REQUEST_LENGTH};
     uint32_t ResponseLength {RPS_DEFAULT_RESPONSE_LENGTH};
+    uint32_t SnapshotInterval {0};
+    uint32_t HistogramCount {0};
 
     struct QuicBufferScopeQuicAlloc {
         QUIC_BUFFER* Buffer;
@@ -181,8 +194,8 @@ public:
     uint64_t SendCompletedRequests {0};
     uint64_t CompletedRequests {0};
     uint64_t CachedCompletedRequests {0};
-    UniquePtr<uint32_t[]> LatencyValues {nullptr};
-    uint64_t MaxLatencyIndex {0};
+    LatencyHistogram Latency;
+    LatencyHistogram LatencySnapshot;
     QuicPoolAllocator<StreamContext> StreamContextAllocator;
     RpsWorkerContext Workers[PERF_MAX_THREAD_COUNT];
     UniquePtr<RpsConnectionContext[]> Connections {nullptr};
@@ -0,0 +1,72 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Crypto helpers shared by all the TLS/crypto implementations.
+
+--*/
+
+#include "platform_internal.h"
+#ifdef QUIC_CLOG
+#include "crypt.c.clog.h"
+#endif
+
+//
+// None of the crypto libraries currently have an API to process several
+// packets in a single call, so the batch is processed one packet at a time.
+//
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QuicEncryptBatch(
+    _In_ QUIC_KEY* Key,
+    _In_ uint8_t BatchSize,
+    _Inout_updates_(BatchSize)
+        QUIC_CRYPT_BATCH_ENTRY* Batch
+    )
+{
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+    for (uint8_t i = 0; i < BatchSize; ++i) {
+        Batch[i].Status =
+            QuicEncrypt(
+                Key,
+                Batch[i].Iv,
+                Batch[i].AuthDataLength,
+                Batch[i].AuthData,
+                Batch[i].BufferLength,
+                Batch[i].Buffer);
+        if (QUIC_FAILED(Batch[i].Status) && QUIC_SUCCEEDED(Status)) {
+            Status = Batch[i].Status;
+        }
+    }
+    return Status;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QuicDecryptBatch(
+    _In_ QUIC_KEY* Key,
+    _In_ uint8_t BatchSize,
+    _Inout_updates_(BatchSize)
+        QUIC_CRYPT_BATCH_ENTRY* Batch
+    )
+{
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+    for (uint8_t i = 0; i < BatchSize; ++i) {
+        Batch[i].Status =
+            QuicDecrypt(
+                Key,
+                Batch[i].Iv,
+                Batch[i].AuthDataLength,
+                Batch[i].AuthData,
+                Batch[i].BufferLength,
+                Batch[i].Buffer);
+        if (QUIC_FAILED(Batch[i].Status) && QUIC_SUCCEEDED(Status)) {
+            Status = Batch[i].Status;
+        }
+    }
+    return Status;
+}
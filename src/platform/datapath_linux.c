@@ -17,9 +17,19 @@ Environment:
 #include "quic_platform_dispatch.h"
 #include <arpa/inet.h>
 #include <inttypes.h>
+#include <linux/errqueue.h>
+#include <linux/filter.h>
 #include <linux/in6.h>
+#include <linux/net_tstamp.h>
+#include <netinet/udp.h>
+#include <poll.h>
 #include <sys/epoll.h>
 #include <sys/eventfd.h>
+#ifdef QUIC_LINUX_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
 #ifdef QUIC_CLOG
 #include "datapath_linux.c.clog.h"
 #endif
@@ -28,12 +38,193 @@ QUIC_STATIC_ASSERT((SIZEOF_STRUCT_MEMBER(QUIC_BUFFER, Length) <= sizeof(size_t))
 QUIC_STATIC_ASSERT((SIZEOF_STRUCT_MEMBER(QUIC_BUFFER, Buffer) == sizeof(void*)), "(sizeof(QUIC_BUFFER.Buffer) == sizeof(void*) must be TRUE.");
 
 //
-// TODO: Support batching.
+// Not yet available in older C library headers. When available everywhere this
+// code can be removed.
+//
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+
+//
+// The maximum number of send buffers in a single send context. With UDP send
+// segmentation, a single buffer can contain many datagrams.
 //
 #define QUIC_MAX_BATCH_SEND 1
 
 //
-// A receive block to receive a UDP packet over the sockets.
+// The maximum single buffer size for sending segmented payloads. The kernel
+// limits a single segmented send to one maximum sized IP packet.
+//
+#define QUIC_LARGE_SEND_BUFFER_SIZE (UINT16_MAX - QUIC_MIN_IPV4_HEADER_SIZE - QUIC_UDP_HEADER_SIZE)
+
+//
+// The maximum number of segments the kernel allows in a single segmented send
+// (UDP_MAX_SEGMENTS).
+//
+#define QUIC_MAX_SEND_SEGMENT_COUNT 64
+
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+
+#ifndef SO_ATTACH_REUSEPORT_CBPF
+#define SO_ATTACH_REUSEPORT_CBPF 51
+#endif
+
+#ifndef SO_BUSY_POLL
+#define SO_BUSY_POLL 46
+#endif
+
+#ifndef SO_ZEROCOPY
+#define SO_ZEROCOPY 60
+#endif
+
+#ifndef MSG_ZEROCOPY
+#define MSG_ZEROCOPY 0x4000000
+#endif
+
+#ifndef SO_EE_ORIGIN_ZEROCOPY
+#define SO_EE_ORIGIN_ZEROCOPY 5
+#endif
+
+#ifndef SO_EE_CODE_ZEROCOPY_COPIED
+#define SO_EE_CODE_ZEROCOPY_COPIED 1
+#endif
+
+#ifndef SO_TXTIME
+#define SO_TXTIME 61
+#define SCM_TXTIME SO_TXTIME
+#endif
+
+//
+// The minimum size of a segmented send to do without copying. Below this,
+// pinning the pages and reaping the completion costs more than the copy.
+//
+#define QUIC_ZEROCOPY_MIN_SEND_SIZE 16384
+
+//
+// The maximum time to wait for outstanding zero-copy send completions when a
+// socket is closed.
+//
+#define QUIC_ZEROCOPY_CLOSE_TIMEOUT_MS 100
+
+//
+// The maximum number of receive buffers posted with one call.
+//
+#define QUIC_MAX_BATCH_RECEIVE 32
+
+//
+// The maximum number of receive buffers posted with one call when receive
+// coalescing is enabled. Each buffer is then large enough to hold a maximum
+// sized coalesced payload, so fewer are posted to bound memory usage.
+//
+#define QUIC_MAX_BATCH_RECEIVE_COALESCED 8
+
+//
+// The maximum UDP receive coalescing payload.
+//
+#define MAX_GRO_PAYLOAD_LENGTH (UINT16_MAX - QUIC_UDP_HEADER_SIZE)
+
+//
+// The maximum number of UDP datagrams the kernel coalesces into a single
+// receive (UDP_GRO_CNT_MAX).
+//
+#define GRO_MAX_DATAGRAMS_PER_RECEIVE 64
+
+//
+// The size of the control buffer used for sends.
+//
+#define QUIC_SEND_CONTROL_BUFFER_SIZE \
+    (CMSG_SPACE(sizeof(struct in6_pktinfo)) +   /* IP_PKTINFO */ \
+     CMSG_SPACE(sizeof(int)) +                  /* IP_TOS */ \
+     CMSG_SPACE(sizeof(uint16_t)) +             /* UDP_SEGMENT */ \
+     CMSG_SPACE(sizeof(uint64_t)))              /* SCM_TXTIME */
+
+#ifdef QUIC_LINUX_IO_URING
+
+//
+// The number of submission queue entries in each io_uring instance.
+//
+#define QUIC_URING_QUEUE_DEPTH 1024
+
+//
+// The types of operations submitted to io_uring.
+//
+#define QUIC_URING_OP_RECV      0
+#define QUIC_URING_OP_SEND      1
+#define QUIC_URING_OP_SHUTDOWN  2
+#define QUIC_URING_OP_CANCEL    3
+
+//
+// Context for an operation submitted to io_uring. A pointer to it is the user
+// data of the operation's submission and completion queue entries.
+//
+typedef struct QUIC_URING_OP {
+    //
+    // The type of the operation (QUIC_URING_OP_*).
+    //
+    uint8_t Type;
+
+    //
+    // The receive slot of a receive operation.
+    //
+    uint8_t Index;
+
+    //
+    // The socket context the operation was submitted for.
+    //
+    struct QUIC_SOCKET_CONTEXT* SocketContext;
+
+} QUIC_URING_OP;
+
+//
+// An io_uring instance with its mapped submission and completion rings.
+//
+typedef struct QUIC_URING {
+    //
+    // The io_uring file descriptor.
+    //
+    int RingFd;
+
+    //
+    // Serializes producers of submission queue entries. Any thread may send,
+    // while the worker thread reposts receives.
+    //
+    QUIC_LOCK SqLock;
+
+    //
+    // The submission ring.
+    //
+    uint32_t SqEntries;
+    uint32_t SqMask;
+    uint32_t* SqHead;
+    uint32_t* SqTail;
+    uint32_t* SqArray;
+    struct io_uring_sqe* Sqes;
+
+    //
+    // The completion ring. Only consumed by the worker thread.
+    //
+    uint32_t CqMask;
+    uint32_t* CqHead;
+    uint32_t* CqTail;
+    struct io_uring_cqe* Cqes;
+
+    //
+    // The mapped ring memory.
+    //
+    void* RingMemory;
+    size_t RingMemoryLength;
+    size_t SqesMemoryLength;
+
+} QUIC_URING;
+
+#endif // QUIC_LINUX_IO_URING
+
+//
+// A receive block to receive UDP packets over the sockets. The block is
+// shared by all the datagrams split out of a single (possibly coalesced)
+// receive and is freed when the last of them is returned.
 //
 typedef struct QUIC_DATAPATH_RECV_BLOCK {
     //
@@ -42,9 +233,9 @@ typedef struct QUIC_DATAPATH_RECV_BLOCK {
     QUIC_POOL* OwningPool;
 
     //
-    // The recv buffer used by MsQuic.
+    // The number of datagrams from this block still held by the upper layer.
     //
-    QUIC_RECV_DATAGRAM RecvPacket;
+    int64_t volatile ReferenceCount;
 
     //
     // Represents the address (source and destination) information of the
@@ -53,16 +244,27 @@ typedef struct QUIC_DATAPATH_RECV_BLOCK {
     QUIC_TUPLE Tuple;
 
     //
-    // Buffer that actually stores the UDP payload.
+    // This is followed by Datapath->RecvDatagramCount datagram slots of
+    // Datapath->DatagramStride bytes each, and then the buffer that actually
+    // stores the UDP payload, at Datapath->RecvPayloadOffset. Each slot is:
     //
-    uint8_t Buffer[MAX_UDP_PAYLOAD_LENGTH];
+    // QUIC_RECV_DATAGRAM;
+    // QUIC_DATAPATH_RECV_BUFFER_CONTEXT;
+    // QUIC_RECV_PACKET (client context);
+    //
+
+} QUIC_DATAPATH_RECV_BLOCK;
 
+//
+// Internal context that follows each datagram in a receive block.
+//
+typedef struct QUIC_DATAPATH_RECV_BUFFER_CONTEXT {
     //
-    // This follows the recv block.
+    // The receive block owning the datagram.
     //
-    // QUIC_RECV_PACKET RecvContext;
+    QUIC_DATAPATH_RECV_BLOCK* RecvBlock;
 
-} QUIC_DATAPATH_RECV_BLOCK;
+} QUIC_DATAPATH_RECV_BUFFER_CONTEXT;
 
 //
 // Send context.
@@ -99,6 +301,17 @@ typedef struct QUIC_DATAPATH_SEND_CONTEXT {
     //
     QUIC_ECN_TYPE ECN;
 
+    //
+    // The send segmentation size; zero if segmentation is not performed.
+    //
+    uint16_t SegmentSize;
+
+    //
+    // The earliest departure time of the datagrams, in microseconds on the
+    // CLOCK_MONOTONIC clock; zero to send immediately.
+    //
+    uint64_t DepartureTime;
+
     //
     // The proc context owning this send context.
     //
@@ -121,6 +334,29 @@ typedef struct QUIC_DATAPATH_SEND_CONTEXT {
     QUIC_BUFFER Buffers[QUIC_MAX_BATCH_SEND];
     struct iovec Iovs[QUIC_MAX_BATCH_SEND];
 
+    //
+    // The QUIC_BUFFER returned to the client for segmented sends.
+    //
+    QUIC_BUFFER ClientBuffer;
+
+#ifdef QUIC_LINUX_IO_URING
+    //
+    // The io_uring operation for the send. The message, address and control
+    // data below must stay valid until the send completes.
+    //
+    QUIC_URING_OP UringOp;
+    struct msghdr Mhdr;
+    QUIC_ADDR MappedRemoteAddress;
+    char ControlBuffer[QUIC_SEND_CONTROL_BUFFER_SIZE];
+#else
+    //
+    // Linkage to the socket's list of zero-copy sends whose buffers are still
+    // referenced by the kernel, and the kernel's identifier for the send.
+    //
+    QUIC_LIST_ENTRY ZeroCopyLinkage;
+    uint32_t ZeroCopyId;
+#endif
+
 } QUIC_DATAPATH_SEND_CONTEXT;
 
 //
@@ -138,6 +374,7 @@ typedef struct QUIC_SOCKET_CONTEXT {
     //
     int SocketFd;
 
+#ifndef QUIC_LINUX_IO_URING
     //
     // The cleanup event FD used by this socket context.
     //
@@ -154,34 +391,95 @@ typedef struct QUIC_SOCKET_CONTEXT {
     // Indicates if sends are waiting for the socket to be write ready.
     //
     BOOLEAN SendWaiting;
+#endif
 
     //
-    // The I/O vector for receive datagrams.
+    // The I/O vectors for receive datagrams.
     //
-    struct iovec RecvIov;
+    struct iovec RecvIov[QUIC_MAX_BATCH_RECEIVE];
 
     //
-    // The control buffer used in RecvMsgHdr.
+    // The control buffers used in RecvMsgHdr.
     //
-    char RecvMsgControl[CMSG_SPACE(sizeof(struct in6_pktinfo)) +
+    char RecvMsgControl[QUIC_MAX_BATCH_RECEIVE][
+                        CMSG_SPACE(sizeof(struct in6_pktinfo)) +
                         CMSG_SPACE(sizeof(struct in_pktinfo)) +
-                        2 * CMSG_SPACE(sizeof(int))];
+                        3 * CMSG_SPACE(sizeof(int))];
+
+    //
+    // The buffers used to receive msg headers on socket with recvmmsg.
+    //
+    struct mmsghdr RecvMsgHdr[QUIC_MAX_BATCH_RECEIVE];
 
     //
-    // The buffer used to receive msg headers on socket.
+    // The receive blocks currently being used for receives on this socket.
     //
-    struct msghdr RecvMsgHdr;
+    QUIC_DATAPATH_RECV_BLOCK* CurrentRecvBlocks[QUIC_MAX_BATCH_RECEIVE];
 
     //
-    // The receive block currently being used for receives on this socket.
+    // The number of receive slots currently in use. Starts at one and only
+    // grows toward the datapath's MaxRecvBatchSize as datagrams arrive, so
+    // idle sockets don't pin a full batch of receive blocks.
     //
-    QUIC_DATAPATH_RECV_BLOCK* CurrentRecvBlock;
+    uint8_t RecvSlotCount;
 
+#ifdef QUIC_LINUX_IO_URING
+    //
+    // The io_uring operations for the receives posted on this socket.
+    //
+    QUIC_URING_OP RecvOps[QUIC_MAX_BATCH_RECEIVE];
+
+    //
+    // The io_uring operations used to cancel the receives on shutdown.
+    //
+    QUIC_URING_OP CancelOps[QUIC_MAX_BATCH_RECEIVE];
+
+    //
+    // The io_uring operation used to shut down the socket.
+    //
+    QUIC_URING_OP ShutdownOp;
+
+    //
+    // The number of outstanding io_uring operations, plus one held until all
+    // operations have been canceled on shutdown.
+    //
+    long volatile IoCount;
+#else
     //
     // The head of list containg all pending sends on this socket.
     //
     QUIC_LIST_ENTRY PendingSendContextHead;
 
+    //
+    // Serializes zero-copy sends with the tracking of their completions, as
+    // the kernel identifies completions by the order of the sends.
+    //
+    QUIC_LOCK ZeroCopyLock;
+
+    //
+    // Zero-copy sends whose buffers are still referenced by the kernel, in
+    // the order they were sent.
+    //
+    QUIC_LIST_ENTRY ZeroCopySendContextHead;
+
+    //
+    // The kernel's identifier for the next zero-copy send on the socket.
+    //
+    uint32_t ZeroCopyNextId;
+
+    //
+    // TRUE if zero-copy sends aren't used on this socket, because enabling
+    // them failed or the kernel reported it had to copy the data anyway.
+    //
+    BOOLEAN ZeroCopyDisabled;
+#endif
+
+    //
+    // TRUE if SO_TXTIME is enabled on the socket, so sends may carry an
+    // earliest departure time.
+    //
+    BOOLEAN TxTimeEnabled;
+
 } QUIC_SOCKET_CONTEXT;
 
 //
@@ -224,6 +522,14 @@ typedef struct QUIC_DATAPATH_BINDING {
     //
     BOOLEAN Shutdown : 1;
 
+    //
+    // Indicates every socket of the binding joined its SO_REUSEPORT group,
+    // which is required for CID steering. Only set for bindings created with
+    // QUIC_DATAPATH_BINDING_FLAG_CID_STEERING, and cleared if any socket
+    // fails to join.
+    //
+    BOOLEAN ReusePortGroup : 1;
+
     //
     // The MTU for this binding.
     //
@@ -246,6 +552,12 @@ typedef struct QUIC_DATAPATH_PROC_CONTEXT {
     //
     QUIC_DATAPATH* Datapath;
 
+#ifdef QUIC_LINUX_IO_URING
+    //
+    // The io_uring instance for this proc context.
+    //
+    QUIC_URING Ring;
+#else
     //
     // The Epoll FD for this proc context.
     //
@@ -255,6 +567,7 @@ typedef struct QUIC_DATAPATH_PROC_CONTEXT {
     // The event FD for this proc context.
     //
     int EventFd;
+#endif
 
     //
     // The index of the context in the datapath's array.
@@ -277,11 +590,25 @@ typedef struct QUIC_DATAPATH_PROC_CONTEXT {
     //
     QUIC_POOL SendBufferPool;
 
+    //
+    // Pool of large segmented send buffers to be shared by all sockets on this
+    // core.
+    //
+    QUIC_POOL LargeSendBufferPool;
+
     //
     // Pool of send contexts to be shared by all sockets on this core.
     //
     QUIC_POOL SendContextPool;
 
+    //
+    // The number of times the worker thread found events while spinning, and
+    // the number of times it blocked waiting for them. Only written by the
+    // worker thread.
+    //
+    uint64_t SpinWakeCount;
+    uint64_t SleepCount;
+
 } QUIC_DATAPATH_PROC_CONTEXT;
 
 //
@@ -296,10 +623,61 @@ typedef struct QUIC_DATAPATH {
 
     //
     // The max send batch size.
-    // TODO: See how send batching can be enabled.
     //
     uint8_t MaxSendBatchSize;
 
+    //
+    // The max number of receive buffers posted per receive call.
+    //
+    uint8_t MaxRecvBatchSize;
+
+    //
+    // The number of datagram slots in each receive block.
+    //
+    uint8_t RecvDatagramCount;
+
+    //
+    // Set of supported features. Only written during initialization.
+    //
+    uint32_t Features;
+
+    //
+    // Set to TRUE once a segmented send fails with EIO, which turns off send
+    // segmentation even though the kernel supports it.
+    //
+    long volatile SendSegmentationDisabled;
+
+    //
+    // The size of each datagram slot in a receive block.
+    //
+    uint32_t DatagramStride;
+
+    //
+    // The offset of the payload buffer in a receive block.
+    //
+    uint32_t RecvPayloadOffset;
+
+    //
+    // The length of the payload buffer in a receive block.
+    //
+    uint32_t RecvPayloadLength;
+
+    //
+    // The time (in us) worker threads spin polling for new events before
+    // blocking.
+    //
+    uint32_t volatile SpinTimeUs;
+
+    //
+    // The SO_BUSY_POLL time (in us) applied to new sockets.
+    //
+    uint32_t volatile BusyPollUs;
+
+    //
+    // TRUE if large segmented sends are done without copying.
+    //
+    BOOLEAN volatile ZeroCopySendEnabled;
+
     //
     // A reference rundown on the datapath binding.
     //
@@ -337,100 +715,326 @@ QuicDataPathWorkerThread(
     _In_ void* Context
     );
 
+#ifdef QUIC_LINUX_IO_URING
+
 QUIC_STATUS
-QuicProcessorContextInitialize(
-    _In_ QUIC_DATAPATH* Datapath,
-    _In_ uint32_t Index,
-    _Out_ QUIC_DATAPATH_PROC_CONTEXT* ProcContext
+QuicUringInitialize(
+    _Out_ QUIC_URING* Ring,
+    _In_ uint32_t Entries
     )
 {
     QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
-    int EpollFd = INVALID_SOCKET_FD;
-    int EventFd = INVALID_SOCKET_FD;
-    int Ret = 0;
-    uint32_t RecvPacketLength = 0;
-    BOOLEAN EventFdAdded = FALSE;
-
-    QUIC_DBG_ASSERT(Datapath != NULL);
-
-    RecvPacketLength =
-        sizeof(QUIC_DATAPATH_RECV_BLOCK) + Datapath->ClientRecvContextLength;
-
-    ProcContext->Index = Index;
-    QuicPoolInitialize(
-        TRUE,
-        RecvPacketLength,
-        QUIC_POOL_DATA,
-        &ProcContext->RecvBlockPool);
-    QuicPoolInitialize(
-        TRUE,
-        MAX_UDP_PAYLOAD_LENGTH,
-        QUIC_POOL_DATA,
-        &ProcContext->SendBufferPool);
-    QuicPoolInitialize(
-        TRUE,
-        sizeof(QUIC_DATAPATH_SEND_CONTEXT),
-        QUIC_POOL_PLATFORM_SENDCTX,
-        &ProcContext->SendContextPool);
-
-    EpollFd = epoll_create1(EPOLL_CLOEXEC);
-    if (EpollFd == INVALID_SOCKET_FD) {
+    struct io_uring_params Params;
+    uint8_t* SqRing;
+    uint8_t* CqRing;
+
+    QuicZeroMemory(Ring, sizeof(*Ring));
+    Ring->RingFd = INVALID_SOCKET_FD;
+    Ring->RingMemory = MAP_FAILED;
+    Ring->Sqes = MAP_FAILED;
+    QuicZeroMemory(&Params, sizeof(Params));
+
+    Ring->RingFd = (int)syscall(__NR_io_uring_setup, Entries, &Params);
+    if (Ring->RingFd == INVALID_SOCKET_FD) {
         Status = errno;
         QuicTraceEvent(
             LibraryErrorStatus,
             "[ lib] ERROR, %u, %s.",
             Status,
-            "epoll_create1(EPOLL_CLOEXEC) failed");
+            "io_uring_setup failed");
         goto Exit;
     }
 
-    EventFd = eventfd(0, EFD_CLOEXEC);
-    if (EventFd == INVALID_SOCKET_FD) {
-        Status = errno;
+    //
+    // Only kernels (5.4+) that map both rings with a single mmap, and never
+    // drop completions (5.5+), are supported.
+    //
+    if (!(Params.features & IORING_FEAT_SINGLE_MMAP) ||
+        !(Params.features & IORING_FEAT_NODROP)) {
+        Status = QUIC_STATUS_NOT_SUPPORTED;
         QuicTraceEvent(
             LibraryErrorStatus,
             "[ lib] ERROR, %u, %s.",
             Status,
-            "eventfd failed");
+            "io_uring features not supported");
         goto Exit;
     }
 
-    struct epoll_event EvtFdEpEvt = {
-        .events = EPOLLIN,
-        .data = {
-            .ptr = NULL
-        }
-    };
+    Ring->RingMemoryLength =
+        Params.sq_off.array + Params.sq_entries * sizeof(uint32_t);
+    if (Ring->RingMemoryLength <
+        Params.cq_off.cqes + Params.cq_entries * sizeof(struct io_uring_cqe)) {
+        Ring->RingMemoryLength =
+            Params.cq_off.cqes + Params.cq_entries * sizeof(struct io_uring_cqe);
+    }
+    Ring->RingMemory =
+        mmap(
+            NULL,
+            Ring->RingMemoryLength,
+            PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE,
+            Ring->RingFd,
+            IORING_OFF_SQ_RING);
+    if (Ring->RingMemory == MAP_FAILED) {
+        Status = errno;
+        QuicTraceEvent(
+            LibraryErrorStatus,
+            "[ lib] ERROR, %u, %s.",
+            Status,
+            "mmap(IORING_OFF_SQ_RING) failed");
+        goto Exit;
+    }
 
-    Ret = epoll_ctl(EpollFd, EPOLL_CTL_ADD, EventFd, &EvtFdEpEvt);
-    if (Ret != 0) {
+    Ring->SqesMemoryLength = Params.sq_entries * sizeof(struct io_uring_sqe);
+    Ring->Sqes =
+        mmap(
+            NULL,
+            Ring->SqesMemoryLength,
+            PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE,
+            Ring->RingFd,
+            IORING_OFF_SQES);
+    if (Ring->Sqes == MAP_FAILED) {
         Status = errno;
         QuicTraceEvent(
             LibraryErrorStatus,
             "[ lib] ERROR, %u, %s.",
             Status,
-            "epoll_ctl(EPOLL_CTL_ADD) failed");
+            "mmap(IORING_OFF_SQES) failed");
         goto Exit;
     }
 
-    EventFdAdded = TRUE;
+    SqRing = (uint8_t*)Ring->RingMemory;
+    Ring->SqEntries = Params.sq_entries;
+    Ring->SqMask = *(uint32_t*)(SqRing + Params.sq_off.ring_mask);
+    Ring->SqHead = (uint32_t*)(SqRing + Params.sq_off.head);
+    Ring->SqTail = (uint32_t*)(SqRing + Params.sq_off.tail);
+    Ring->SqArray = (uint32_t*)(SqRing + Params.sq_off.array);
 
-    ProcContext->Datapath = Datapath;
-    ProcContext->EpollFd = EpollFd;
-    ProcContext->EventFd = EventFd;
+    CqRing = (uint8_t*)Ring->RingMemory;
+    Ring->CqMask = *(uint32_t*)(CqRing + Params.cq_off.ring_mask);
+    Ring->CqHead = (uint32_t*)(CqRing + Params.cq_off.head);
+    Ring->CqTail = (uint32_t*)(CqRing + Params.cq_off.tail);
+    Ring->Cqes = (struct io_uring_cqe*)(CqRing + Params.cq_off.cqes);
 
-    //
-    // Starting the thread must be done after the rest of the ProcContext
-    // members have been initialized. Because the thread start routine accesses
-    // ProcContext members.
-    //
+    QuicLockInitialize(&Ring->SqLock);
 
-    QUIC_THREAD_CONFIG ThreadConfig = {
-        0,
-        0,
-        NULL,
-        QuicDataPathWorkerThread,
-        ProcContext
+Exit:
+
+    if (QUIC_FAILED(Status)) {
+        if (Ring->Sqes != MAP_FAILED) {
+            munmap(Ring->Sqes, Ring->SqesMemoryLength);
+        }
+        if (Ring->RingMemory != MAP_FAILED) {
+            munmap(Ring->RingMemory, Ring->RingMemoryLength);
+        }
+        if (Ring->RingFd != INVALID_SOCKET_FD) {
+            close(Ring->RingFd);
+        }
+    }
+
+    return Status;
+}
+
+void
+QuicUringUninitialize(
+    _In_ QUIC_URING* Ring
+    )
+{
+    QuicLockUninitialize(&Ring->SqLock);
+    munmap(Ring->Sqes, Ring->SqesMemoryLength);
+    munmap(Ring->RingMemory, Ring->RingMemoryLength);
+    close(Ring->RingFd);
+}
+
+//
+// Submits queued entries and/or waits for completions.
+//
+int
+QuicUringEnter(
+    _In_ QUIC_URING* Ring,
+    _In_ uint32_t ToSubmit,
+    _In_ uint32_t MinComplete
+    )
+{
+    int Ret;
+    do {
+        Ret =
+            (int)syscall(
+                __NR_io_uring_enter,
+                Ring->RingFd,
+                ToSubmit,
+                MinComplete,
+                MinComplete > 0 ? IORING_ENTER_GETEVENTS : 0,
+                NULL,
+                0);
+    } while (Ret < 0 && errno == EINTR);
+    return Ret;
+}
+
+//
+// Queues a submission queue entry. The caller must call QuicUringEnter to
+// submit it.
+//
+void
+QuicUringQueueSqe(
+    _In_ QUIC_URING* Ring,
+    _In_ uint8_t Opcode,
+    _In_ int Fd,
+    _In_opt_ void* Addr,
+    _In_ uint32_t OpFlags,
+    _In_ QUIC_URING_OP* Op
+    )
+{
+    QuicLockAcquire(&Ring->SqLock);
+
+    uint32_t Tail = *Ring->SqTail;
+    if (Tail - __atomic_load_n(Ring->SqHead, __ATOMIC_ACQUIRE) == Ring->SqEntries) {
+        //
+        // The submission ring is full. Hand the queued entries over to the
+        // kernel, which frees up the ring.
+        //
+        QuicUringEnter(Ring, Ring->SqEntries, 0);
+        QUIC_FRE_ASSERT(Tail - __atomic_load_n(Ring->SqHead, __ATOMIC_ACQUIRE) < Ring->SqEntries);
+    }
+
+    uint32_t Index = Tail & Ring->SqMask;
+    struct io_uring_sqe* Sqe = &Ring->Sqes[Index];
+    QuicZeroMemory(Sqe, sizeof(*Sqe));
+    Sqe->opcode = Opcode;
+    Sqe->fd = Fd;
+    Sqe->addr = (uint64_t)(uintptr_t)Addr;
+    //
+    // Message operations take one msghdr. Cancels take the user data of the
+    // operation to cancel in addr, and the kernel rejects a non-zero len.
+    //
+    Sqe->len = Opcode == IORING_OP_ASYNC_CANCEL || Addr == NULL ? 0 : 1;
+    Sqe->msg_flags = OpFlags;
+    Sqe->user_data = (uint64_t)(uintptr_t)Op;
+    Ring->SqArray[Index] = Index;
+
+    __atomic_store_n(Ring->SqTail, Tail + 1, __ATOMIC_RELEASE);
+
+    QuicLockRelease(&Ring->SqLock);
+}
+
+#endif // QUIC_LINUX_IO_URING
+
+QUIC_STATUS
+QuicProcessorContextInitialize(
+    _In_ QUIC_DATAPATH* Datapath,
+    _In_ uint32_t Index,
+    _Out_ QUIC_DATAPATH_PROC_CONTEXT* ProcContext
+    )
+{
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+#ifdef QUIC_LINUX_IO_URING
+    BOOLEAN RingInitialized = FALSE;
+#else
+    int EpollFd = INVALID_SOCKET_FD;
+    int EventFd = INVALID_SOCKET_FD;
+    int Ret = 0;
+    BOOLEAN EventFdAdded = FALSE;
+#endif
+    uint32_t RecvPacketLength = 0;
+
+    QUIC_DBG_ASSERT(Datapath != NULL);
+
+    RecvPacketLength =
+        Datapath->RecvPayloadOffset + Datapath->RecvPayloadLength;
+
+    ProcContext->Index = Index;
+    QuicPoolInitialize(
+        TRUE,
+        RecvPacketLength,
+        QUIC_POOL_DATA,
+        &ProcContext->RecvBlockPool);
+    QuicPoolInitialize(
+        TRUE,
+        MAX_UDP_PAYLOAD_LENGTH,
+        QUIC_POOL_DATA,
+        &ProcContext->SendBufferPool);
+    QuicPoolInitialize(
+        TRUE,
+        QUIC_LARGE_SEND_BUFFER_SIZE,
+        QUIC_POOL_DATA,
+        &ProcContext->LargeSendBufferPool);
+    QuicPoolInitializeEx(
+        TRUE,
+        sizeof(QUIC_DATAPATH_SEND_CONTEXT),
+        QUIC_POOL_PLATFORM_SENDCTX,
+        TRUE,
+        &ProcContext->SendContextPool);
+
+#ifdef QUIC_LINUX_IO_URING
+    Status = QuicUringInitialize(&ProcContext->Ring, QUIC_URING_QUEUE_DEPTH);
+    if (QUIC_FAILED(Status)) {
+        goto Exit;
+    }
+
+    RingInitialized = TRUE;
+
+    ProcContext->Datapath = Datapath;
+#else
+    EpollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (EpollFd == INVALID_SOCKET_FD) {
+        Status = errno;
+        QuicTraceEvent(
+            LibraryErrorStatus,
+            "[ lib] ERROR, %u, %s.",
+            Status,
+            "epoll_create1(EPOLL_CLOEXEC) failed");
+        goto Exit;
+    }
+
+    EventFd = eventfd(0, EFD_CLOEXEC);
+    if (EventFd == INVALID_SOCKET_FD) {
+        Status = errno;
+        QuicTraceEvent(
+            LibraryErrorStatus,
+            "[ lib] ERROR, %u, %s.",
+            Status,
+            "eventfd failed");
+        goto Exit;
+    }
+
+    struct epoll_event EvtFdEpEvt = {
+        .events = EPOLLIN,
+        .data = {
+            .ptr = NULL
+        }
+    };
+
+    Ret = epoll_ctl(EpollFd, EPOLL_CTL_ADD, EventFd, &EvtFdEpEvt);
+    if (Ret != 0) {
+        Status = errno;
+        QuicTraceEvent(
+            LibraryErrorStatus,
+            "[ lib] ERROR, %u, %s.",
+            Status,
+            "epoll_ctl(EPOLL_CTL_ADD) failed");
+        goto Exit;
+    }
+
+    EventFdAdded = TRUE;
+
+    ProcContext->Datapath = Datapath;
+    ProcContext->EpollFd = EpollFd;
+    ProcContext->EventFd = EventFd;
+#endif
+
+    //
+    // Starting the thread must be done after the rest of the ProcContext
+    // members have been initialized. Because the thread start routine accesses
+    // ProcContext members.
+    //
+
+    QUIC_THREAD_CONFIG ThreadConfig = {
+        0,
+        0,
+        NULL,
+        QuicDataPathWorkerThread,
+        ProcContext
     };
 
     Status = QuicThreadCreate(&ThreadConfig, &ProcContext->EpollWaitThread);
@@ -446,6 +1050,11 @@ QuicProcessorContextInitialize(
 Exit:
 
     if (QUIC_FAILED(Status)) {
+#ifdef QUIC_LINUX_IO_URING
+        if (RingInitialized) {
+            QuicUringUninitialize(&ProcContext->Ring);
+        }
+#else
         if (EventFdAdded) {
             epoll_ctl(EpollFd, EPOLL_CTL_DEL, EventFd, NULL);
         }
@@ -455,8 +1064,10 @@ Exit:
         if (EpollFd != INVALID_SOCKET_FD) {
             close(EpollFd);
         }
+#endif
         QuicPoolUninitialize(&ProcContext->RecvBlockPool);
         QuicPoolUninitialize(&ProcContext->SendBufferPool);
+        QuicPoolUninitialize(&ProcContext->LargeSendBufferPool);
         QuicPoolUninitialize(&ProcContext->SendContextPool);
     }
 
@@ -468,6 +1079,18 @@ QuicProcessorContextUninitialize(
     _In_ QUIC_DATAPATH_PROC_CONTEXT* ProcContext
     )
 {
+#ifdef QUIC_LINUX_IO_URING
+    //
+    // A NOP without an operation context wakes up the worker thread, which
+    // then sees the datapath is shutting down.
+    //
+    QuicUringQueueSqe(&ProcContext->Ring, IORING_OP_NOP, -1, NULL, 0, NULL);
+    QuicUringEnter(&ProcContext->Ring, 1, 0);
+    QuicThreadWait(&ProcContext->EpollWaitThread);
+    QuicThreadDelete(&ProcContext->EpollWaitThread);
+
+    QuicUringUninitialize(&ProcContext->Ring);
+#else
     const eventfd_t Value = 1;
     eventfd_write(ProcContext->EventFd, Value);
     QuicThreadWait(&ProcContext->EpollWaitThread);
@@ -476,12 +1099,154 @@ QuicProcessorContextUninitialize(
     epoll_ctl(ProcContext->EpollFd, EPOLL_CTL_DEL, ProcContext->EventFd, NULL);
     close(ProcContext->EventFd);
     close(ProcContext->EpollFd);
+#endif
 
     QuicPoolUninitialize(&ProcContext->RecvBlockPool);
     QuicPoolUninitialize(&ProcContext->SendBufferPool);
+    QuicPoolUninitialize(&ProcContext->LargeSendBufferPool);
     QuicPoolUninitialize(&ProcContext->SendContextPool);
 }
 
+void
+QuicDataPathQuerySockoptSupport(
+    _Inout_ QUIC_DATAPATH* Datapath
+    )
+{
+    int Result;
+    socklen_t OptionLength;
+
+    int UdpSocket = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, IPPROTO_UDP);
+    if (UdpSocket == INVALID_SOCKET_FD) {
+        QuicTraceLogWarning(
+            DatapathOpenUdpSocketFailed,
+            "[ udp] UDP send segmentation helper socket failed to open, 0x%x",
+            errno);
+        return;
+    }
+
+    //
+    // UDP_SEGMENT is only supported on newer kernels (4.18+). Querying it is
+    // the simplest way to determine support.
+    //
+    int SegmentSize;
+    OptionLength = sizeof(SegmentSize);
+    Result =
+        getsockopt(
+            UdpSocket,
+            IPPROTO_UDP,
+            UDP_SEGMENT,
+            (void*)&SegmentSize,
+            &OptionLength);
+    if (Result == SOCKET_ERROR) {
+        QuicTraceLogWarning(
+            DatapathQueryUdpSegmentFailed,
+            "[ udp] Query for UDP_SEGMENT failed, 0x%x",
+            errno);
+    } else {
+        Datapath->Features |= QUIC_DATAPATH_FEATURE_SEND_SEGMENTATION;
+    }
+
+    //
+    // UDP_GRO is only supported on newer kernels (5.0+). There is no way to
+    // query it without enabling it, so enable it on the helper socket.
+    //
+    int Option = TRUE;
+    Result =
+        setsockopt(
+            UdpSocket,
+            IPPROTO_UDP,
+            UDP_GRO,
+            (const void*)&Option,
+            sizeof(Option));
+    if (Result == SOCKET_ERROR) {
+        QuicTraceLogWarning(
+            DatapathQueryUdpGroFailed,
+            "[ udp] Enabling UDP_GRO failed, 0x%x",
+            errno);
+    } else {
+        Datapath->Features |= QUIC_DATAPATH_FEATURE_RECV_COALESCING;
+    }
+
+    //
+    // Steering by connection ID needs SO_REUSEPORT groups (3.9+) with classic
+    // BPF selection programs (4.5+). Attach a trivial program to check both.
+    //
+    struct sock_filter Code[] = {
+        BPF_STMT(BPF_RET | BPF_K, 0)
+    };
+    struct sock_fprog Program = { ARRAYSIZE(Code), Code };
+    Result =
+        setsockopt(
+            UdpSocket,
+            SOL_SOCKET,
+            SO_REUSEPORT,
+            (const void*)&Option,
+            sizeof(Option));
+    if (Result != SOCKET_ERROR) {
+        Result =
+            setsockopt(
+                UdpSocket,
+                SOL_SOCKET,
+                SO_ATTACH_REUSEPORT_CBPF,
+                (const void*)&Program,
+                sizeof(Program));
+    }
+    if (Result == SOCKET_ERROR) {
+        QuicTraceLogWarning(
+            DatapathQueryReusePortCbpfFailed,
+            "[ udp] Attaching SO_REUSEPORT CBPF program failed, 0x%x",
+            errno);
+    } else {
+        Datapath->Features |= QUIC_DATAPATH_FEATURE_CID_STEERING;
+    }
+
+#ifndef QUIC_LINUX_IO_URING
+    //
+    // MSG_ZEROCOPY is only supported for UDP on newer kernels (5.0+), which is
+    // when SO_ZEROCOPY started being accepted on UDP sockets. It's only
+    // implemented for the epoll based datapath.
+    //
+    Result =
+        setsockopt(
+            UdpSocket,
+            SOL_SOCKET,
+            SO_ZEROCOPY,
+            (const void*)&Option,
+            sizeof(Option));
+    if (Result == SOCKET_ERROR) {
+        QuicTraceLogWarning(
+            DatapathQueryZeroCopyFailed,
+            "[ udp] Enabling SO_ZEROCOPY failed, 0x%x",
+            errno);
+    } else {
+        Datapath->Features |= QUIC_DATAPATH_FEATURE_SEND_ZEROCOPY;
+    }
+#endif
+
+    //
+    // SO_TXTIME is supported on newer kernels (4.19+). The departure times
+    // are only honored by qdiscs that support them, such as fq and etf.
+    //
+    struct sock_txtime TxTime = { CLOCK_MONOTONIC, 0 };
+    Result =
+        setsockopt(
+            UdpSocket,
+            SOL_SOCKET,
+            SO_TXTIME,
+            (const void*)&TxTime,
+            sizeof(TxTime));
+    if (Result == SOCKET_ERROR) {
+        QuicTraceLogWarning(
+            DatapathQueryTxTimeFailed,
+            "[ udp] Enabling SO_TXTIME failed, 0x%x",
+            errno);
+    } else {
+        Datapath->Features |= QUIC_DATAPATH_FEATURE_SEND_TXTIME;
+    }
+
+    close(UdpSocket);
+}
+
 QUIC_STATUS
 QuicDataPathInitialize(
     _In_ uint32_t ClientRecvContextLength,
@@ -529,6 +1294,32 @@ QuicDataPathInitialize(
     Datapath->MaxSendBatchSize = QUIC_MAX_BATCH_SEND;
     QuicRundownInitialize(&Datapath->BindingsRundown);
 
+    QuicDataPathQuerySockoptSupport(Datapath);
+
+    //
+    // With receive coalescing, each receive block holds up to a maximum sized
+    // coalesced payload, split into as many datagrams as the kernel can
+    // coalesce.
+    //
+    if (Datapath->Features & QUIC_DATAPATH_FEATURE_RECV_COALESCING) {
+        Datapath->MaxRecvBatchSize = QUIC_MAX_BATCH_RECEIVE_COALESCED;
+        Datapath->RecvDatagramCount = GRO_MAX_DATAGRAMS_PER_RECEIVE;
+        Datapath->RecvPayloadLength = MAX_GRO_PAYLOAD_LENGTH;
+    } else {
+        Datapath->MaxRecvBatchSize = QUIC_MAX_BATCH_RECEIVE;
+        Datapath->RecvDatagramCount = 1;
+        Datapath->RecvPayloadLength = MAX_UDP_PAYLOAD_LENGTH;
+    }
+    Datapath->DatagramStride =
+        ALIGN_UP(
+            sizeof(QUIC_RECV_DATAGRAM) +
+            sizeof(QUIC_DATAPATH_RECV_BUFFER_CONTEXT) +
+            ClientRecvContextLength,
+            void*);
+    Datapath->RecvPayloadOffset =
+        sizeof(QUIC_DATAPATH_RECV_BLOCK) +
+        Datapath->RecvDatagramCount * Datapath->DatagramStride;
+
     //
     // Initialize the per processor contexts.
     //
@@ -587,8 +1378,11 @@ QuicDataPathGetSupportedFeatures(
     _In_ QUIC_DATAPATH* Datapath
     )
 {
-    UNREFERENCED_PARAMETER(Datapath);
-    return 0;
+    uint32_t Features = Datapath->Features;
+    if (Datapath->SendSegmentationDisabled) {
+        Features &= ~QUIC_DATAPATH_FEATURE_SEND_SEGMENTATION;
+    }
+    return Features;
 }
 
 BOOLEAN
@@ -599,12 +1393,57 @@ QuicDataPathIsPaddingPreferred(
 #ifdef QUIC_PLATFORM_DISPATCH_TABLE
     return PlatDispatch->DatapathIsPaddingPreferred(Datapath);
 #else
-    UNREFERENCED_PARAMETER(Datapath);
-    //
-    // The windows implementation returns TRUE only if GSO is supported and
-    // this DAL implementation doesn't support GSO currently.
-    //
-    return FALSE;
+    return !!(QuicDataPathGetSupportedFeatures(Datapath) & QUIC_DATAPATH_FEATURE_SEND_SEGMENTATION);
+#endif
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicDataPathSetPolling(
+    _In_ QUIC_DATAPATH* Datapath,
+    _In_ uint32_t SpinTimeUs,
+    _In_ uint32_t BusyPollUs
+    )
+{
+#ifdef QUIC_PLATFORM_DISPATCH_TABLE
+    PlatDispatch->DatapathSetPolling(Datapath, SpinTimeUs, BusyPollUs);
+#else
+    Datapath->SpinTimeUs = SpinTimeUs;
+    Datapath->BusyPollUs = BusyPollUs;
+#endif
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicDataPathGetPollingStats(
+    _In_ QUIC_DATAPATH* Datapath,
+    _Out_ uint64_t* SpinWakes,
+    _Out_ uint64_t* Sleeps
+    )
+{
+#ifdef QUIC_PLATFORM_DISPATCH_TABLE
+    PlatDispatch->DatapathGetPollingStats(Datapath, SpinWakes, Sleeps);
+#else
+    *SpinWakes = 0;
+    *Sleeps = 0;
+    for (uint32_t i = 0; i < Datapath->ProcCount; i++) {
+        *SpinWakes += Datapath->ProcContexts[i].SpinWakeCount;
+        *Sleeps += Datapath->ProcContexts[i].SleepCount;
+    }
+#endif
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicDataPathSetZeroCopySend(
+    _In_ QUIC_DATAPATH* Datapath,
+    _In_ BOOLEAN Enabled
+    )
+{
+#ifdef QUIC_PLATFORM_DISPATCH_TABLE
+    PlatDispatch->DatapathSetZeroCopySend(Datapath, Enabled);
+#else
+    Datapath->ZeroCopySendEnabled = Enabled;
 #endif
 }
 
@@ -625,12 +1464,42 @@ QuicDataPathAllocRecvBlock(
     } else {
         QuicZeroMemory(RecvBlock, sizeof(*RecvBlock));
         RecvBlock->OwningPool = &Datapath->ProcContexts[ProcIndex].RecvBlockPool;
-        RecvBlock->RecvPacket.Buffer = RecvBlock->Buffer;
-        RecvBlock->RecvPacket.Allocated = TRUE;
     }
     return RecvBlock;
 }
 
+QUIC_RECV_DATAGRAM*
+QuicDataPathRecvBlockGetDatagram(
+    _In_ const QUIC_DATAPATH* Datapath,
+    _In_ QUIC_DATAPATH_RECV_BLOCK* RecvBlock,
+    _In_ uint32_t Index
+    )
+{
+    QUIC_DBG_ASSERT(Index < Datapath->RecvDatagramCount);
+    return
+        (QUIC_RECV_DATAGRAM*)
+            ((uint8_t*)(RecvBlock + 1) + Index * Datapath->DatagramStride);
+}
+
+uint8_t*
+QuicDataPathRecvBlockGetPayload(
+    _In_ const QUIC_DATAPATH* Datapath,
+    _In_ QUIC_DATAPATH_RECV_BLOCK* RecvBlock
+    )
+{
+    return (uint8_t*)RecvBlock + Datapath->RecvPayloadOffset;
+}
+
+QUIC_DATAPATH_RECV_BUFFER_CONTEXT*
+QuicDataPathDatagramToInternalDatagramContext(
+    _In_ QUIC_RECV_DATAGRAM* Datagram
+    )
+{
+    return
+        (QUIC_DATAPATH_RECV_BUFFER_CONTEXT*)
+            ((uint8_t*)Datagram + sizeof(QUIC_RECV_DATAGRAM));
+}
+
 void
 QuicDataPathPopulateTargetAddress(
     _In_ QUIC_ADDRESS_FAMILY Family,
@@ -762,6 +1631,20 @@ QuicSocketContextInitialize(
 
     QUIC_DATAPATH_BINDING* Binding = SocketContext->Binding;
 
+#ifdef QUIC_LINUX_IO_URING
+    UNREFERENCED_PARAMETER(ProcContext);
+
+    for (uint32_t i = 0; i < ARRAYSIZE(SocketContext->RecvOps); ++i) {
+        SocketContext->RecvOps[i].Type = QUIC_URING_OP_RECV;
+        SocketContext->RecvOps[i].Index = (uint8_t)i;
+        SocketContext->RecvOps[i].SocketContext = SocketContext;
+        SocketContext->CancelOps[i].Type = QUIC_URING_OP_CANCEL;
+        SocketContext->CancelOps[i].Index = (uint8_t)i;
+        SocketContext->CancelOps[i].SocketContext = SocketContext;
+    }
+    SocketContext->ShutdownOp.Type = QUIC_URING_OP_SHUTDOWN;
+    SocketContext->ShutdownOp.SocketContext = SocketContext;
+#else
     for (uint32_t i = 0; i < ARRAYSIZE(SocketContext->EventContexts); ++i) {
         SocketContext->EventContexts[i] = i;
     }
@@ -799,14 +1682,21 @@ QuicSocketContextInitialize(
             "epoll_ctl(EPOLL_CTL_ADD) failed");
         goto Exit;
     }
+#endif
 
     //
-    // Create datagram socket.
+    // Create datagram socket. With io_uring, the socket must be blocking so
+    // that operations which can't complete immediately are queued by the
+    // kernel instead of failing with EAGAIN.
     //
     SocketContext->SocketFd =
         socket(
             AF_INET6,
+#ifdef QUIC_LINUX_IO_URING
+            SOCK_DGRAM | SOCK_CLOEXEC,
+#else
             SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, // TODO check if SOCK_CLOEXEC is required?
+#endif
             IPPROTO_UDP);
     if (SocketContext->SocketFd == INVALID_SOCKET_FD) {
         Status = errno;
@@ -979,6 +1869,27 @@ QuicSocketContextInitialize(
         goto Exit;
     }
 
+    if (Binding->Datapath->Features & QUIC_DATAPATH_FEATURE_RECV_COALESCING) {
+        Option = TRUE;
+        Result =
+            setsockopt(
+                SocketContext->SocketFd,
+                IPPROTO_UDP,
+                UDP_GRO,
+                (const void*)&Option,
+                sizeof(Option));
+        if (Result == SOCKET_ERROR) {
+            Status = errno;
+            QuicTraceEvent(
+                DatapathErrorStatus,
+                "[ udp][%p] ERROR, %u, %s.",
+                Binding,
+                Status,
+                "setsockopt(UDP_GRO) failed");
+            goto Exit;
+        }
+    }
+
     //
     // The socket is shared by multiple QUIC endpoints, so increase the receive
     // buffer size.
@@ -1024,6 +1935,108 @@ QuicSocketContextInitialize(
         goto Exit;
     }
 
+    //
+    // Sockets of a binding that opted in to CID steering form a SO_REUSEPORT
+    // group, so that the kernel spreads receives across processors instead of
+    // delivering them all to one socket. SO_REUSEPORT also lets any other
+    // socket of the same user join the group, which is why it is opt-in.
+    //
+    if (Binding->ReusePortGroup) {
+        Result =
+            setsockopt(
+                SocketContext->SocketFd,
+                SOL_SOCKET,
+                SO_REUSEPORT,
+                (const void*)&Option,
+                sizeof(Option));
+        if (Result == SOCKET_ERROR) {
+            //
+            // SO_REUSEADDR still lets the socket share the port, so just
+            // fall back to unsteered receives.
+            //
+            QuicTraceLogWarning(
+                DatapathReusePortFailed,
+                "[ udp][%p] Setting SO_REUSEPORT failed, 0x%x",
+                Binding,
+                errno);
+            Binding->ReusePortGroup = FALSE;
+        }
+    }
+
+    //
+    // Let the kernel busy poll the device queue for this socket, if
+    // configured. Values above net.core.busy_poll need CAP_NET_ADMIN, so
+    // failure only costs the latency benefit.
+    //
+    Option = (int)Binding->Datapath->BusyPollUs;
+    if (Option != 0) {
+        Result =
+            setsockopt(
+                SocketContext->SocketFd,
+                SOL_SOCKET,
+                SO_BUSY_POLL,
+                (const void*)&Option,
+                sizeof(Option));
+        if (Result == SOCKET_ERROR) {
+            QuicTraceLogWarning(
+                DatapathBusyPollFailed,
+                "[ udp][%p] Setting SO_BUSY_POLL failed, 0x%x",
+                Binding,
+                errno);
+        }
+    }
+
+#ifndef QUIC_LINUX_IO_URING
+    //
+    // Allow MSG_ZEROCOPY sends on the socket. Whether they are actually used
+    // is decided per send, so the setting can change at runtime.
+    //
+    SocketContext->ZeroCopyDisabled = TRUE;
+    if (Binding->Datapath->Features & QUIC_DATAPATH_FEATURE_SEND_ZEROCOPY) {
+        Option = TRUE;
+        Result =
+            setsockopt(
+                SocketContext->SocketFd,
+                SOL_SOCKET,
+                SO_ZEROCOPY,
+                (const void*)&Option,
+                sizeof(Option));
+        if (Result == SOCKET_ERROR) {
+            QuicTraceLogWarning(
+                DatapathZeroCopyFailed,
+                "[ udp][%p] Setting SO_ZEROCOPY failed, 0x%x",
+                Binding,
+                errno);
+        } else {
+            SocketContext->ZeroCopyDisabled = FALSE;
+        }
+    }
+#endif
+
+    //
+    // Allow sends to carry an earliest departure time (SCM_TXTIME), on the
+    // same clock as QuicTimeUs64.
+    //
+    if (Binding->Datapath->Features & QUIC_DATAPATH_FEATURE_SEND_TXTIME) {
+        struct sock_txtime TxTime = { CLOCK_MONOTONIC, 0 };
+        Result =
+            setsockopt(
+                SocketContext->SocketFd,
+                SOL_SOCKET,
+                SO_TXTIME,
+                (const void*)&TxTime,
+                sizeof(TxTime));
+        if (Result == SOCKET_ERROR) {
+            QuicTraceLogWarning(
+                DatapathTxTimeFailed,
+                "[ udp][%p] Setting SO_TXTIME failed, 0x%x",
+                Binding,
+                errno);
+        } else {
+            SocketContext->TxTimeEnabled = TRUE;
+        }
+    }
+
     QuicCopyMemory(&MappedAddress, &Binding->LocalAddress, sizeof(MappedAddress));
     if (MappedAddress.Ipv6.sin6_family == QUIC_ADDRESS_FAMILY_INET6) {
         MappedAddress.Ipv6.sin6_family = AF_INET6;
@@ -1109,91 +2122,355 @@ Exit:
         SocketContext->SocketFd = INVALID_SOCKET_FD;
     }
 
-    return Status;
+    return Status;
+}
+
+#ifdef QUIC_LINUX_IO_URING
+
+void
+QuicSocketContextUninitialize(
+    _In_ QUIC_SOCKET_CONTEXT* SocketContext,
+    _In_ QUIC_DATAPATH_PROC_CONTEXT* ProcContext
+    )
+{
+    //
+    // The worker thread cancels the outstanding receives once it processes
+    // this, so that it doesn't race with receives it is reposting.
+    //
+    QuicUringQueueSqe(
+        &ProcContext->Ring,
+        IORING_OP_NOP,
+        -1,
+        NULL,
+        0,
+        &SocketContext->ShutdownOp);
+    QuicUringEnter(&ProcContext->Ring, 1, 0);
+}
+
+void
+QuicSocketContextUninitializeComplete(
+    _In_ QUIC_SOCKET_CONTEXT* SocketContext,
+    _In_ QUIC_DATAPATH_PROC_CONTEXT* ProcContext
+    )
+{
+    UNREFERENCED_PARAMETER(ProcContext);
+
+    for (uint32_t i = 0; i < QUIC_MAX_BATCH_RECEIVE; ++i) {
+        QUIC_DATAPATH_RECV_BLOCK* RecvBlock = SocketContext->CurrentRecvBlocks[i];
+        if (RecvBlock != NULL) {
+            QuicPoolFree(RecvBlock->OwningPool, RecvBlock);
+        }
+    }
+
+    close(SocketContext->SocketFd);
+
+    QuicRundownRelease(&SocketContext->Binding->Rundown);
+}
+
+#else
+
+//
+// Reaps zero-copy send completions from the socket's error queue and frees
+// the send contexts whose buffers the kernel no longer references.
+//
+void
+QuicSocketContextReapZeroCopySends(
+    _In_ QUIC_SOCKET_CONTEXT* SocketContext
+    )
+{
+    char ControlBuffer[
+        CMSG_SPACE(sizeof(struct sock_extended_err) + sizeof(struct sockaddr_in6))];
+
+    while (TRUE) {
+        struct msghdr Mhdr = {
+            .msg_control = ControlBuffer,
+            .msg_controllen = sizeof(ControlBuffer)
+        };
+        if (recvmsg(SocketContext->SocketFd, &Mhdr, MSG_ERRQUEUE) < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                QuicTraceEvent(
+                    DatapathErrorStatus,
+                    "[ udp][%p] ERROR, %u, %s.",
+                    SocketContext->Binding,
+                    errno,
+                    "recvmsg(MSG_ERRQUEUE) failed");
+            }
+            break;
+        }
+
+        for (struct cmsghdr* CMsg = CMSG_FIRSTHDR(&Mhdr);
+             CMsg != NULL;
+             CMsg = CMSG_NXTHDR(&Mhdr, CMsg)) {
+            if (!(CMsg->cmsg_level == IPPROTO_IP && CMsg->cmsg_type == IP_RECVERR) &&
+                !(CMsg->cmsg_level == IPPROTO_IPV6 && CMsg->cmsg_type == IPV6_RECVERR)) {
+                continue;
+            }
+
+            const struct sock_extended_err* Error =
+                (const struct sock_extended_err*)CMSG_DATA(CMsg);
+            if (Error->ee_origin != SO_EE_ORIGIN_ZEROCOPY || Error->ee_errno != 0) {
+                continue;
+            }
+
+            if ((Error->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) &&
+                !SocketContext->ZeroCopyDisabled) {
+                //
+                // The kernel had to copy the data anyway (e.g. loopback, or a
+                // device without scatter-gather), so zero-copy sends only add
+                // overhead on this socket.
+                //
+                QuicTraceLogWarning(
+                    DatapathZeroCopyDeferredCopy,
+                    "[ udp][%p] Zero-copy sends disabled, data was copied",
+                    SocketContext->Binding);
+                SocketContext->ZeroCopyDisabled = TRUE;
+            }
+
+            //
+            // The notification covers the inclusive range [ee_info, ee_data]
+            // of send identifiers. Usually they complete in order, so the
+            // sends are at the head of the list.
+            //
+            const uint32_t First = Error->ee_info;
+            uint32_t Remaining = Error->ee_data - First + 1;
+
+            QuicLockAcquire(&SocketContext->ZeroCopyLock);
+            QUIC_LIST_ENTRY* Entry = SocketContext->ZeroCopySendContextHead.Flink;
+            while (Remaining > 0 && Entry != &SocketContext->ZeroCopySendContextHead) {
+                QUIC_DATAPATH_SEND_CONTEXT* SendContext =
+                    QUIC_CONTAINING_RECORD(
+                        Entry, QUIC_DATAPATH_SEND_CONTEXT, ZeroCopyLinkage);
+                Entry = Entry->Flink;
+                if (SendContext->ZeroCopyId - First <= Error->ee_data - First) {
+                    QuicListEntryRemove(&SendContext->ZeroCopyLinkage);
+                    QuicDataPathBindingFreeSendContext(SendContext);
+                    Remaining--;
+                }
+            }
+            QuicLockRelease(&SocketContext->ZeroCopyLock);
+        }
+    }
+}
+
+void
+QuicSocketContextUninitialize(
+    _In_ QUIC_SOCKET_CONTEXT* SocketContext,
+    _In_ QUIC_DATAPATH_PROC_CONTEXT* ProcContext
+    )
+{
+    epoll_ctl(ProcContext->EpollFd, EPOLL_CTL_DEL, SocketContext->SocketFd, NULL);
+
+    const eventfd_t Value = 1;
+    eventfd_write(SocketContext->CleanupFd, Value);
+}
+
+void
+QuicSocketContextUninitializeComplete(
+    _In_ QUIC_SOCKET_CONTEXT* SocketContext,
+    _In_ QUIC_DATAPATH_PROC_CONTEXT* ProcContext
+    )
+{
+    for (uint32_t i = 0; i < QUIC_MAX_BATCH_RECEIVE; ++i) {
+        QUIC_DATAPATH_RECV_BLOCK* RecvBlock = SocketContext->CurrentRecvBlocks[i];
+        if (RecvBlock != NULL) {
+            QuicPoolFree(RecvBlock->OwningPool, RecvBlock);
+        }
+    }
+
+    while (!QuicListIsEmpty(&SocketContext->PendingSendContextHead)) {
+        QuicDataPathBindingFreeSendContext(
+            QUIC_CONTAINING_RECORD(
+                QuicListRemoveHead(&SocketContext->PendingSendContextHead),
+                QUIC_DATAPATH_SEND_CONTEXT,
+                PendingSendLinkage));
+    }
+
+    epoll_ctl(ProcContext->EpollFd, EPOLL_CTL_DEL, SocketContext->SocketFd, NULL);
+    epoll_ctl(ProcContext->EpollFd, EPOLL_CTL_DEL, SocketContext->CleanupFd, NULL);
+    close(SocketContext->CleanupFd);
+
+    //
+    // No more zero-copy completions are delivered once the socket is closed,
+    // so wait a bounded time for the outstanding ones first. Completions are
+    // queued on the error queue, which poll always reports as POLLERR.
+    //
+    const uint64_t WaitStart = QuicTimeMs64();
+    QuicSocketContextReapZeroCopySends(SocketContext);
+    while (!QuicListIsEmpty(&SocketContext->ZeroCopySendContextHead)) {
+        const uint64_t WaitTime = QuicTimeDiff64(WaitStart, QuicTimeMs64());
+        if (WaitTime >= QUIC_ZEROCOPY_CLOSE_TIMEOUT_MS) {
+            break;
+        }
+        struct pollfd PollFd = { .fd = SocketContext->SocketFd, .events = 0 };
+        if (poll(&PollFd, 1, (int)(QUIC_ZEROCOPY_CLOSE_TIMEOUT_MS - WaitTime)) <= 0) {
+            break;
+        }
+        QuicSocketContextReapZeroCopySends(SocketContext);
+    }
+
+    close(SocketContext->SocketFd);
+
+    //
+    // The kernel may still reference the buffers of sends that never
+    // completed, so they are leaked instead of being returned to the pool.
+    //
+    uint32_t LeakedCount = 0;
+    while (!QuicListIsEmpty(&SocketContext->ZeroCopySendContextHead)) {
+        QuicListRemoveHead(&SocketContext->ZeroCopySendContextHead);
+        LeakedCount++;
+    }
+    if (LeakedCount > 0) {
+        QuicTraceLogWarning(
+            DatapathZeroCopySendsLeaked,
+            "[ udp][%p] Leaked %u zero-copy sends that never completed",
+            SocketContext->Binding,
+            LeakedCount);
+    }
+    QuicLockUninitialize(&SocketContext->ZeroCopyLock);
+
+    QuicRundownRelease(&SocketContext->Binding->Rundown);
+}
+
+#endif // QUIC_LINUX_IO_URING
+
+QUIC_STATUS
+QuicSocketContextPrepareReceiveMessage(
+    _In_ QUIC_SOCKET_CONTEXT* SocketContext,
+    _In_ uint32_t Index
+    )
+{
+    QUIC_DATAPATH* Datapath = SocketContext->Binding->Datapath;
+
+    if (SocketContext->CurrentRecvBlocks[Index] == NULL) {
+        QUIC_DATAPATH_RECV_BLOCK* RecvBlock =
+            QuicDataPathAllocRecvBlock(
+                Datapath,
+                QuicProcCurrentNumber());
+        if (RecvBlock == NULL) {
+            QuicTraceEvent(
+                AllocFailure,
+                "Allocation of '%s' failed. (%llu bytes)",
+                "QUIC_DATAPATH_RECV_BLOCK",
+                0);
+            return QUIC_STATUS_OUT_OF_MEMORY;
+        }
+
+        SocketContext->RecvIov[Index].iov_base =
+            QuicDataPathRecvBlockGetPayload(Datapath, RecvBlock);
+        SocketContext->CurrentRecvBlocks[Index] = RecvBlock;
+    }
+
+    //
+    // The kernel updates the name, control and flags fields on every
+    // receive, so they need to be reset even for unused blocks.
+    //
+    struct msghdr* MsgHdr = &SocketContext->RecvMsgHdr[Index].msg_hdr;
+    MsgHdr->msg_name = &SocketContext->CurrentRecvBlocks[Index]->Tuple.RemoteAddress;
+    MsgHdr->msg_namelen = sizeof(SocketContext->CurrentRecvBlocks[Index]->Tuple.RemoteAddress);
+    MsgHdr->msg_iov = &SocketContext->RecvIov[Index];
+    MsgHdr->msg_iovlen = 1;
+    MsgHdr->msg_control = SocketContext->RecvMsgControl[Index];
+    MsgHdr->msg_controllen = sizeof(SocketContext->RecvMsgControl[Index]);
+    MsgHdr->msg_flags = 0;
+    SocketContext->RecvMsgHdr[Index].msg_len = 0;
+
+    return QUIC_STATUS_SUCCESS;
 }
 
-void
-QuicSocketContextUninitialize(
+#ifdef QUIC_LINUX_IO_URING
+
+//
+// Queues a receive on the given slot. The caller must submit it.
+//
+QUIC_STATUS
+QuicSocketContextQueueReceive(
     _In_ QUIC_SOCKET_CONTEXT* SocketContext,
-    _In_ QUIC_DATAPATH_PROC_CONTEXT* ProcContext
+    _In_ QUIC_DATAPATH_PROC_CONTEXT* ProcContext,
+    _In_ uint32_t Index
     )
 {
-    epoll_ctl(ProcContext->EpollFd, EPOLL_CTL_DEL, SocketContext->SocketFd, NULL);
+    QUIC_STATUS Status =
+        QuicSocketContextPrepareReceiveMessage(SocketContext, Index);
+    if (QUIC_FAILED(Status)) {
+        return Status;
+    }
 
-    const eventfd_t Value = 1;
-    eventfd_write(SocketContext->CleanupFd, Value);
+    InterlockedIncrement(&SocketContext->IoCount);
+    QuicUringQueueSqe(
+        &ProcContext->Ring,
+        IORING_OP_RECVMSG,
+        SocketContext->SocketFd,
+        &SocketContext->RecvMsgHdr[Index].msg_hdr,
+        0,
+        &SocketContext->RecvOps[Index]);
+
+    return QUIC_STATUS_SUCCESS;
 }
 
-void
-QuicSocketContextUninitializeComplete(
+QUIC_STATUS
+QuicSocketContextStartReceive(
     _In_ QUIC_SOCKET_CONTEXT* SocketContext,
     _In_ QUIC_DATAPATH_PROC_CONTEXT* ProcContext
     )
 {
-    if (SocketContext->CurrentRecvBlock != NULL) {
-        QuicDataPathBindingReturnRecvDatagrams(&SocketContext->CurrentRecvBlock->RecvPacket);
-    }
+    //
+    // The initial reference is released once all operations are canceled on
+    // shutdown.
+    //
+    SocketContext->IoCount = 1;
 
-    while (!QuicListIsEmpty(&SocketContext->PendingSendContextHead)) {
-        QuicDataPathBindingFreeSendContext(
-            QUIC_CONTAINING_RECORD(
-                QuicListRemoveHead(&SocketContext->PendingSendContextHead),
-                QUIC_DATAPATH_SEND_CONTEXT,
-                PendingSendLinkage));
+    //
+    // Only a single receive is posted up front. More are posted as receives
+    // complete (see QUIC_URING_OP_RECV).
+    //
+    QUIC_STATUS Status =
+        QuicSocketContextQueueReceive(SocketContext, ProcContext, 0);
+    if (QUIC_FAILED(Status)) {
+        return Status;
     }
+    SocketContext->RecvSlotCount = 1;
 
-    epoll_ctl(ProcContext->EpollFd, EPOLL_CTL_DEL, SocketContext->SocketFd, NULL);
-    epoll_ctl(ProcContext->EpollFd, EPOLL_CTL_DEL, SocketContext->CleanupFd, NULL);
-    close(SocketContext->CleanupFd);
-    close(SocketContext->SocketFd);
+    if (QuicUringEnter(&ProcContext->Ring, 1, 0) < 0) {
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[ udp][%p] ERROR, %u, %s.",
+            SocketContext->Binding,
+            errno,
+            "io_uring_enter failed");
+    }
 
-    QuicRundownRelease(&SocketContext->Binding->Rundown);
+    return Status;
 }
 
+#else
+
 QUIC_STATUS
 QuicSocketContextPrepareReceive(
     _In_ QUIC_SOCKET_CONTEXT* SocketContext
     )
 {
-    if (SocketContext->CurrentRecvBlock == NULL) {
-        SocketContext->CurrentRecvBlock =
-            QuicDataPathAllocRecvBlock(
-                SocketContext->Binding->Datapath,
-                QuicProcCurrentNumber());
-        if (SocketContext->CurrentRecvBlock == NULL) {
-            QuicTraceEvent(
-                AllocFailure,
-                "Allocation of '%s' failed. (%llu bytes)",
-                "QUIC_DATAPATH_RECV_BLOCK",
-                0);
-            return QUIC_STATUS_OUT_OF_MEMORY;
+    for (uint32_t i = 0; i < SocketContext->RecvSlotCount; ++i) {
+        QUIC_STATUS Status =
+            QuicSocketContextPrepareReceiveMessage(SocketContext, i);
+        if (QUIC_FAILED(Status)) {
+            return Status;
         }
     }
 
-    SocketContext->RecvIov.iov_base = SocketContext->CurrentRecvBlock->RecvPacket.Buffer;
-    SocketContext->CurrentRecvBlock->RecvPacket.BufferLength = SocketContext->RecvIov.iov_len;
-    SocketContext->CurrentRecvBlock->RecvPacket.Tuple = &SocketContext->CurrentRecvBlock->Tuple;
-
-    QuicZeroMemory(&SocketContext->RecvMsgHdr, sizeof(SocketContext->RecvMsgHdr));
-    QuicZeroMemory(&SocketContext->RecvMsgControl, sizeof(SocketContext->RecvMsgControl));
-
-    SocketContext->RecvMsgHdr.msg_name = &SocketContext->CurrentRecvBlock->RecvPacket.Tuple->RemoteAddress;
-    SocketContext->RecvMsgHdr.msg_namelen = sizeof(SocketContext->CurrentRecvBlock->RecvPacket.Tuple->RemoteAddress);
-    SocketContext->RecvMsgHdr.msg_iov = &SocketContext->RecvIov;
-    SocketContext->RecvMsgHdr.msg_iovlen = 1;
-    SocketContext->RecvMsgHdr.msg_control = SocketContext->RecvMsgControl;
-    SocketContext->RecvMsgHdr.msg_controllen = sizeof(SocketContext->RecvMsgControl);
-    SocketContext->RecvMsgHdr.msg_flags = 0;
-
     return QUIC_STATUS_SUCCESS;
 }
 
 QUIC_STATUS
 QuicSocketContextStartReceive(
     _In_ QUIC_SOCKET_CONTEXT* SocketContext,
-    _In_ int EpollFd
+    _In_ QUIC_DATAPATH_PROC_CONTEXT* ProcContext
     )
 {
+    //
+    // Only a single receive block is allocated up front. The batch grows as
+    // receives complete (see QuicSocketContextRecvComplete).
+    //
+    SocketContext->RecvSlotCount = 1;
     QUIC_STATUS Status = QuicSocketContextPrepareReceive(SocketContext);
     if (QUIC_FAILED(Status)) {
         goto Error;
@@ -1208,7 +2485,7 @@ QuicSocketContextStartReceive(
 
     int Ret =
         epoll_ctl(
-            EpollFd,
+            ProcContext->EpollFd,
             EPOLL_CTL_ADD,
             SocketContext->SocketFd,
             &SockFdEpEvt);
@@ -1233,37 +2510,48 @@ Error:
     return Status;
 }
 
-void
-QuicSocketContextRecvComplete(
+#endif // QUIC_LINUX_IO_URING
+
+//
+// Takes the receive block of a completed receive message and appends its
+// datagrams to the chain. Returns the new tail of the chain.
+//
+QUIC_RECV_DATAGRAM**
+QuicSocketContextRecvMessage(
     _In_ QUIC_SOCKET_CONTEXT* SocketContext,
     _In_ QUIC_DATAPATH_PROC_CONTEXT* ProcContext,
-    _In_ ssize_t BytesTransferred
+    _In_ uint32_t Index,
+    _In_ QUIC_RECV_DATAGRAM** DatagramChainTail
     )
 {
-    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+    QUIC_DATAPATH* Datapath = SocketContext->Binding->Datapath;
+
+    QUIC_DATAPATH_RECV_BLOCK* RecvBlock = SocketContext->CurrentRecvBlocks[Index];
+    QUIC_DBG_ASSERT(RecvBlock != NULL);
+    SocketContext->CurrentRecvBlocks[Index] = NULL;
 
-    QUIC_DBG_ASSERT(SocketContext->CurrentRecvBlock != NULL);
-    QUIC_RECV_DATAGRAM* RecvPacket = &SocketContext->CurrentRecvBlock->RecvPacket;
-    SocketContext->CurrentRecvBlock = NULL;
+    struct msghdr* MsgHdr = &SocketContext->RecvMsgHdr[Index].msg_hdr;
+    uint32_t BytesTransferred = SocketContext->RecvMsgHdr[Index].msg_len;
+    QUIC_DBG_ASSERT(BytesTransferred <= Datapath->RecvPayloadLength);
 
     BOOLEAN FoundLocalAddr = FALSE;
     BOOLEAN FoundTOS = FALSE;
-    QUIC_ADDR* LocalAddr = &RecvPacket->Tuple->LocalAddress;
+    uint8_t TypeOfService = 0;
+    uint32_t MessageLength = BytesTransferred;
+    QUIC_ADDR* LocalAddr = &RecvBlock->Tuple.LocalAddress;
     if (LocalAddr->Ipv6.sin6_family == AF_INET6) {
         LocalAddr->Ipv6.sin6_family = QUIC_ADDRESS_FAMILY_INET6;
     }
-    QUIC_ADDR* RemoteAddr = &RecvPacket->Tuple->RemoteAddress;
+    QUIC_ADDR* RemoteAddr = &RecvBlock->Tuple.RemoteAddress;
     if (RemoteAddr->Ipv6.sin6_family == AF_INET6) {
         RemoteAddr->Ipv6.sin6_family = QUIC_ADDRESS_FAMILY_INET6;
     }
     QuicConvertFromMappedV6(RemoteAddr, RemoteAddr);
 
-    RecvPacket->TypeOfService = 0;
-
     struct cmsghdr *CMsg;
-    for (CMsg = CMSG_FIRSTHDR(&SocketContext->RecvMsgHdr);
+    for (CMsg = CMSG_FIRSTHDR(MsgHdr);
          CMsg != NULL;
-         CMsg = CMSG_NXTHDR(&SocketContext->RecvMsgHdr, CMsg)) {
+         CMsg = CMSG_NXTHDR(MsgHdr, CMsg)) {
 
         if (CMsg->cmsg_level == IPPROTO_IPV6) {
             if (CMsg->cmsg_type == IPV6_PKTINFO) {
@@ -1276,7 +2564,7 @@ QuicSocketContextRecvComplete(
                 LocalAddr->Ipv6.sin6_scope_id = PktInfo6->ipi6_ifindex;
                 FoundLocalAddr = TRUE;
             } else if (CMsg->cmsg_type == IPV6_TCLASS) {
-                RecvPacket->TypeOfService = *(uint8_t *)CMSG_DATA(CMsg);
+                TypeOfService = *(uint8_t *)CMSG_DATA(CMsg);
                 FoundTOS = TRUE;
             }
         } else if (CMsg->cmsg_level == IPPROTO_IP) {
@@ -1288,9 +2576,18 @@ QuicSocketContextRecvComplete(
                 LocalAddr->Ipv6.sin6_scope_id = PktInfo->ipi_ifindex;
                 FoundLocalAddr = TRUE;
             } else if (CMsg->cmsg_type == IP_TOS) {
-                RecvPacket->TypeOfService = *(uint8_t *)CMSG_DATA(CMsg);
+                TypeOfService = *(uint8_t *)CMSG_DATA(CMsg);
                 FoundTOS = TRUE;
             }
+        } else if (CMsg->cmsg_level == IPPROTO_UDP) {
+            if (CMsg->cmsg_type == UDP_GRO) {
+                //
+                // The payload was coalesced from multiple datagrams of
+                // this size. Only the last one may be shorter.
+                //
+                MessageLength = *(int*)CMSG_DATA(CMsg);
+                QUIC_DBG_ASSERT(MessageLength > 0);
+            }
         }
     }
 
@@ -1301,21 +2598,97 @@ QuicSocketContextRecvComplete(
         DatapathRecv,
         "[ udp][%p] Recv %u bytes (segment=%hu) Src=%!ADDR! Dst=%!ADDR!",
         SocketContext->Binding,
-        (uint32_t)BytesTransferred,
-        (uint32_t)BytesTransferred,
+        BytesTransferred,
+        MessageLength,
         CLOG_BYTEARRAY(sizeof(*LocalAddr), LocalAddr),
         CLOG_BYTEARRAY(sizeof(*RemoteAddr), RemoteAddr));
 
-    QUIC_DBG_ASSERT(BytesTransferred <= RecvPacket->BufferLength);
-    RecvPacket->BufferLength = BytesTransferred;
+    //
+    // Split the (possibly coalesced) payload into its datagrams, which all
+    // share the receive block.
+    //
+    uint8_t* RecvPayload = QuicDataPathRecvBlockGetPayload(Datapath, RecvBlock);
+    uint32_t DatagramCount = 0;
+    uint32_t Offset = 0;
+    do {
+        if (DatagramCount == Datapath->RecvDatagramCount) {
+            QuicTraceLogWarning(
+                DatapathUroPreallocExceeded,
+                "[ udp][%p] Exceeded URO preallocation capacity.",
+                SocketContext->Binding);
+            break;
+        }
+
+        QUIC_RECV_DATAGRAM* Datagram =
+            QuicDataPathRecvBlockGetDatagram(Datapath, RecvBlock, DatagramCount++);
+        QuicDataPathDatagramToInternalDatagramContext(Datagram)->RecvBlock = RecvBlock;
+
+        Datagram->Next = NULL;
+        Datagram->Buffer = RecvPayload + Offset;
+        Datagram->BufferLength =
+            (uint16_t)min(MessageLength, BytesTransferred - Offset);
+        Datagram->Tuple = &RecvBlock->Tuple;
+        Datagram->PartitionIndex = ProcContext->Index;
+        Datagram->TypeOfService = TypeOfService;
+        Datagram->Allocated = TRUE;
+        Datagram->QueuedOnConnection = FALSE;
+
+        *DatagramChainTail = Datagram;
+        DatagramChainTail = &Datagram->Next;
+
+        Offset += MessageLength;
+    } while (Offset < BytesTransferred);
+
+    RecvBlock->ReferenceCount = DatagramCount;
+
+    return DatagramChainTail;
+}
+
+#ifndef QUIC_LINUX_IO_URING
+
+void
+QuicSocketContextRecvComplete(
+    _In_ QUIC_SOCKET_CONTEXT* SocketContext,
+    _In_ QUIC_DATAPATH_PROC_CONTEXT* ProcContext,
+    _In_ int MessagesReceived
+    )
+{
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+    QUIC_RECV_DATAGRAM* DatagramChain = NULL;
+    QUIC_RECV_DATAGRAM** DatagramChainTail = &DatagramChain;
+
+    QUIC_DBG_ASSERT(
+        MessagesReceived > 0 &&
+        MessagesReceived <= SocketContext->RecvSlotCount);
 
-    RecvPacket->PartitionIndex = ProcContext->Index;
+    for (int i = 0; i < MessagesReceived; ++i) {
+        DatagramChainTail =
+            QuicSocketContextRecvMessage(
+                SocketContext,
+                ProcContext,
+                i,
+                DatagramChainTail);
+    }
 
+    //
+    // Indicate the whole batch to the upper layer as a single chain.
+    //
     QUIC_DBG_ASSERT(SocketContext->Binding->Datapath->RecvHandler);
     SocketContext->Binding->Datapath->RecvHandler(
         SocketContext->Binding,
         SocketContext->Binding->ClientContext,
-        RecvPacket);
+        DatagramChain);
+
+    //
+    // A full batch means more datagrams are likely queued, so double the
+    // batch, up to the max batch size.
+    //
+    if (MessagesReceived == SocketContext->RecvSlotCount) {
+        SocketContext->RecvSlotCount =
+            (uint8_t)min(
+                2 * SocketContext->RecvSlotCount,
+                SocketContext->Binding->Datapath->MaxRecvBatchSize);
+    }
 
     Status = QuicSocketContextPrepareReceive(SocketContext);
 
@@ -1484,6 +2857,10 @@ QuicSocketContextProcessEvents(
     QUIC_DBG_ASSERT(EventType == QUIC_SOCK_EVENT_SOCKET);
 
     if (EPOLLERR & Events) {
+        if (SocketContext->Binding->Datapath->Features & QUIC_DATAPATH_FEATURE_SEND_ZEROCOPY) {
+            QuicSocketContextReapZeroCopySends(SocketContext);
+        }
+
         int ErrNum = 0;
         socklen_t OptLen = sizeof(ErrNum);
         ssize_t Ret =
@@ -1500,7 +2877,7 @@ QuicSocketContextProcessEvents(
                 SocketContext->Binding,
                 errno,
                 "getsockopt(SO_ERROR) failed");
-        } else {
+        } else if (ErrNum != 0) {
             QuicTraceEvent(
                 DatapathErrorStatus,
                 "[ udp][%p] ERROR, %u, %s.",
@@ -1525,21 +2902,21 @@ QuicSocketContextProcessEvents(
 
     if (EPOLLIN & Events) {
         while (TRUE) {
-            QUIC_DBG_ASSERT(SocketContext->CurrentRecvBlock != NULL);
-
-            ssize_t Ret =
-                recvmsg(
+            int Ret =
+                recvmmsg(
                     SocketContext->SocketFd,
-                    &SocketContext->RecvMsgHdr,
-                    0);
-            if (Ret < 0) {
-                if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                    SocketContext->RecvMsgHdr,
+                    SocketContext->RecvSlotCount,
+                    0,
+                    NULL);
+            if (Ret <= 0) {
+                if (Ret < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
                     QuicTraceEvent(
                         DatapathErrorStatus,
                         "[ udp][%p] ERROR, %u, %s.",
                         SocketContext->Binding,
                         errno,
-                        "recvmsg failed");
+                        "recvmmsg failed");
                 }
                 break;
             }
@@ -1552,6 +2929,8 @@ QuicSocketContextProcessEvents(
     }
 }
 
+#endif // QUIC_LINUX_IO_URING
+
 //
 // Datapath binding interface.
 //
@@ -1562,6 +2941,7 @@ QuicDataPathBindingCreate(
     _In_opt_ const QUIC_ADDR* LocalAddress,
     _In_opt_ const QUIC_ADDR* RemoteAddress,
     _In_opt_ void* RecvCallbackContext,
+    _In_ uint32_t Flags,
     _Out_ QUIC_DATAPATH_BINDING** NewBinding
     )
 {
@@ -1572,6 +2952,7 @@ QuicDataPathBindingCreate(
             LocalAddress,
             RemoteAddress,
             RecvCallbackContext,
+            Flags,
             NewBinding);
 #else
     QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
@@ -1604,6 +2985,10 @@ QuicDataPathBindingCreate(
     Binding->Datapath = Datapath;
     Binding->ClientContext = RecvCallbackContext;
     Binding->Mtu = QUIC_MAX_MTU;
+    Binding->ReusePortGroup =
+        RemoteAddress == NULL &&
+        (Flags & QUIC_DATAPATH_BINDING_FLAG_CID_STEERING) &&
+        (Datapath->Features & QUIC_DATAPATH_FEATURE_CID_STEERING);
     QuicRundownInitialize(&Binding->Rundown);
     if (LocalAddress) {
         QuicConvertToMappedV6(LocalAddress, &Binding->LocalAddress);
@@ -1613,9 +2998,15 @@ QuicDataPathBindingCreate(
     for (uint32_t i = 0; i < SocketCount; i++) {
         Binding->SocketContexts[i].Binding = Binding;
         Binding->SocketContexts[i].SocketFd = INVALID_SOCKET_FD;
-        Binding->SocketContexts[i].RecvIov.iov_len =
-            Binding->Mtu - QUIC_MIN_IPV4_HEADER_SIZE - QUIC_UDP_HEADER_SIZE;
+        for (uint32_t j = 0; j < QUIC_MAX_BATCH_RECEIVE; j++) {
+            Binding->SocketContexts[i].RecvIov[j].iov_len =
+                Datapath->RecvPayloadLength;
+        }
+#ifndef QUIC_LINUX_IO_URING
         QuicListInitializeHead(&Binding->SocketContexts[i].PendingSendContextHead);
+        QuicListInitializeHead(&Binding->SocketContexts[i].ZeroCopySendContextHead);
+        QuicLockInitialize(&Binding->SocketContexts[i].ZeroCopyLock);
+#endif
         QuicRundownAcquire(&Binding->Rundown);
     }
 
@@ -1652,7 +3043,7 @@ QuicDataPathBindingCreate(
         Status =
             QuicSocketContextStartReceive(
                 &Binding->SocketContexts[i],
-                Datapath->ProcContexts[i].EpollFd);
+                &Datapath->ProcContexts[i]);
         if (QUIC_FAILED(Status)) {
             goto Exit;
         }
@@ -1744,6 +3135,89 @@ QuicDataPathBindingGetRemoteAddress(
 #endif
 }
 
+#ifndef QUIC_PLATFORM_DISPATCH_TABLE
+
+//
+// Attaches a classic BPF program to the binding's SO_REUSEPORT group which
+// returns the group index of the socket to deliver each datagram to. For short
+// header packets, this is the partition index from the destination connection
+// ID. For everything else, an out of range index makes the kernel fall back
+// to its default 4-tuple hash.
+//
+// The kernel indexes a group by the order its sockets bound. The binding's
+// sockets bind in processor order, so the group index is the processor index,
+// but only if every one of them joined the group. Otherwise the binding is
+// left unsteered.
+//
+QUIC_STATUS
+QuicDataPathBindingAttachCidSteering(
+    _In_ QUIC_DATAPATH_BINDING* Binding,
+    _In_ const QUIC_DATAPATH_CID_STEERING* Steering
+    )
+{
+    if (Steering->PartitionCount == 0 ||
+        Steering->PartitionCount > Binding->Datapath->ProcCount) {
+        return QUIC_STATUS_INVALID_PARAMETER;
+    }
+
+    //
+    // The destination connection ID directly follows the first byte of a
+    // short header. The partition ID is in host byte order, while BPF loads
+    // are in network byte order, so load it a byte at a time.
+    //
+    const uint32_t PartitionIdOffset = 1 + Steering->PartitionIdOffset;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    const uint32_t HighByteOffset = PartitionIdOffset + 1;
+    const uint32_t LowByteOffset = PartitionIdOffset;
+#else
+    const uint32_t HighByteOffset = PartitionIdOffset;
+    const uint32_t LowByteOffset = PartitionIdOffset + 1;
+#endif
+
+    struct sock_filter Code[] = {
+        BPF_STMT(BPF_LD | BPF_W | BPF_LEN, 0),
+        BPF_JUMP(BPF_JMP | BPF_JGE | BPF_K, PartitionIdOffset + 2, 0, 10),
+        BPF_STMT(BPF_LD | BPF_B | BPF_ABS, 0),
+        BPF_JUMP(BPF_JMP | BPF_JSET | BPF_K, 0x80, 8, 0), // Long header
+        BPF_STMT(BPF_LD | BPF_B | BPF_ABS, HighByteOffset),
+        BPF_STMT(BPF_ALU | BPF_LSH | BPF_K, 8),
+        BPF_STMT(BPF_MISC | BPF_TAX, 0),
+        BPF_STMT(BPF_LD | BPF_B | BPF_ABS, LowByteOffset),
+        BPF_STMT(BPF_ALU | BPF_OR | BPF_X, 0),
+        BPF_STMT(BPF_ALU | BPF_AND | BPF_K, Steering->PartitionMask),
+        BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, Steering->PartitionCount),
+        BPF_STMT(BPF_RET | BPF_A, 0),
+        BPF_STMT(BPF_RET | BPF_K, UINT32_MAX) // Fall back to the 4-tuple hash
+    };
+    struct sock_fprog Program = { ARRAYSIZE(Code), Code };
+
+    //
+    // The program applies to the whole group, so attaching it to any one
+    // socket is enough.
+    //
+    int Result =
+        setsockopt(
+            Binding->SocketContexts[0].SocketFd,
+            SOL_SOCKET,
+            SO_ATTACH_REUSEPORT_CBPF,
+            (const void*)&Program,
+            sizeof(Program));
+    if (Result == SOCKET_ERROR) {
+        QUIC_STATUS Status = errno;
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[ udp][%p] ERROR, %u, %s.",
+            Binding,
+            Status,
+            "setsockopt(SO_ATTACH_REUSEPORT_CBPF) failed");
+        return Status;
+    }
+
+    return QUIC_STATUS_SUCCESS;
+}
+
+#endif // QUIC_PLATFORM_DISPATCH_TABLE
+
 QUIC_STATUS
 QuicDataPathBindingSetParam(
     _In_ QUIC_DATAPATH_BINDING* Binding,
@@ -1760,11 +3234,23 @@ QuicDataPathBindingSetParam(
             BufferLength,
             Buffer);
 #else
-    UNREFERENCED_PARAMETER(Binding);
-    UNREFERENCED_PARAMETER(Param);
-    UNREFERENCED_PARAMETER(BufferLength);
-    UNREFERENCED_PARAMETER(Buffer);
-    return QUIC_STATUS_NOT_SUPPORTED;
+    switch (Param) {
+
+    case QUIC_DATAPATH_BINDING_PARAM_CID_STEERING:
+        if (BufferLength != sizeof(QUIC_DATAPATH_CID_STEERING) || Buffer == NULL) {
+            return QUIC_STATUS_INVALID_PARAMETER;
+        }
+        if (!Binding->ReusePortGroup) {
+            return QUIC_STATUS_NOT_SUPPORTED;
+        }
+        return
+            QuicDataPathBindingAttachCidSteering(
+                Binding,
+                (const QUIC_DATAPATH_CID_STEERING*)Buffer);
+
+    default:
+        return QUIC_STATUS_NOT_SUPPORTED;
+    }
 #endif
 }
 
@@ -1800,11 +3286,11 @@ QuicDataPathRecvPacketToRecvDatagram(
 #ifdef QUIC_PLATFORM_DISPATCH_TABLE
     return PlatDispatch->DatapathRecvContextToRecvPacket(Packet);
 #else
-    QUIC_DATAPATH_RECV_BLOCK* RecvBlock =
-        (QUIC_DATAPATH_RECV_BLOCK*)
-            ((char *)Packet - sizeof(QUIC_DATAPATH_RECV_BLOCK));
-
-    return &RecvBlock->RecvPacket;
+    return
+        (QUIC_RECV_DATAGRAM*)
+            ((uint8_t*)Packet -
+                sizeof(QUIC_DATAPATH_RECV_BUFFER_CONTEXT) -
+                sizeof(QUIC_RECV_DATAGRAM));
 #endif
 }
 
@@ -1816,10 +3302,11 @@ QuicDataPathRecvDatagramToRecvPacket(
 #ifdef QUIC_PLATFORM_DISPATCH_TABLE
     return PlatDispatch->DatapathRecvPacketToRecvContext(Datagram);
 #else
-    QUIC_DATAPATH_RECV_BLOCK* RecvBlock =
-        QUIC_CONTAINING_RECORD(Datagram, QUIC_DATAPATH_RECV_BLOCK, RecvPacket);
-
-    return (QUIC_RECV_PACKET*)(RecvBlock + 1);
+    return
+        (QUIC_RECV_PACKET*)
+            ((uint8_t*)Datagram +
+                sizeof(QUIC_RECV_DATAGRAM) +
+                sizeof(QUIC_DATAPATH_RECV_BUFFER_CONTEXT));
 #endif
 }
 
@@ -1834,11 +3321,40 @@ QuicDataPathBindingReturnRecvDatagrams(
     }
 #else
     QUIC_RECV_DATAGRAM* Datagram;
+
+    int64_t BatchedBufferCount = 0;
+    QUIC_DATAPATH_RECV_BLOCK* BatchedRecvBlock = NULL;
+
+    //
+    // Datagrams split from the same receive are usually adjacent in the chain,
+    // so batch up the reference releases for each receive block.
+    //
     while ((Datagram = DatagramChain) != NULL) {
         DatagramChain = DatagramChain->Next;
+
         QUIC_DATAPATH_RECV_BLOCK* RecvBlock =
-            QUIC_CONTAINING_RECORD(Datagram, QUIC_DATAPATH_RECV_BLOCK, RecvPacket);
-        QuicPoolFree(RecvBlock->OwningPool, RecvBlock);
+            QuicDataPathDatagramToInternalDatagramContext(Datagram)->RecvBlock;
+
+        if (BatchedRecvBlock == RecvBlock) {
+            BatchedBufferCount++;
+        } else {
+            if (BatchedRecvBlock != NULL &&
+                InterlockedExchangeAdd64(
+                    &BatchedRecvBlock->ReferenceCount,
+                    -BatchedBufferCount) == BatchedBufferCount) {
+                QuicPoolFree(BatchedRecvBlock->OwningPool, BatchedRecvBlock);
+            }
+
+            BatchedRecvBlock = RecvBlock;
+            BatchedBufferCount = 1;
+        }
+    }
+
+    if (BatchedRecvBlock != NULL &&
+        InterlockedExchangeAdd64(
+            &BatchedRecvBlock->ReferenceCount,
+            -BatchedBufferCount) == BatchedBufferCount) {
+        QuicPoolFree(BatchedRecvBlock->OwningPool, BatchedRecvBlock);
     }
 #endif
 }
@@ -1856,7 +3372,6 @@ QuicDataPathBindingAllocSendContext(
             Binding,
             MaxPacketSize);
 #else
-    UNREFERENCED_PARAMETER(MaxPacketSize);
     QUIC_DBG_ASSERT(Binding != NULL);
 
     QUIC_DATAPATH_PROC_CONTEXT* ProcContext =
@@ -1867,40 +3382,209 @@ QuicDataPathBindingAllocSendContext(
         QuicTraceEvent(
             AllocFailure,
             "Allocation of '%s' failed. (%llu bytes)",
-            "QUIC_DATAPATH_SEND_CONTEXT",
+            "QUIC_DATAPATH_SEND_CONTEXT",
+            0);
+        goto Exit;
+    }
+
+    SendContext->Owner = ProcContext;
+    SendContext->ECN = ECN;
+    SendContext->SegmentSize =
+        (QuicDataPathGetSupportedFeatures(Binding->Datapath) &
+            QUIC_DATAPATH_FEATURE_SEND_SEGMENTATION) ? MaxPacketSize : 0;
+
+Exit:
+
+    return SendContext;
+#endif
+}
+
+void
+QuicDataPathBindingFreeSendContext(
+    _In_ QUIC_DATAPATH_SEND_CONTEXT* SendContext
+    )
+{
+#ifdef QUIC_PLATFORM_DISPATCH_TABLE
+    PlatDispatch->DatapathBindingFreeSendContext(SendContext);
+#else
+    QUIC_POOL* BufferPool =
+        SendContext->SegmentSize > 0 ?
+            &SendContext->Owner->LargeSendBufferPool :
+            &SendContext->Owner->SendBufferPool;
+
+    size_t i = 0;
+    for (i = 0; i < SendContext->BufferCount; ++i) {
+        QuicPoolFree(BufferPool, SendContext->Buffers[i].Buffer);
+        SendContext->Buffers[i].Buffer = NULL;
+    }
+
+    QuicPoolFree(&SendContext->Owner->SendContextPool, SendContext);
+#endif
+}
+
+#ifndef QUIC_PLATFORM_DISPATCH_TABLE
+static
+BOOLEAN
+QuicSendContextCanAllocSendSegment(
+    _In_ QUIC_DATAPATH_SEND_CONTEXT* SendContext,
+    _In_ uint16_t MaxBufferLength
+    )
+{
+    QUIC_DBG_ASSERT(SendContext->SegmentSize > 0);
+    QUIC_DBG_ASSERT(SendContext->BufferCount > 0);
+    QUIC_DBG_ASSERT(SendContext->BufferCount <= SendContext->Owner->Datapath->MaxSendBatchSize);
+
+    if (SendContext->ClientBuffer.Buffer == NULL ||
+        (SendContext->ClientBuffer.Length != 0 &&
+         SendContext->ClientBuffer.Length < SendContext->SegmentSize)) {
+        //
+        // A short (final) segment has been written to the backing buffer, so
+        // no more segments can be appended to it.
+        //
+        return FALSE;
+    }
+
+    uint32_t BytesUsed =
+        SendContext->Buffers[SendContext->BufferCount - 1].Length +
+        SendContext->ClientBuffer.Length;
+
+    return
+        BytesUsed / SendContext->SegmentSize < QUIC_MAX_SEND_SEGMENT_COUNT &&
+        MaxBufferLength <= QUIC_LARGE_SEND_BUFFER_SIZE - BytesUsed;
+}
+
+static
+BOOLEAN
+QuicSendContextCanAllocSend(
+    _In_ QUIC_DATAPATH_SEND_CONTEXT* SendContext,
+    _In_ uint16_t MaxBufferLength
+    )
+{
+    return
+        (SendContext->BufferCount < SendContext->Owner->Datapath->MaxSendBatchSize) ||
+        ((SendContext->SegmentSize > 0) &&
+            QuicSendContextCanAllocSendSegment(SendContext, MaxBufferLength));
+}
+
+static
+void
+QuicSendContextFinalizeSendBuffer(
+    _In_ QUIC_DATAPATH_SEND_CONTEXT* SendContext,
+    _In_ BOOLEAN IsSendingImmediately
+    )
+{
+    if (SendContext->ClientBuffer.Length == 0) {
+        //
+        // There is no buffer segment outstanding at the client.
+        //
+        return;
+    }
+
+    QUIC_DBG_ASSERT(SendContext->SegmentSize > 0 && SendContext->BufferCount > 0);
+    QUIC_DBG_ASSERT(SendContext->ClientBuffer.Length <= SendContext->SegmentSize);
+
+    //
+    // Append the client's buffer segment to our internal send buffer.
+    //
+    SendContext->Buffers[SendContext->BufferCount - 1].Length +=
+        SendContext->ClientBuffer.Length;
+
+    if (SendContext->ClientBuffer.Length == SendContext->SegmentSize) {
+        SendContext->ClientBuffer.Buffer += SendContext->SegmentSize;
+        SendContext->ClientBuffer.Length = 0;
+    } else {
+        //
+        // A short segment must be the last one in the send.
+        //
+        QUIC_DBG_ASSERT(IsSendingImmediately);
+        UNREFERENCED_PARAMETER(IsSendingImmediately);
+        SendContext->ClientBuffer.Buffer = NULL;
+        SendContext->ClientBuffer.Length = 0;
+    }
+}
+
+_Success_(return != NULL)
+static
+QUIC_BUFFER*
+QuicSendContextAllocBuffer(
+    _In_ QUIC_DATAPATH_SEND_CONTEXT* SendContext,
+    _In_ QUIC_POOL* BufferPool
+    )
+{
+    QUIC_DBG_ASSERT(SendContext->BufferCount < SendContext->Owner->Datapath->MaxSendBatchSize);
+
+    QUIC_BUFFER* Buffer = &SendContext->Buffers[SendContext->BufferCount];
+    QuicZeroMemory(Buffer, sizeof(*Buffer));
+
+    Buffer->Buffer = QuicPoolAlloc(BufferPool);
+    if (Buffer->Buffer == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "Send Buffer",
             0);
-        goto Exit;
+        return NULL;
     }
+    ++SendContext->BufferCount;
 
-    QuicZeroMemory(SendContext, sizeof(*SendContext));
-    SendContext->Owner = ProcContext;
-    SendContext->ECN = ECN;
-
-Exit:
+    return Buffer;
+}
 
-    return SendContext;
-#endif
+_Success_(return != NULL)
+static
+QUIC_BUFFER*
+QuicSendContextAllocPacketBuffer(
+    _In_ QUIC_DATAPATH_SEND_CONTEXT* SendContext,
+    _In_ uint16_t MaxBufferLength
+    )
+{
+    QUIC_BUFFER* Buffer =
+        QuicSendContextAllocBuffer(SendContext, &SendContext->Owner->SendBufferPool);
+    if (Buffer != NULL) {
+        Buffer->Length = MaxBufferLength;
+    }
+    return Buffer;
 }
 
-void
-QuicDataPathBindingFreeSendContext(
-    _In_ QUIC_DATAPATH_SEND_CONTEXT* SendContext
+_Success_(return != NULL)
+static
+QUIC_BUFFER*
+QuicSendContextAllocSegmentBuffer(
+    _In_ QUIC_DATAPATH_SEND_CONTEXT* SendContext,
+    _In_ uint16_t MaxBufferLength
     )
 {
-#ifdef QUIC_PLATFORM_DISPATCH_TABLE
-    PlatDispatch->DatapathBindingFreeSendContext(SendContext);
-#else
-    size_t i = 0;
-    for (i = 0; i < SendContext->BufferCount; ++i) {
-        QuicPoolFree(
-            &SendContext->Owner->SendBufferPool,
-            SendContext->Buffers[i].Buffer);
-        SendContext->Buffers[i].Buffer = NULL;
+    QUIC_DBG_ASSERT(SendContext->SegmentSize > 0);
+    QUIC_DBG_ASSERT(MaxBufferLength <= SendContext->SegmentSize);
+
+    if (SendContext->ClientBuffer.Buffer != NULL &&
+        QuicSendContextCanAllocSendSegment(SendContext, MaxBufferLength)) {
+
+        //
+        // All clear to return the next segment of our contiguous buffer.
+        //
+        SendContext->ClientBuffer.Length = MaxBufferLength;
+        return &SendContext->ClientBuffer;
     }
 
-    QuicPoolFree(&SendContext->Owner->SendContextPool, SendContext);
-#endif
+    QUIC_BUFFER* Buffer =
+        QuicSendContextAllocBuffer(SendContext, &SendContext->Owner->LargeSendBufferPool);
+    if (Buffer == NULL) {
+        return NULL;
+    }
+
+    //
+    // Provide a virtual QUIC_BUFFER to the client. Once the client has
+    // committed to a final send size, we'll append it to our internal backing
+    // buffer.
+    //
+    Buffer->Length = 0;
+    SendContext->ClientBuffer.Buffer = Buffer->Buffer;
+    SendContext->ClientBuffer.Length = MaxBufferLength;
+
+    return &SendContext->ClientBuffer;
 }
+#endif
 
 QUIC_BUFFER*
 QuicDataPathBindingAllocSendDatagram(
@@ -1914,44 +3598,25 @@ QuicDataPathBindingAllocSendDatagram(
             SendContext,
             MaxBufferLength);
 #else
-    QUIC_BUFFER* Buffer = NULL;
-
     QUIC_DBG_ASSERT(SendContext != NULL);
+    QUIC_DBG_ASSERT(MaxBufferLength > 0);
     QUIC_DBG_ASSERT(MaxBufferLength <= QUIC_MAX_MTU - QUIC_MIN_IPV4_HEADER_SIZE - QUIC_UDP_HEADER_SIZE);
 
-    if (SendContext->BufferCount ==
-            SendContext->Owner->Datapath->MaxSendBatchSize) {
+    QuicSendContextFinalizeSendBuffer(SendContext, FALSE);
+
+    if (!QuicSendContextCanAllocSend(SendContext, MaxBufferLength)) {
         QuicTraceEvent(
             LibraryError,
             "[ lib] ERROR, %s.",
             "Max batch size limit hit");
-        goto Exit;
+        return NULL;
     }
 
-    Buffer = &SendContext->Buffers[SendContext->BufferCount];
-    QuicZeroMemory(Buffer, sizeof(*Buffer));
-
-    Buffer->Buffer = QuicPoolAlloc(&SendContext->Owner->SendBufferPool);
-    if (Buffer->Buffer == NULL) {
-        QuicTraceEvent(
-            AllocFailure,
-            "Allocation of '%s' failed. (%llu bytes)",
-            "Send Buffer",
-            0);
-        Buffer = NULL;
-        goto Exit;
+    if (SendContext->SegmentSize == 0) {
+        return QuicSendContextAllocPacketBuffer(SendContext, MaxBufferLength);
+    } else {
+        return QuicSendContextAllocSegmentBuffer(SendContext, MaxBufferLength);
     }
-
-    Buffer->Length = MaxBufferLength;
-
-    SendContext->Iovs[SendContext->BufferCount].iov_base = Buffer->Buffer;
-    SendContext->Iovs[SendContext->BufferCount].iov_len = Buffer->Length;
-
-    ++SendContext->BufferCount;
-
-Exit:
-
-    return Buffer;
 #endif
 }
 
@@ -1964,15 +3629,67 @@ QuicDataPathBindingFreeSendDatagram(
 #ifdef QUIC_PLATFORM_DISPATCH_TABLE
     PlatDispatch->DatapathBindingFreeSendBuffer(SendContext, Datagram);
 #else
-    QuicPoolFree(&SendContext->Owner->SendBufferPool, Datagram->Buffer);
-    Datagram->Buffer = NULL;
+    //
+    // This must be the final send buffer; intermediate buffers cannot be freed.
+    //
+    QUIC_DATAPATH_PROC_CONTEXT* ProcContext = SendContext->Owner;
+    uint8_t* TailBuffer = SendContext->Buffers[SendContext->BufferCount - 1].Buffer;
+
+    if (SendContext->SegmentSize == 0) {
+        QUIC_DBG_ASSERT(Datagram->Buffer == TailBuffer);
 
-    QUIC_DBG_ASSERT(Datagram == &SendContext->Buffers[SendContext->BufferCount - 1]);
+        QuicPoolFree(&ProcContext->SendBufferPool, Datagram->Buffer);
+        Datagram->Buffer = NULL;
+        --SendContext->BufferCount;
+    } else {
+        TailBuffer += SendContext->Buffers[SendContext->BufferCount - 1].Length;
+        QUIC_DBG_ASSERT(Datagram->Buffer == TailBuffer);
+
+        if (SendContext->Buffers[SendContext->BufferCount - 1].Length == 0) {
+            QuicPoolFree(&ProcContext->LargeSendBufferPool, Datagram->Buffer);
+            --SendContext->BufferCount;
+        }
 
-    --SendContext->BufferCount;
+        SendContext->ClientBuffer.Buffer = NULL;
+        SendContext->ClientBuffer.Length = 0;
+    }
 #endif
 }
 
+void
+QuicSocketContextSendFailed(
+    _In_ QUIC_SOCKET_CONTEXT* SocketContext,
+    _In_ QUIC_DATAPATH_SEND_CONTEXT* SendContext,
+    _In_ int Error
+    )
+{
+    QuicTraceEvent(
+        DatapathErrorStatus,
+        "[ udp][%p] ERROR, %u, %s.",
+        SocketContext->Binding,
+        Error,
+        "sendmsg failed");
+
+    if (Error == EIO && SendContext->SegmentSize > 0) {
+        //
+        // The kernel fails segmented sends with EIO when the outgoing
+        // device can't checksum them. Stop using segmentation for
+        // future sends; the data in this one will be recovered by the
+        // normal loss detection logic. Sends on several processors can fail
+        // at once, so only the first one to disable segmentation logs it.
+        //
+        if (InterlockedCompareExchange(
+                &SocketContext->Binding->Datapath->SendSegmentationDisabled,
+                TRUE,
+                FALSE) == FALSE) {
+            QuicTraceLogWarning(
+                DatapathSendSegmentationDisabled,
+                "[ udp][%p] UDP send segmentation disabled after EIO",
+                SocketContext->Binding);
+        }
+    }
+}
+
 QUIC_STATUS
 QuicDataPathBindingSend(
     _In_ QUIC_DATAPATH_BINDING* Binding,
@@ -1992,18 +3709,38 @@ QuicDataPathBindingSend(
     QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
     QUIC_SOCKET_CONTEXT* SocketContext = NULL;
     QUIC_DATAPATH_PROC_CONTEXT* ProcContext = NULL;
-    ssize_t SentByteCount = 0;
-    QUIC_ADDR MappedRemoteAddress = {0};
     struct cmsghdr *CMsg = NULL;
     struct in_pktinfo *PktInfo = NULL;
     struct in6_pktinfo *PktInfo6 = NULL;
     BOOLEAN SendPending = FALSE;
 
     static_assert(CMSG_SPACE(sizeof(struct in6_pktinfo)) >= CMSG_SPACE(sizeof(struct in_pktinfo)), "sizeof(struct in6_pktinfo) >= sizeof(struct in_pktinfo) failed");
-    char ControlBuffer[CMSG_SPACE(sizeof(struct in6_pktinfo)) + CMSG_SPACE(sizeof(int))] = {0};
+#ifdef QUIC_LINUX_IO_URING
+    //
+    // The message is only consumed when the send completes, so it is kept in
+    // the send context.
+    //
+    QUIC_ADDR* MappedRemoteAddress = &SendContext->MappedRemoteAddress;
+    char* ControlBuffer = SendContext->ControlBuffer;
+    struct msghdr* Mhdr = &SendContext->Mhdr;
+#else
+    ssize_t SentByteCount = 0;
+    QUIC_ADDR MappedRemoteAddressStorage;
+    QUIC_ADDR* MappedRemoteAddress = &MappedRemoteAddressStorage;
+    char ControlBuffer[QUIC_SEND_CONTROL_BUFFER_SIZE];
+    struct msghdr MhdrStorage;
+    struct msghdr* Mhdr = &MhdrStorage;
+#endif
 
     QUIC_DBG_ASSERT(Binding != NULL && RemoteAddress != NULL && SendContext != NULL);
 
+    QuicSendContextFinalizeSendBuffer(SendContext, TRUE);
+
+    if (SendContext->BufferCount == 0) {
+        Status = QUIC_STATUS_INVALID_PARAMETER;
+        goto Exit;
+    }
+
     SocketContext = &Binding->SocketContexts[QuicProcCurrentNumber()];
     ProcContext = &Binding->Datapath->ProcContexts[QuicProcCurrentNumber()];
 
@@ -2020,38 +3757,38 @@ QuicDataPathBindingSend(
         Binding,
         TotalSize,
         SendContext->BufferCount,
-        SendContext->Buffers[0].Length,
+        SendContext->SegmentSize,
         CLOG_BYTEARRAY(sizeof(*RemoteAddress), RemoteAddress),
         CLOG_BYTEARRAY(sizeof(*LocalAddress), LocalAddress));
 
     //
     // Map V4 address to dual-stack socket format.
     //
-    QuicConvertToMappedV6(RemoteAddress, &MappedRemoteAddress);
+    QuicZeroMemory(MappedRemoteAddress, sizeof(*MappedRemoteAddress));
+    QuicConvertToMappedV6(RemoteAddress, MappedRemoteAddress);
 
-    if (MappedRemoteAddress.Ipv6.sin6_family == QUIC_ADDRESS_FAMILY_INET6) {
-        MappedRemoteAddress.Ipv6.sin6_family = AF_INET6;
+    if (MappedRemoteAddress->Ipv6.sin6_family == QUIC_ADDRESS_FAMILY_INET6) {
+        MappedRemoteAddress->Ipv6.sin6_family = AF_INET6;
     }
 
-    struct msghdr Mhdr = {
-        .msg_name = &MappedRemoteAddress,
-        .msg_namelen = sizeof(MappedRemoteAddress),
-        .msg_iov = SendContext->Iovs,
-        .msg_iovlen = SendContext->BufferCount,
-        .msg_control = ControlBuffer,
-        .msg_controllen = CMSG_SPACE(sizeof(int)),
-        .msg_flags = 0
-    };
+    QuicZeroMemory(ControlBuffer, QUIC_SEND_CONTROL_BUFFER_SIZE);
+    Mhdr->msg_name = MappedRemoteAddress;
+    Mhdr->msg_namelen = sizeof(*MappedRemoteAddress);
+    Mhdr->msg_iov = SendContext->Iovs;
+    Mhdr->msg_iovlen = SendContext->BufferCount;
+    Mhdr->msg_control = ControlBuffer;
+    Mhdr->msg_controllen = CMSG_SPACE(sizeof(int));
+    Mhdr->msg_flags = 0;
 
-    CMsg = CMSG_FIRSTHDR(&Mhdr);
+    CMsg = CMSG_FIRSTHDR(Mhdr);
     CMsg->cmsg_level = RemoteAddress->Ip.sa_family == QUIC_ADDRESS_FAMILY_INET ? IPPROTO_IP : IPPROTO_IPV6;
     CMsg->cmsg_type = RemoteAddress->Ip.sa_family == QUIC_ADDRESS_FAMILY_INET ? IP_TOS : IPV6_TCLASS;
     CMsg->cmsg_len = CMSG_LEN(sizeof(int));
     *(int *)CMSG_DATA(CMsg) = SendContext->ECN;
 
     if (!Binding->Connected) {
-        Mhdr.msg_controllen += CMSG_SPACE(sizeof(struct in6_pktinfo));
-        CMsg = CMSG_NXTHDR(&Mhdr, CMsg);
+        Mhdr->msg_controllen += CMSG_SPACE(sizeof(struct in6_pktinfo));
+        CMsg = CMSG_NXTHDR(Mhdr, CMsg);
         QUIC_DBG_ASSERT(LocalAddress != NULL);
         QUIC_DBG_ASSERT(CMsg != NULL);
         if (RemoteAddress->Ip.sa_family == QUIC_ADDRESS_FAMILY_INET) {
@@ -2072,7 +3809,91 @@ QuicDataPathBindingSend(
         }
     }
 
-    SentByteCount = sendmsg(SocketContext->SocketFd, &Mhdr, 0);
+    if (SendContext->SegmentSize > 0 && TotalSize > SendContext->SegmentSize) {
+        //
+        // Let the kernel split the buffer into SegmentSize sized datagrams.
+        //
+        Mhdr->msg_controllen += CMSG_SPACE(sizeof(uint16_t));
+        CMsg = CMSG_NXTHDR(Mhdr, CMsg);
+        QUIC_DBG_ASSERT(CMsg != NULL);
+        CMsg->cmsg_level = SOL_UDP;
+        CMsg->cmsg_type = UDP_SEGMENT;
+        CMsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+        *(uint16_t*)CMSG_DATA(CMsg) = SendContext->SegmentSize;
+    }
+
+    if (SendContext->DepartureTime != 0 && SocketContext->TxTimeEnabled) {
+        //
+        // Have the kernel (fq qdisc) hold the datagrams until their earliest
+        // departure time, in nanoseconds.
+        //
+        Mhdr->msg_controllen += CMSG_SPACE(sizeof(uint64_t));
+        CMsg = CMSG_NXTHDR(Mhdr, CMsg);
+        QUIC_DBG_ASSERT(CMsg != NULL);
+        CMsg->cmsg_level = SOL_SOCKET;
+        CMsg->cmsg_type = SCM_TXTIME;
+        CMsg->cmsg_len = CMSG_LEN(sizeof(uint64_t));
+        *(uint64_t*)CMSG_DATA(CMsg) = SendContext->DepartureTime * 1000;
+    }
+
+#ifdef QUIC_LINUX_IO_URING
+    //
+    // The send completes on the worker thread, which frees the send context.
+    //
+    SendContext->UringOp.Type = QUIC_URING_OP_SEND;
+    SendContext->UringOp.SocketContext = SocketContext;
+    InterlockedIncrement(&SocketContext->IoCount);
+    QuicUringQueueSqe(
+        &ProcContext->Ring,
+        IORING_OP_SENDMSG,
+        SocketContext->SocketFd,
+        Mhdr,
+        0,
+        &SendContext->UringOp);
+    SendPending = TRUE;
+
+    if (QuicUringEnter(&ProcContext->Ring, 1, 0) < 0) {
+        //
+        // The send stays queued and is submitted with the next batch.
+        //
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[ udp][%p] ERROR, %u, %s.",
+            SocketContext->Binding,
+            errno,
+            "io_uring_enter failed");
+    }
+#else
+    if (Binding->Datapath->ZeroCopySendEnabled &&
+        !SocketContext->ZeroCopyDisabled &&
+        SendContext->SegmentSize > 0 &&
+        TotalSize >= QUIC_ZEROCOPY_MIN_SEND_SIZE) {
+        //
+        // The kernel references the send buffers directly, so the send
+        // context is held until the completion for this send is reaped from
+        // the socket's error queue.
+        //
+        QuicLockAcquire(&SocketContext->ZeroCopyLock);
+        SentByteCount = sendmsg(SocketContext->SocketFd, Mhdr, MSG_ZEROCOPY);
+        if (SentByteCount >= 0) {
+            SendContext->ZeroCopyId = SocketContext->ZeroCopyNextId++;
+            QuicListInsertTail(
+                &SocketContext->ZeroCopySendContextHead,
+                &SendContext->ZeroCopyLinkage);
+            SendPending = TRUE;
+        }
+        QuicLockRelease(&SocketContext->ZeroCopyLock);
+
+        if (SentByteCount < 0 && errno == ENOBUFS) {
+            //
+            // Too many completions are outstanding on the socket, so fall
+            // back to copying the data.
+            //
+            SentByteCount = sendmsg(SocketContext->SocketFd, Mhdr, 0);
+        }
+    } else {
+        SentByteCount = sendmsg(SocketContext->SocketFd, Mhdr, 0);
+    }
 
     if (SentByteCount < 0) {
         if (errno == EAGAIN || errno == EWOULDBLOCK) {
@@ -2091,15 +3912,11 @@ QuicDataPathBindingSend(
             goto Exit;
         } else {
             Status = errno;
-            QuicTraceEvent(
-                DatapathErrorStatus,
-                "[ udp][%p] ERROR, %u, %s.",
-                SocketContext->Binding,
-                Status,
-                "sendmsg failed");
+            QuicSocketContextSendFailed(SocketContext, SendContext, Status);
             goto Exit;
         }
     }
+#endif
 
     Status = QUIC_STATUS_SUCCESS;
 
@@ -2137,6 +3954,270 @@ QuicDataPathBindingGetLocalMtu(
     })
 #endif
 
+#ifdef QUIC_LINUX_IO_URING
+
+//
+// Indicates a chain of received datagrams to the upper layer.
+//
+void
+QuicSocketContextIndicateReceive(
+    _In_ QUIC_SOCKET_CONTEXT* SocketContext,
+    _In_ QUIC_RECV_DATAGRAM* DatagramChain
+    )
+{
+    QUIC_DBG_ASSERT(SocketContext->Binding->Datapath->RecvHandler);
+    SocketContext->Binding->Datapath->RecvHandler(
+        SocketContext->Binding,
+        SocketContext->Binding->ClientContext,
+        DatagramChain);
+}
+
+void*
+QuicDataPathWorkerThread(
+    _In_ void* Context
+    )
+{
+    QUIC_DATAPATH_PROC_CONTEXT* ProcContext = (QUIC_DATAPATH_PROC_CONTEXT*)Context;
+    QUIC_DBG_ASSERT(ProcContext != NULL && ProcContext->Datapath != NULL);
+    QUIC_URING* Ring = &ProcContext->Ring;
+    uint32_t ToSubmit = 0;
+
+    QuicTraceLogInfo(
+        DatapathWorkerThreadStart,
+        "[ udp][%p] Worker start",
+        ProcContext);
+
+    while (!ProcContext->Datapath->Shutdown) {
+        BOOLEAN HasCompletions = FALSE;
+
+        //
+        // Optionally poll for new completions for a while before blocking, to
+        // avoid the wake up latency of a sleeping thread. Entering without
+        // waiting still submits queued entries and runs any pending
+        // completion work.
+        //
+        const uint32_t SpinTimeUs = ProcContext->Datapath->SpinTimeUs;
+        if (SpinTimeUs != 0) {
+            const uint64_t SpinStart = QuicTimeUs64();
+            do {
+                if (QuicUringEnter(Ring, ToSubmit, 0) < 0 && errno != EBUSY) {
+                    QuicTraceEvent(
+                        LibraryErrorStatus,
+                        "[ lib] ERROR, %u, %s.",
+                        errno,
+                        "io_uring_enter failed");
+                }
+                ToSubmit = 0;
+                HasCompletions =
+                    *Ring->CqHead != __atomic_load_n(Ring->CqTail, __ATOMIC_ACQUIRE);
+            } while (!HasCompletions &&
+                     !ProcContext->Datapath->Shutdown &&
+                     QuicTimeDiff64(SpinStart, QuicTimeUs64()) < SpinTimeUs);
+        }
+
+        if (HasCompletions) {
+            ProcContext->SpinWakeCount++;
+        } else {
+            //
+            // Submit everything queued while processing the last batch of
+            // completions and wait for more, in a single system call.
+            //
+            ProcContext->SleepCount++;
+            if (QuicUringEnter(Ring, ToSubmit, 1) < 0 && errno != EBUSY) {
+                QuicTraceEvent(
+                    LibraryErrorStatus,
+                    "[ lib] ERROR, %u, %s.",
+                    errno,
+                    "io_uring_enter failed");
+            }
+            ToSubmit = 0;
+        }
+
+        //
+        // Consecutive receives on the same socket are indicated as a single
+        // chain.
+        //
+        QUIC_SOCKET_CONTEXT* ChainSocketContext = NULL;
+        QUIC_RECV_DATAGRAM* DatagramChain = NULL;
+        QUIC_RECV_DATAGRAM** DatagramChainTail = &DatagramChain;
+
+        uint32_t Head = *Ring->CqHead;
+        while (Head != __atomic_load_n(Ring->CqTail, __ATOMIC_ACQUIRE)) {
+            struct io_uring_cqe* Cqe = &Ring->Cqes[Head & Ring->CqMask];
+            QUIC_URING_OP* Op = (QUIC_URING_OP*)(uintptr_t)Cqe->user_data;
+            int Result = Cqe->res;
+            __atomic_store_n(Ring->CqHead, ++Head, __ATOMIC_RELEASE);
+
+            if (Op == NULL) {
+                //
+                // The processor context is shutting down.
+                //
+                QUIC_DBG_ASSERT(ProcContext->Datapath->Shutdown);
+                continue;
+            }
+
+            QUIC_SOCKET_CONTEXT* SocketContext = Op->SocketContext;
+
+            if (ChainSocketContext != NULL && ChainSocketContext != SocketContext) {
+                QuicSocketContextIndicateReceive(ChainSocketContext, DatagramChain);
+                ChainSocketContext = NULL;
+                DatagramChain = NULL;
+                DatagramChainTail = &DatagramChain;
+            }
+
+            switch (Op->Type) {
+            case QUIC_URING_OP_RECV:
+                if (Result >= 0) {
+                    SocketContext->RecvMsgHdr[Op->Index].msg_len = (uint32_t)Result;
+                    DatagramChainTail =
+                        QuicSocketContextRecvMessage(
+                            SocketContext,
+                            ProcContext,
+                            Op->Index,
+                            DatagramChainTail);
+                    ChainSocketContext = SocketContext;
+                } else if (Result == -ECANCELED) {
+                    break;
+                } else {
+                    QuicTraceEvent(
+                        DatapathErrorStatus,
+                        "[ udp][%p] ERROR, %u, %s.",
+                        SocketContext->Binding,
+                        -Result,
+                        "recvmsg failed");
+
+                    //
+                    // Send unreachable notification to MsQuic if any related
+                    // errors were received.
+                    //
+                    if (Result == -ECONNREFUSED ||
+                        Result == -EHOSTUNREACH ||
+                        Result == -ENETUNREACH) {
+                        SocketContext->Binding->Datapath->UnreachHandler(
+                            SocketContext->Binding,
+                            SocketContext->Binding->ClientContext,
+                            &SocketContext->Binding->RemoteAddress);
+                    }
+                }
+
+                if (!SocketContext->Binding->Shutdown) {
+                    //
+                    // Prepare can only fail under low memory condition. Treat
+                    // it as a fatal error.
+                    //
+                    QUIC_STATUS Status =
+                        QuicSocketContextQueueReceive(
+                            SocketContext,
+                            ProcContext,
+                            Op->Index);
+                    QUIC_FRE_ASSERT(QUIC_SUCCEEDED(Status));
+                    ToSubmit++;
+
+                    //
+                    // The socket is receiving, so post one more receive, up
+                    // to the max batch size.
+                    //
+                    if (Result >= 0 &&
+                        SocketContext->RecvSlotCount <
+                            SocketContext->Binding->Datapath->MaxRecvBatchSize) {
+                        Status =
+                            QuicSocketContextQueueReceive(
+                                SocketContext,
+                                ProcContext,
+                                SocketContext->RecvSlotCount);
+                        if (QUIC_SUCCEEDED(Status)) {
+                            SocketContext->RecvSlotCount++;
+                            ToSubmit++;
+                        }
+                    }
+                }
+                break;
+
+            case QUIC_URING_OP_SEND: {
+                QUIC_DATAPATH_SEND_CONTEXT* SendContext =
+                    QUIC_CONTAINING_RECORD(Op, QUIC_DATAPATH_SEND_CONTEXT, UringOp);
+                if (Result < 0 && Result != -ECANCELED) {
+                    QuicSocketContextSendFailed(SocketContext, SendContext, -Result);
+                }
+                QuicDataPathBindingFreeSendContext(SendContext);
+                break;
+            }
+
+            case QUIC_URING_OP_SHUTDOWN:
+                //
+                // Cancel the receives posted on the socket, one at a time by
+                // user data, which all supported kernels (5.5+) implement. No
+                // more receives are posted now the binding is shut down, and
+                // slots without an outstanding receive just fail with ENOENT.
+                // Sends are not canceled; they complete on their own. Each
+                // cancel holds a reference, and the initial one is released.
+                //
+                QUIC_DBG_ASSERT(SocketContext->Binding->Shutdown);
+                for (uint32_t i = 0; i < SocketContext->RecvSlotCount; ++i) {
+                    InterlockedIncrement(&SocketContext->IoCount);
+                    QuicUringQueueSqe(
+                        Ring,
+                        IORING_OP_ASYNC_CANCEL,
+                        -1,
+                        &SocketContext->RecvOps[i],
+                        0,
+                        &SocketContext->CancelOps[i]);
+                    ToSubmit++;
+                }
+                break;
+
+            case QUIC_URING_OP_CANCEL:
+                if (Result == -EINVAL) {
+                    //
+                    // The kernel can't cancel the receive. Shut the socket
+                    // down instead, which completes any blocked receive.
+                    //
+                    QuicTraceEvent(
+                        DatapathErrorStatus,
+                        "[ udp][%p] ERROR, %u, %s.",
+                        SocketContext->Binding,
+                        -Result,
+                        "io_uring cancel failed");
+                    shutdown(SocketContext->SocketFd, SHUT_RDWR);
+                }
+                //
+                // Otherwise the receive was canceled (0), is being canceled
+                // (EALREADY) or had already completed (ENOENT). Either way,
+                // its own completion releases its reference.
+                //
+                break;
+
+            default:
+                QUIC_FRE_ASSERT(FALSE);
+                break;
+            }
+
+            if (InterlockedDecrement(&SocketContext->IoCount) == 0) {
+                if (ChainSocketContext != NULL) {
+                    QuicSocketContextIndicateReceive(ChainSocketContext, DatagramChain);
+                    ChainSocketContext = NULL;
+                    DatagramChain = NULL;
+                    DatagramChainTail = &DatagramChain;
+                }
+                QuicSocketContextUninitializeComplete(SocketContext, ProcContext);
+            }
+        }
+
+        if (ChainSocketContext != NULL) {
+            QuicSocketContextIndicateReceive(ChainSocketContext, DatagramChain);
+        }
+    }
+
+    QuicTraceLogInfo(
+        DatapathWorkerThreadStop,
+        "[ udp][%p] Worker stop",
+        ProcContext);
+
+    return NO_ERROR;
+}
+
+#else
+
 void*
 QuicDataPathWorkerThread(
     _In_ void* Context
@@ -2154,13 +4235,41 @@ QuicDataPathWorkerThread(
     struct epoll_event EpollEvents[EpollEventCtMax];
 
     while (!ProcContext->Datapath->Shutdown) {
-        int ReadyEventCount =
-            TEMP_FAILURE_RETRY(
-                epoll_wait(
-                    ProcContext->EpollFd,
-                    EpollEvents,
-                    EpollEventCtMax,
-                    -1));
+        int ReadyEventCount = 0;
+
+        //
+        // Optionally poll for new events for a while before blocking, to avoid
+        // the wake up latency of a sleeping thread. Sockets with SO_BUSY_POLL
+        // additionally let the kernel poll the device queue from these calls.
+        //
+        const uint32_t SpinTimeUs = ProcContext->Datapath->SpinTimeUs;
+        if (SpinTimeUs != 0) {
+            const uint64_t SpinStart = QuicTimeUs64();
+            do {
+                ReadyEventCount =
+                    TEMP_FAILURE_RETRY(
+                        epoll_wait(
+                            ProcContext->EpollFd,
+                            EpollEvents,
+                            EpollEventCtMax,
+                            0));
+            } while (ReadyEventCount == 0 &&
+                     !ProcContext->Datapath->Shutdown &&
+                     QuicTimeDiff64(SpinStart, QuicTimeUs64()) < SpinTimeUs);
+        }
+
+        if (ReadyEventCount > 0) {
+            ProcContext->SpinWakeCount++;
+        } else {
+            ProcContext->SleepCount++;
+            ReadyEventCount =
+                TEMP_FAILURE_RETRY(
+                    epoll_wait(
+                        ProcContext->EpollFd,
+                        EpollEvents,
+                        EpollEventCtMax,
+                        -1));
+        }
 
         QUIC_FRE_ASSERT(ReadyEventCount >= 0);
         for (int i = 0; i < ReadyEventCount; i++) {
@@ -2188,6 +4297,8 @@ QuicDataPathWorkerThread(
     return NO_ERROR;
 }
 
+#endif // QUIC_LINUX_IO_URING
+
 BOOLEAN
 QuicDataPathBindingIsSendContextFull(
     _In_ QUIC_DATAPATH_SEND_CONTEXT* SendContext
@@ -2196,6 +4307,19 @@ QuicDataPathBindingIsSendContextFull(
 #ifdef QUIC_PLATFORM_DISPATCH_TABLE
     return PlatDispatch->DatapathBindingIsSendContextFull(SendContext);
 #else
-    return SendContext->BufferCount == SendContext->Owner->Datapath->MaxSendBatchSize;
+    return !QuicSendContextCanAllocSend(SendContext, SendContext->SegmentSize);
+#endif
+}
+
+void
+QuicDataPathBindingSetSendDepartureTime(
+    _In_ QUIC_DATAPATH_SEND_CONTEXT* SendContext,
+    _In_ uint64_t DepartureTimeUs
+    )
+{
+#ifdef QUIC_PLATFORM_DISPATCH_TABLE
+    PlatDispatch->DatapathBindingSetSendDepartureTime(SendContext, DepartureTimeUs);
+#else
+    SendContext->DepartureTime = DepartureTimeUs;
 #endif
 }
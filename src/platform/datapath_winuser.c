@@ -852,6 +852,49 @@ QuicDataPathIsPaddingPreferred(
     return !!(Datapath->Features & QUIC_DATAPATH_FEATURE_SEND_SEGMENTATION);
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicDataPathSetPolling(
+    _In_ QUIC_DATAPATH* Datapath,
+    _In_ uint32_t SpinTimeUs,
+    _In_ uint32_t BusyPollUs
+    )
+{
+    //
+    // Spinning and busy polling aren't supported by this datapath.
+    //
+    UNREFERENCED_PARAMETER(Datapath);
+    UNREFERENCED_PARAMETER(SpinTimeUs);
+    UNREFERENCED_PARAMETER(BusyPollUs);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicDataPathGetPollingStats(
+    _In_ QUIC_DATAPATH* Datapath,
+    _Out_ uint64_t* SpinWakes,
+    _Out_ uint64_t* Sleeps
+    )
+{
+    UNREFERENCED_PARAMETER(Datapath);
+    *SpinWakes = 0;
+    *Sleeps = 0;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicDataPathSetZeroCopySend(
+    _In_ QUIC_DATAPATH* Datapath,
+    _In_ BOOLEAN Enabled
+    )
+{
+    //
+    // Zero-copy sends aren't supported by this datapath.
+    //
+    UNREFERENCED_PARAMETER(Datapath);
+    UNREFERENCED_PARAMETER(Enabled);
+}
+
 void
 QuicDataPathPopulateTargetAddress(
     _In_ ADDRESS_FAMILY Family,
@@ -1005,6 +1048,7 @@ QuicDataPathBindingCreate(
     _In_opt_ const QUIC_ADDR* LocalAddress,
     _In_opt_ const QUIC_ADDR* RemoteAddress,
     _In_opt_ void* RecvCallbackContext,
+    _In_ uint32_t Flags,
     _Out_ QUIC_DATAPATH_BINDING** NewBinding
     )
 {
@@ -1015,6 +1059,8 @@ QuicDataPathBindingCreate(
     int Result;
     int Option;
 
+    UNREFERENCED_PARAMETER(Flags);
+
     BindingLength =
         sizeof(QUIC_DATAPATH_BINDING) +
         SocketCount * sizeof(QUIC_UDP_SOCKET_CONTEXT);
@@ -2451,6 +2497,17 @@ QuicDataPathBindingIsSendContextFull(
     return !QuicSendContextCanAllocSend(SendContext, SendContext->SegmentSize);
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicDataPathBindingSetSendDepartureTime(
+    _In_ QUIC_DATAPATH_SEND_CONTEXT* SendContext,
+    _In_ uint64_t DepartureTimeUs
+    )
+{
+    UNREFERENCED_PARAMETER(SendContext);
+    UNREFERENCED_PARAMETER(DepartureTimeUs);
+}
+
 void
 QuicSendContextComplete(
     _In_ QUIC_UDP_SOCKET_CONTEXT* SocketContext,
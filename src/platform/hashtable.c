@@ -127,15 +127,13 @@ Return Value:
 #define QuicBitScanReverse(A, B) BitScanReverse((ULONG*)A, (ULONG)B)
 #endif // BitScanReverse
 
+_Ret_range_(<, HT_FIRST_LEVEL_DIR_SIZE)
 static
-void
+uint32_t
 QuicComputeDirIndices(
     _In_range_(<, MAX_HASH_TABLE_SIZE)
     uint32_t BucketIndex,
-    _Out_range_(<, HT_FIRST_LEVEL_DIR_SIZE)
-    uint32_t* FirstLevelIndex,
-    _Out_range_(<, (1 << (*FirstLevelIndex + HT_SECOND_LEVEL_DIR_SHIFT)))
-    uint32_t* SecondLevelIndex
+    _Out_ uint32_t* SecondLevelIndex
     )
 /*++
 
@@ -149,12 +147,13 @@ Arguments:
 
     BucketIndex - [0, MAX_HASH_TABLE_SIZE-1]
 
-    FirstLevelIndex - Pointer to a uint32_t that will be assigned the first
-        level index upon return.
-
     SecondLevelIndex - Pointer to a uint32_t that will be assigned the second
         level index upon return.
 
+Return Value:
+
+    The first level index.
+
 --*/
 {
     QUIC_DBG_ASSERT(BucketIndex < MAX_HASH_TABLE_SIZE);
@@ -166,23 +165,24 @@ Arguments:
     // we don't need to check the return value.
     //
 
-    QuicBitScanReverse(FirstLevelIndex, AbsoluteIndex);
+    uint32_t HighestSetBit = 0;
+    QuicBitScanReverse(&HighestSetBit, AbsoluteIndex);
 
     //
     // The second level index is the absolute index with the most significant
     // bit cleared.
     //
 
-    *SecondLevelIndex = (AbsoluteIndex ^ (1 << *FirstLevelIndex));
+    *SecondLevelIndex = (AbsoluteIndex ^ (1 << HighestSetBit));
 
     //
     // The first level index is the position of the most significant bit
     // adjusted for the size of the minimum second level dir size.
     //
 
-    *FirstLevelIndex -= HT_SECOND_LEVEL_DIR_SHIFT;
-
-    QUIC_DBG_ASSERT(*FirstLevelIndex < HT_FIRST_LEVEL_DIR_SIZE);
+    uint32_t FirstLevelIndex = HighestSetBit - HT_SECOND_LEVEL_DIR_SHIFT;
+    QUIC_DBG_ASSERT(FirstLevelIndex < HT_FIRST_LEVEL_DIR_SIZE);
+    return FirstLevelIndex;
 }
 
 _Ret_range_(>=, QUIC_HASH_MIN_SIZE)
@@ -312,8 +312,8 @@ Return Value:
         SecondLevelIndex = BucketIndex;
 
     } else {
-        uint32_t FirstLevelIndex = 0;
-        QuicComputeDirIndices(BucketIndex, &FirstLevelIndex, &SecondLevelIndex);
+        uint32_t FirstLevelIndex =
+            QuicComputeDirIndices(BucketIndex, &SecondLevelIndex);
         SecondLevelDir = *(HashTable->FirstLevelDir + FirstLevelIndex);
     }
 
@@ -350,14 +350,10 @@ Return Value:
 --*/
 
 {
-#ifdef QUIC_HASHTABLE_RESIZE_SUPPORT
     uint32_t BucketIndex = ((uint32_t)Signature) & HashTable->DivisorMask;
     if (BucketIndex < HashTable->Pivot) {
         BucketIndex = ((uint32_t)Signature) & ((HashTable->DivisorMask << 1) | 1);
     }
-#else
-    uint32_t BucketIndex = ((uint32_t)Signature) & (HashTable->TableSize - 1);
-#endif
 
     return BucketIndex;
 }
@@ -498,10 +494,8 @@ Return Value:
     QuicZeroMemory(Table, sizeof(QUIC_HASHTABLE));
     Table->Flags = LocalFlags;
     Table->TableSize = InitialSize;
-#ifdef QUIC_HASHTABLE_RESIZE_SUPPORT
     Table->DivisorMask = Table->TableSize - 1;
     Table->Pivot = 0;
-#endif
 
     //
     // Now we allocate the second level entries.
@@ -536,9 +530,9 @@ Return Value:
         // Allocate and initialize the first-level directory entries required to
         // fit upper bound.
         //
-        uint32_t FirstLevelIndex = 0, SecondLevelIndex = 0;
-        QuicComputeDirIndices(
-            (Table->TableSize - 1), &FirstLevelIndex, &SecondLevelIndex);
+        uint32_t SecondLevelIndex = 0;
+        uint32_t FirstLevelIndex =
+            QuicComputeDirIndices((Table->TableSize - 1), &SecondLevelIndex);
 
         Table->FirstLevelDir =
             QUIC_ALLOC_NONPAGED(
@@ -623,9 +617,10 @@ Arguments:
         if (HashTable->FirstLevelDir != NULL) {
 
 #if DEBUG
-            uint32_t largestFirstLevelIndex = 0, largestSecondLevelIndex = 0;
-            QuicComputeDirIndices(
-                (HashTable->TableSize - 1), &largestFirstLevelIndex, &largestSecondLevelIndex);
+            uint32_t largestSecondLevelIndex = 0;
+            uint32_t largestFirstLevelIndex =
+                QuicComputeDirIndices(
+                    (HashTable->TableSize - 1), &largestSecondLevelIndex);
 #endif
 
             uint32_t FirstLevelIndex;
@@ -1141,8 +1136,6 @@ Arguments:
     Enumerator->ChainHead = FALSE;
 }
 
-#ifdef QUIC_HASHTABLE_RESIZE_SUPPORT
-
 BOOLEAN
 QuicHashTableExpand(
     _Inout_ QUIC_HASHTABLE* HashTable
@@ -1166,9 +1159,9 @@ QuicHashTableExpand(
     // the hash table is increased by one, the highest bucket index will be the
     // current table size, which is what we use in the calculations below
     //
-    uint32_t FirstLevelIndex, SecondLevelIndex;
-    QuicComputeDirIndices(
-        HashTable->TableSize, &FirstLevelIndex, &SecondLevelIndex);
+    uint32_t SecondLevelIndex;
+    uint32_t FirstLevelIndex =
+        QuicComputeDirIndices(HashTable->TableSize, &SecondLevelIndex);
 
     //
     // Switch to the multi-dir mode in case of the only second-level directory
@@ -1180,7 +1173,9 @@ QuicHashTableExpand(
     if (HT_SECOND_LEVEL_DIR_MIN_SIZE == HashTable->TableSize) {
 
         SecondLevelDir = (QUIC_LIST_ENTRY*)HashTable->SecondLevelDir;
-        FirstLevelDir = QUIC_ALLOC_NONPAGED(sizeof(QUIC_LIST_ENTRY*) * HT_FIRST_LEVEL_DIR_SIZE);
+        FirstLevelDir = QUIC_ALLOC_NONPAGED(
+                sizeof(QUIC_LIST_ENTRY*) * HT_FIRST_LEVEL_DIR_SIZE,
+                QUIC_POOL_HASHTABLE_MEMBER);
 
         if (FirstLevelDir == NULL) {
             return FALSE;
@@ -1205,7 +1200,8 @@ QuicHashTableExpand(
         //
         SecondLevelDir =
             QUIC_ALLOC_NONPAGED(
-                QuicComputeSecondLevelDirSize(FirstLevelIndex) * sizeof(QUIC_LIST_ENTRY));
+                QuicComputeSecondLevelDirSize(FirstLevelIndex) * sizeof(QUIC_LIST_ENTRY),
+                QUIC_POOL_HASHTABLE_MEMBER);
         if (NULL == SecondLevelDir) {
 
             //
@@ -1218,7 +1214,7 @@ QuicHashTableExpand(
                 QUIC_DBG_ASSERT(FirstLevelIndex == 1);
 
                 HashTable->SecondLevelDir = FirstLevelDir[0];
-                QUIC_FREE(FirstLevelDir);
+                QUIC_FREE(FirstLevelDir, QUIC_POOL_HASHTABLE_MEMBER);
             }
 
             return FALSE;
@@ -1369,16 +1365,16 @@ QuicHashTableContract(
     // Finally free any extra memory if possible.
     //
 
-    uint32_t FirstLevelIndex, SecondLevelIndex;
-    QuicComputeDirIndices(
-        HashTable->TableSize, &FirstLevelIndex, &SecondLevelIndex);
+    uint32_t SecondLevelIndex;
+    uint32_t FirstLevelIndex =
+        QuicComputeDirIndices(HashTable->TableSize, &SecondLevelIndex);
 
     if (SecondLevelIndex == 0) {
 
         QUIC_LIST_ENTRY** FirstLevelDir = HashTable->FirstLevelDir;
         QUIC_LIST_ENTRY* SecondLevelDir = FirstLevelDir[FirstLevelIndex];
 
-        QUIC_FREE(SecondLevelDir);
+        QUIC_FREE(SecondLevelDir, QUIC_POOL_HASHTABLE_MEMBER);
         FirstLevelDir[FirstLevelIndex] = NULL;
 
         //
@@ -1387,11 +1383,9 @@ QuicHashTableContract(
 
         if (HT_SECOND_LEVEL_DIR_MIN_SIZE == HashTable->TableSize) {
             HashTable->SecondLevelDir = FirstLevelDir[0];
-            QUIC_FREE(FirstLevelDir);
+            QUIC_FREE(FirstLevelDir, QUIC_POOL_HASHTABLE_MEMBER);
         }
     }
 
     return TRUE;
 }
-
-#endif // QUIC_HASHTABLE_RESIZE_SUPPORT
@@ -199,6 +199,130 @@ QuicFree(
 #endif
 }
 
+#ifndef QUIC_PLATFORM_DISPATCH_TABLE
+
+QUIC_STATIC_ASSERT(sizeof(QUIC_POOL_CACHE) == QUIC_CACHE_LINE_SIZE, "QUIC_POOL_CACHE must fill a cache line");
+
+static
+void
+QuicPoolCacheLock(
+    _Inout_ QUIC_POOL_CACHE* Cache
+    )
+{
+    while (__atomic_exchange_n(&Cache->Lock, 1, __ATOMIC_ACQUIRE)) {
+        //
+        // The owner was likely preempted right after moving processors, so
+        // give it a chance to run.
+        //
+        sched_yield();
+    }
+}
+
+static
+void
+QuicPoolCacheUnlock(
+    _Inout_ QUIC_POOL_CACHE* Cache
+    )
+{
+    __atomic_store_n(&Cache->Lock, 0, __ATOMIC_RELEASE);
+}
+
+static
+void
+QuicPoolFreeList(
+    _Inout_ QUIC_POOL* Pool,
+    _In_opt_ QUIC_SINGLE_LIST_ENTRY* Head
+    )
+{
+    while (Head != NULL) {
+        QUIC_SINGLE_LIST_ENTRY* Next = Head->Next;
+        QuicFree(Head, Pool->MemTag);
+        Head = Next;
+    }
+}
+
+//
+// Pushes a chain of free entries onto the lock-free spill list, or frees them
+// if the spill list is already full.
+//
+static
+void
+QuicPoolSpill(
+    _Inout_ QUIC_POOL* Pool,
+    _In_ QUIC_SINGLE_LIST_ENTRY* Head,
+    _In_ QUIC_SINGLE_LIST_ENTRY* Tail,
+    _In_ uint32_t Count
+    )
+{
+    if (__atomic_load_n(&Pool->SpillDepth, __ATOMIC_RELAXED) + (long)Count >
+        (long)Pool->MaxDepth * QUIC_POOL_SPILL_FACTOR) {
+        Tail->Next = NULL;
+        QuicPoolFreeList(Pool, Head);
+        return;
+    }
+
+    __atomic_add_fetch(&Pool->SpillDepth, (long)Count, __ATOMIC_RELAXED);
+
+    QUIC_SINGLE_LIST_ENTRY* OldHead = __atomic_load_n(&Pool->SpillHead, __ATOMIC_RELAXED);
+    do {
+        Tail->Next = OldHead;
+    } while (
+        !__atomic_compare_exchange_n(
+            &Pool->SpillHead,
+            &OldHead,
+            Head,
+            TRUE,
+            __ATOMIC_RELEASE,
+            __ATOMIC_RELAXED));
+}
+
+//
+// Refills an empty (and locked) per-processor cache from the spill list.
+//
+static
+void
+QuicPoolCacheRefill(
+    _Inout_ QUIC_POOL* Pool,
+    _Inout_ QUIC_POOL_CACHE* Cache
+    )
+{
+    QUIC_SINGLE_LIST_ENTRY* Head =
+        __atomic_exchange_n(&Pool->SpillHead, NULL, __ATOMIC_ACQUIRE);
+    if (Head == NULL) {
+        return;
+    }
+
+    //
+    // Keep up to a full cache worth of entries and spill the rest back.
+    //
+    QUIC_SINGLE_LIST_ENTRY* Tail = Head;
+    uint16_t Count = 1;
+    while (Count < Pool->MaxDepth && Tail->Next != NULL) {
+        Tail = Tail->Next;
+        Count++;
+    }
+
+    QUIC_SINGLE_LIST_ENTRY* Rest = Tail->Next;
+    Tail->Next = NULL;
+    Cache->ListHead.Next = Head;
+    Cache->ListTail = Tail;
+    Cache->ListDepth = Count;
+    __atomic_sub_fetch(&Pool->SpillDepth, (long)Count, __ATOMIC_RELAXED);
+
+    if (Rest != NULL) {
+        uint32_t RestCount = 1;
+        QUIC_SINGLE_LIST_ENTRY* RestTail = Rest;
+        while (RestTail->Next != NULL) {
+            RestTail = RestTail->Next;
+            RestCount++;
+        }
+        __atomic_sub_fetch(&Pool->SpillDepth, (long)RestCount, __ATOMIC_RELAXED);
+        QuicPoolSpill(Pool, Rest, RestTail, RestCount);
+    }
+}
+
+#endif // QUIC_PLATFORM_DISPATCH_TABLE
+
 void
 QuicPoolInitialize(
     _In_ BOOLEAN IsPaged,
@@ -206,13 +330,51 @@ QuicPoolInitialize(
     _In_ uint32_t Tag,
     _Inout_ QUIC_POOL* Pool
     )
+{
+    QuicPoolInitializeEx(IsPaged, Size, Tag, FALSE, Pool);
+}
+
+void
+QuicPoolInitializeEx(
+    _In_ BOOLEAN IsPaged,
+    _In_ uint32_t Size,
+    _In_ uint32_t Tag,
+    _In_ BOOLEAN ZeroOnAlloc,
+    _Inout_ QUIC_POOL* Pool
+    )
 {
 #ifdef QUIC_PLATFORM_DISPATCH_TABLE
+    UNREFERENCED_PARAMETER(ZeroOnAlloc);
     PlatDispatch->PoolInitialize(IsPaged, Size, Pool);
 #else
     UNREFERENCED_PARAMETER(IsPaged);
+    QUIC_DBG_ASSERT(Size >= sizeof(QUIC_SINGLE_LIST_ENTRY));
+    QuicZeroMemory(Pool, sizeof(*Pool));
     Pool->Size = Size;
     Pool->MemTag = Tag;
+    Pool->ZeroOnAlloc = ZeroOnAlloc;
+    Pool->MaxDepth = QUIC_POOL_MAXIMUM_DEPTH;
+    if ((uint64_t)Pool->MaxDepth * Size > QUIC_POOL_MAXIMUM_CACHE_SIZE) {
+        Pool->MaxDepth = (uint16_t)(QUIC_POOL_MAXIMUM_CACHE_SIZE / Size);
+        if (Pool->MaxDepth == 0) {
+            Pool->MaxDepth = 1;
+        }
+    }
+
+#ifndef QUIC_DISABLE_MEM_POOL
+    //
+    // If the caches can't be allocated, the pool falls back to the general
+    // allocator. They must be cache line aligned, which malloc doesn't
+    // guarantee.
+    //
+    uint32_t CacheCount = QuicProcMaxCount();
+    Pool->Caches =
+        aligned_alloc(QUIC_CACHE_LINE_SIZE, CacheCount * sizeof(QUIC_POOL_CACHE));
+    if (Pool->Caches != NULL) {
+        QuicZeroMemory(Pool->Caches, CacheCount * sizeof(QUIC_POOL_CACHE));
+        Pool->CacheCount = CacheCount;
+    }
+#endif
 #endif
 }
 
@@ -224,7 +386,12 @@ QuicPoolUninitialize(
 #ifdef QUIC_PLATFORM_DISPATCH_TABLE
     PlatDispatch->PoolUninitialize(Pool);
 #else
-    UNREFERENCED_PARAMETER(Pool);
+    for (uint32_t i = 0; i < Pool->CacheCount; ++i) {
+        QuicPoolFreeList(Pool, Pool->Caches[i].ListHead.Next);
+    }
+    QuicPoolFreeList(Pool, Pool->SpillHead);
+    free(Pool->Caches);
+    QuicZeroMemory(Pool, sizeof(*Pool));
 #endif
 }
 
@@ -236,9 +403,29 @@ QuicPoolAlloc(
 #ifdef QUIC_PLATFORM_DISPATCH_TABLE
     return PlatDispatch->PoolAlloc(Pool);
 #else
-    void*Entry = QuicAlloc(Pool->Size, Pool->MemTag);
+    void* Entry = NULL;
+
+    if (Pool->CacheCount != 0) {
+        QUIC_POOL_CACHE* Cache =
+            &Pool->Caches[QuicProcCurrentNumber() % Pool->CacheCount];
+        QuicPoolCacheLock(Cache);
+        if (Cache->ListDepth == 0) {
+            QuicPoolCacheRefill(Pool, Cache);
+        }
+        if (Cache->ListDepth != 0) {
+            Entry = QuicListPopEntry(&Cache->ListHead);
+            if (--Cache->ListDepth == 0) {
+                Cache->ListTail = NULL;
+            }
+        }
+        QuicPoolCacheUnlock(Cache);
+    }
+
+    if (Entry == NULL) {
+        Entry = QuicAlloc(Pool->Size, Pool->MemTag);
+    }
 
-    if (Entry != NULL) {
+    if (Entry != NULL && Pool->ZeroOnAlloc) {
         QuicZeroMemory(Entry, Pool->Size);
     }
 
@@ -255,8 +442,39 @@ QuicPoolFree(
 #ifdef QUIC_PLATFORM_DISPATCH_TABLE
     PlatDispatch->PoolFree(Pool, Entry);
 #else
-    UNREFERENCED_PARAMETER(Pool);
-    QuicFree(Entry, Pool->MemTag);
+    if (Pool->CacheCount == 0) {
+        QuicFree(Entry, Pool->MemTag);
+        return;
+    }
+
+    QUIC_SINGLE_LIST_ENTRY* ListEntry = (QUIC_SINGLE_LIST_ENTRY*)Entry;
+    QUIC_POOL_CACHE* Cache =
+        &Pool->Caches[QuicProcCurrentNumber() % Pool->CacheCount];
+    QuicPoolCacheLock(Cache);
+
+    if (Cache->ListDepth < Pool->MaxDepth) {
+        QuicListPushEntry(&Cache->ListHead, ListEntry);
+        if (Cache->ListDepth++ == 0) {
+            Cache->ListTail = ListEntry;
+        }
+        QuicPoolCacheUnlock(Cache);
+        return;
+    }
+
+    //
+    // The cache is full. Move all its entries to the spill list in one go and
+    // start over with just this entry.
+    //
+    QUIC_SINGLE_LIST_ENTRY* Head = Cache->ListHead.Next;
+    QUIC_SINGLE_LIST_ENTRY* Tail = Cache->ListTail;
+    uint32_t Count = Cache->ListDepth;
+    ListEntry->Next = NULL;
+    Cache->ListHead.Next = ListEntry;
+    Cache->ListTail = ListEntry;
+    Cache->ListDepth = 1;
+    QuicPoolCacheUnlock(Cache);
+
+    QuicPoolSpill(Pool, Head, Tail, Count);
 #endif
 }
 
@@ -2294,6 +2294,9 @@ QuicPacketKeyFree(
 {
     if (Key != NULL) {
         QuicKeyFree(Key->PacketKey);
+        for (uint8_t i = 0; i < QUIC_PACKET_KEY_MAX_DUPLICATES; ++i) {
+            QuicKeyFree(Key->PacketKeyDuplicates[i]);
+        }
         QuicHpKeyFree(Key->HeaderKey);
         if (Key->Type >= QUIC_PACKET_KEY_1_RTT) {
             RtlSecureZeroMemory(Key->TrafficSecret, sizeof(QUIC_SECRET));
@@ -2414,6 +2417,29 @@ QuicKeyFree(
     }
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QuicKeyDuplicate(
+    _In_ QUIC_KEY* Key,
+    _Out_ QUIC_KEY** NewKey
+    )
+{
+    QUIC_KEY* Copy = QUIC_ALLOC_NONPAGED(sizeof(QUIC_KEY), QUIC_POOL_TLS_KEY);
+    if (Copy == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "QUIC_KEY",
+            sizeof(QUIC_KEY));
+        return QUIC_STATUS_OUT_OF_MEMORY;
+    }
+
+    QuicCopyMemory(Copy, Key, sizeof(QUIC_KEY));
+    *NewKey = Copy;
+
+    return QUIC_STATUS_SUCCESS;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
 #pragma prefast(suppress: __WARNING_6262, "miTLS won't be shipped in product.")
@@ -25,6 +25,23 @@ Abstract:
 
 uint16_t QuicTlsTPHeaderSize = 0;
 
+//
+// Length of the (optional) app provided session ticket key material.
+//
+#define QUIC_TLS_TICKET_KEY_LENGTH          44
+
+//
+// Length of the ticket key name, encryption key and HMAC key derived from the
+// ticket key material.
+//
+#define QUIC_TLS_TICKET_SECRET_LENGTH       32
+
+//
+// How often the session ticket keys are rotated. Tickets encrypted with the
+// previous key are still accepted (and renewed).
+//
+#define QUIC_TLS_TICKET_KEY_ROTATION_MS     (60 * 60 * 1000)
+
 //
 // The QUIC sec config object. Created once per listener on server side and
 // once per connection on client side.
@@ -38,6 +55,14 @@ typedef struct QUIC_SEC_CONFIG {
 
     SSL_CTX *SSLCtx;
 
+    //
+    // The key material the rotating session ticket keys are derived from
+    // (server side only). Either provided by the app, so that all servers
+    // sharing it can decrypt each other's tickets, or randomly generated.
+    //
+
+    uint8_t TicketKey[QUIC_TLS_TICKET_KEY_LENGTH];
+
 } QUIC_SEC_CONFIG;
 
 //
@@ -87,6 +112,11 @@ typedef struct QUIC_TLS {
     QUIC_CONNECTION* Connection;
     QUIC_TLS_RECEIVE_TP_CALLBACK_HANDLER ReceiveTPCallback;
 
+    //
+    // Callback handler for received resumption tickets.
+    //
+    QUIC_TLS_RECEIVE_TICKET_CALLBACK_HANDLER ReceiveResumptionCallback;
+
 #ifdef QUIC_TLS_SECRETS_SUPPORT
     //
     // Optional struct to log TLS traffic secrets.
@@ -237,46 +267,63 @@ QuicTlsSetEncryptionSecretsCallback(
 
     QUIC_SECRET Secret;
     QuicTlsNegotiatedCiphers(TlsContext, &Secret.Aead, &Secret.Hash);
-    QuicCopyMemory(Secret.Secret, WriteSecret, SecretLen);
 
-    QUIC_DBG_ASSERT(TlsState->WriteKeys[KeyType] == NULL);
-    Status =
-        QuicPacketKeyDerive(
-            KeyType,
-            &Secret,
-            "write secret",
-            TRUE,
-            &TlsState->WriteKeys[KeyType]);
-    if (QUIC_FAILED(Status)) {
-        TlsContext->ResultFlags |= QUIC_TLS_RESULT_ERROR;
-        return -1;
-    }
+    //
+    // For 0-RTT, only the client's write secret and the server's read secret
+    // are provided.
+    //
 
-    TlsState->WriteKey = KeyType;
-    TlsContext->ResultFlags |= QUIC_TLS_RESULT_WRITE_KEY_UPDATED;
-    QuicCopyMemory(Secret.Secret, ReadSecret, SecretLen);
+    if (WriteSecret != NULL) {
+        QuicCopyMemory(Secret.Secret, WriteSecret, SecretLen);
 
-    QUIC_DBG_ASSERT(TlsState->ReadKeys[KeyType] == NULL);
-    Status =
-        QuicPacketKeyDerive(
-            KeyType,
-            &Secret,
-            "read secret",
-            TRUE,
-            &TlsState->ReadKeys[KeyType]);
-    if (QUIC_FAILED(Status)) {
-        TlsContext->ResultFlags |= QUIC_TLS_RESULT_ERROR;
-        return -1;
+        QUIC_DBG_ASSERT(TlsState->WriteKeys[KeyType] == NULL);
+        Status =
+            QuicPacketKeyDerive(
+                KeyType,
+                &Secret,
+                "write secret",
+                TRUE,
+                &TlsState->WriteKeys[KeyType]);
+        if (QUIC_FAILED(Status)) {
+            TlsContext->ResultFlags |= QUIC_TLS_RESULT_ERROR;
+            return -1;
+        }
+
+        TlsState->WriteKey = KeyType;
+        TlsContext->ResultFlags |= QUIC_TLS_RESULT_WRITE_KEY_UPDATED;
     }
 
-    if (TlsContext->IsServer && KeyType == QUIC_PACKET_KEY_1_RTT) {
-        //
-        // The 1-RTT read keys aren't actually allowed to be used until the
-        // handshake completes.
-        //
-    } else {
-        TlsState->ReadKey = KeyType;
-        TlsContext->ResultFlags |= QUIC_TLS_RESULT_READ_KEY_UPDATED;
+    if (ReadSecret != NULL) {
+        QuicCopyMemory(Secret.Secret, ReadSecret, SecretLen);
+
+        QUIC_DBG_ASSERT(TlsState->ReadKeys[KeyType] == NULL);
+        Status =
+            QuicPacketKeyDerive(
+                KeyType,
+                &Secret,
+                "read secret",
+                TRUE,
+                &TlsState->ReadKeys[KeyType]);
+        if (QUIC_FAILED(Status)) {
+            TlsContext->ResultFlags |= QUIC_TLS_RESULT_ERROR;
+            return -1;
+        }
+
+        if (TlsContext->IsServer && KeyType == QUIC_PACKET_KEY_1_RTT) {
+            //
+            // The 1-RTT read keys aren't actually allowed to be used until the
+            // handshake completes.
+            //
+        } else if (KeyType == QUIC_PACKET_KEY_0_RTT) {
+            //
+            // The 0-RTT read key is only used for packets; the client's crypto
+            // data continues at the current (initial) level, and the handshake
+            // read key immediately follows.
+            //
+        } else {
+            TlsState->ReadKey = KeyType;
+            TlsContext->ResultFlags |= QUIC_TLS_RESULT_READ_KEY_UPDATED;
+        }
     }
 #ifdef QUIC_TLS_SECRETS_SUPPORT
     if (TlsContext->TlsSecrets != NULL) {
@@ -480,6 +527,289 @@ QuicTlsClientHelloCallback(
     return SSL_CLIENT_HELLO_SUCCESS;
 }
 
+//
+// Derives one of the session ticket secrets for the given key rotation epoch
+// from the sec config's ticket key material.
+//
+static
+BOOLEAN
+QuicTlsDeriveTicketSecret(
+    _In_ const QUIC_SEC_CONFIG* SecConfig,
+    _In_z_ const char* Label,
+    _In_ uint64_t Epoch,
+    _Out_writes_all_(QUIC_TLS_TICKET_SECRET_LENGTH) uint8_t* Secret
+    )
+{
+    uint8_t Info[32];
+    size_t LabelLength = strlen(Label);
+    QUIC_DBG_ASSERT(LabelLength + sizeof(Epoch) <= sizeof(Info));
+
+    memcpy(Info, Label, LabelLength);
+    for (uint8_t i = 0; i < sizeof(Epoch); ++i) {
+        Info[LabelLength + i] = (uint8_t)(Epoch >> (56 - 8 * i));
+    }
+
+    unsigned int SecretLength = QUIC_TLS_TICKET_SECRET_LENGTH;
+    return
+        HMAC(
+            EVP_sha256(),
+            SecConfig->TicketKey,
+            sizeof(SecConfig->TicketKey),
+            Info,
+            LabelLength + sizeof(Epoch),
+            Secret,
+            &SecretLength) != NULL;
+}
+
+//
+// Encrypts or decrypts session tickets with keys derived from the sec config's
+// ticket key material and the current rotation epoch. The key name carries the
+// epoch the ticket was encrypted in, so no per-ticket server state is needed.
+//
+static
+int
+QuicTlsTicketKeyCallback(
+    _In_ SSL* Ssl,
+    _Inout_updates_(16) unsigned char* KeyName,
+    _Inout_updates_(EVP_MAX_IV_LENGTH) unsigned char* Iv,
+    _In_ EVP_CIPHER_CTX* CipherCtx,
+    _In_ HMAC_CTX* HmacCtx,
+    _In_ int Encrypt
+    )
+{
+    QUIC_TLS* TlsContext = SSL_get_app_data(Ssl);
+    const QUIC_SEC_CONFIG* SecConfig = TlsContext->SecConfig;
+    const uint64_t CurrentEpoch = QuicTimeEpochMs64() / QUIC_TLS_TICKET_KEY_ROTATION_MS;
+    uint64_t Epoch = 0;
+    uint8_t Name[QUIC_TLS_TICKET_SECRET_LENGTH];
+    uint8_t CipherKey[QUIC_TLS_TICKET_SECRET_LENGTH];
+    uint8_t HmacKey[QUIC_TLS_TICKET_SECRET_LENGTH];
+    int Result = -1;
+
+    if (Encrypt) {
+        Epoch = CurrentEpoch;
+        for (uint8_t i = 0; i < sizeof(Epoch); ++i) {
+            KeyName[i] = (uint8_t)(Epoch >> (56 - 8 * i));
+        }
+        if (QUIC_FAILED(QuicRandom(EVP_CIPHER_iv_length(EVP_aes_256_cbc()), Iv))) {
+            goto Exit;
+        }
+        Result = 1;
+
+    } else {
+        for (uint8_t i = 0; i < sizeof(Epoch); ++i) {
+            Epoch = (Epoch << 8) | KeyName[i];
+        }
+        if (Epoch == CurrentEpoch || Epoch == CurrentEpoch + 1) {
+            Result = 1; // Allow for a little clock skew between servers.
+        } else if (Epoch + 1 == CurrentEpoch) {
+            Result = 2; // Previous key. Decrypt, but issue a fresh ticket.
+        } else {
+            QuicTraceLogConnVerbose(
+                OpenSslTicketKeyExpired,
+                TlsContext->Connection,
+                "Ticket key epoch %llu expired",
+                Epoch);
+            Result = 0;
+            goto Exit;
+        }
+    }
+
+    if (!QuicTlsDeriveTicketSecret(SecConfig, "quic tk name", Epoch, Name) ||
+        !QuicTlsDeriveTicketSecret(SecConfig, "quic tk enc", Epoch, CipherKey) ||
+        !QuicTlsDeriveTicketSecret(SecConfig, "quic tk hmac", Epoch, HmacKey)) {
+        QuicTraceEvent(
+            TlsError,
+            "[ tls][%p] ERROR, %s.",
+            TlsContext->Connection,
+            "Ticket key derivation failed");
+        Result = -1;
+        goto Exit;
+    }
+
+    if (Encrypt) {
+        memcpy(KeyName + sizeof(Epoch), Name, 16 - sizeof(Epoch));
+        if (EVP_EncryptInit_ex(CipherCtx, EVP_aes_256_cbc(), NULL, CipherKey, Iv) != 1) {
+            Result = -1;
+            goto Exit;
+        }
+    } else {
+        if (memcmp(KeyName + sizeof(Epoch), Name, 16 - sizeof(Epoch)) != 0) {
+            Result = 0; // Encrypted with some other key material.
+            goto Exit;
+        }
+        if (EVP_DecryptInit_ex(CipherCtx, EVP_aes_256_cbc(), NULL, CipherKey, Iv) != 1) {
+            Result = -1;
+            goto Exit;
+        }
+    }
+
+    if (HMAC_Init_ex(HmacCtx, HmacKey, sizeof(HmacKey), EVP_sha256(), NULL) != 1) {
+        Result = -1;
+        goto Exit;
+    }
+
+Exit:
+
+    QuicSecureZeroMemory(CipherKey, sizeof(CipherKey));
+    QuicSecureZeroMemory(HmacKey, sizeof(HmacKey));
+
+    return Result;
+}
+
+//
+// Called on the server after a client's session ticket is decrypted. The QUIC
+// resumption state stored in the ticket (via QUIC_TLS_TICKET_DATA) is passed
+// up for validation, which decides if the session is resumed.
+//
+static
+SSL_TICKET_RETURN
+QuicTlsDecryptTicketCallback(
+    _In_ SSL* Ssl,
+    _In_ SSL_SESSION* Session,
+    _In_reads_(KeyNameLength) const unsigned char* KeyName,
+    _In_ size_t KeyNameLength,
+    _In_ SSL_TICKET_STATUS Status,
+    _In_ void* Arg
+    )
+{
+    UNREFERENCED_PARAMETER(KeyName);
+    UNREFERENCED_PARAMETER(KeyNameLength);
+    UNREFERENCED_PARAMETER(Arg);
+
+    QUIC_TLS* TlsContext = SSL_get_app_data(Ssl);
+    void* Ticket = NULL;
+    size_t TicketLength = 0;
+
+    switch (Status) {
+    case SSL_TICKET_SUCCESS:
+    case SSL_TICKET_SUCCESS_RENEW:
+        break;
+    case SSL_TICKET_EMPTY:
+    case SSL_TICKET_NO_DECRYPT:
+        return SSL_TICKET_RETURN_IGNORE;
+    default:
+        return SSL_TICKET_RETURN_ABORT;
+    }
+
+    if (!SSL_SESSION_get0_ticket_appdata(Session, &Ticket, &TicketLength) ||
+        Ticket == NULL || TicketLength == 0 || TicketLength > UINT32_MAX) {
+        QuicTraceLogConnWarning(
+            OpenSslMissingTicketAppData,
+            TlsContext->Connection,
+            "Session ticket has no resumption state");
+        return SSL_TICKET_RETURN_IGNORE;
+    }
+
+    if (!TlsContext->ReceiveResumptionCallback(
+            TlsContext->Connection,
+            (uint32_t)TicketLength,
+            (const uint8_t*)Ticket)) {
+        return SSL_TICKET_RETURN_IGNORE;
+    }
+
+    return
+        Status == SSL_TICKET_SUCCESS_RENEW ?
+            SSL_TICKET_RETURN_USE_RENEW : SSL_TICKET_RETURN_USE;
+}
+
+//
+// Called on the client when a new session ticket is received from the server.
+// The serialized session is passed up as the opaque TLS part of the client's
+// resumption ticket.
+//
+static
+int
+QuicTlsClientNewSessionCallback(
+    _In_ SSL* Ssl,
+    _In_ SSL_SESSION* Session
+    )
+{
+    QUIC_TLS* TlsContext = SSL_get_app_data(Ssl);
+    uint8_t* Ticket = NULL;
+    uint8_t* TicketEnd;
+    int TicketLength;
+
+    if (!SSL_SESSION_is_resumable(Session)) {
+        goto Exit;
+    }
+
+    TicketLength = i2d_SSL_SESSION(Session, NULL);
+    if (TicketLength <= 0) {
+        QuicTraceEvent(
+            TlsError,
+            "[ tls][%p] ERROR, %s.",
+            TlsContext->Connection,
+            "i2d_SSL_SESSION failed");
+        goto Exit;
+    }
+
+    Ticket = QUIC_ALLOC_NONPAGED((size_t)TicketLength, QUIC_POOL_TLS_RESUMPTION);
+    if (Ticket == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "Resumption ticket",
+            (uint64_t)TicketLength);
+        goto Exit;
+    }
+
+    TicketEnd = Ticket;
+    if (i2d_SSL_SESSION(Session, &TicketEnd) != TicketLength) {
+        QuicTraceEvent(
+            TlsError,
+            "[ tls][%p] ERROR, %s.",
+            TlsContext->Connection,
+            "i2d_SSL_SESSION failed");
+        goto Exit;
+    }
+
+    QuicTraceLogConnInfo(
+        OpenSslTicketReceived,
+        TlsContext->Connection,
+        "Received session ticket (%d bytes)",
+        TicketLength);
+
+    (void)TlsContext->ReceiveResumptionCallback(
+        TlsContext->Connection,
+        (uint32_t)TicketLength,
+        Ticket);
+
+Exit:
+
+    if (Ticket != NULL) {
+        QUIC_FREE(Ticket, QUIC_POOL_TLS_RESUMPTION);
+    }
+
+    return 0; // The session isn't kept by this callback.
+}
+
+//
+// Updates the early data state from the TLS library, once it's known.
+//
+static
+void
+QuicTlsUpdateEarlyDataState(
+    _In_ QUIC_TLS* TlsContext
+    )
+{
+    QUIC_TLS_PROCESS_STATE* State = TlsContext->State;
+
+    switch (SSL_get_early_data_status(TlsContext->Ssl)) {
+    case SSL_EARLY_DATA_ACCEPTED:
+        State->EarlyDataState = QUIC_TLS_EARLY_DATA_ACCEPTED;
+        TlsContext->ResultFlags |= QUIC_TLS_RESULT_EARLY_DATA_ACCEPT;
+        break;
+    case SSL_EARLY_DATA_REJECTED:
+        State->EarlyDataState = QUIC_TLS_EARLY_DATA_REJECTED;
+        TlsContext->ResultFlags |= QUIC_TLS_RESULT_EARLY_DATA_REJECT;
+        break;
+    default: // SSL_EARLY_DATA_NOT_SENT
+        State->EarlyDataState = QUIC_TLS_EARLY_DATA_UNSUPPORTED;
+        break;
+    }
+}
+
 SSL_QUIC_METHOD OpenSslQuicCallbacks = {
     QuicTlsSetEncryptionSecretsCallback,
     QuicTlsAddHandshakeDataCallback,
@@ -503,10 +833,6 @@ QuicTlsSecConfigCreate(
         return QUIC_STATUS_NOT_SUPPORTED; // Not supported by this TLS implementation
     }
 
-    if (CredConfig->TicketKey != NULL) {
-        return QUIC_STATUS_NOT_SUPPORTED; // Not currently supported
-    }
-
     QUIC_CERTIFICATE_FILE* CertFile = CredConfig->CertificateFile;
 
     if (CredConfig->Flags & QUIC_CREDENTIAL_FLAG_CLIENT) {
@@ -727,6 +1053,83 @@ QuicTlsSecConfigCreate(
 
         SSL_CTX_set_max_early_data(SecurityConfig->SSLCtx, UINT32_MAX);
         SSL_CTX_set_client_hello_cb(SecurityConfig->SSLCtx, QuicTlsClientHelloCallback, NULL);
+
+        //
+        // Set up stateless session tickets. Tickets are only sent when QUIC
+        // provides the resumption state to put in them, and are encrypted with
+        // rotating keys derived from the app's ticket key, if provided.
+        //
+
+        if (CredConfig->TicketKey != NULL) {
+            QuicCopyMemory(
+                SecurityConfig->TicketKey,
+                CredConfig->TicketKey,
+                sizeof(SecurityConfig->TicketKey));
+        } else {
+            Status = QuicRandom(sizeof(SecurityConfig->TicketKey), SecurityConfig->TicketKey);
+            if (QUIC_FAILED(Status)) {
+                QuicTraceEvent(
+                    LibraryErrorStatus,
+                    "[ lib] ERROR, %u, %s.",
+                    Status,
+                    "QuicRandom (ticket key) failed");
+                goto Exit;
+            }
+        }
+
+        SSL_CTX_set_session_cache_mode(SecurityConfig->SSLCtx, SSL_SESS_CACHE_OFF);
+
+        Ret = SSL_CTX_set_num_tickets(SecurityConfig->SSLCtx, 0);
+        if (Ret != 1) {
+            QuicTraceEvent(
+                LibraryErrorStatus,
+                "[ lib] ERROR, %u, %s.",
+                ERR_get_error(),
+                "SSL_CTX_set_num_tickets failed");
+            Status = QUIC_STATUS_TLS_ERROR;
+            goto Exit;
+        }
+
+        Ret =
+            SSL_CTX_set_tlsext_ticket_key_cb(
+                SecurityConfig->SSLCtx,
+                QuicTlsTicketKeyCallback);
+        if (Ret != 1) {
+            QuicTraceEvent(
+                LibraryErrorStatus,
+                "[ lib] ERROR, %u, %s.",
+                ERR_get_error(),
+                "SSL_CTX_set_tlsext_ticket_key_cb failed");
+            Status = QUIC_STATUS_TLS_ERROR;
+            goto Exit;
+        }
+
+        Ret =
+            SSL_CTX_set_session_ticket_cb(
+                SecurityConfig->SSLCtx,
+                NULL,
+                QuicTlsDecryptTicketCallback,
+                NULL);
+        if (Ret != 1) {
+            QuicTraceEvent(
+                LibraryErrorStatus,
+                "[ lib] ERROR, %u, %s.",
+                ERR_get_error(),
+                "SSL_CTX_set_session_ticket_cb failed");
+            Status = QUIC_STATUS_TLS_ERROR;
+            goto Exit;
+        }
+    }
+
+    if (CredConfig->Flags & QUIC_CREDENTIAL_FLAG_CLIENT) {
+        //
+        // Export received session tickets, without caching them internally.
+        //
+
+        SSL_CTX_set_session_cache_mode(
+            SecurityConfig->SSLCtx,
+            SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+        SSL_CTX_sess_set_new_cb(SecurityConfig->SSLCtx, QuicTlsClientNewSessionCallback);
     }
 
     //
@@ -794,6 +1197,7 @@ QuicTlsInitialize(
     TlsContext->AlpnBufferLength = Config->AlpnBufferLength;
     TlsContext->AlpnBuffer = Config->AlpnBuffer;
     TlsContext->ReceiveTPCallback = Config->ReceiveTPCallback;
+    TlsContext->ReceiveResumptionCallback = Config->ReceiveResumptionCallback;
 #ifdef QUIC_TLS_SECRETS_SUPPORT
     TlsContext->TlsSecrets = Config->TlsSecrets;
 #endif
@@ -852,11 +1256,47 @@ QuicTlsInitialize(
 
     if (Config->IsServer) {
         SSL_set_accept_state(TlsContext->Ssl);
-        //SSL_set_quic_early_data_enabled(TlsContext->Ssl, 1);
+        SSL_set_quic_early_data_enabled(TlsContext->Ssl, 1);
+        State->EarlyDataState = QUIC_TLS_EARLY_DATA_UNKNOWN;
     } else {
         SSL_set_connect_state(TlsContext->Ssl);
         SSL_set_tlsext_host_name(TlsContext->Ssl, TlsContext->SNI);
         SSL_set_alpn_protos(TlsContext->Ssl, TlsContext->AlpnBuffer, TlsContext->AlpnBufferLength);
+        State->EarlyDataState = QUIC_TLS_EARLY_DATA_UNSUPPORTED;
+
+        if (Config->ResumptionTicketBuffer != NULL) {
+            //
+            // Resume the serialized session from the ticket, attempting 0-RTT
+            // if the server allowed it. If the ticket can't be used, just fall
+            // back to a full handshake.
+            //
+            const uint8_t* Ticket = Config->ResumptionTicketBuffer;
+            SSL_SESSION* Session =
+                d2i_SSL_SESSION(NULL, &Ticket, (long)Config->ResumptionTicketLength);
+            if (Session == NULL) {
+                QuicTraceEvent(
+                    TlsError,
+                    "[ tls][%p] ERROR, %s.",
+                    TlsContext->Connection,
+                    "d2i_SSL_SESSION failed");
+            } else {
+                if (SSL_set_session(TlsContext->Ssl, Session) != 1) {
+                    QuicTraceEvent(
+                        TlsError,
+                        "[ tls][%p] ERROR, %s.",
+                        TlsContext->Connection,
+                        "SSL_set_session failed");
+                } else {
+                    QuicTraceLogConnVerbose(
+                        OpenSslUsing0Rtt,
+                        TlsContext->Connection,
+                        "Using 0-RTT ticket.");
+                    SSL_set_quic_early_data_enabled(TlsContext->Ssl, 1);
+                    State->EarlyDataState = QUIC_TLS_EARLY_DATA_UNKNOWN;
+                }
+                SSL_SESSION_free(Session);
+            }
+        }
     }
 
     if (SSL_set_quic_transport_params(
@@ -873,7 +1313,9 @@ QuicTlsInitialize(
     }
     QUIC_FREE(Config->LocalTPBuffer, QUIC_POOL_TLS_TRANSPARAMS);
 
-    State->EarlyDataState = QUIC_TLS_EARLY_DATA_UNSUPPORTED; // 0-RTT not currently supported.
+    if (Config->ResumptionTicketBuffer != NULL) {
+        QUIC_FREE(Config->ResumptionTicketBuffer, QUIC_POOL_TLS_RESUMPTION);
+    }
 
     *NewTlsContext = TlsContext;
     TlsContext = NULL;
@@ -987,15 +1429,51 @@ QuicTlsProcessData(
 
     QUIC_DBG_ASSERT(Buffer != NULL || *BufferLength == 0);
 
+    TlsContext->State = State;
+    TlsContext->ResultFlags = 0;
+
     if (DataType == QUIC_TLS_TICKET_DATA) {
-        TlsContext->ResultFlags = QUIC_TLS_RESULT_ERROR;
+        QUIC_DBG_ASSERT(TlsContext->IsServer);
+        QUIC_DBG_ASSERT(State->HandshakeComplete);
 
         QuicTraceLogConnVerbose(
-            OpenSsslIgnoringTicket,
+            OpenSslSendTicketData,
             TlsContext->Connection,
-            "Ignoring %u ticket bytes",
+            "Sending ticket data, %u bytes",
             *BufferLength);
-        goto Exit;
+
+        //
+        // Store the QUIC resumption state in the session and then write a new
+        // session ticket message for it.
+        //
+
+        if (SSL_SESSION_set1_ticket_appdata(
+                SSL_get_session(TlsContext->Ssl),
+                Buffer,
+                *BufferLength) != 1) {
+            QuicTraceEvent(
+                TlsError,
+                "[ tls][%p] ERROR, %s.",
+                TlsContext->Connection,
+                "SSL_SESSION_set1_ticket_appdata failed");
+            TlsContext->ResultFlags |= QUIC_TLS_RESULT_ERROR;
+            goto Exit;
+        }
+
+        if (SSL_new_session_ticket(TlsContext->Ssl) != 1) {
+            QuicTraceEvent(
+                TlsError,
+                "[ tls][%p] ERROR, %s.",
+                TlsContext->Connection,
+                "SSL_new_session_ticket failed");
+            TlsContext->ResultFlags |= QUIC_TLS_RESULT_ERROR;
+            goto Exit;
+        }
+
+        //
+        // The ticket is written out by the post-handshake processing below.
+        //
+        goto PostHandshake;
     }
 
     if (*BufferLength != 0) {
@@ -1006,9 +1484,6 @@ QuicTlsProcessData(
             *BufferLength);
     }
 
-    TlsContext->State = State;
-    TlsContext->ResultFlags = 0;
-
     if (SSL_provide_quic_data(
             TlsContext->Ssl,
             (OSSL_ENCRYPTION_LEVEL)TlsContext->State->ReadKey,
@@ -1083,6 +1558,12 @@ QuicTlsProcessData(
             }
         }
 
+        State->SessionResumed = SSL_session_reused(TlsContext->Ssl) == 1;
+        if (!TlsContext->IsServer &&
+            State->EarlyDataState == QUIC_TLS_EARLY_DATA_UNKNOWN) {
+            QuicTlsUpdateEarlyDataState(TlsContext);
+        }
+
         QuicTraceLogConnInfo(
             OpenSslHandshakeComplete,
             TlsContext->Connection,
@@ -1114,8 +1595,24 @@ QuicTlsProcessData(
                 goto Exit;
             }
         }
+
+    } else {
+        //
+        // Process any post-handshake messages, such as session tickets.
+        //
+        if (SSL_process_quic_post_handshake(TlsContext->Ssl) != 1) {
+            QuicTraceLogConnError(
+                OpenSslHandshakeErrorStr,
+                TlsContext->Connection,
+                "TLS handshake error: %s",
+                ERR_error_string(ERR_get_error(), NULL));
+            TlsContext->ResultFlags |= QUIC_TLS_RESULT_ERROR;
+        }
+        goto Exit;
     }
 
+PostHandshake:
+
     Ret = SSL_do_handshake(TlsContext->Ssl);
     if (Ret != 1) {
         Err = SSL_get_error(TlsContext->Ssl, Ret);
@@ -1147,6 +1644,15 @@ QuicTlsProcessData(
 Exit:
 
     if (!(TlsContext->ResultFlags & QUIC_TLS_RESULT_ERROR)) {
+        if (TlsContext->IsServer &&
+            State->EarlyDataState == QUIC_TLS_EARLY_DATA_UNKNOWN &&
+            State->WriteKeys[QUIC_PACKET_KEY_HANDSHAKE] != NULL) {
+            //
+            // The server decides on early data while processing the client
+            // hello, so it's known once the handshake keys are available.
+            //
+            QuicTlsUpdateEarlyDataState(TlsContext);
+        }
         if (State->WriteKeys[QUIC_PACKET_KEY_HANDSHAKE] != NULL &&
             State->BufferOffsetHandshake == 0) {
             State->BufferOffsetHandshake = State->BufferTotalLength;
@@ -1603,6 +2109,9 @@ QuicPacketKeyFree(
 {
     if (Key != NULL) {
         QuicKeyFree(Key->PacketKey);
+        for (uint8_t i = 0; i < QUIC_PACKET_KEY_MAX_DUPLICATES; ++i) {
+            QuicKeyFree(Key->PacketKeyDuplicates[i]);
+        }
         QuicHpKeyFree(Key->HeaderKey);
         if (Key->Type >= QUIC_PACKET_KEY_1_RTT) {
             QuicSecureZeroMemory(Key->TrafficSecret, sizeof(QUIC_SECRET));
@@ -1742,6 +2251,44 @@ QuicKeyFree(
     EVP_CIPHER_CTX_free((EVP_CIPHER_CTX*)Key);
 }
 
+QUIC_STATUS
+QuicKeyDuplicate(
+    _In_ QUIC_KEY* Key,
+    _Out_ QUIC_KEY** NewKey
+    )
+{
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+
+    EVP_CIPHER_CTX* CipherCtx = EVP_CIPHER_CTX_new();
+    if (CipherCtx == NULL) {
+        QuicTraceEvent(
+            LibraryError,
+            "[ lib] ERROR, %s.",
+            "EVP_CIPHER_CTX_new failed");
+        Status = QUIC_STATUS_OUT_OF_MEMORY;
+        goto Exit;
+    }
+
+    if (EVP_CIPHER_CTX_copy(CipherCtx, (EVP_CIPHER_CTX*)Key) != 1) {
+        QuicTraceEvent(
+            LibraryErrorStatus,
+            "[ lib] ERROR, %u, %s.",
+            ERR_get_error(),
+            "EVP_CIPHER_CTX_copy failed");
+        Status = QUIC_STATUS_TLS_ERROR;
+        goto Exit;
+    }
+
+    *NewKey = (QUIC_KEY*)CipherCtx;
+    CipherCtx = NULL;
+
+Exit:
+
+    QuicKeyFree((QUIC_KEY*)CipherCtx);
+
+    return Status;
+}
+
 QUIC_STATUS
 QuicEncrypt(
     _In_ QUIC_KEY* Key,
@@ -2997,6 +2997,9 @@ QuicPacketKeyFree(
 {
     if (Key != NULL) {
         QuicKeyFree(Key->PacketKey);
+        for (uint8_t i = 0; i < QUIC_PACKET_KEY_MAX_DUPLICATES; ++i) {
+            QuicKeyFree(Key->PacketKeyDuplicates[i]);
+        }
         QuicHpKeyFree(Key->HeaderKey);
         if (Key->Type >= QUIC_PACKET_KEY_1_RTT) {
             RtlSecureZeroMemory(Key->TrafficSecret, sizeof(QUIC_SECRET));
@@ -3128,6 +3131,31 @@ QuicKeyFree(
     }
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QuicKeyDuplicate(
+    _In_ QUIC_KEY* Key,
+    _Out_ QUIC_KEY** NewKey
+    )
+{
+    NTSTATUS Status =
+        BCryptDuplicateKey(
+            (BCRYPT_KEY_HANDLE)Key,
+            (BCRYPT_KEY_HANDLE*)NewKey,
+            NULL, // Let BCrypt manage the memory for this key.
+            0,
+            0);
+    if (!NT_SUCCESS(Status)) {
+        QuicTraceEvent(
+            LibraryErrorStatus,
+            "[ lib] ERROR, %u, %s.",
+            Status,
+            "BCryptDuplicateKey");
+    }
+
+    return NtStatusToQuicStatus(Status);
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
 QuicEncrypt(
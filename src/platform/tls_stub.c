@@ -1291,6 +1291,9 @@ QuicPacketKeyFree(
 {
     if (Key != NULL) {
         QuicKeyFree(Key->PacketKey);
+        for (uint8_t i = 0; i < QUIC_PACKET_KEY_MAX_DUPLICATES; ++i) {
+            QuicKeyFree(Key->PacketKeyDuplicates[i]);
+        }
         QUIC_FREE(Key, QUIC_POOL_TLS_PACKETKEY);
     }
 }
@@ -1343,6 +1346,20 @@ QuicKeyFree(
     }
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QuicKeyDuplicate(
+    _In_ QUIC_KEY* Key,
+    _Out_ QUIC_KEY** NewKey
+    )
+{
+    QUIC_KEY *Copy = QUIC_ALLOC_NONPAGED(sizeof(QUIC_KEY), QUIC_POOL_TLS_KEY);
+    QUIC_FRE_ASSERT(Copy != NULL);
+    Copy->Secret = Key->Secret;
+    *NewKey = Copy;
+    return QUIC_STATUS_SUCCESS;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
 QuicEncrypt(
@@ -448,6 +448,103 @@ TEST_P(CryptTest, Encryption)
     ASSERT_FALSE(Key.Decrypt(Iv, sizeof(AuthData), AuthData, sizeof(Buffer), Buffer));
 }
 
+TEST_P(CryptTest, EncryptionBatch)
+{
+    const uint8_t BatchSize = 8;
+
+    int AEAD = GetParam();
+
+    uint8_t RawKey[32] = {0};
+    uint8_t Iv[BatchSize][QUIC_IV_LENGTH];
+    uint8_t AuthData[BatchSize][12];
+    uint8_t Buffer[BatchSize][128];
+    uint8_t Expected[BatchSize][128];
+    QUIC_CRYPT_BATCH_ENTRY Batch[BatchSize];
+
+    QuicKey Key((QUIC_AEAD_TYPE)AEAD, RawKey);
+    if (Key.Ptr == NULL) return;
+
+    for (uint8_t i = 0; i < BatchSize; ++i) {
+        memset(Iv[i], i, sizeof(Iv[i]));
+        memset(AuthData[i], 0x80 | i, sizeof(AuthData[i]));
+        memset(Buffer[i], 0x40 | i, sizeof(Buffer[i]));
+        memcpy(Expected[i], Buffer[i], sizeof(Buffer[i]));
+        ASSERT_TRUE(Key.Encrypt(Iv[i], sizeof(AuthData[i]), AuthData[i], sizeof(Expected[i]), Expected[i]));
+
+        Batch[i].Iv = Iv[i];
+        Batch[i].AuthData = AuthData[i];
+        Batch[i].AuthDataLength = sizeof(AuthData[i]);
+        Batch[i].Buffer = Buffer[i];
+        Batch[i].BufferLength = sizeof(Buffer[i]);
+    }
+
+    //
+    // The batch must produce the same output as individual encryption.
+    //
+
+    VERIFY_QUIC_SUCCESS(QuicEncryptBatch(Key.Ptr, BatchSize, Batch));
+    for (uint8_t i = 0; i < BatchSize; ++i) {
+        VERIFY_QUIC_SUCCESS(Batch[i].Status);
+        ASSERT_EQ(0, memcmp(Expected[i], Buffer[i], sizeof(Buffer[i])));
+    }
+
+    //
+    // A corrupt packet only fails its own entry.
+    //
+
+    Buffer[3][0] ^= 1;
+    ASSERT_TRUE(QUIC_FAILED(QuicDecryptBatch(Key.Ptr, BatchSize, Batch)));
+    for (uint8_t i = 0; i < BatchSize; ++i) {
+        if (i == 3) {
+            ASSERT_TRUE(QUIC_FAILED(Batch[i].Status));
+        } else {
+            VERIFY_QUIC_SUCCESS(Batch[i].Status);
+            for (uint16_t j = 0; j < sizeof(Buffer[i]) - QUIC_ENCRYPTION_OVERHEAD; ++j) {
+                ASSERT_EQ(0x40 | i, Buffer[i][j]);
+            }
+        }
+    }
+}
+
+TEST_P(CryptTest, KeyDuplicate)
+{
+    int AEAD = GetParam();
+
+    uint8_t RawKey[32];
+    uint8_t Iv[QUIC_IV_LENGTH];
+    uint8_t AuthData[12];
+    uint8_t Buffer[128];
+    uint8_t Expected[128];
+
+    QuicRandom(sizeof(RawKey), RawKey);
+    QuicRandom(sizeof(Iv), Iv);
+    QuicRandom(sizeof(AuthData), AuthData);
+    QuicRandom(sizeof(Buffer), Buffer);
+    memcpy(Expected, Buffer, sizeof(Buffer));
+
+    QuicKey Key((QUIC_AEAD_TYPE)AEAD, RawKey);
+    if (Key.Ptr == NULL) return;
+
+    QUIC_KEY* Copy = nullptr;
+    VERIFY_QUIC_SUCCESS(QuicKeyDuplicate(Key.Ptr, &Copy));
+    ASSERT_NE(nullptr, Copy);
+
+    //
+    // Both keys must produce the same output, and each must be able to
+    // decrypt what the other encrypted.
+    //
+
+    ASSERT_TRUE(Key.Encrypt(Iv, sizeof(AuthData), AuthData, sizeof(Expected), Expected));
+    VERIFY_QUIC_SUCCESS(QuicEncrypt(Copy, Iv, sizeof(AuthData), AuthData, sizeof(Buffer), Buffer));
+    ASSERT_EQ(0, memcmp(Expected, Buffer, sizeof(Buffer)));
+
+    VERIFY_QUIC_SUCCESS(QuicDecrypt(Copy, Iv, sizeof(AuthData), AuthData, sizeof(Expected), Expected));
+    ASSERT_TRUE(Key.Decrypt(Iv, sizeof(AuthData), AuthData, sizeof(Buffer), Buffer));
+    ASSERT_EQ(0, memcmp(Expected, Buffer, sizeof(Buffer) - QUIC_ENCRYPTION_OVERHEAD));
+
+    QuicKeyFree(Copy);
+}
+
 TEST_P(CryptTest, HashWellKnown)
 {
     int HASH = GetParam();
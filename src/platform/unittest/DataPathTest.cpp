@@ -75,6 +75,20 @@ struct DataRecvContext {
     QUIC_EVENT ClientCompletion;
 };
 
+struct SegmentedRecvContext {
+    QUIC_EVENT ServerCompletion;
+    volatile long RecvCount;
+    long ExpectedCount;
+};
+
+struct SteeringRecvContext {
+    QUIC_EVENT ServerCompletion;
+    uint16_t PartitionCount;
+    volatile long RecvCount;
+    long ExpectedCount;
+    volatile long MisroutedCount;
+};
+
 struct DataPathTest : public ::testing::TestWithParam<int32_t>
 {
 protected:
@@ -264,6 +278,67 @@ protected:
 
         QuicDataPathBindingReturnRecvDatagrams(recvBufferChain);
     }
+
+    static void
+    SegmentedRecvCallback(
+        _In_ QUIC_DATAPATH_BINDING* /* Binding */,
+        _In_ void * recvContext,
+        _In_ QUIC_RECV_DATAGRAM* recvBufferChain
+        )
+    {
+        SegmentedRecvContext* RecvContext = (SegmentedRecvContext*)recvContext;
+        ASSERT_NE(nullptr, RecvContext);
+
+        QUIC_RECV_DATAGRAM* recvBuffer = recvBufferChain;
+
+        while (recvBuffer != NULL) {
+            ASSERT_EQ(recvBuffer->BufferLength, ExpectedDataSize);
+            ASSERT_EQ(0, memcmp(recvBuffer->Buffer, ExpectedData, ExpectedDataSize));
+
+            if (InterlockedIncrement(&RecvContext->RecvCount) == RecvContext->ExpectedCount) {
+                QuicEventSet(RecvContext->ServerCompletion);
+            }
+
+            recvBuffer = recvBuffer->Next;
+        }
+
+        QuicDataPathBindingReturnRecvDatagrams(recvBufferChain);
+    }
+
+    static void
+    SteeringRecvCallback(
+        _In_ QUIC_DATAPATH_BINDING* /* Binding */,
+        _In_ void * recvContext,
+        _In_ QUIC_RECV_DATAGRAM* recvBufferChain
+        )
+    {
+        SteeringRecvContext* RecvContext = (SteeringRecvContext*)recvContext;
+        ASSERT_NE(nullptr, RecvContext);
+
+        QUIC_RECV_DATAGRAM* recvBuffer = recvBufferChain;
+
+        while (recvBuffer != NULL) {
+            //
+            // Short header packets must arrive on the processor encoded in
+            // their partition ID. Long header packets can arrive anywhere.
+            //
+            if (!(recvBuffer->Buffer[0] & 0x80)) {
+                uint16_t PartitionId;
+                memcpy(&PartitionId, recvBuffer->Buffer + 1, sizeof(PartitionId));
+                if (recvBuffer->PartitionIndex != PartitionId % RecvContext->PartitionCount) {
+                    InterlockedIncrement(&RecvContext->MisroutedCount);
+                }
+            }
+
+            if (InterlockedIncrement(&RecvContext->RecvCount) == RecvContext->ExpectedCount) {
+                QuicEventSet(RecvContext->ServerCompletion);
+            }
+
+            recvBuffer = recvBuffer->Next;
+        }
+
+        QuicDataPathBindingReturnRecvDatagrams(recvBufferChain);
+    }
 };
 
 volatile uint16_t DataPathTest::NextPort;
@@ -329,6 +404,7 @@ TEST_F(DataPathTest, Bind)
             nullptr,
             nullptr,
             nullptr,
+            QUIC_DATAPATH_BINDING_FLAG_NONE,
             &binding));
     ASSERT_NE(nullptr, binding);
 
@@ -362,6 +438,7 @@ TEST_F(DataPathTest, Rebind)
             nullptr,
             nullptr,
             nullptr,
+            QUIC_DATAPATH_BINDING_FLAG_NONE,
             &binding1));
     ASSERT_NE(nullptr, binding1);
 
@@ -375,6 +452,7 @@ TEST_F(DataPathTest, Rebind)
             nullptr,
             nullptr,
             nullptr,
+            QUIC_DATAPATH_BINDING_FLAG_NONE,
             &binding2));
     ASSERT_NE(nullptr, binding2);
 
@@ -389,6 +467,44 @@ TEST_F(DataPathTest, Rebind)
         datapath);
 }
 
+TEST_F(DataPathTest, BindDeleteMany)
+{
+    //
+    // Every binding has receives posted on it (on the io_uring path, in the
+    // kernel), which must all be canceled for the delete to complete.
+    //
+    const uint32_t BindingCount = 64;
+    QUIC_DATAPATH* datapath = nullptr;
+    QUIC_DATAPATH_BINDING* bindings[BindingCount] = {};
+
+    VERIFY_QUIC_SUCCESS(
+        QuicDataPathInitialize(
+            0,
+            EmptyReceiveCallback,
+            EmptyUnreachableCallback,
+            &datapath));
+    ASSERT_NE(nullptr, datapath);
+
+    for (uint32_t i = 0; i < BindingCount; ++i) {
+        VERIFY_QUIC_SUCCESS(
+            QuicDataPathBindingCreate(
+                datapath,
+                nullptr,
+                nullptr,
+                nullptr,
+                QUIC_DATAPATH_BINDING_FLAG_NONE,
+                &bindings[i]));
+        ASSERT_NE(nullptr, bindings[i]);
+    }
+
+    for (uint32_t i = 0; i < BindingCount; ++i) {
+        QuicDataPathBindingDelete(bindings[i]);
+    }
+
+    QuicDataPathUninitialize(
+        datapath);
+}
+
 TEST_P(DataPathTest, Data)
 {
     QUIC_DATAPATH* datapath = nullptr;
@@ -417,6 +533,94 @@ TEST_P(DataPathTest, Data)
                 &serverAddress.SockAddr,
                 nullptr,
                 &RecvContext,
+                QUIC_DATAPATH_BINDING_FLAG_NONE,
+                &server);
+#ifdef _WIN32
+        if (Status == HRESULT_FROM_WIN32(WSAEACCES)) {
+            Status = QUIC_STATUS_ADDRESS_IN_USE;
+            std::cout << "Replacing EACCESS with ADDRINUSE for port: " <<
+                htons(serverAddress.SockAddr.Ipv4.sin_port) << std::endl;
+        }
+#endif //_WIN32
+    }
+    VERIFY_QUIC_SUCCESS(Status);
+    ASSERT_NE(nullptr, server);
+    QuicDataPathBindingGetLocalAddress(server, &RecvContext.ServerAddress);
+    ASSERT_NE(RecvContext.ServerAddress.Ipv4.sin_port, (uint16_t)0);
+    serverAddress.SetPort(RecvContext.ServerAddress.Ipv4.sin_port);
+
+    VERIFY_QUIC_SUCCESS(
+        QuicDataPathBindingCreate(
+            datapath,
+            nullptr,
+            &serverAddress.SockAddr,
+            &RecvContext,
+            QUIC_DATAPATH_BINDING_FLAG_NONE,
+            &client));
+    ASSERT_NE(nullptr, client);
+
+    auto ClientSendContext =
+        QuicDataPathBindingAllocSendContext(client, QUIC_ECN_NON_ECT, 0);
+    ASSERT_NE(nullptr, ClientSendContext);
+
+    auto ClientDatagram =
+        QuicDataPathBindingAllocSendDatagram(ClientSendContext, ExpectedDataSize);
+    ASSERT_NE(nullptr, ClientDatagram);
+
+    memcpy(ClientDatagram->Buffer, ExpectedData, ExpectedDataSize);
+
+    QUIC_ADDR ClientAddress;
+    QuicDataPathBindingGetLocalAddress(client, &ClientAddress);
+
+    VERIFY_QUIC_SUCCESS(
+        QuicDataPathBindingSend(
+            client,
+            &ClientAddress,
+            &serverAddress.SockAddr,
+            ClientSendContext));
+
+    ASSERT_TRUE(QuicEventWaitWithTimeout(RecvContext.ClientCompletion, 2000));
+
+    QuicDataPathBindingDelete(client);
+    QuicDataPathBindingDelete(server);
+
+    QuicDataPathUninitialize(
+        datapath);
+
+    QuicEventUninitialize(RecvContext.ClientCompletion);
+}
+
+TEST_P(DataPathTest, DataSpinPolling)
+{
+    QUIC_DATAPATH* datapath = nullptr;
+    QUIC_DATAPATH_BINDING* server = nullptr;
+    QUIC_DATAPATH_BINDING* client = nullptr;
+    auto serverAddress = GetNewLocalAddr();
+
+    DataRecvContext RecvContext = {};
+
+    QuicEventInitialize(&RecvContext.ClientCompletion, FALSE, FALSE);
+
+    VERIFY_QUIC_SUCCESS(
+        QuicDataPathInitialize(
+            0,
+            DataRecvCallback,
+            EmptyUnreachableCallback,
+            &datapath));
+    ASSERT_NE(nullptr, datapath);
+
+    QuicDataPathSetPolling(datapath, 1000, 50);
+
+    QUIC_STATUS Status = QUIC_STATUS_ADDRESS_IN_USE;
+    while (Status == QUIC_STATUS_ADDRESS_IN_USE) {
+        serverAddress.SockAddr.Ipv4.sin_port = GetNextPort();
+        Status =
+            QuicDataPathBindingCreate(
+                datapath,
+                &serverAddress.SockAddr,
+                nullptr,
+                &RecvContext,
+                QUIC_DATAPATH_BINDING_FLAG_NONE,
                 &server);
 #ifdef _WIN32
         if (Status == HRESULT_FROM_WIN32(WSAEACCES)) {
@@ -438,6 +642,7 @@ TEST_P(DataPathTest, Data)
             nullptr,
             &serverAddress.SockAddr,
             &RecvContext,
+            QUIC_DATAPATH_BINDING_FLAG_NONE,
             &client));
     ASSERT_NE(nullptr, client);
 
@@ -463,6 +668,105 @@ TEST_P(DataPathTest, Data)
 
     ASSERT_TRUE(QuicEventWaitWithTimeout(RecvContext.ClientCompletion, 2000));
 
+    uint64_t SpinWakes, Sleeps;
+    QuicDataPathGetPollingStats(datapath, &SpinWakes, &Sleeps);
+#ifndef _WIN32
+    ASSERT_NE(0ull, SpinWakes + Sleeps);
+#endif
+
+    QuicDataPathBindingDelete(client);
+    QuicDataPathBindingDelete(server);
+
+    QuicDataPathUninitialize(
+        datapath);
+
+    QuicEventUninitialize(RecvContext.ClientCompletion);
+}
+
+TEST_P(DataPathTest, DataDepartureTime)
+{
+    QUIC_DATAPATH* datapath = nullptr;
+    QUIC_DATAPATH_BINDING* server = nullptr;
+    QUIC_DATAPATH_BINDING* client = nullptr;
+    auto serverAddress = GetNewLocalAddr();
+
+    DataRecvContext RecvContext = {};
+
+    QuicEventInitialize(&RecvContext.ClientCompletion, FALSE, FALSE);
+
+    VERIFY_QUIC_SUCCESS(
+        QuicDataPathInitialize(
+            0,
+            DataRecvCallback,
+            EmptyUnreachableCallback,
+            &datapath));
+    ASSERT_NE(nullptr, datapath);
+
+    QUIC_STATUS Status = QUIC_STATUS_ADDRESS_IN_USE;
+    while (Status == QUIC_STATUS_ADDRESS_IN_USE) {
+        serverAddress.SockAddr.Ipv4.sin_port = GetNextPort();
+        Status =
+            QuicDataPathBindingCreate(
+                datapath,
+                &serverAddress.SockAddr,
+                nullptr,
+                &RecvContext,
+                QUIC_DATAPATH_BINDING_FLAG_NONE,
+                &server);
+#ifdef _WIN32
+        if (Status == HRESULT_FROM_WIN32(WSAEACCES)) {
+            Status = QUIC_STATUS_ADDRESS_IN_USE;
+            std::cout << "Replacing EACCESS with ADDRINUSE for port: " <<
+                htons(serverAddress.SockAddr.Ipv4.sin_port) << std::endl;
+        }
+#endif //_WIN32
+    }
+    VERIFY_QUIC_SUCCESS(Status);
+    ASSERT_NE(nullptr, server);
+    QuicDataPathBindingGetLocalAddress(server, &RecvContext.ServerAddress);
+    ASSERT_NE(RecvContext.ServerAddress.Ipv4.sin_port, (uint16_t)0);
+    serverAddress.SetPort(RecvContext.ServerAddress.Ipv4.sin_port);
+
+    VERIFY_QUIC_SUCCESS(
+        QuicDataPathBindingCreate(
+            datapath,
+            nullptr,
+            &serverAddress.SockAddr,
+            &RecvContext,
+            QUIC_DATAPATH_BINDING_FLAG_NONE,
+            &client));
+    ASSERT_NE(nullptr, client);
+
+    auto ClientSendContext =
+        QuicDataPathBindingAllocSendContext(client, QUIC_ECN_NON_ECT, 0);
+    ASSERT_NE(nullptr, ClientSendContext);
+
+    auto ClientDatagram =
+        QuicDataPathBindingAllocSendDatagram(ClientSendContext, ExpectedDataSize);
+    ASSERT_NE(nullptr, ClientDatagram);
+
+    memcpy(ClientDatagram->Buffer, ExpectedData, ExpectedDataSize);
+
+    //
+    // Loopback doesn't use a qdisc that honors departure times, but the send
+    // must still succeed when one is set.
+    //
+    QuicDataPathBindingSetSendDepartureTime(
+        ClientSendContext,
+        QuicTimeUs64() + 1000);
+
+    QUIC_ADDR ClientAddress;
+    QuicDataPathBindingGetLocalAddress(client, &ClientAddress);
+
+    VERIFY_QUIC_SUCCESS(
+        QuicDataPathBindingSend(
+            client,
+            &ClientAddress,
+            &serverAddress.SockAddr,
+            ClientSendContext));
+
+    ASSERT_TRUE(QuicEventWaitWithTimeout(RecvContext.ClientCompletion, 2000));
+
     QuicDataPathBindingDelete(client);
     QuicDataPathBindingDelete(server);
 
@@ -500,6 +804,7 @@ TEST_P(DataPathTest, DataRebind)
                 &serverAddress.SockAddr,
                 nullptr,
                 &RecvContext,
+                QUIC_DATAPATH_BINDING_FLAG_NONE,
                 &server);
 #ifdef _WIN32
         if (Status == HRESULT_FROM_WIN32(WSAEACCES)) {
@@ -521,6 +826,7 @@ TEST_P(DataPathTest, DataRebind)
             nullptr,
             &serverAddress.SockAddr,
             &RecvContext,
+            QUIC_DATAPATH_BINDING_FLAG_NONE,
             &client));
     ASSERT_NE(nullptr, client);
 
@@ -556,6 +862,7 @@ TEST_P(DataPathTest, DataRebind)
             nullptr,
             &serverAddress.SockAddr,
             &RecvContext,
+            QUIC_DATAPATH_BINDING_FLAG_NONE,
             &client));
     ASSERT_NE(nullptr, client);
 
@@ -617,6 +924,7 @@ TEST_P(DataPathTest, DataECT0)
                 &serverAddress.SockAddr,
                 nullptr,
                 &RecvContext,
+                QUIC_DATAPATH_BINDING_FLAG_NONE,
                 &server);
 #ifdef _WIN32
         if (Status == HRESULT_FROM_WIN32(WSAEACCES)) {
@@ -638,6 +946,7 @@ TEST_P(DataPathTest, DataECT0)
             nullptr,
             &serverAddress.SockAddr,
             &RecvContext,
+            QUIC_DATAPATH_BINDING_FLAG_NONE,
             &client));
     ASSERT_NE(nullptr, client);
 
@@ -672,4 +981,352 @@ TEST_P(DataPathTest, DataECT0)
     QuicEventUninitialize(RecvContext.ClientCompletion);
 }
 
+TEST_P(DataPathTest, DataSegmented)
+{
+    const long MaxSegmentCount = 8;
+    QUIC_DATAPATH* datapath = nullptr;
+    QUIC_DATAPATH_BINDING* server = nullptr;
+    QUIC_DATAPATH_BINDING* client = nullptr;
+    auto serverAddress = GetNewLocalAddr();
+
+    SegmentedRecvContext RecvContext = {};
+
+    QuicEventInitialize(&RecvContext.ServerCompletion, FALSE, FALSE);
+
+    VERIFY_QUIC_SUCCESS(
+        QuicDataPathInitialize(
+            0,
+            SegmentedRecvCallback,
+            EmptyUnreachableCallback,
+            &datapath));
+    ASSERT_NE(nullptr, datapath);
+
+    QUIC_STATUS Status = QUIC_STATUS_ADDRESS_IN_USE;
+    while (Status == QUIC_STATUS_ADDRESS_IN_USE) {
+        serverAddress.SockAddr.Ipv4.sin_port = GetNextPort();
+        Status =
+            QuicDataPathBindingCreate(
+                datapath,
+                &serverAddress.SockAddr,
+                nullptr,
+                &RecvContext,
+                QUIC_DATAPATH_BINDING_FLAG_NONE,
+                &server);
+#ifdef _WIN32
+        if (Status == HRESULT_FROM_WIN32(WSAEACCES)) {
+            Status = QUIC_STATUS_ADDRESS_IN_USE;
+            std::cout << "Replacing EACCESS with ADDRINUSE for port: " <<
+                htons(serverAddress.SockAddr.Ipv4.sin_port) << std::endl;
+        }
+#endif //_WIN32
+    }
+    VERIFY_QUIC_SUCCESS(Status);
+    ASSERT_NE(nullptr, server);
+
+    QUIC_ADDR ServerAddress;
+    QuicDataPathBindingGetLocalAddress(server, &ServerAddress);
+    ASSERT_NE(ServerAddress.Ipv4.sin_port, (uint16_t)0);
+    serverAddress.SetPort(ServerAddress.Ipv4.sin_port);
+
+    VERIFY_QUIC_SUCCESS(
+        QuicDataPathBindingCreate(
+            datapath,
+            nullptr,
+            &serverAddress.SockAddr,
+            &RecvContext,
+            QUIC_DATAPATH_BINDING_FLAG_NONE,
+            &client));
+    ASSERT_NE(nullptr, client);
+
+    //
+    // Fill as many equally sized datagrams as the send context allows. With
+    // send segmentation support these all go out in a single send call.
+    //
+    auto ClientSendContext =
+        QuicDataPathBindingAllocSendContext(client, QUIC_ECN_NON_ECT, ExpectedDataSize);
+    ASSERT_NE(nullptr, ClientSendContext);
+
+    do {
+        auto ClientDatagram =
+            QuicDataPathBindingAllocSendDatagram(ClientSendContext, ExpectedDataSize);
+        ASSERT_NE(nullptr, ClientDatagram);
+        memcpy(ClientDatagram->Buffer, ExpectedData, ExpectedDataSize);
+        RecvContext.ExpectedCount++;
+    } while (RecvContext.ExpectedCount < MaxSegmentCount &&
+             !QuicDataPathBindingIsSendContextFull(ClientSendContext));
+
+    if (QuicDataPathGetSupportedFeatures(datapath) & QUIC_DATAPATH_FEATURE_SEND_SEGMENTATION) {
+        ASSERT_EQ(MaxSegmentCount, RecvContext.ExpectedCount);
+    }
+
+    QUIC_ADDR ClientAddress;
+    QuicDataPathBindingGetLocalAddress(client, &ClientAddress);
+
+    VERIFY_QUIC_SUCCESS(
+        QuicDataPathBindingSend(
+            client,
+            &ClientAddress,
+            &serverAddress.SockAddr,
+            ClientSendContext));
+
+    ASSERT_TRUE(QuicEventWaitWithTimeout(RecvContext.ServerCompletion, 2000));
+
+    QuicDataPathBindingDelete(client);
+    QuicDataPathBindingDelete(server);
+
+    QuicDataPathUninitialize(
+        datapath);
+
+    QuicEventUninitialize(RecvContext.ServerCompletion);
+}
+
+TEST_P(DataPathTest, DataZeroCopy)
+{
+    const long MaxSegmentCount = 32;
+    QUIC_DATAPATH* datapath = nullptr;
+    QUIC_DATAPATH_BINDING* server = nullptr;
+    QUIC_DATAPATH_BINDING* client = nullptr;
+    auto serverAddress = GetNewLocalAddr();
+
+    SegmentedRecvContext RecvContext = {};
+
+    QuicEventInitialize(&RecvContext.ServerCompletion, FALSE, FALSE);
+
+    VERIFY_QUIC_SUCCESS(
+        QuicDataPathInitialize(
+            0,
+            SegmentedRecvCallback,
+            EmptyUnreachableCallback,
+            &datapath));
+    ASSERT_NE(nullptr, datapath);
+
+    QuicDataPathSetZeroCopySend(datapath, TRUE);
+
+    QUIC_STATUS Status = QUIC_STATUS_ADDRESS_IN_USE;
+    while (Status == QUIC_STATUS_ADDRESS_IN_USE) {
+        serverAddress.SockAddr.Ipv4.sin_port = GetNextPort();
+        Status =
+            QuicDataPathBindingCreate(
+                datapath,
+                &serverAddress.SockAddr,
+                nullptr,
+                &RecvContext,
+                QUIC_DATAPATH_BINDING_FLAG_NONE,
+                &server);
+#ifdef _WIN32
+        if (Status == HRESULT_FROM_WIN32(WSAEACCES)) {
+            Status = QUIC_STATUS_ADDRESS_IN_USE;
+            std::cout << "Replacing EACCESS with ADDRINUSE for port: " <<
+                htons(serverAddress.SockAddr.Ipv4.sin_port) << std::endl;
+        }
+#endif //_WIN32
+    }
+    VERIFY_QUIC_SUCCESS(Status);
+    ASSERT_NE(nullptr, server);
+
+    QUIC_ADDR ServerAddress;
+    QuicDataPathBindingGetLocalAddress(server, &ServerAddress);
+    ASSERT_NE(ServerAddress.Ipv4.sin_port, (uint16_t)0);
+    serverAddress.SetPort(ServerAddress.Ipv4.sin_port);
+
+    VERIFY_QUIC_SUCCESS(
+        QuicDataPathBindingCreate(
+            datapath,
+            nullptr,
+            &serverAddress.SockAddr,
+            &RecvContext,
+            QUIC_DATAPATH_BINDING_FLAG_NONE,
+            &client));
+    ASSERT_NE(nullptr, client);
+
+    //
+    // Fill enough datagrams for the segmented send to be large enough to be
+    // done without copying, if supported. Loopback makes the kernel copy the
+    // data anyway, but the completion must still release the send.
+    //
+    auto ClientSendContext =
+        QuicDataPathBindingAllocSendContext(client, QUIC_ECN_NON_ECT, ExpectedDataSize);
+    ASSERT_NE(nullptr, ClientSendContext);
+
+    do {
+        auto ClientDatagram =
+            QuicDataPathBindingAllocSendDatagram(ClientSendContext, ExpectedDataSize);
+        ASSERT_NE(nullptr, ClientDatagram);
+        memcpy(ClientDatagram->Buffer, ExpectedData, ExpectedDataSize);
+        RecvContext.ExpectedCount++;
+    } while (RecvContext.ExpectedCount < MaxSegmentCount &&
+             !QuicDataPathBindingIsSendContextFull(ClientSendContext));
+
+    if (QuicDataPathGetSupportedFeatures(datapath) & QUIC_DATAPATH_FEATURE_SEND_SEGMENTATION) {
+        ASSERT_EQ(MaxSegmentCount, RecvContext.ExpectedCount);
+    }
+
+    QUIC_ADDR ClientAddress;
+    QuicDataPathBindingGetLocalAddress(client, &ClientAddress);
+
+    VERIFY_QUIC_SUCCESS(
+        QuicDataPathBindingSend(
+            client,
+            &ClientAddress,
+            &serverAddress.SockAddr,
+            ClientSendContext));
+
+    ASSERT_TRUE(QuicEventWaitWithTimeout(RecvContext.ServerCompletion, 2000));
+
+    QuicDataPathBindingDelete(client);
+    QuicDataPathBindingDelete(server);
+
+    QuicDataPathUninitialize(
+        datapath);
+
+    QuicEventUninitialize(RecvContext.ServerCompletion);
+}
+
+TEST_P(DataPathTest, DataCidSteering)
+{
+    const uint16_t DatagramLength = 64;
+    QUIC_DATAPATH* datapath = nullptr;
+    QUIC_DATAPATH_BINDING* server = nullptr;
+    QUIC_DATAPATH_BINDING* client = nullptr;
+    auto serverAddress = GetNewLocalAddr();
+
+    SteeringRecvContext RecvContext = {};
+    RecvContext.PartitionCount = (uint16_t)min(QuicProcMaxCount(), 16);
+
+    QuicEventInitialize(&RecvContext.ServerCompletion, FALSE, FALSE);
+
+    VERIFY_QUIC_SUCCESS(
+        QuicDataPathInitialize(
+            0,
+            SteeringRecvCallback,
+            EmptyUnreachableCallback,
+            &datapath));
+    ASSERT_NE(nullptr, datapath);
+
+    if (!(QuicDataPathGetSupportedFeatures(datapath) & QUIC_DATAPATH_FEATURE_CID_STEERING)) {
+        QuicDataPathUninitialize(datapath);
+        QuicEventUninitialize(RecvContext.ServerCompletion);
+        GTEST_SKIP_NO_RETURN_(": CID steering unsupported");
+        return;
+    }
+
+    QUIC_STATUS Status = QUIC_STATUS_ADDRESS_IN_USE;
+    while (Status == QUIC_STATUS_ADDRESS_IN_USE) {
+        serverAddress.SockAddr.Ipv4.sin_port = GetNextPort();
+        Status =
+            QuicDataPathBindingCreate(
+                datapath,
+                &serverAddress.SockAddr,
+                nullptr,
+                &RecvContext,
+                QUIC_DATAPATH_BINDING_FLAG_CID_STEERING,
+                &server);
+    }
+    VERIFY_QUIC_SUCCESS(Status);
+    ASSERT_NE(nullptr, server);
+
+    QUIC_DATAPATH_CID_STEERING CidSteering = { 0, 0xFFFF, RecvContext.PartitionCount };
+    VERIFY_QUIC_SUCCESS(
+        QuicDataPathBindingSetParam(
+            server,
+            QUIC_DATAPATH_BINDING_PARAM_CID_STEERING,
+            sizeof(CidSteering),
+            (const uint8_t*)&CidSteering));
+
+    QUIC_ADDR ServerAddress;
+    QuicDataPathBindingGetLocalAddress(server, &ServerAddress);
+    serverAddress.SetPort(ServerAddress.Ipv4.sin_port);
+
+    VERIFY_QUIC_SUCCESS(
+        QuicDataPathBindingCreate(
+            datapath,
+            nullptr,
+            &serverAddress.SockAddr,
+            &RecvContext,
+            QUIC_DATAPATH_BINDING_FLAG_CID_STEERING,
+            &client));
+    ASSERT_NE(nullptr, client);
+
+    //
+    // The flag is ignored on bindings with a remote address.
+    //
+    ASSERT_EQ(
+        QUIC_STATUS_NOT_SUPPORTED,
+        QuicDataPathBindingSetParam(
+            client,
+            QUIC_DATAPATH_BINDING_PARAM_CID_STEERING,
+            sizeof(CidSteering),
+            (const uint8_t*)&CidSteering));
+
+    //
+    // Bindings that didn't opt in can't be steered.
+    //
+    QUIC_DATAPATH_BINDING* unsteered = nullptr;
+    VERIFY_QUIC_SUCCESS(
+        QuicDataPathBindingCreate(
+            datapath,
+            nullptr,
+            nullptr,
+            &RecvContext,
+            QUIC_DATAPATH_BINDING_FLAG_NONE,
+            &unsteered));
+    ASSERT_NE(nullptr, unsteered);
+    ASSERT_EQ(
+        QUIC_STATUS_NOT_SUPPORTED,
+        QuicDataPathBindingSetParam(
+            unsteered,
+            QUIC_DATAPATH_BINDING_PARAM_CID_STEERING,
+            sizeof(CidSteering),
+            (const uint8_t*)&CidSteering));
+    QuicDataPathBindingDelete(unsteered);
+
+    QUIC_ADDR ClientAddress;
+    QuicDataPathBindingGetLocalAddress(client, &ClientAddress);
+
+    //
+    // Send one short header packet per partition, with random high bits in
+    // the partition ID, followed by a long header packet.
+    //
+    RecvContext.ExpectedCount = RecvContext.PartitionCount + 1;
+    for (long i = 0; i < RecvContext.ExpectedCount; ++i) {
+        auto ClientSendContext =
+            QuicDataPathBindingAllocSendContext(client, QUIC_ECN_NON_ECT, 0);
+        ASSERT_NE(nullptr, ClientSendContext);
+
+        auto ClientDatagram =
+            QuicDataPathBindingAllocSendDatagram(ClientSendContext, DatagramLength);
+        ASSERT_NE(nullptr, ClientDatagram);
+
+        QuicRandom(DatagramLength, ClientDatagram->Buffer);
+        if (i < RecvContext.PartitionCount) {
+            uint16_t PartitionId;
+            memcpy(&PartitionId, ClientDatagram->Buffer + 1, sizeof(PartitionId));
+            PartitionId =
+                (uint16_t)(PartitionId - PartitionId % RecvContext.PartitionCount + i);
+            memcpy(ClientDatagram->Buffer + 1, &PartitionId, sizeof(PartitionId));
+            ClientDatagram->Buffer[0] = 0x40;
+        } else {
+            ClientDatagram->Buffer[0] = 0xC0;
+        }
+
+        VERIFY_QUIC_SUCCESS(
+            QuicDataPathBindingSend(
+                client,
+                &ClientAddress,
+                &serverAddress.SockAddr,
+                ClientSendContext));
+    }
+
+    ASSERT_TRUE(QuicEventWaitWithTimeout(RecvContext.ServerCompletion, 2000));
+    ASSERT_EQ(0, RecvContext.MisroutedCount);
+
+    QuicDataPathBindingDelete(client);
+    QuicDataPathBindingDelete(server);
+
+    QuicDataPathUninitialize(
+        datapath);
+
+    QuicEventUninitialize(RecvContext.ServerCompletion);
+}
+
 INSTANTIATE_TEST_SUITE_P(DataPathTest, DataPathTest, ::testing::Values(4, 6), testing::PrintToStringParamName());
@@ -0,0 +1,119 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+--*/
+
+#include "main.h"
+#ifdef QUIC_CLOG
+#include "HashtableTest.cpp.clog.h"
+#endif
+
+#define HASHTABLE_TEST_ENTRY_COUNT 65536
+
+struct HashtableTestEntry {
+    QUIC_HASHTABLE_ENTRY TableEntry;
+    QUIC_ADDR Address;
+};
+
+struct HashtableTest : public ::testing::Test
+{
+    QUIC_HASHTABLE Table;
+    HashtableTestEntry* Entries {nullptr};
+
+    void SetUp() override {
+        ASSERT_TRUE(QuicHashtableInitializeEx(&Table, QUIC_HASH_MIN_SIZE));
+        Entries = new(std::nothrow) HashtableTestEntry[HASHTABLE_TEST_ENTRY_COUNT];
+        ASSERT_NE(nullptr, Entries);
+        for (uint32_t i = 0; i < HASHTABLE_TEST_ENTRY_COUNT; ++i) {
+            QuicZeroMemory(&Entries[i].Address, sizeof(QUIC_ADDR));
+            QuicAddrSetFamily(&Entries[i].Address, QUIC_ADDRESS_FAMILY_INET);
+            Entries[i].Address.Ipv4.sin_addr.s_addr = htonl(0x0A000000 | (i >> 8));
+            QuicAddrSetPort(&Entries[i].Address, (uint16_t)(4433 + (i & 0xFF)));
+        }
+    }
+
+    void TearDown() override {
+        delete [] Entries;
+        QuicHashtableUninitialize(&Table);
+    }
+
+    //
+    // Mirrors how the library maintains its binding table.
+    //
+    void Insert(HashtableTestEntry* Entry) {
+        QuicHashtableInsert(
+            &Table, &Entry->TableEntry, QuicAddrHash(&Entry->Address), NULL);
+        if (Table.NumEntries > Table.TableSize) {
+            ASSERT_TRUE(QuicHashTableExpand(&Table));
+        }
+    }
+
+    void Remove(HashtableTestEntry* Entry) {
+        QuicHashtableRemove(&Table, &Entry->TableEntry, NULL);
+        if (Table.NumEntries < Table.TableSize / 4) {
+            (void)QuicHashTableContract(&Table);
+        }
+    }
+
+    HashtableTestEntry* Lookup(const QUIC_ADDR* Address) {
+        QUIC_HASHTABLE_LOOKUP_CONTEXT Context;
+        QUIC_HASHTABLE_ENTRY* Entry =
+            QuicHashtableLookup(&Table, QuicAddrHash(Address), &Context);
+        while (Entry != NULL) {
+            HashtableTestEntry* TestEntry =
+                QUIC_CONTAINING_RECORD(Entry, HashtableTestEntry, TableEntry);
+            if (QuicAddrCompare(&TestEntry->Address, Address)) {
+                return TestEntry;
+            }
+            Entry = QuicHashtableLookupNext(&Table, &Context);
+        }
+        return nullptr;
+    }
+};
+
+TEST_F(HashtableTest, ExpandWithLoad)
+{
+    for (uint32_t i = 0; i < HASHTABLE_TEST_ENTRY_COUNT; ++i) {
+        Insert(&Entries[i]);
+    }
+    ASSERT_EQ((uint32_t)HASHTABLE_TEST_ENTRY_COUNT, Table.NumEntries);
+    ASSERT_GE(Table.TableSize, Table.NumEntries);
+    uint32_t MaxTableSize = Table.TableSize;
+
+    for (uint32_t i = 0; i < HASHTABLE_TEST_ENTRY_COUNT; ++i) {
+        ASSERT_EQ(&Entries[i], Lookup(&Entries[i].Address));
+    }
+
+    QUIC_ADDR Missing;
+    QuicZeroMemory(&Missing, sizeof(Missing));
+    QuicAddrSetFamily(&Missing, QUIC_ADDRESS_FAMILY_INET);
+    Missing.Ipv4.sin_addr.s_addr = htonl(0x0B000001);
+    QuicAddrSetPort(&Missing, 4433);
+    ASSERT_EQ(nullptr, Lookup(&Missing));
+
+    for (uint32_t i = 0; i < HASHTABLE_TEST_ENTRY_COUNT; i += 2) {
+        Remove(&Entries[i]);
+    }
+    for (uint32_t i = 0; i < HASHTABLE_TEST_ENTRY_COUNT; ++i) {
+        ASSERT_EQ(i % 2 == 0 ? nullptr : &Entries[i], Lookup(&Entries[i].Address));
+    }
+
+    for (uint32_t i = 1; i < HASHTABLE_TEST_ENTRY_COUNT; i += 2) {
+        Remove(&Entries[i]);
+    }
+    ASSERT_EQ(0u, Table.NumEntries);
+    ASSERT_LT(Table.TableSize, MaxTableSize);
+}
+
+TEST_F(HashtableTest, NoExpandWhileEnumerating)
+{
+    QUIC_HASHTABLE_ENUMERATOR Enumerator;
+    QuicHashtableEnumerateBegin(&Table, &Enumerator);
+    ASSERT_FALSE(QuicHashTableExpand(&Table));
+    QuicHashtableEnumerateEnd(&Table, &Enumerator);
+    ASSERT_TRUE(QuicHashTableExpand(&Table));
+    ASSERT_TRUE(QuicHashTableContract(&Table));
+    ASSERT_FALSE(QuicHashTableContract(&Table));
+}
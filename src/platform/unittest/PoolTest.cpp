@@ -0,0 +1,200 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+--*/
+
+#include "main.h"
+#ifdef QUIC_CLOG
+#include "PoolTest.cpp.clog.h"
+#endif
+
+#define POOL_TEST_ENTRY_SIZE    128
+#define POOL_TEST_TAG           'lPqQ' // QqPl
+
+struct PoolTest : public ::testing::Test
+{
+    QUIC_POOL Pool;
+
+    void SetUp() override {
+        QuicPoolInitialize(FALSE, POOL_TEST_ENTRY_SIZE, POOL_TEST_TAG, &Pool);
+    }
+
+    void TearDown() override {
+        QuicPoolUninitialize(&Pool);
+    }
+};
+
+TEST_F(PoolTest, AllocFree)
+{
+    void* Entries[1024];
+    for (uint32_t i = 0; i < ARRAYSIZE(Entries); ++i) {
+        Entries[i] = QuicPoolAlloc(&Pool);
+        ASSERT_NE(nullptr, Entries[i]);
+        memset(Entries[i], (int)i, POOL_TEST_ENTRY_SIZE);
+    }
+    for (uint32_t i = 0; i < ARRAYSIZE(Entries); ++i) {
+        QuicPoolFree(&Pool, Entries[i]);
+    }
+    for (uint32_t i = 0; i < ARRAYSIZE(Entries); ++i) {
+        Entries[i] = QuicPoolAlloc(&Pool);
+        ASSERT_NE(nullptr, Entries[i]);
+    }
+    for (uint32_t i = 0; i < ARRAYSIZE(Entries); ++i) {
+        QuicPoolFree(&Pool, Entries[i]);
+    }
+}
+
+#ifndef _WIN32
+TEST(PoolTestEx, ZeroOnAlloc)
+{
+    QUIC_POOL Pool;
+    QuicPoolInitializeEx(FALSE, POOL_TEST_ENTRY_SIZE, POOL_TEST_TAG, TRUE, &Pool);
+
+    uint8_t* Entries[64];
+    for (uint32_t i = 0; i < ARRAYSIZE(Entries); ++i) {
+        Entries[i] = (uint8_t*)QuicPoolAlloc(&Pool);
+        ASSERT_NE(nullptr, Entries[i]);
+        memset(Entries[i], 0xFF, POOL_TEST_ENTRY_SIZE);
+    }
+    for (uint32_t i = 0; i < ARRAYSIZE(Entries); ++i) {
+        QuicPoolFree(&Pool, Entries[i]);
+    }
+    for (uint32_t i = 0; i < ARRAYSIZE(Entries); ++i) {
+        Entries[i] = (uint8_t*)QuicPoolAlloc(&Pool);
+        ASSERT_NE(nullptr, Entries[i]);
+        for (uint32_t j = 0; j < POOL_TEST_ENTRY_SIZE; ++j) {
+            ASSERT_EQ(0, Entries[i][j]);
+        }
+    }
+    for (uint32_t i = 0; i < ARRAYSIZE(Entries); ++i) {
+        QuicPoolFree(&Pool, Entries[i]);
+    }
+
+    QuicPoolUninitialize(&Pool);
+}
+#endif
+
+struct PoolStressContext {
+    QUIC_POOL* Pool;
+    uint32_t Iterations;
+    uint32_t Id;
+    bool Failed;
+};
+
+QUIC_THREAD_CALLBACK(PoolStressThread, Context)
+{
+    PoolStressContext* Ctx = (PoolStressContext*)Context;
+    uint32_t* Entries[32];
+    for (uint32_t i = 0; i < Ctx->Iterations; ++i) {
+        //
+        // Vary the batch size so entries move between the per-processor
+        // caches and the shared spill list.
+        //
+        uint32_t Count = 1 + (i % ARRAYSIZE(Entries));
+        for (uint32_t j = 0; j < Count; ++j) {
+            Entries[j] = (uint32_t*)QuicPoolAlloc(Ctx->Pool);
+            if (Entries[j] == nullptr) {
+                Ctx->Failed = true;
+                QUIC_THREAD_RETURN(0);
+            }
+            Entries[j][1] = Ctx->Id;
+        }
+        for (uint32_t j = 0; j < Count; ++j) {
+            if (Entries[j][1] != Ctx->Id) {
+                Ctx->Failed = true;
+            }
+            QuicPoolFree(Ctx->Pool, Entries[j]);
+        }
+    }
+    QUIC_THREAD_RETURN(0);
+}
+
+TEST_F(PoolTest, MultiThreadStress)
+{
+    const uint32_t ThreadCount = 8;
+    QUIC_THREAD Threads[ThreadCount];
+    PoolStressContext Contexts[ThreadCount];
+
+    for (uint32_t i = 0; i < ThreadCount; ++i) {
+        Contexts[i].Pool = &Pool;
+        Contexts[i].Iterations = 20000;
+        Contexts[i].Id = i;
+        Contexts[i].Failed = false;
+        QUIC_THREAD_CONFIG Config = {
+            0, 0, "PoolStress", PoolStressThread, &Contexts[i]
+        };
+        VERIFY_QUIC_SUCCESS(QuicThreadCreate(&Config, &Threads[i]));
+    }
+
+    for (uint32_t i = 0; i < ThreadCount; ++i) {
+        QuicThreadWait(&Threads[i]);
+        QuicThreadDelete(&Threads[i]);
+        ASSERT_FALSE(Contexts[i].Failed);
+    }
+}
+
+uint64_t PoolAllocFree(
+    const uint64_t LoopCount
+    )
+{
+    QUIC_POOL Pool;
+    void* Entries[16];
+    uint64_t Start, End;
+
+    QuicPoolInitialize(FALSE, POOL_TEST_ENTRY_SIZE, POOL_TEST_TAG, &Pool);
+    Start = QuicTimeUs64();
+    for (uint64_t j = 0; j < LoopCount; ++j) {
+        for (uint32_t i = 0; i < ARRAYSIZE(Entries); ++i) {
+            Entries[i] = QuicPoolAlloc(&Pool);
+        }
+        for (uint32_t i = 0; i < ARRAYSIZE(Entries); ++i) {
+            QuicPoolFree(&Pool, Entries[i]);
+        }
+    }
+    End = QuicTimeUs64();
+    QuicPoolUninitialize(&Pool);
+
+    return End - Start;
+}
+
+uint64_t MallocZeroFree(
+    const uint64_t LoopCount
+    )
+{
+    void* Entries[16];
+    uint64_t Start, End;
+
+    Start = QuicTimeUs64();
+    for (uint64_t j = 0; j < LoopCount; ++j) {
+        for (uint32_t i = 0; i < ARRAYSIZE(Entries); ++i) {
+            Entries[i] = QUIC_ALLOC_NONPAGED(POOL_TEST_ENTRY_SIZE, POOL_TEST_TAG);
+            if (Entries[i] != nullptr) {
+                QuicZeroMemory(Entries[i], POOL_TEST_ENTRY_SIZE);
+            }
+        }
+        for (uint32_t i = 0; i < ARRAYSIZE(Entries); ++i) {
+            QUIC_FREE(Entries[i], POOL_TEST_TAG);
+        }
+    }
+    End = QuicTimeUs64();
+
+    return End - Start;
+}
+
+TEST_F(PoolTest, PerfTest)
+{
+    uint64_t (*const TestFuncs[]) (uint64_t) = {PoolAllocFree, MallocZeroFree};
+    const char* const TestName[] = {"Pool alloc/free", "Malloc/zero/free"};
+    const uint64_t LoopCount = 100000;
+
+    for (uint8_t i = 0; i < ARRAYSIZE(TestName); ++i) {
+
+        const uint64_t elapsedMicroseconds = TestFuncs[i](LoopCount);
+
+        std::cout << elapsedMicroseconds / 1000 << "." << (int)(elapsedMicroseconds % 1000) <<
+            " milliseconds elapsed "
+            << TestName[i] << " " << LoopCount * 16 << " entries" << std::endl;
+    }
+}
@@ -198,9 +198,36 @@ EXT_COMMAND(
         "\tQueued Streams       ");
 
     HasAtLeastOneStream = false;
-    auto SendStreams = Send.GetSendStreams();
+    for (ULONG Level = QUIC_STREAM_PRIORITY_LEVEL_COUNT; Level > 0; --Level) {
+        auto SendStreams = Send.GetSendStreams(Level - 1);
+        while (!CheckControlC()) {
+            auto StreamSendLinkAddr = SendStreams.Next();
+            if (StreamSendLinkAddr == 0) {
+                break;
+            }
+
+            auto Strm = Stream::FromSendLink(StreamSendLinkAddr);
+            Dml("<link cmd=\"!quicstream 0x%I64X\">Stream %I64u</link> (Priority %u)\n"
+                "\t                     ",
+                Strm.Addr,
+                Strm.ID(),
+                Level - 1);
+            HasAtLeastOneStream = true;
+        }
+    }
+
+    if (!HasAtLeastOneStream) {
+        Dml("NONE\n");
+    } else {
+        Dml("\n");
+    }
+
+    Dml("\tBlocked Streams      ");
+
+    HasAtLeastOneStream = false;
+    auto BlockedStreams = Send.GetBlockedStreams();
     while (!CheckControlC()) {
-        auto StreamSendLinkAddr = SendStreams.Next();
+        auto StreamSendLinkAddr = BlockedStreams.Next();
         if (StreamSendLinkAddr == 0) {
             break;
         }
@@ -37,6 +37,7 @@ typedef union QUIC_STREAM_FLAGS {
 
         BOOLEAN SendOpen                : 1;    // Send a STREAM frame immediately on start.
         BOOLEAN SendOpenAcked           : 1;    // A STREAM frame has been acknowledged.
+        BOOLEAN SendBlocked             : 1;    // Queued on the blocked streams list.
 
         BOOLEAN LocalNotAllowed         : 1;    // Peer's unidirectional stream.
         BOOLEAN LocalCloseFin           : 1;    // Locally closed (graceful).
@@ -419,10 +420,6 @@ struct CidHashEntry : Struct {
 
     CidHashEntry(ULONG64 Addr) : Struct("msquic!QUIC_CID_HASH_ENTRY", Addr) { }
 
-    static CidHashEntry FromEntry(ULONG64 EntryAddr) {
-        return CidHashEntry(LinkEntryToType(EntryAddr, "msquic!QUIC_CID_HASH_ENTRY", "Entry"));
-    }
-
     static CidHashEntry FromLink(ULONG64 LinkAddr) {
         return CidHashEntry(LinkEntryToType(LinkAddr, "msquic!QUIC_CID_HASH_ENTRY", "Link"));
     }
@@ -721,6 +718,8 @@ struct Stream : Struct {
 #define QUIC_CONN_SEND_FLAG_DATAGRAM                0x00004000
 #define QUIC_CONN_SEND_FLAG_PMTUD                   0x80000000
 
+#define QUIC_STREAM_PRIORITY_LEVEL_COUNT            8
+
 struct Send : Struct {
 
     Send(ULONG64 Addr) : Struct("msquic!QUIC_SEND", Addr) { }
@@ -733,8 +732,15 @@ struct Send : Struct {
         return ReadType<UINT32>("SendFlags");
     }
 
-    LinkedList GetSendStreams() {
-        return LinkedList(AddrOf("SendStreams"));
+    LinkedList GetSendStreams(ULONG Level) {
+        return
+            LinkedList(
+                AddrOf("SendStreams") +
+                Level * GetTypeSize("msquic!QUIC_LIST_ENTRY"));
+    }
+
+    LinkedList GetBlockedStreams() {
+        return LinkedList(AddrOf("BlockedStreams"));
     }
 };
 
@@ -1359,12 +1365,61 @@ struct Registration : Struct {
     }
 };
 
+#define QUIC_CID_TABLE_SLOTS 7
+
+struct CidTable : Struct {
+
+    ULONG Bucket;
+    ULONG Slot;
+    ULONG BucketSize;
+    ULONG FingerprintsOffset;
+    ULONG EntriesOffset;
+
+    CidTable(ULONG64 Addr) : Struct("msquic!QUIC_CID_TABLE", Addr) {
+        Bucket = 0;
+        Slot = 0;
+        BucketSize = GetTypeSize("msquic!QUIC_CID_TABLE_BUCKET");
+        GetFieldOffset("msquic!QUIC_CID_TABLE_BUCKET", "Fingerprints", &FingerprintsOffset);
+        GetFieldOffset("msquic!QUIC_CID_TABLE_BUCKET", "Entries", &EntriesOffset);
+    }
+
+    ULONG BucketCount() {
+        return ReadType<ULONG>("BucketCount");
+    }
+
+    ULONG EntryCount() {
+        return ReadType<ULONG>("EntryCount");
+    }
+
+    bool GetNextEntry(ULONG64* EntryAddress) {
+        ULONG64 Buckets = ReadPointer("Buckets");
+        ULONG Count = BucketCount();
+        for (; Bucket < Count; Bucket++, Slot = 0) {
+            ULONG64 BucketAddr = Buckets + Bucket * BucketSize;
+            for (; Slot < QUIC_CID_TABLE_SLOTS; Slot++) {
+                UCHAR Fingerprint;
+                if (!ReadTypeAtAddr(BucketAddr + FingerprintsOffset + Slot, &Fingerprint)) {
+                    return false;
+                }
+                if (Fingerprint != 0) {
+                    ReadPointerAtAddr(
+                        BucketAddr + EntriesOffset + Slot * g_ExtInstance.m_PtrSize,
+                        EntryAddress);
+                    Slot++;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+};
+
 struct LookupHashTable : Struct {
 
     LookupHashTable(ULONG64 Addr) : Struct("msquic!QUIC_PARTITIONED_HASHTABLE", Addr) { }
 
     ULONG64 GetTablePtr() {
-        return AddrOf("Table"); // TODO - Need Hash Table Enumeration.
+        return AddrOf("Table");
     }
 };
 
@@ -77,6 +77,16 @@ QuicTestVersionNegotiation(
     _In_ int Family
     );
 
+void
+QuicTestConnectHandshakeOffload(
+    _In_ int Family
+    );
+
+void
+QuicTestPathMtuDiscovery(
+    _In_ int Family
+    );
+
 //
 // Negative Handshake Tests
 //
@@ -147,6 +157,11 @@ QuicTestConnectAndPing(
     _In_ bool FifoScheduling
     );
 
+void
+QuicTestBbrTransfer(
+    _In_ int Family
+    );
+
 //
 // Other Data Tests
 //
@@ -590,4 +605,16 @@ typedef struct {
     QUIC_CTL_CODE(46, METHOD_BUFFERED, FILE_WRITE_DATA)
     // int - Family
 
-#define QUIC_MAX_IOCTL_FUNC_CODE 46
+#define IOCTL_QUIC_RUN_CONNECT_HANDSHAKE_OFFLOAD \
+    QUIC_CTL_CODE(47, METHOD_BUFFERED, FILE_WRITE_DATA)
+    // int - Family
+
+#define IOCTL_QUIC_RUN_PATH_MTU_DISCOVERY \
+    QUIC_CTL_CODE(48, METHOD_BUFFERED, FILE_WRITE_DATA)
+    // int - Family
+
+#define IOCTL_QUIC_RUN_BBR_TRANSFER \
+    QUIC_CTL_CODE(49, METHOD_BUFFERED, FILE_WRITE_DATA)
+    // int - Family
+
+#define QUIC_MAX_IOCTL_FUNC_CODE 49
@@ -392,6 +392,24 @@ TEST_P(WithFamilyArgs, VersionNegotiation) {
     }
 }
 
+TEST_P(WithFamilyArgs, HandshakeOffload) {
+    TestLoggerT<ParamType> Logger("QuicTestConnectHandshakeOffload", GetParam());
+    if (TestingKernelMode) {
+        ASSERT_TRUE(DriverClient.Run(IOCTL_QUIC_RUN_CONNECT_HANDSHAKE_OFFLOAD, GetParam().Family));
+    } else {
+        QuicTestConnectHandshakeOffload(GetParam().Family);
+    }
+}
+
+TEST_P(WithFamilyArgs, PathMtuDiscovery) {
+    TestLoggerT<ParamType> Logger("QuicTestPathMtuDiscovery", GetParam());
+    if (TestingKernelMode) {
+        ASSERT_TRUE(DriverClient.Run(IOCTL_QUIC_RUN_PATH_MTU_DISCOVERY, GetParam().Family));
+    } else {
+        QuicTestPathMtuDiscovery(GetParam().Family);
+    }
+}
+
 #if QUIC_TEST_DATAPATH_HOOKS_ENABLED
 TEST_P(WithHandshakeArgs4, RandomLoss) {
     TestLoggerT<ParamType> Logger("QuicTestConnect-RandomLoss", GetParam());
@@ -694,6 +712,15 @@ TEST_P(WithSend0RttArgs2, Reject0Rtt) {
 
 #endif // QUIC_DISABLE_0RTT_TESTS
 
+TEST_P(WithFamilyArgs, BbrTransfer) {
+    TestLoggerT<ParamType> Logger("QuicTestBbrTransfer", GetParam());
+    if (TestingKernelMode) {
+        ASSERT_TRUE(DriverClient.Run(IOCTL_QUIC_RUN_BBR_TRANSFER, GetParam().Family));
+    } else {
+        QuicTestBbrTransfer(GetParam().Family);
+    }
+}
+
 TEST_P(WithBool, IdleTimeout) {
     TestLoggerT<ParamType> Logger("QuicTestConnectAndIdle", GetParam());
     if (TestingKernelMode) {
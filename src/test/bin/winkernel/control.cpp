@@ -412,6 +412,9 @@ size_t QUIC_IOCTL_BUFFER_SIZES[] =
     sizeof(INT32),
     sizeof(INT32),
     0,
+    sizeof(INT32),
+    sizeof(INT32),
+    sizeof(INT32),
     sizeof(INT32)
 };
 
@@ -821,6 +824,24 @@ QuicTestCtlEvtIoDeviceControl(
             QuicTestAckSendDelay(Params->Family));
         break;
 
+    case IOCTL_QUIC_RUN_CONNECT_HANDSHAKE_OFFLOAD:
+        QUIC_FRE_ASSERT(Params != nullptr);
+        QuicTestCtlRun(
+            QuicTestConnectHandshakeOffload(Params->Family));
+        break;
+
+    case IOCTL_QUIC_RUN_PATH_MTU_DISCOVERY:
+        QUIC_FRE_ASSERT(Params != nullptr);
+        QuicTestCtlRun(
+            QuicTestPathMtuDiscovery(Params->Family));
+        break;
+
+    case IOCTL_QUIC_RUN_BBR_TRANSFER:
+        QUIC_FRE_ASSERT(Params != nullptr);
+        QuicTestCtlRun(
+            QuicTestBbrTransfer(Params->Family));
+        break;
+
     default:
         Status = STATUS_NOT_IMPLEMENTED;
         break;
@@ -137,8 +137,68 @@ void QuicTestValidateConfiguration()
     LocalConfiguration = nullptr;
 
     //
-    // Invalid settings - TODO
+    // Settings with the original, smaller QUIC_SETTINGS size.
     //
+    const uint32_t OriginalSettingsSize =
+        (uint32_t)offsetof(QUIC_SETTINGS, SpinTimeUs);
+    TEST_QUIC_SUCCEEDED(
+        MsQuic->ConfigurationOpen(
+            Registration,
+            &GoodAlpn,
+            1,
+            &GoodSettings,
+            OriginalSettingsSize,
+            nullptr,
+            &LocalConfiguration));
+
+    {
+        QUIC_SETTINGS Settings;
+        memset(&Settings, 0xFF, sizeof(Settings));
+        uint32_t SettingsSize = OriginalSettingsSize - 1;
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_BUFFER_TOO_SMALL,
+            MsQuic->GetParam(
+                LocalConfiguration,
+                QUIC_PARAM_LEVEL_CONFIGURATION,
+                QUIC_PARAM_CONFIGURATION_SETTINGS,
+                &SettingsSize,
+                &Settings));
+        TEST_EQUAL(sizeof(QUIC_SETTINGS), SettingsSize);
+
+        SettingsSize = OriginalSettingsSize;
+        TEST_QUIC_SUCCEEDED(
+            MsQuic->GetParam(
+                LocalConfiguration,
+                QUIC_PARAM_LEVEL_CONFIGURATION,
+                QUIC_PARAM_CONFIGURATION_SETTINGS,
+                &SettingsSize,
+                &Settings));
+        TEST_EQUAL(OriginalSettingsSize, SettingsSize);
+        TEST_EQUAL(30000u, Settings.IdleTimeoutMs);
+        TEST_EQUAL(0xFFFFFFFF, Settings.SpinTimeUs); // Not written.
+    }
+
+    MsQuic->ConfigurationClose(
+        LocalConfiguration);
+    LocalConfiguration = nullptr;
+
+    //
+    // Invalid settings.
+    //
+    QUIC_SETTINGS BadSettings{0};
+    BadSettings.CongestionControlAlgorithm = QUIC_CONGESTION_CONTROL_ALGORITHM_MAX;
+    BadSettings.IsSet.CongestionControlAlgorithm = TRUE;
+
+    TEST_QUIC_STATUS(
+        QUIC_STATUS_INVALID_PARAMETER,
+        MsQuic->ConfigurationOpen(
+            Registration,
+            &GoodAlpn,
+            1,
+            &BadSettings,
+            sizeof(BadSettings),
+            nullptr,
+            &LocalConfiguration));
 
     //
     // Null ALPN.
@@ -800,6 +860,56 @@ void QuicTestValidateConnection()
                 &ReceiveDatagrams));
     }
 
+    //
+    // Statistics queried with the original, smaller QUIC_STATISTICS size.
+    //
+    {
+        ConnectionScope Connection;
+        TEST_QUIC_SUCCEEDED(
+            MsQuic->ConnectionOpen(
+                Registration,
+                DummyConnectionCallback,
+                nullptr,
+                &Connection.Handle));
+
+        const uint32_t OriginalSize =
+            (uint32_t)offsetof(QUIC_STATISTICS, PathMtuSearchState);
+        QUIC_STATISTICS Stats;
+        memset(&Stats, 0xFF, sizeof(Stats));
+        uint32_t StatsSize = OriginalSize - 1;
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_BUFFER_TOO_SMALL,
+            MsQuic->GetParam(
+                Connection.Handle,
+                QUIC_PARAM_LEVEL_CONNECTION,
+                QUIC_PARAM_CONN_STATISTICS,
+                &StatsSize,
+                &Stats));
+        TEST_EQUAL(sizeof(QUIC_STATISTICS), StatsSize);
+
+        StatsSize = OriginalSize;
+        TEST_QUIC_SUCCEEDED(
+            MsQuic->GetParam(
+                Connection.Handle,
+                QUIC_PARAM_LEVEL_CONNECTION,
+                QUIC_PARAM_CONN_STATISTICS,
+                &StatsSize,
+                &Stats));
+        TEST_EQUAL(OriginalSize, StatsSize);
+        TEST_EQUAL(0xFFFFFFFF, Stats.PathMtuProbeCount); // Not written.
+
+        StatsSize = sizeof(Stats);
+        TEST_QUIC_SUCCEEDED(
+            MsQuic->GetParam(
+                Connection.Handle,
+                QUIC_PARAM_LEVEL_CONNECTION,
+                QUIC_PARAM_CONN_STATISTICS,
+                &StatsSize,
+                &Stats));
+        TEST_EQUAL(sizeof(QUIC_STATISTICS), StatsSize);
+        TEST_EQUAL(0u, Stats.PathMtuProbeCount);
+    }
+
     //
     // Invalid send resumption.
     //
@@ -1342,6 +1452,87 @@ void QuicTestValidateStream(bool Connect)
                         QUIC_TEST_NO_ERROR));
             }
 
+            //
+            // Stream priority.
+            //
+            {
+                StreamScope Stream;
+                TEST_QUIC_SUCCEEDED(
+                    MsQuic->StreamOpen(
+                        Client.GetConnection(),
+                        QUIC_STREAM_OPEN_FLAG_NONE,
+                        DummyStreamCallback,
+                        nullptr,
+                        &Stream.Handle));
+
+                QUIC_STREAM_PRIORITY Priority;
+                uint32_t Length = sizeof(Priority);
+                TEST_QUIC_SUCCEEDED(
+                    MsQuic->GetParam(
+                        Stream.Handle,
+                        QUIC_PARAM_LEVEL_STREAM,
+                        QUIC_PARAM_STREAM_PRIORITY,
+                        &Length,
+                        &Priority));
+                TEST_EQUAL(Priority.Level, QUIC_STREAM_PRIORITY_LEVEL_DEFAULT);
+                TEST_EQUAL(Priority.Weight, QUIC_STREAM_PRIORITY_WEIGHT_DEFAULT);
+
+                Priority.Level = QUIC_STREAM_PRIORITY_LEVEL_COUNT;
+                TEST_QUIC_STATUS(
+                    QUIC_STATUS_INVALID_PARAMETER,
+                    MsQuic->SetParam(
+                        Stream.Handle,
+                        QUIC_PARAM_LEVEL_STREAM,
+                        QUIC_PARAM_STREAM_PRIORITY,
+                        sizeof(Priority),
+                        &Priority));
+
+                Priority.Level = QUIC_STREAM_PRIORITY_LEVEL_COUNT - 1;
+                Priority.Weight = 0;
+                TEST_QUIC_STATUS(
+                    QUIC_STATUS_INVALID_PARAMETER,
+                    MsQuic->SetParam(
+                        Stream.Handle,
+                        QUIC_PARAM_LEVEL_STREAM,
+                        QUIC_PARAM_STREAM_PRIORITY,
+                        sizeof(Priority),
+                        &Priority));
+
+                Priority.Weight = 4;
+                TEST_QUIC_SUCCEEDED(
+                    MsQuic->SetParam(
+                        Stream.Handle,
+                        QUIC_PARAM_LEVEL_STREAM,
+                        QUIC_PARAM_STREAM_PRIORITY,
+                        sizeof(Priority),
+                        &Priority));
+
+                TEST_QUIC_SUCCEEDED(
+                    MsQuic->StreamStart(
+                        Stream.Handle,
+                        QUIC_STREAM_START_FLAG_NONE));
+
+                Priority.Level = 0;
+                TEST_QUIC_SUCCEEDED(
+                    MsQuic->SetParam(
+                        Stream.Handle,
+                        QUIC_PARAM_LEVEL_STREAM,
+                        QUIC_PARAM_STREAM_PRIORITY,
+                        sizeof(Priority),
+                        &Priority));
+
+                Length = sizeof(Priority);
+                TEST_QUIC_SUCCEEDED(
+                    MsQuic->GetParam(
+                        Stream.Handle,
+                        QUIC_PARAM_LEVEL_STREAM,
+                        QUIC_PARAM_STREAM_PRIORITY,
+                        &Length,
+                        &Priority));
+                TEST_EQUAL(Priority.Level, 0);
+                TEST_EQUAL(Priority.Weight, 4);
+            }
+
             //
             // Close nullptr.
             //
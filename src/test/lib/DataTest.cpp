@@ -66,6 +66,9 @@ struct PingStats
 
     QUIC_BUFFER* ResumptionTicket {nullptr};
 
+    bool ExpectBandwidthEstimate {false};
+    bool ExpectNoPersistentCongestion {false};
+
     PingStats(
         uint64_t _PayloadLength,
         uint32_t _ConnectionCount,
@@ -214,6 +217,14 @@ PingConnectionShutdown(
         TEST_FALSE(Connection->GetTransportClosed());
         TEST_FALSE(Connection->GetPeerClosed());
     }
+    if (ConnState->GetPingStats()->ExpectBandwidthEstimate &&
+        Connection->GetStatistics().EstimatedBandwidth == 0) {
+        TEST_FAILURE("No bandwidth estimate after sending data.");
+    }
+    if (ConnState->GetPingStats()->ExpectNoPersistentCongestion &&
+        Connection->GetStatistics().Send.PersistentCongestionCount != 0) {
+        TEST_FAILURE("Window collapsed on random loss.");
+    }
     delete ConnState;
 }
 
@@ -493,6 +504,81 @@ QuicTestConnectAndPing(
     }
 }
 
+void
+QuicTestBbrTransfer(
+    _In_ int Family
+    )
+{
+    const uint64_t Length = 1000000;
+    const uint32_t TimeoutMs = EstimateTimeoutMs(Length);
+    QUIC_ADDRESS_FAMILY QuicAddrFamily = (Family == 4) ? QUIC_ADDRESS_FAMILY_INET : QUIC_ADDRESS_FAMILY_INET6;
+
+    PingStats ServerStats(Length, 1, 1, false, false, false, false, false, QUIC_STATUS_SUCCESS);
+    PingStats ClientStats(Length, 1, 1, false, false, false, false);
+    ClientStats.ExpectBandwidthEstimate = true;
+    ClientStats.ExpectNoPersistentCongestion = true;
+
+    MsQuicRegistration Registration(true);
+    TEST_TRUE(Registration.IsValid());
+
+    MsQuicAlpn Alpn("MsQuicTest");
+
+    MsQuicSettings Settings;
+    Settings.SetPeerBidiStreamCount(1);
+    Settings.SetCongestionControlAlgorithm(QUIC_CONGESTION_CONTROL_ALGORITHM_BBR);
+
+    MsQuicConfiguration ServerConfiguration(Registration, Alpn, Settings, SelfSignedCredConfig);
+    TEST_TRUE(ServerConfiguration.IsValid());
+
+    MsQuicCredentialConfig ClientCredConfig;
+    MsQuicConfiguration ClientConfiguration(Registration, Alpn, Settings, ClientCredConfig);
+    TEST_TRUE(ClientConfiguration.IsValid());
+
+#if QUIC_TEST_DATAPATH_HOOKS_ENABLED
+    //
+    // Some random loss, which BBR shouldn't treat as congestion.
+    //
+    RandomLossHelper LossHelper(1);
+#endif
+
+    {
+        TestListener Listener(Registration, ListenerAcceptPingConnection, ServerConfiguration);
+        TEST_TRUE(Listener.IsValid());
+        TEST_QUIC_SUCCEEDED(Listener.Start(Alpn));
+
+        QuicAddr ServerLocalAddr;
+        TEST_QUIC_SUCCEEDED(Listener.GetLocalAddr(ServerLocalAddr));
+
+        Listener.Context = &ServerStats;
+
+        TestConnection* Client = NewPingConnection(Registration, &ClientStats, false);
+        if (Client == nullptr) {
+            return;
+        }
+
+        if (!SendPingBurst(Client, 1, Length)) {
+            return;
+        }
+
+        TEST_QUIC_SUCCEEDED(
+            Client->Start(
+                ClientConfiguration,
+                QuicAddrFamily,
+                QUIC_LOCALHOST_FOR_AF(QuicAddrFamily),
+                ServerLocalAddr.GetPort()));
+
+        if (!QuicEventWaitWithTimeout(ClientStats.CompletionEvent, TimeoutMs)) {
+            TEST_FAILURE("Wait for client to complete timed out after %u ms.", TimeoutMs);
+            return;
+        }
+
+        if (!QuicEventWaitWithTimeout(ServerStats.CompletionEvent, TimeoutMs)) {
+            TEST_FAILURE("Wait for server to complete timed out after %u ms.", TimeoutMs);
+            return;
+        }
+    }
+}
+
 void
 QuicTestServerDisconnect(
     void
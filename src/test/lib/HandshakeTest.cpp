@@ -836,6 +836,189 @@ QuicTestVersionNegotiation(
     }
 }
 
+void
+QuicTestConnectHandshakeOffload(
+    _In_ int Family
+    )
+{
+    MsQuicRegistration Registration;
+    TEST_TRUE(Registration.IsValid());
+
+    MsQuicAlpn Alpn("MsQuicTest");
+
+    MsQuicSettings Settings;
+    Settings.SetIdleTimeoutMs(3000);
+
+    MsQuicSettings ServerSettings;
+    ServerSettings.SetIdleTimeoutMs(3000);
+    ServerSettings.SetHandshakeOffloadEnabled(true);
+
+    MsQuicConfiguration ServerConfiguration(Registration, Alpn, ServerSettings, SelfSignedCredConfig);
+    TEST_TRUE(ServerConfiguration.IsValid());
+
+    MsQuicCredentialConfig ClientCredConfig;
+    MsQuicConfiguration ClientConfiguration(Registration, Alpn, Settings, ClientCredConfig);
+    TEST_TRUE(ClientConfiguration.IsValid());
+
+    {
+        TestListener Listener(Registration, ListenerAcceptConnection, ServerConfiguration);
+        TEST_TRUE(Listener.IsValid());
+        TEST_QUIC_SUCCEEDED(Listener.Start(Alpn));
+
+        QUIC_ADDRESS_FAMILY QuicAddrFamily = (Family == 4) ? QUIC_ADDRESS_FAMILY_INET : QUIC_ADDRESS_FAMILY_INET6;
+        QuicAddr ServerLocalAddr;
+        TEST_QUIC_SUCCEEDED(Listener.GetLocalAddr(ServerLocalAddr));
+
+        //
+        // Run a few handshakes, so that some reuse the already running
+        // handshake offload threads.
+        //
+        for (uint32_t i = 0; i < 4; ++i) {
+            UniquePtr<TestConnection> Server;
+            ServerAcceptContext ServerAcceptCtx((TestConnection**)&Server);
+            Listener.Context = &ServerAcceptCtx;
+
+            {
+                TestConnection Client(Registration);
+                TEST_TRUE(Client.IsValid());
+
+                TEST_QUIC_SUCCEEDED(
+                    Client.Start(
+                        ClientConfiguration,
+                        QuicAddrFamily,
+                        QUIC_LOCALHOST_FOR_AF(QuicAddrFamily),
+                        ServerLocalAddr.GetPort()));
+                if (!Client.WaitForConnectionComplete()) {
+                    return;
+                }
+                TEST_TRUE(Client.GetIsConnected());
+
+                TEST_NOT_EQUAL(nullptr, Server);
+                if (!Server->WaitForConnectionComplete()) {
+                    return;
+                }
+                TEST_TRUE(Server->GetIsConnected());
+            }
+        }
+    }
+}
+
+void
+QuicTestPathMtuDiscoveryRun(
+    _In_ MsQuicRegistration& Registration,
+    _In_ MsQuicConfiguration& ClientConfiguration,
+    _In_ TestListener& Listener,
+    _In_ QUIC_ADDRESS_FAMILY QuicAddrFamily,
+    _In_ uint16_t ServerPort,
+    _In_ uint16_t MinExpectedMtu,
+    _In_ uint16_t MaxExpectedMtu
+    )
+{
+    UniquePtr<TestConnection> Server;
+    ServerAcceptContext ServerAcceptCtx((TestConnection**)&Server);
+    Listener.Context = &ServerAcceptCtx;
+
+    TestConnection Client(Registration);
+    TEST_TRUE(Client.IsValid());
+
+    TEST_QUIC_SUCCEEDED(
+        Client.Start(
+            ClientConfiguration,
+            QuicAddrFamily,
+            QUIC_LOCALHOST_FOR_AF(QuicAddrFamily),
+            ServerPort));
+    if (!Client.WaitForConnectionComplete()) {
+        return;
+    }
+    TEST_TRUE(Client.GetIsConnected());
+
+    TEST_NOT_EQUAL(nullptr, Server);
+    if (!Server->WaitForConnectionComplete()) {
+        return;
+    }
+    TEST_TRUE(Server->GetIsConnected());
+
+    QUIC_STATISTICS Stats = Client.GetStatistics();
+    for (uint32_t i = 0;
+        i < 200 && Stats.PathMtuSearchState != QUIC_PATH_MTU_SEARCH_STATE_COMPLETE;
+        ++i) {
+        QuicSleep(50);
+        Stats = Client.GetStatistics();
+    }
+
+    if (Stats.PathMtuSearchState != QUIC_PATH_MTU_SEARCH_STATE_COMPLETE) {
+        TEST_FAILURE("Path MTU search didn't complete (state=%u)", Stats.PathMtuSearchState);
+        return;
+    }
+    if (Stats.Send.PathMtu < MinExpectedMtu || Stats.Send.PathMtu > MaxExpectedMtu) {
+        TEST_FAILURE(
+            "Path MTU of %hu not in expected range [%hu, %hu]",
+            Stats.Send.PathMtu,
+            MinExpectedMtu,
+            MaxExpectedMtu);
+        return;
+    }
+    TEST_NOT_EQUAL(0u, Stats.PathMtuProbeCount);
+}
+
+void
+QuicTestPathMtuDiscovery(
+    _In_ int Family
+    )
+{
+    MsQuicRegistration Registration;
+    TEST_TRUE(Registration.IsValid());
+
+    MsQuicAlpn Alpn("MsQuicTest");
+
+    MsQuicSettings Settings;
+    Settings.SetIdleTimeoutMs(10000);
+
+    MsQuicConfiguration ServerConfiguration(Registration, Alpn, Settings, SelfSignedCredConfig);
+    TEST_TRUE(ServerConfiguration.IsValid());
+
+    MsQuicCredentialConfig ClientCredConfig;
+    MsQuicConfiguration ClientConfiguration(Registration, Alpn, Settings, ClientCredConfig);
+    TEST_TRUE(ClientConfiguration.IsValid());
+
+    TestListener Listener(Registration, ListenerAcceptConnection, ServerConfiguration);
+    TEST_TRUE(Listener.IsValid());
+
+    QUIC_ADDRESS_FAMILY QuicAddrFamily = (Family == 4) ? QUIC_ADDRESS_FAMILY_INET : QUIC_ADDRESS_FAMILY_INET6;
+    QuicAddr ServerLocalAddr(QuicAddrFamily);
+    TEST_QUIC_SUCCEEDED(Listener.Start(Alpn, &ServerLocalAddr.SockAddr));
+    TEST_QUIC_SUCCEEDED(Listener.GetLocalAddr(ServerLocalAddr));
+
+    //
+    // Loopback supports the largest MTU, which should be found right away.
+    //
+    QuicTestPathMtuDiscoveryRun(
+        Registration,
+        ClientConfiguration,
+        Listener,
+        QuicAddrFamily,
+        ServerLocalAddr.GetPort(),
+        QUIC_MAX_MTU,
+        QUIC_MAX_MTU);
+
+#if QUIC_TEST_DATAPATH_HOOKS_ENABLED
+    //
+    // With anything over 1400 bytes dropped, the search needs to narrow down on
+    // the actual MTU.
+    //
+    const uint16_t PathMtu = 1400;
+    MtuDropHelper DropHelper(MaxUdpPayloadSizeForFamily(QuicAddrFamily, PathMtu));
+    QuicTestPathMtuDiscoveryRun(
+        Registration,
+        ClientConfiguration,
+        Listener,
+        QuicAddrFamily,
+        ServerLocalAddr.GetPort(),
+        PathMtu - 16, // The core's search granularity.
+        PathMtu);
+#endif
+}
+
 void
 QuicTestConnectBadAlpn(
     _In_ int Family
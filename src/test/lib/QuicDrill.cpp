@@ -166,6 +166,7 @@ struct DrillSender {
                 nullptr,
                 &ServerAddress,
                 this,
+                QUIC_DATAPATH_BINDING_FLAG_NONE,
                 &Binding);
         if (QUIC_FAILED(Status)) {
             TEST_FAILURE("Binding failed: 0x%x", Status);
@@ -352,6 +352,30 @@ struct SelectiveLossHelper : public DatapathHook
     }
 };
 
+struct MtuDropHelper : public DatapathHook
+{
+    uint16_t MaxUdpPayloadSize;
+    MtuDropHelper(uint16_t _MaxUdpPayloadSize) : MaxUdpPayloadSize(_MaxUdpPayloadSize) {
+        DatapathHooks::Instance->AddHook(this);
+    }
+    ~MtuDropHelper() {
+        DatapathHooks::Instance->RemoveHook(this);
+    }
+    _IRQL_requires_max_(DISPATCH_LEVEL)
+    BOOLEAN
+    Receive(
+        _Inout_ struct QUIC_RECV_DATAGRAM* Datagram
+        ) {
+        if (Datagram->BufferLength <= MaxUdpPayloadSize) {
+            return FALSE;
+        }
+        QuicTraceLogVerbose(
+            TestHookDropPacketMtu,
+            "[test][hook] MTU packet drop");
+        return TRUE;
+    }
+};
+
 struct ReplaceAddressHelper : public DatapathHook
 {
     QUIC_ADDR Original;
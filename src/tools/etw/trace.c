@@ -296,6 +296,21 @@ QuicTraceGlobalEvent(
             case QUIC_PERF_COUNTER_WORK_OPER_COMPLETED:
                 printf("    Total worker operations processed ever:             ");
                 break;
+            case QUIC_PERF_COUNTER_WORK_SPIN_WAKES:
+                printf("    Total times a spinning worker found work:           ");
+                break;
+            case QUIC_PERF_COUNTER_WORK_SLEEPS:
+                printf("    Total times a worker blocked waiting for work:      ");
+                break;
+            case QUIC_PERF_COUNTER_UDP_SPIN_WAKES:
+                printf("    Total times a datapath thread spun into events:     ");
+                break;
+            case QUIC_PERF_COUNTER_UDP_SLEEPS:
+                printf("    Total times a datapath thread blocked for events:   ");
+                break;
+            case QUIC_PERF_COUNTER_WORK_CONN_REBALANCED:
+                printf("    Total connections moved off an overloaded worker:   ");
+                break;
             default:
                 printf("    Unknown:                                            ");
                 break;
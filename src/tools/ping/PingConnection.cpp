@@ -338,6 +338,7 @@ PingConnection::ProcessEvent(
             printf("[%p]     Stream Bytes:           %llu\n", QuicConnection, (unsigned long long)Stats.Send.TotalStreamBytes);
             printf("[%p]     Congestion Events:      %u\n", QuicConnection, Stats.Send.CongestionCount);
             printf("[%p]     Pers Congestion Events: %u\n", QuicConnection, Stats.Send.PersistentCongestionCount);
+            printf("[%p]     Est. Bandwidth:         %llu bytes/sec\n", QuicConnection, (unsigned long long)Stats.EstimatedBandwidth);
             printf("[%p]   Recv:\n", QuicConnection);
             printf("[%p]     Total Packets:          %llu\n", QuicConnection, (unsigned long long)Stats.Recv.TotalPackets);
             printf("[%p]     Reordered Packets:      %llu\n", QuicConnection, (unsigned long long)Stats.Recv.ReorderedPackets);
@@ -391,7 +391,7 @@ const uint32_t ParamCounts[] = {
     QUIC_PARAM_LISTENER_STATS + 1,
     QUIC_PARAM_CONN_DISABLE_1RTT_ENCRYPTION + 1,
     0,
-    QUIC_PARAM_STREAM_IDEAL_SEND_BUFFER_SIZE + 1
+    QUIC_PARAM_STREAM_PRIORITY + 1
 };
 
 #define GET_PARAM_LOOP_COUNT 10